@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+#include "benchmarks/bench_runner.h"
+
+using namespace std;
+
+
+import vectors.vector;
+import vectors.vect2;
+import vectors.vect4;
+import vectors.clipvect2;
+import vectors.clipvect4;
+import utils.offsets;
+import utils.timecodes;
+import utils.perfmeters;
+import utils.profilers;
+import utils.latency_histograms;
+import utils.traces;
+import utils.numa;
+import graphitems.rect;
+import graphitems.line;
+import frames.frame_memory;
+import frames.frame_buffers;
+import frames.pixels;
+import frames.frame;
+import frames.frame_workers;
+import frames.yuv_frames;
+import frames.color_conversions;
+import frames.chroma_resampling;
+import frames.luts;
+import frames.blending;
+
+
+/** \brief main for micro-benchmarks on modules.
+* Usage: vcl_bench [--filter=<text>] [--reps=<count>] [--min-time-ms=<ms>] [--json=<path>]
+*/
+int main(int argc, char** argv)
+{
+    std::cout << ">>>>>>>>>>   BENCHMARKS SEQUENCE STARTED   <<<<<<<<<<\n\n";
+
+    vcl::bench::BenchRunner runner(argc, argv);
+
+#include "benchmarks/vectors/bench_vectors.h"
+#include "benchmarks/graphitems/bench_graphitems.h"
+#include "benchmarks/utils/bench_timecodes.h"
+#include "benchmarks/utils/bench_perfmeters.h"
+#include "benchmarks/frames/bench_frames.h"
+#include "benchmarks/frames/bench_color_conversions.h"
+#include "benchmarks/frames/bench_yuv_frames.h"
+#include "benchmarks/frames/bench_chroma_resampling.h"
+#include "benchmarks/frames/bench_luts.h"
+#include "benchmarks/frames/bench_blending.h"
+
+    std::cout << std::format("\n>>>>>>>>>>   {} benchmarks done   <<<<<<<<<<\n\n", runner.results().size());
+
+    return runner.finish();
+}
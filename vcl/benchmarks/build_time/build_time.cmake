@@ -0,0 +1,87 @@
+# MIT License
+#
+# Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+#
+# Build time benchmark of the explicit instantiations of vcl specializations.
+# Builds the same generated units twice, with VCL_EXPLICIT_INSTANTIATIONS OFF
+# (before) then ON (after), and reports the build time of library vcl and of the units.
+#
+#   cmake [-DTUS=100] [-DJOBS=8] [-DGENERATOR=Ninja] [-DWORK_DIR=<dir>] [-DJSON=<path>] -P benchmarks/build_time/build_time.cmake
+#
+# Results are only comparable between runs on the same machine with the
+# same compiler. Run it on an idle machine.
+
+cmake_minimum_required(VERSION 3.28)
+
+if(NOT DEFINED TUS)
+    set(TUS 100)
+endif()
+if(NOT DEFINED JOBS)
+    cmake_host_system_information(RESULT JOBS QUERY NUMBER_OF_LOGICAL_CORES)
+endif()
+if(NOT DEFINED GENERATOR)
+    set(GENERATOR Ninja)
+endif()
+if(NOT DEFINED WORK_DIR)
+    set(WORK_DIR ${CMAKE_CURRENT_BINARY_DIR}/vcl_build_time)
+endif()
+get_filename_component(VCL_SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR}/../.. ABSOLUTE)
+
+
+#---   returns the current time, in ms   ---------------------------------
+function(vcl_now_ms OUT_VAR)
+    string(TIMESTAMP now_us "%s%f" UTC)
+    math(EXPR now_ms "${now_us} / 1000")
+    set(${OUT_VAR} ${now_ms} PARENT_SCOPE)
+endfunction()
+
+#---   builds target, returns its build time, in ms   -------------------
+function(vcl_timed_build BUILD_DIR TARGET OUT_VAR)
+    vcl_now_ms(start_ms)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --target ${TARGET} --parallel ${JOBS}
+        RESULT_VARIABLE result
+        OUTPUT_QUIET
+    )
+    vcl_now_ms(stop_ms)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "build of ${TARGET} in ${BUILD_DIR} failed")
+    endif()
+    math(EXPR elapsed_ms "${stop_ms} - ${start_ms}")
+    set(${OUT_VAR} ${elapsed_ms} PARENT_SCOPE)
+endfunction()
+
+
+#---   before (OFF) and after (ON)   -------------------------------------
+set(JSON_RESULTS)
+foreach(MODE OFF ON)
+    set(BUILD_DIR ${WORK_DIR}/explicit_${MODE})
+    file(REMOVE_RECURSE ${BUILD_DIR})
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -S ${VCL_SOURCE_DIR} -B ${BUILD_DIR} -G ${GENERATOR}
+                -DCMAKE_BUILD_TYPE=Release
+                -DVCL_EXPLICIT_INSTANTIATIONS=${MODE}
+                -DVCL_BUILD_TIME_TUS=${TUS}
+        RESULT_VARIABLE result
+        OUTPUT_QUIET
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "configuration of ${BUILD_DIR} failed")
+    endif()
+
+    vcl_timed_build(${BUILD_DIR} vcl vcl_ms)
+    vcl_timed_build(${BUILD_DIR} vcl_build_time_bench units_ms)
+    file(SIZE ${BUILD_DIR}/vcl_build_time_bench exe_bytes)
+
+    message(STATUS "explicit instantiations ${MODE}: vcl ${vcl_ms} ms, ${TUS} units ${units_ms} ms, executable ${exe_bytes} bytes")
+    if(JSON_RESULTS)
+        string(APPEND JSON_RESULTS ",")
+    endif()
+    string(APPEND JSON_RESULTS "\n    {\"explicit_instantiations\": \"${MODE}\", \"vcl_ms\": ${vcl_ms}, \"units_ms\": ${units_ms}, \"executable_bytes\": ${exe_bytes}}")
+endforeach()
+
+if(DEFINED JSON)
+    string(TIMESTAMP date "%Y-%m-%dT%H:%M:%SZ" UTC)
+    file(WRITE ${JSON} "{\n  \"context\": {\"date\": \"${date}\", \"units\": ${TUS}, \"jobs\": ${JOBS}},\n  \"builds\": [${JSON_RESULTS}\n  ]\n}\n")
+    message(STATUS "results written to ${JSON}")
+endif()
@@ -0,0 +1,461 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#   define NOMINMAX
+#   include <windows.h>
+#   include <psapi.h>
+#else
+#   include <sys/resource.h>
+#endif
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "benchmarks/bench_runner.h"
+#include "utils/allocation_hooks.h"
+
+using namespace std;
+
+
+import utils.allocations;
+import utils.colors;
+import utils.latency_histograms;
+import utils.perfmeters;
+import utils.pos;
+import utils.timecodes;
+import utils.traces;
+import graphitems.rect;
+import graphitems.line;
+
+
+//===========================================================================
+namespace vcl::bench {
+
+    //-----------------------------------------------------------------------
+    /** \brief The stages of the synthetic video pipeline. */
+    enum PipelineStage : unsigned char
+    {
+        STAGE_GENERATE = 0,  //!< synthetic frame content generation.
+        STAGE_OVERLAYS,      //!< moving RectT and LineT overlays.
+        STAGE_TIMECODE,      //!< Timecode stamping.
+        STAGE_ANALYZE,       //!< full frame read-back, as an encoder or an analyzer would do.
+        STAGE_FRAME,         //!< the whole frame processing.
+        STAGES_COUNT
+    };
+
+    constexpr std::array<const char*, STAGES_COUNT> STAGES_NAMES{ "generate", "overlays", "timecode", "analyze", "frame" };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The results of one run of the pipeline. */
+    struct PipelineResult
+    {
+        std::string resolution;
+        int width;
+        int height;
+        unsigned int threads_count;
+        unsigned long long frames_count;
+        double elapsed_s;
+        double fps;
+        double peak_rss_mb;
+        std::array<vcl::utils::LatencyHistogram, STAGES_COUNT> latencies;
+    };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief Resets the peak resident set size of this process to its current resident set size.
+    * Linux only, via /proc/self/clear_refs.  Returns false when the peak
+    * cannot be reset, peak_rss_mb() then returning the running maximum of
+    * all the configurations run so far.
+    */
+    inline bool reset_peak_rss()
+    {
+#if defined(__linux__)
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        return bool(clear_refs << "5" << std::flush);
+#else
+        return false;
+#endif
+    }
+
+    /** \brief Returns the peak resident set size of this process since the last reset_peak_rss(), or since its start, in MB. */
+    inline double peak_rss_mb()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return double(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+        return 0.0;
+#else
+#   if defined(__linux__)
+        // VmHWM, unlike ru_maxrss, gets reset by reset_peak_rss()
+        std::ifstream status("/proc/self/status");
+        for (std::string line; std::getline(status, line); )
+            if (line.starts_with("VmHWM:"))
+                return std::stod(line.substr(6)) / 1024.0;  // kilobytes
+#   endif
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#   if defined(__APPLE__)
+        return double(usage.ru_maxrss) / (1024.0 * 1024.0);  // bytes
+#   else
+        return double(usage.ru_maxrss) / 1024.0;             // kilobytes
+#   endif
+#endif
+    }
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The synthetic video pipeline of one worker thread.
+    * Frame buffers and overlays are allocated once at construction time,
+    * so that the frame loop itself does not allocate.
+    */
+    class SyntheticPipeline
+    {
+    public:
+        static constexpr int OVERLAYS_COUNT = 16;
+
+        /** \brief Constructor. */
+        SyntheticPipeline(const int width, const int height, const unsigned int seed)
+            : m_frame(height, width, CV_8UC3),
+              m_tc(seed % 24, 0, 0, 0),
+              m_scale(height / 1080.0)
+        {
+            unsigned int rnd = seed * 2654435761u + 1;
+            auto next = [&rnd](const int modulo) { rnd = rnd * 1103515245u + 12345u; return int((rnd >> 8) % unsigned(modulo)); };
+
+            for (int i = 0; i < OVERLAYS_COUNT; ++i) {
+                const int w = 40 + next(width / 4);
+                const int h = 40 + next(height / 4);
+                const int x = next(width - w);
+                const int y = next(height - h);
+                m_rects[i] = vcl::graphitems::Rect_i(x, x + w, y, y + h);
+                m_rects_speeds[i] = { 1 + next(12), 1 + next(12) };
+
+                m_lines[i] = vcl::graphitems::Line_i(next(width), next(height), next(width), next(height));
+                m_lines_speeds[i] = { 1 + next(8) - 4, 1 + next(8) - 4 };
+
+                m_colors[i] = vcl::utils::RGBColor((unsigned char)next(256), (unsigned char)next(256), (unsigned char)next(256));
+            }
+        }
+
+        /** \brief Processes one frame, recording the latency of each stage. */
+        void process_frame(std::array<vcl::utils::LatencyHistogram, STAGES_COUNT>& latencies)
+        {
+            vcl::utils::PerfMeter frame_perf;
+            vcl::utils::TraceScope frame_scope("frame", m_tc, "pipeline");
+
+            vcl::utils::PerfMeter perf;
+            {
+                vcl::utils::TraceScope scope("generate", "pipeline");
+                prvt_generate();
+            }
+            latencies[STAGE_GENERATE].record(perf);
+
+            perf.start();
+            {
+                vcl::utils::TraceScope scope("overlays", "pipeline");
+                prvt_overlays();
+            }
+            latencies[STAGE_OVERLAYS].record(perf);
+
+            perf.start();
+            {
+                vcl::utils::TraceScope scope("timecode", "pipeline");
+                prvt_timecode();
+            }
+            latencies[STAGE_TIMECODE].record(perf);
+
+            perf.start();
+            {
+                vcl::utils::TraceScope scope("analyze", "pipeline");
+                prvt_analyze();
+            }
+            latencies[STAGE_ANALYZE].record(perf);
+
+            latencies[STAGE_FRAME].record(frame_perf);
+            ++m_frame_index;
+        }
+
+        /** \brief Returns the checksum of the analyzed frames, so that no stage can be optimized out. */
+        inline const unsigned long long checksum() const noexcept
+        {
+            return m_checksum;
+        }
+
+
+    private:
+        cv::Mat m_frame;
+        vcl::utils::Timecode25fps m_tc;
+        double m_scale;
+        unsigned long long m_frame_index = 0;
+        unsigned long long m_checksum = 0;
+
+        std::array<vcl::graphitems::Rect_i, OVERLAYS_COUNT> m_rects;
+        std::array<std::array<int, 2>, OVERLAYS_COUNT> m_rects_speeds;
+        std::array<vcl::graphitems::Line_i, OVERLAYS_COUNT> m_lines;
+        std::array<std::array<int, 2>, OVERLAYS_COUNT> m_lines_speeds;
+        std::array<vcl::utils::RGBColor, OVERLAYS_COUNT> m_colors;
+
+        /** \brief Fills the frame with a moving color gradient. */
+        void prvt_generate() noexcept
+        {
+            const unsigned int shift = unsigned(m_frame_index * 3);
+            for (int y = 0; y < m_frame.rows; ++y) {
+                unsigned char* p = m_frame.ptr<unsigned char>(y);
+                const unsigned char g = (unsigned char)((y >> 2) + shift);
+                for (int x = 0; x < m_frame.cols; ++x) {
+                    *p++ = (unsigned char)((x >> 3) + shift);
+                    *p++ = g;
+                    *p++ = (unsigned char)((x ^ y) >> 4);
+                }
+            }
+        }
+
+        /** \brief Moves then draws the rectangles and lines overlays, rectangles bouncing on frame borders. */
+        void prvt_overlays()
+        {
+            const int thickness = std::max(1, int(2 * m_scale));
+
+            for (int i = 0; i < OVERLAYS_COUNT; ++i) {
+                vcl::graphitems::Rect_i& r = m_rects[i];
+                std::array<int, 2>& speed = m_rects_speeds[i];
+                if (r.x + speed[0] < 0 || r.x + r.width + speed[0] >= m_frame.cols)
+                    speed[0] = -speed[0];
+                if (r.y + speed[1] < 0 || r.y + r.height + speed[1] >= m_frame.rows)
+                    speed[1] = -speed[1];
+                r.move(speed[0], speed[1]);
+                r.draw(m_frame, m_colors[i], thickness);
+
+                vcl::graphitems::Line_i& l = m_lines[i];
+                l.move(m_lines_speeds[i][0], m_lines_speeds[i][1]);
+                if (l.start.x() < 0 || l.start.x() >= m_frame.cols || l.start.y() < 0 || l.start.y() >= m_frame.rows) {
+                    m_lines_speeds[i][0] = -m_lines_speeds[i][0];
+                    m_lines_speeds[i][1] = -m_lines_speeds[i][1];
+                }
+                l.draw(m_frame, m_colors[OVERLAYS_COUNT - 1 - i], thickness);
+            }
+        }
+
+        /** \brief Stamps the advancing timecode in the top-left corner of the frame. */
+        void prvt_timecode()
+        {
+            ++m_tc;
+            char text[vcl::utils::Timecode25fps::TC_CHARS_SIZE];
+            m_tc.to_chars(text);
+            cv::putText(m_frame, text, cv::Point(int(40 * m_scale), int(80 * m_scale)),
+                        cv::FONT_HERSHEY_SIMPLEX, 2.0 * m_scale, cv::Scalar(255, 255, 255), std::max(1, int(3 * m_scale)));
+        }
+
+        /** \brief Reads the whole frame back, as an encoder would do. */
+        void prvt_analyze() noexcept
+        {
+            unsigned long long sum = 0;
+            for (int y = 0; y < m_frame.rows; ++y) {
+                const unsigned char* p = m_frame.ptr<unsigned char>(y);
+                for (int x = 0; x < 3 * m_frame.cols; ++x)
+                    sum += p[x];
+            }
+            m_checksum += sum;
+        }
+    };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief Runs frames_count frames at resolution width x height, shared among threads_count threads. */
+    PipelineResult run_pipeline(const std::string& resolution, const int width, const int height,
+                                const unsigned int threads_count, const unsigned long long frames_count)
+    {
+        std::vector<std::array<vcl::utils::LatencyHistogram, STAGES_COUNT>> latencies(threads_count);
+        std::vector<unsigned long long> checksums(threads_count, 0);
+        std::vector<std::thread> workers;
+
+        reset_peak_rss();
+        vcl::utils::PerfMeter perf;
+        for (unsigned int t = 0; t < threads_count; ++t)
+            workers.emplace_back([&, t]() {
+                SyntheticPipeline pipeline(width, height, t + 1);
+                const unsigned long long first = frames_count * t / threads_count;
+                const unsigned long long last = frames_count * (t + 1) / threads_count;
+                for (unsigned long long f = first; f < last; ++f)
+                    pipeline.process_frame(latencies[t]);
+                checksums[t] = pipeline.checksum();
+            });
+        for (auto& w : workers)
+            w.join();
+        const double elapsed_s = perf.get_elapsed_s();
+
+        PipelineResult result{ resolution, width, height, threads_count, frames_count, elapsed_s,
+                               double(frames_count) / elapsed_s, peak_rss_mb(), {} };
+        for (unsigned int t = 0; t < threads_count; ++t)
+            for (int s = 0; s < STAGES_COUNT; ++s)
+                result.latencies[s] += latencies[t][s];
+
+        unsigned long long checksum = 0;
+        for (const unsigned long long c : checksums)
+            checksum += c;
+        do_not_optimize(checksum);
+
+        return result;
+    }
+
+
+    //-----------------------------------------------------------------------
+    /** \brief Returns the results as a JSON document. */
+    std::string to_json(const std::vector<PipelineResult>& results)
+    {
+        std::string txt = "{\n  \"context\": {\n";
+        txt += std::format("    \"date\": \"{}\",\n", BenchRunner::date_utc());
+        txt += std::format("    \"compiler\": \"{}\",\n", BenchRunner::compiler_name());
+#if defined(VCL_GIT_COMMIT)
+        txt += std::format("    \"commit\": \"{}\",\n", VCL_GIT_COMMIT);
+#endif
+        txt += std::format("    \"hardware_threads\": {}\n  }},\n  \"runs\": [", std::thread::hardware_concurrency());
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const PipelineResult& r = results[i];
+            txt += std::format("{}\n    {{\"resolution\": \"{}\", \"width\": {}, \"height\": {}, \"threads\": {}, \"frames\": {}, "
+                               "\"elapsed_s\": {:.4f}, \"fps\": {:.2f}, \"peak_rss_mb\": {:.1f}, \"stages\": {{",
+                               i == 0 ? "" : ",", r.resolution, r.width, r.height, r.threads_count, r.frames_count,
+                               r.elapsed_s, r.fps, r.peak_rss_mb);
+            for (int s = 0; s < STAGES_COUNT; ++s) {
+                const vcl::utils::LatencyHistogram& h = r.latencies[s];
+                txt += std::format("{}\n      \"{}\": {{\"p50_us\": {:.3f}, \"p90_us\": {:.3f}, \"p99_us\": {:.3f}, \"p999_us\": {:.3f}, \"max_us\": {:.3f}, \"mean_us\": {:.3f}}}",
+                                   s == 0 ? "" : ",", STAGES_NAMES[s],
+                                   h.p50() * 1e-3, h.p90() * 1e-3, h.p99() * 1e-3, h.p999() * 1e-3, h.max() * 1e-3, h.mean() * 1e-3);
+            }
+            txt += "\n    }}";
+        }
+        txt += "\n  ]\n}\n";
+        return txt;
+    }
+
+}
+
+
+//===========================================================================
+/** \brief main for the end-to-end synthetic video pipeline macro-benchmark.
+* Usage: vcl_pipeline_bench [--frames=<count>] [--resolutions=1080p,4k] [--threads=1,4,N] [--json=<path>] [--trace=<path>]
+* 'N' stands for the count of hardware threads.
+*/
+int main(int argc, char** argv)
+{
+    // builds with -DVCL_ALLOC_TRACKING=ON: checks that frame loops do not allocate
+    if constexpr (vcl::utils::ALLOC_TRACKING_ENABLED)
+        vcl::utils::AllocationTracker::report_at_exit();
+
+    unsigned long long frames_count = 600;
+    std::string resolutions = "1080p,4k";
+    std::string threads_list = "1,4,N";
+    std::string json_path;
+    std::string trace_path;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg.starts_with("--frames="))
+            frames_count = std::max(1ull, std::stoull(std::string(arg.substr(9))));
+        else if (arg.starts_with("--resolutions="))
+            resolutions = arg.substr(14);
+        else if (arg.starts_with("--threads="))
+            threads_list = arg.substr(10);
+        else if (arg.starts_with("--json="))
+            json_path = arg.substr(7);
+        else if (arg.starts_with("--trace="))
+            trace_path = arg.substr(8);
+        else
+            std::cerr << "unknown option " << arg << " ignored\n";
+    }
+
+    auto split = [](const std::string& text) {
+        std::vector<std::string> items;
+        std::size_t start = 0;
+        for (std::size_t comma = text.find(','); ; comma = text.find(',', start)) {
+            items.push_back(text.substr(start, comma - start));
+            if (comma == std::string::npos)
+                break;
+            start = comma + 1;
+        }
+        return items;
+    };
+
+    if (!trace_path.empty() && !vcl::utils::TraceSink::start(trace_path))
+        std::cerr << "cannot create trace file " << trace_path << '\n';
+
+    std::cout << ">>>>>>>>>>   PIPELINE BENCHMARK STARTED   <<<<<<<<<<\n\n";
+    std::cout << std::format("{:<6s} {:>8s} {:>8s} {:>10s} {:>12s} {:>12s} {:>12s} {:>12s} {:>10s}\n",
+                             "res.", "threads", "frames", "fps", "p50 ms", "p99 ms", "p99.9 ms", "max ms", "RSS MB");
+
+    std::vector<vcl::bench::PipelineResult> results;
+    for (const std::string& res : split(resolutions)) {
+        int width, height;
+        if (res == "1080p")
+            width = 1920, height = 1080;
+        else if (res == "4k")
+            width = 3840, height = 2160;
+        else {
+            std::cerr << "unknown resolution " << res << " ignored\n";
+            continue;
+        }
+
+        for (const std::string& th : split(threads_list)) {
+            const unsigned int threads_count = (th == "N") ? std::max(1u, std::thread::hardware_concurrency())
+                                                           : unsigned(std::max(1, std::stoi(th)));
+            results.push_back(vcl::bench::run_pipeline(res, width, height, threads_count, frames_count));
+
+            const vcl::bench::PipelineResult& r = results.back();
+            const vcl::utils::LatencyHistogram& h = r.latencies[vcl::bench::STAGE_FRAME];
+            std::cout << std::format("{:<6s} {:>8d} {:>8d} {:>10.1f} {:>12.3f} {:>12.3f} {:>12.3f} {:>12.3f} {:>10.1f}\n",
+                                     r.resolution, r.threads_count, r.frames_count, r.fps,
+                                     h.p50() * 1e-6, h.p99() * 1e-6, h.p999() * 1e-6, h.max() * 1e-6, r.peak_rss_mb);
+            for (int s = 0; s < vcl::bench::STAGE_FRAME; ++s)
+                std::cout << std::format("       {:<10s} {}\n", vcl::bench::STAGES_NAMES[s], r.latencies[s].report());
+        }
+    }
+
+    if (vcl::utils::TraceSink::is_running())
+        vcl::utils::TraceSink::stop();
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        out << vcl::bench::to_json(results);
+        if (!out)
+            return 1;
+    }
+
+    std::cout << "\n>>>>>>>>>>   PIPELINE BENCHMARK DONE   <<<<<<<<<<\n\n";
+    return 0;
+}
@@ -0,0 +1,271 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#endif
+
+import utils.perfmeters;
+
+
+//===========================================================================
+namespace vcl::bench {
+
+    //-----------------------------------------------------------------------
+    /** \brief Prevents the compiler from optimizing out the computation of value. */
+    template<typename T>
+    inline void do_not_optimize(T& value) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+        (void)*sink;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : "+m"(value) : : "memory");
+#endif
+    }
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The statistics of one benchmark, times are nanoseconds per operation. */
+    struct BenchResult
+    {
+        std::string name;
+        std::size_t repetitions;
+        std::size_t iterations;   //!< the count of calls per repetition.
+        std::size_t ops_per_call;
+        double median_ns;
+        double mad_ns;            //!< the median absolute deviation.
+        double mean_ns;
+        double stddev_ns;
+        double min_ns;
+        double max_ns;
+    };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The runner of micro-benchmarks.
+    *
+    * Every benchmark is warmed up, then its count of iterations is
+    * calibrated so that each repetition lasts at least min_time_ms/reps.
+    * Robust statistics - median and median absolute deviation - are
+    * computed over the repetitions.
+    *
+    * Command line options:
+    *   --filter=<text>     runs only the benchmarks whose names contain text
+    *   --reps=<count>      the count of repetitions, default 15
+    *   --min-time-ms=<ms>  the min total measured time per benchmark, default 150
+    *   --json=<path>       writes the results as JSON in file path
+    */
+    class BenchRunner
+    {
+    public:
+        /** \brief Constructor, parses command line options. */
+        BenchRunner(const int argc, char** argv)
+        {
+            for (int i = 1; i < argc; ++i) {
+                const std::string_view arg(argv[i]);
+                if (arg.starts_with("--filter="))
+                    m_filter = arg.substr(9);
+                else if (arg.starts_with("--reps="))
+                    m_reps = std::max<std::size_t>(3, std::stoul(std::string(arg.substr(7))));
+                else if (arg.starts_with("--min-time-ms="))
+                    m_min_time_ms = std::max(1.0, std::stod(std::string(arg.substr(14))));
+                else if (arg.starts_with("--json="))
+                    m_json_path = arg.substr(7);
+                else
+                    std::cerr << "unknown option " << arg << " ignored\n";
+            }
+        }
+
+        /** \brief Runs benchmark name, fn() processing ops_per_call operations per call. */
+        template<typename Fn>
+        void run(const std::string& name, Fn&& fn, const std::size_t ops_per_call = 1)
+        {
+            if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+                return;
+
+            // warm-up - e.g. lazy initializations - then calibration
+            fn();
+            constexpr std::size_t MAX_ITERATIONS = std::size_t(1) << 40;
+            const double rep_min_ns = m_min_time_ms * 1e6 / double(m_reps);
+            std::size_t iterations = 1;
+            for (;;) {
+                const double elapsed_ns = prvt_measure(fn, iterations);
+                if (elapsed_ns >= rep_min_ns || iterations >= MAX_ITERATIONS)
+                    break;
+                const double factor = elapsed_ns > 0.0 ? std::clamp(1.5 * rep_min_ns / elapsed_ns, 2.0, 100.0) : 100.0;
+                iterations = std::min(MAX_ITERATIONS, std::size_t(double(iterations) * factor));
+            }
+
+            // measures
+            std::vector<double> samples(m_reps);
+            for (double& s : samples)
+                s = prvt_measure(fn, iterations) / double(iterations * ops_per_call);
+
+            std::vector<double> sorted(samples);
+            std::sort(sorted.begin(), sorted.end());
+            const double median = prvt_median(sorted);
+
+            std::vector<double> deviations(m_reps);
+            for (std::size_t i = 0; i < m_reps; ++i)
+                deviations[i] = std::abs(sorted[i] - median);
+            std::sort(deviations.begin(), deviations.end());
+
+            double mean = 0.0;
+            for (const double s : samples)
+                mean += s;
+            mean /= double(m_reps);
+            double variance = 0.0;
+            for (const double s : samples)
+                variance += (s - mean) * (s - mean);
+            variance /= double(m_reps - 1);
+
+            m_results.push_back(BenchResult{ name, m_reps, iterations, ops_per_call,
+                                             median, prvt_median(deviations), mean, std::sqrt(variance),
+                                             sorted.front(), sorted.back() });
+            const BenchResult& r = m_results.back();
+            std::cout << std::format("{:<44s} {:>12.3f} ns/op  +/- {:>8.3f}  (min {:.3f}, max {:.3f}, {} x {})\n",
+                                     r.name, r.median_ns, r.mad_ns, r.min_ns, r.max_ns, r.repetitions, r.iterations);
+        }
+
+        /** \brief Returns the results of the benchmarks run up to now. */
+        inline const std::vector<BenchResult>& results() const noexcept
+        {
+            return m_results;
+        }
+
+        /** \brief Prints the throughputs of the benchmarks whose names start with prefix, in millions of operations per second.
+        * unit names these millions of operations per second, e.g. "Mpix/s".
+        */
+        void report_throughput(const std::string_view prefix, const std::string_view unit) const
+        {
+            for (const BenchResult& r : m_results)
+                if (r.name.starts_with(prefix))
+                    std::cout << std::format("{:<44s} {:>12.1f} {}\n", r.name, 1e3 / r.median_ns, unit);
+        }
+
+        /** \brief Returns the results as a JSON document. */
+        std::string to_json() const
+        {
+            std::string txt = "{\n  \"context\": {\n";
+            txt += std::format("    \"date\": \"{}\",\n", date_utc());
+            txt += std::format("    \"compiler\": \"{}\",\n", compiler_name());
+#if defined(NDEBUG)
+            txt += "    \"build_type\": \"release\",\n";
+#else
+            txt += "    \"build_type\": \"debug\",\n";
+#endif
+#if defined(VCL_GIT_COMMIT)
+            txt += std::format("    \"commit\": \"{}\",\n", VCL_GIT_COMMIT);
+#endif
+            txt += std::format("    \"repetitions\": {},\n    \"min_time_ms\": {}\n  }},\n  \"benchmarks\": [", m_reps, m_min_time_ms);
+
+            for (std::size_t i = 0; i < m_results.size(); ++i) {
+                const BenchResult& r = m_results[i];
+                txt += std::format("{}\n    {{\"name\": \"{}\", \"repetitions\": {}, \"iterations\": {}, \"ops_per_call\": {}, "
+                                   "\"median_ns\": {:.4f}, \"mad_ns\": {:.4f}, \"mean_ns\": {:.4f}, \"stddev_ns\": {:.4f}, "
+                                   "\"min_ns\": {:.4f}, \"max_ns\": {:.4f}}}",
+                                   i == 0 ? "" : ",", r.name, r.repetitions, r.iterations, r.ops_per_call,
+                                   r.median_ns, r.mad_ns, r.mean_ns, r.stddev_ns, r.min_ns, r.max_ns);
+            }
+            txt += "\n  ]\n}\n";
+            return txt;
+        }
+
+        /** \brief Writes the JSON results if requested on command line. Returns the program exit code. */
+        int finish() const
+        {
+            if (m_json_path.empty())
+                return 0;
+            std::ofstream out(m_json_path);
+            out << to_json();
+            return out ? 0 : 1;
+        }
+
+        /** \brief Returns the current UTC date and time, ISO 8601 formatted. */
+        static std::string date_utc()
+        {
+            const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            char buffer[32];
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+            return buffer;
+        }
+
+        /** \brief Returns the compiler name and version. */
+        static std::string compiler_name()
+        {
+#if defined(__clang__)
+            return std::format("clang {}.{}.{}", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+            return std::format("gcc {}.{}.{}", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+            return std::format("msvc {}", _MSC_FULL_VER);
+#else
+            return "unknown";
+#endif
+        }
+
+
+    private:
+        std::string m_filter;
+        std::string m_json_path;
+        std::size_t m_reps = 15;
+        double m_min_time_ms = 150.0;
+        std::vector<BenchResult> m_results;
+
+        /** \brief Returns the duration of iterations calls to fn(), in nanoseconds. */
+        template<typename Fn>
+        static inline double prvt_measure(Fn& fn, const std::size_t iterations)
+        {
+            vcl::utils::PerfMeter perf;
+            for (std::size_t i = 0; i < iterations; ++i)
+                fn();
+            return double(perf.get_elapsed_ns());
+        }
+
+        /** \brief Returns the median of sorted values. */
+        static inline double prvt_median(const std::vector<double>& sorted) noexcept
+        {
+            const std::size_t n = sorted.size();
+            return (n % 2 == 1) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+        }
+    };
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of the blending of premultiplied-alpha frames, against OpenCV cv::addWeighted(). */
+
+{
+    using vcl::bench::do_not_optimize;
+    using namespace vcl::frames;
+
+    constexpr std::size_t WIDTH = 1920, HEIGHT = 1080, PIXELS_COUNT = WIDTH * HEIGHT;
+
+    // a translucent overlay with opaque and transparent areas, as subtitles or graphics
+    Frame_bgra32 overlay(WIDTH, HEIGHT), opaque(WIDTH, HEIGHT), background(WIDTH, HEIGHT), composited(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x) {
+            const std::uint8_t a = row < HEIGHT / 3 ? 0 : row < 2 * HEIGHT / 3 ? std::uint8_t(x ^ row) : 255;
+            overlay.row(row)[x] = BGRA32::rgba(std::uint8_t(x * a / 255), std::uint8_t(row * a / 255), 0, a);
+            background.row(row)[x] = BGRA32::rgb(std::uint8_t(x), std::uint8_t(row), std::uint8_t(x ^ row));
+        }
+    opaque.fill(BGRA32::rgb(16, 128, 235));
+    FrameT<RGBA64> overlay64(WIDTH, HEIGHT), composited64(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x) {
+            const std::uint16_t a = std::uint16_t((x ^ row) * 64);
+            overlay64.row(row)[x] = RGBA64::rgba(std::uint16_t(x * 34 * a / 65535), std::uint16_t(row * 60 * a / 65535), 0, a);
+        }
+    background.copy_to(composited);
+
+    FrameWorkers workers(vcl::utils::NumaTopology::system(), std::max(1u, std::thread::hardware_concurrency()));
+    runner.run("blend/1080p/over", [&]() { blend(overlay, composited); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/over/scalar", [&]() { blend_scalar(overlay, composited); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/over/workers", [&]() { blend(overlay, composited, BLEND_OVER, &workers); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/over/opaque", [&]() { blend(opaque, composited); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/add", [&]() { blend(overlay, composited, BLEND_ADD); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/multiply", [&]() { blend(overlay, composited, BLEND_MULTIPLY); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/multiply/scalar", [&]() { blend_scalar(overlay, composited, BLEND_MULTIPLY); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/screen", [&]() { blend(overlay, composited, BLEND_SCREEN); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/over/rgba64", [&]() { blend(overlay64, composited64); do_not_optimize(composited64); }, PIXELS_COUNT);
+    runner.run("blend/1080p/premultiply", [&]() { premultiply(background, composited); do_not_optimize(composited); }, PIXELS_COUNT);
+    runner.run("blend/1080p/unpremultiply", [&]() { unpremultiply(overlay, composited); do_not_optimize(composited); }, PIXELS_COUNT);
+
+    // OpenCV blends with a constant alpha only
+    cv::Mat cv_overlay(int(HEIGHT), int(WIDTH), CV_8UC4, overlay.row(0), overlay.stride());
+    cv::Mat cv_background(int(HEIGHT), int(WIDTH), CV_8UC4, background.row(0), background.stride());
+    cv::Mat cv_composited;
+    runner.run("blend/1080p/opencv_add_weighted", [&]() { cv::addWeighted(cv_overlay, 0.5, cv_background, 0.5, 0.0, cv_composited); do_not_optimize(cv_composited); },
+               PIXELS_COUNT);
+
+    runner.report_throughput("blend/", "Mpix/s");
+}
@@ -0,0 +1,71 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of the chroma resampling of YUV frames, against OpenCV cv::resize() of chroma planes. */
+
+{
+    using vcl::bench::do_not_optimize;
+    using namespace vcl::frames;
+
+    constexpr std::size_t WIDTH = 1920, HEIGHT = 1080, PIXELS_COUNT = WIDTH * HEIGHT;
+    YuvFrame_i420 i420(WIDTH, HEIGHT);
+    YuvFrame_nv12 nv12(WIDTH, HEIGHT);
+    YuvFrame_422 yuv422(WIDTH, HEIGHT);
+    YuvFrame_444 yuv444(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x) {
+            yuv444.y()(x, row) = std::uint8_t(x + row);
+            yuv444.cb()(x, row) = std::uint8_t(x);
+            yuv444.cr()(x, row) = std::uint8_t(x ^ row);
+        }
+    resample_chroma(yuv444, i420);
+    resample_chroma(yuv444, yuv422);
+
+    FrameWorkers workers(vcl::utils::NumaTopology::system(), std::max(1u, std::thread::hardware_concurrency()));
+    const ChromaResampling nearest{ CHROMA_NEAREST };
+    runner.run("chroma/1080p/i420_to_444", [&]() { resample_chroma(i420, yuv444); do_not_optimize(yuv444); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/i420_to_444/nearest", [&]() { resample_chroma(i420, yuv444, nearest); do_not_optimize(yuv444); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/i420_to_444/scalar", [&]() { resample_chroma_scalar(i420, yuv444); do_not_optimize(yuv444); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/i420_to_444/workers", [&]() { resample_chroma(i420, yuv444, ChromaResampling(), &workers); do_not_optimize(yuv444); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/444_to_nv12", [&]() { resample_chroma(yuv444, nv12); do_not_optimize(nv12); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/444_to_nv12/scalar", [&]() { resample_chroma_scalar(yuv444, nv12); do_not_optimize(nv12); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/444_to_nv12/workers", [&]() { resample_chroma(yuv444, nv12, ChromaResampling(), &workers); do_not_optimize(nv12); }, PIXELS_COUNT);
+    runner.run("chroma/1080p/422_to_i420", [&]() { resample_chroma(yuv422, i420); do_not_optimize(i420); }, PIXELS_COUNT);
+
+    // OpenCV resizes each chroma plane, luma being left apart
+    cv::Mat cv_cb(int(HEIGHT / 2), int(WIDTH / 2), CV_8UC1, i420.cb().row(0), i420.cb().stride());
+    cv::Mat cv_cr(int(HEIGHT / 2), int(WIDTH / 2), CV_8UC1, i420.cr().row(0), i420.cr().stride());
+    cv::Mat cv_cb_444, cv_cr_444;
+    runner.run("chroma/1080p/i420_to_444/opencv", [&]() {
+        cv::resize(cv_cb, cv_cb_444, cv::Size(int(WIDTH), int(HEIGHT)), 0.0, 0.0, cv::INTER_LINEAR);
+        cv::resize(cv_cr, cv_cr_444, cv::Size(int(WIDTH), int(HEIGHT)), 0.0, 0.0, cv::INTER_LINEAR);
+        do_not_optimize(cv_cb_444);
+        do_not_optimize(cv_cr_444);
+    }, PIXELS_COUNT);
+
+    runner.report_throughput("chroma/", "Mpix/s");
+}
@@ -0,0 +1,55 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of RGB <-> YUV conversions, against OpenCV cv::cvtColor(). */
+
+{
+    using vcl::bench::do_not_optimize;
+    using namespace vcl::frames;
+
+    constexpr std::size_t WIDTH = 1920, HEIGHT = 1080, PIXELS_COUNT = WIDTH * HEIGHT;
+    Frame_bgr24 bgr(WIDTH, HEIGHT), back(WIDTH, HEIGHT);
+    Frame_b y(WIDTH, HEIGHT), u(WIDTH, HEIGHT), v(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x)
+            bgr.row(row)[x] = BGR24::rgb(std::uint8_t(x), std::uint8_t(row), std::uint8_t(x ^ row));
+
+    FrameWorkers workers(vcl::utils::NumaTopology::system(), std::max(1u, std::thread::hardware_concurrency()));
+    const ColorSpec spec{ MATRIX_BT601, RANGE_FULL };  // the same as OpenCV
+    runner.run("color/1080p/bgr_to_yuv444", [&]() { rgb_to_yuv444(bgr, y, u, v, spec); do_not_optimize(y); }, PIXELS_COUNT);
+    runner.run("color/1080p/bgr_to_yuv444/workers", [&]() { rgb_to_yuv444(bgr, y, u, v, spec, &workers); do_not_optimize(y); }, PIXELS_COUNT);
+    runner.run("color/1080p/yuv444_to_bgr", [&]() { yuv444_to_rgb(y, u, v, back, spec); do_not_optimize(back); }, PIXELS_COUNT);
+    runner.run("color/1080p/yuv444_to_bgr/workers", [&]() { yuv444_to_rgb(y, u, v, back, spec, &workers); do_not_optimize(back); }, PIXELS_COUNT);
+
+    // OpenCV converts to interleaved YUV, its own fixed-point BT.601 full range
+    cv::Mat cv_bgr(int(HEIGHT), int(WIDTH), CV_8UC3, bgr.row(0), bgr.stride());
+    cv::Mat cv_yuv, cv_back;
+    runner.run("color/1080p/bgr_to_yuv/opencv", [&]() { cv::cvtColor(cv_bgr, cv_yuv, cv::COLOR_BGR2YUV); do_not_optimize(cv_yuv); }, PIXELS_COUNT);
+    runner.run("color/1080p/yuv_to_bgr/opencv", [&]() { cv::cvtColor(cv_yuv, cv_back, cv::COLOR_YUV2BGR); do_not_optimize(cv_back); }, PIXELS_COUNT);
+
+    runner.report_throughput("color/", "Mpix/s");
+}
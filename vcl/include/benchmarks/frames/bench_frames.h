@@ -0,0 +1,70 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of frames backed by default or by huge pages. */
+
+{
+    using vcl::bench::do_not_optimize;
+
+    // full-frame passes, rows then columns - columns being the worst case for TLB misses
+    constexpr const char* BACKINGS_LABELS[vcl::frames::BACKINGS_COUNT] = { "default_pages", "thp", "hugetlb" };
+    struct FrameSize { const char* name; std::size_t width; std::size_t height; };
+    for (const FrameSize size : { FrameSize{ "4K", 3840, 2160 }, FrameSize{ "8K", 7680, 4320 } }) {
+        bool measured[vcl::frames::BACKINGS_COUNT] = { false, false, false };
+        for (const vcl::frames::HugePagesMode mode : { vcl::frames::HUGE_PAGES_OFF, vcl::frames::HUGE_PAGES_TRANSPARENT, vcl::frames::HUGE_PAGES_EXPLICIT }) {
+            vcl::frames::FrameBuffersPool pool;
+            pool.huge_pages(mode);
+            vcl::frames::Frame_b frame(size.width, size.height, pool);
+            frame.fill(1);  // touches pages
+
+            const vcl::frames::FrameMemoryBacking backing = frame.memory_backing();
+            if (measured[backing])
+                continue;  // huge pages not available, fell back to an already measured backing
+            measured[backing] = true;
+
+            const std::string prefix = std::format("frames/{}/{}/", size.name, BACKINGS_LABELS[backing]);
+            const std::size_t pixels_count = size.width * size.height;
+            runner.run(prefix + "rows_sum", [&]() {
+                unsigned long long sum = 0;
+                for (std::size_t y = 0; y < frame.height(); ++y) {
+                    const std::uint8_t* row = frame.row(y);
+                    for (std::size_t x = 0; x < frame.width(); ++x)
+                        sum += row[x];
+                }
+                do_not_optimize(sum);
+            }, pixels_count);
+            runner.run(prefix + "columns_sum", [&]() {
+                unsigned long long sum = 0;
+                for (std::size_t x = 0; x < frame.width(); ++x)
+                    for (std::size_t y = 0; y < frame.height(); ++y)
+                        sum += frame(x, y);
+                do_not_optimize(sum);
+            }, pixels_count);
+            runner.run(prefix + "fill", [&]() { frame.fill(std::uint8_t(7)); do_not_optimize(frame); }, pixels_count);
+        }
+    }
+}
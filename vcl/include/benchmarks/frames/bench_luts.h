@@ -0,0 +1,77 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of 1D, 3D and compile-time LUTs, against OpenCV cv::LUT() for 1D ones. */
+
+{
+    using vcl::bench::do_not_optimize;
+    using namespace vcl::frames;
+
+    constexpr std::size_t WIDTH = 1920, HEIGHT = 1080, PIXELS_COUNT = WIDTH * HEIGHT;
+    Frame_bgr24 bgr(WIDTH, HEIGHT), mapped(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x)
+            bgr.row(row)[x] = BGR24::rgb(std::uint8_t(x), std::uint8_t(row), std::uint8_t(x ^ row));
+    FrameT<RGB48> rgb48(WIDTH, HEIGHT), mapped48(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x)
+            rgb48.row(row)[x] = RGB48::rgb(std::uint16_t(x * 34), std::uint16_t(row * 60), std::uint16_t((x ^ row) * 32));
+
+    // a 33^3 grading cube, contrast and channels crosstalk
+    Lut3D cube(33);
+    for (std::size_t b = 0; b < 33; ++b)
+        for (std::size_t g = 0; g < 33; ++g)
+            for (std::size_t r = 0; r < 33; ++r) {
+                const float fr = r / 32.0f, fg = g / 32.0f, fb = b / 32.0f;
+                auto s_curve = [](const float v) { return v * v * (3.0f - 2.0f * v); };
+                cube.set(r, g, b, s_curve(0.8f * fr + 0.2f * fg), s_curve(0.1f * fr + 0.8f * fg + 0.1f * fb), s_curve(0.2f * fg + 0.8f * fb));
+            }
+    Lut1D curves(1024);
+    for (std::size_t i = 0; i < 1024; ++i)
+        curves.set(i, i / 1023.0f * 0.9f, 1.0f - i / 1023.0f, (i / 1023.0f) * (i / 1023.0f));
+
+    FrameWorkers workers(vcl::utils::NumaTopology::system(), std::max(1u, std::thread::hardware_concurrency()));
+    runner.run("lut/1080p/3d_tetrahedral", [&]() { apply_lut(cube, bgr, mapped, LUT_TETRAHEDRAL); do_not_optimize(mapped); }, PIXELS_COUNT);
+    runner.run("lut/1080p/3d_tetrahedral/scalar", [&]() { apply_lut_scalar(cube, bgr, mapped, LUT_TETRAHEDRAL); do_not_optimize(mapped); }, PIXELS_COUNT);
+    runner.run("lut/1080p/3d_tetrahedral/workers", [&]() { apply_lut(cube, bgr, mapped, LUT_TETRAHEDRAL, &workers); do_not_optimize(mapped); }, PIXELS_COUNT);
+    runner.run("lut/1080p/3d_trilinear", [&]() { apply_lut(cube, bgr, mapped, LUT_TRILINEAR); do_not_optimize(mapped); }, PIXELS_COUNT);
+    runner.run("lut/1080p/3d_trilinear/scalar", [&]() { apply_lut_scalar(cube, bgr, mapped, LUT_TRILINEAR); do_not_optimize(mapped); }, PIXELS_COUNT);
+    runner.run("lut/1080p/3d_tetrahedral/rgb48", [&]() { apply_lut(cube, rgb48, mapped48, LUT_TETRAHEDRAL); do_not_optimize(mapped48); }, PIXELS_COUNT);
+    runner.run("lut/1080p/1d", [&]() { apply_lut(curves, bgr, mapped); do_not_optimize(mapped); }, PIXELS_COUNT);
+    runner.run("lut/1080p/1d/rgb48", [&]() { apply_lut(curves, rgb48, mapped48); do_not_optimize(mapped48); }, PIXELS_COUNT);
+    runner.run("lut/1080p/srgb_to_linear", [&]() { apply_transfer<TRANSFER_SRGB_TO_LINEAR>(bgr, mapped); do_not_optimize(mapped); }, PIXELS_COUNT);
+
+    // OpenCV maps 8-bits channels through one table per channel
+    cv::Mat cv_bgr(int(HEIGHT), int(WIDTH), CV_8UC3, bgr.row(0), bgr.stride());
+    cv::Mat cv_table(1, 256, CV_8UC3), cv_mapped;
+    for (int i = 0; i < 256; ++i)
+        cv_table.at<cv::Vec3b>(0, i) = cv::Vec3b(transfer_lut<TRANSFER_SRGB_TO_LINEAR, 8>[i], transfer_lut<TRANSFER_SRGB_TO_LINEAR, 8>[i],
+                                                  transfer_lut<TRANSFER_SRGB_TO_LINEAR, 8>[i]);
+    runner.run("lut/1080p/srgb_to_linear/opencv", [&]() { cv::LUT(cv_bgr, cv_table, cv_mapped); do_not_optimize(cv_mapped); }, PIXELS_COUNT);
+
+    runner.report_throughput("lut/", "Mpix/s");
+}
@@ -0,0 +1,63 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of planar and semi-planar YUV frames conversions, against OpenCV cv::cvtColor(). */
+
+{
+    using vcl::bench::do_not_optimize;
+    using namespace vcl::frames;
+
+    constexpr std::size_t WIDTH = 1920, HEIGHT = 1080, PIXELS_COUNT = WIDTH * HEIGHT;
+    Frame_bgr24 bgr(WIDTH, HEIGHT), back(WIDTH, HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row)
+        for (std::size_t x = 0; x < WIDTH; ++x)
+            bgr.row(row)[x] = BGR24::rgb(std::uint8_t(x), std::uint8_t(row), std::uint8_t(x ^ row));
+    YuvFrame_i420 i420(WIDTH, HEIGHT);
+    YuvFrame_nv12 nv12(WIDTH, HEIGHT);
+    YuvFrame_p010 p010(WIDTH, HEIGHT);
+
+    FrameWorkers workers(vcl::utils::NumaTopology::system(), std::max(1u, std::thread::hardware_concurrency()));
+    const ColorSpec spec{ MATRIX_BT601, RANGE_LIMITED };  // the same as OpenCV
+    runner.run("yuv/1080p/bgr_to_i420", [&]() { rgb_to_yuv(bgr, i420, spec); do_not_optimize(i420); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/bgr_to_nv12", [&]() { rgb_to_yuv(bgr, nv12, spec); do_not_optimize(nv12); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/bgr_to_nv12/workers", [&]() { rgb_to_yuv(bgr, nv12, spec, &workers); do_not_optimize(nv12); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/nv12_to_bgr", [&]() { yuv_to_rgb(nv12, back, spec); do_not_optimize(back); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/nv12_to_bgr/workers", [&]() { yuv_to_rgb(nv12, back, spec, &workers); do_not_optimize(back); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/i420_to_nv12", [&]() { convert_yuv(i420, nv12); do_not_optimize(nv12); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/nv12_to_i420", [&]() { convert_yuv(nv12, i420); do_not_optimize(i420); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/nv12_to_p010", [&]() { convert_yuv(nv12, p010); do_not_optimize(p010); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/p010_to_nv12", [&]() { convert_yuv(p010, nv12); do_not_optimize(nv12); }, PIXELS_COUNT);
+
+    // OpenCV converts into one contiguous I420 image, and from contiguous NV12 ones
+    cv::Mat cv_bgr(int(HEIGHT), int(WIDTH), CV_8UC3, bgr.row(0), bgr.stride());
+    cv::Mat cv_i420, cv_back;
+    cv::Mat cv_nv12(int(HEIGHT + HEIGHT / 2), int(WIDTH), CV_8UC1, cv::Scalar(128));
+    runner.run("yuv/1080p/bgr_to_i420/opencv", [&]() { cv::cvtColor(cv_bgr, cv_i420, cv::COLOR_BGR2YUV_I420); do_not_optimize(cv_i420); }, PIXELS_COUNT);
+    runner.run("yuv/1080p/nv12_to_bgr/opencv", [&]() { cv::cvtColor(cv_nv12, cv_back, cv::COLOR_YUV2BGR_NV12); do_not_optimize(cv_back); }, PIXELS_COUNT);
+
+    runner.report_throughput("yuv/", "Mpix/s");
+}
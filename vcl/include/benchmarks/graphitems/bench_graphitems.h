@@ -0,0 +1,53 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of classes vcl::graphitems::RectT and vcl::graphitems::LineT. */
+
+{
+    using vcl::bench::do_not_optimize;
+
+    // RectT operations
+    vcl::graphitems::Rect rect(10, 210, 20, 140);
+    const vcl::utils::OffsetsT<short> offsets(1, -1);
+    runner.run("graphitems/Rect/move", [&]() { rect.move(1, -1); rect.move(-1, 1); do_not_optimize(rect); }, 2);
+    runner.run("graphitems/Rect/add_offsets", [&]() { vcl::graphitems::Rect r = rect + offsets; do_not_optimize(r); });
+    runner.run("graphitems/Rect/center", [&]() { auto c = rect.center(); do_not_optimize(c); });
+    runner.run("graphitems/Rect/crop_resize", [&]() { rect.crop(2); rect.resize(4); do_not_optimize(rect); }, 2);
+    runner.run("graphitems/Rect/equals", [&]() { bool eq = (rect == vcl::graphitems::Rect(10, 210, 20, 140)); do_not_optimize(eq); });
+
+    vcl::graphitems::Rect_f rect_f(0.1, 0.9, 0.15, 0.25);
+    runner.run("graphitems/Rect_f/scale", [&]() { vcl::graphitems::Rect_f r = rect_f * 1.5; do_not_optimize(r); });
+
+    // LineT operations
+    vcl::graphitems::Line line(10, 20, 310, 420);
+    runner.run("graphitems/Line/length", [&]() { double l = line.length(); do_not_optimize(l); });
+    runner.run("graphitems/Line/move", [&]() { line.move(3, -3); line.move(-3, 3); do_not_optimize(line); }, 2);
+    runner.run("graphitems/Line/add_offsets", [&]() { vcl::graphitems::Line l = line + offsets; do_not_optimize(l); });
+
+    vcl::graphitems::Line_f line_f(0.0f, 0.0f, 30.0f, 40.0f);
+    runner.run("graphitems/Line_f/set_length", [&]() { line_f.set_length(50.0f); do_not_optimize(line_f); });
+}
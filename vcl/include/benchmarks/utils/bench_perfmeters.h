@@ -0,0 +1,43 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of the overhead of instrumentation classes from module utils. */
+
+{
+    using vcl::bench::do_not_optimize;
+
+    runner.run("perfmeters/PerfMeter/measure", [&]() { vcl::utils::PerfMeter p; long long ns = p.get_elapsed_ns(); do_not_optimize(ns); });
+    runner.run("perfmeters/TscPerfMeter/measure", [&]() { vcl::utils::TscPerfMeter p; long long t = p.get_elapsed_ticks(); do_not_optimize(t); });
+    runner.run("perfmeters/PerfMeter/now_ns", [&]() { long long ns = vcl::utils::PerfMeter::now_ns(); do_not_optimize(ns); });
+
+    vcl::utils::LatencyHistogram histogram;
+    unsigned long long value = 0;
+    runner.run("perfmeters/LatencyHistogram/record", [&]() { histogram.record(value += 7919); });
+
+    runner.run("perfmeters/ProfileZone/enter_leave", [&]() { vcl::utils::ProfileZone zone("bench"); });
+    runner.run("perfmeters/TraceScope/not_running", [&]() { vcl::utils::TraceScope scope("bench"); });
+}
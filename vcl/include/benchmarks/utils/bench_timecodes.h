@@ -0,0 +1,58 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of class vcl::utils::Timecode. */
+
+{
+    using vcl::bench::do_not_optimize;
+
+    // parsing and formatting
+    const std::string_view tc_text("01:23:45:12");
+    vcl::utils::Timecode25fps tc;
+    runner.run("timecodes/25fps/parse", [&]() { bool ok = vcl::utils::Timecode25fps::parse(tc_text, tc); do_not_optimize(ok); });
+    runner.run("timecodes/25fps/parse_ctor", [&]() { vcl::utils::Timecode25fps t(tc_text); do_not_optimize(t); });
+
+    char buffer[vcl::utils::Timecode25fps::TC_CHARS_SIZE];
+    runner.run("timecodes/25fps/to_chars", [&]() { tc.to_chars(buffer); do_not_optimize(buffer); });
+    runner.run("timecodes/25fps/to_string", [&]() { std::string s(tc); do_not_optimize(s); });
+
+    vcl::utils::Timecode29_97DF tc_df(1, 23, 45, 12);
+    runner.run("timecodes/29.97DF/to_chars", [&]() { tc_df.to_chars(buffer); do_not_optimize(buffer); });
+    runner.run("timecodes/29.97DF/components", [&]() { int h = tc_df.hh() + tc_df.mm() + tc_df.ss() + tc_df.ff(); do_not_optimize(h); });
+
+    // arithmetic and comparisons
+    vcl::utils::Timecode25fps tc_a(0, 0, 0, 0);
+    const vcl::utils::Timecode25fps tc_b(0, 0, 1, 3);
+    runner.run("timecodes/25fps/increment", [&]() { ++tc_a; do_not_optimize(tc_a); });
+    runner.run("timecodes/25fps/add_frames", [&]() { tc_a += 7; tc_a -= 6; do_not_optimize(tc_a); }, 2);
+    runner.run("timecodes/25fps/add_timecode", [&]() { vcl::utils::Timecode25fps t = tc_a + tc_b; do_not_optimize(t); });
+    runner.run("timecodes/25fps/compare", [&]() { bool lt = tc_a < tc_b; do_not_optimize(lt); });
+
+    const vcl::utils::Timecode30fps tc_30(0, 10, 0, 0);
+    runner.run("timecodes/30fps_to_29.97DF/convert", [&]() { vcl::utils::Timecode29_97DF t(tc_30); do_not_optimize(t); });
+    runner.run("timecodes/30fps_vs_25fps/compare", [&]() { bool lt = tc_30 < tc_a; do_not_optimize(lt); });
+}
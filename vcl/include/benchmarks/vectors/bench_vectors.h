@@ -0,0 +1,83 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief benchmarks of classes vcl::vect::VectorT and vcl::vect::ClipVectT. */
+
+{
+    using vcl::bench::do_not_optimize;
+
+    // VectorT arithmetic
+    vcl::vect::Vect2f v2f_a(1.5f, -2.25f), v2f_b(0.125f, 0.5f);
+    runner.run("vectors/Vect2f/add_assign", [&]() { v2f_a += v2f_b; do_not_optimize(v2f_a); });
+    runner.run("vectors/Vect2f/add", [&]() { vcl::vect::Vect2f r = v2f_a + v2f_b; do_not_optimize(r); });
+    runner.run("vectors/Vect2f/mul_scalar", [&]() { v2f_a *= 1.0001f; do_not_optimize(v2f_a); });
+
+    vcl::vect::Vect4f v4f_a(1.0f, 2.0f, 3.0f, 4.0f), v4f_b(0.5f, 0.25f, 0.125f, 1.0f);
+    runner.run("vectors/Vect4f/add_assign", [&]() { v4f_a += v4f_b; do_not_optimize(v4f_a); });
+    runner.run("vectors/Vect4f/add", [&]() { vcl::vect::Vect4f r = v4f_a + v4f_b; do_not_optimize(r); });
+    runner.run("vectors/Vect4f/equals", [&]() { bool eq = (v4f_a == v4f_b); do_not_optimize(eq); });
+
+    vcl::vect::Vect4 v4s_a(1, 2, 3, 4), v4s_b(5, -6, 7, -8);
+    runner.run("vectors/Vect4s/add_assign", [&]() { v4s_a += v4s_b; do_not_optimize(v4s_a); });
+
+    constexpr std::size_t N = 1024;
+    std::vector<vcl::vect::Vect4f> v4f_array(N, vcl::vect::Vect4f(1.0f, 2.0f, 3.0f, 4.0f));
+    runner.run("vectors/Vect4f/add_assign_x1024", [&]() {
+        for (auto& v : v4f_array)
+            v += v4f_b;
+        do_not_optimize(v4f_array[N - 1]);
+    }, N);
+
+    // ClipVectT clipping paths
+    int value = 0;
+    runner.run("vectors/ClipVect4b/construct_clipped", [&]() {
+        vcl::vect::ClipVect4b v(value++ & 511);
+        do_not_optimize(v);
+    });
+
+    vcl::vect::ClipVect4b cv4b;
+    runner.run("vectors/ClipVect4b/assign_clipped", [&]() { cv4b = (value++ & 511) - 128; do_not_optimize(cv4b); });
+    runner.run("vectors/ClipVect4b/setters_clipped", [&]() {
+        const int x = (value++ & 511) - 128;
+        cv4b.x(x); cv4b.y(x + 1); cv4b.z(x + 2); cv4b.w(x + 3);
+        do_not_optimize(cv4b);
+    });
+
+    vcl::vect::ClipVect2d cv2d(0.5);
+    double dvalue = 0.0;
+    runner.run("vectors/ClipVect2d/setters_clipped", [&]() {
+        dvalue += 0.01;
+        cv2d.x(dvalue); cv2d.y(-dvalue);
+        do_not_optimize(cv2d);
+    });
+
+    const vcl::vect::Vect4i v4i_src(-300, 20, 300, 120);
+    runner.run("vectors/ClipVect4b/copy_clipped", [&]() {
+        vcl::vect::ClipVect4b v(v4i_src);
+        do_not_optimize(v);
+    });
+}
@@ -0,0 +1,186 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on the blending of premultiplied-alpha frames, module frames.blending. */
+
+cout << "## frames.blending / vcl::frames::blend() testing application..." << endl;
+
+{
+    using namespace vcl::frames;
+    using vcl::graphitems::Rect_i;
+    using vcl::utils::Dims_ui;
+
+    static_assert(BlendPixel<RGBA32> && BlendPixel<BGRA32> && BlendPixel<RGBA64>);
+    static_assert(!BlendPixel<RGB24> && !BlendPixel<Gray8> && !BlendPixel<RGB30>);
+
+    // pseudo-random premultiplied frames, with opaque and transparent runs, odd widths for the scalar tails
+    std::uint32_t seed = 13579;
+    auto premultiplied_frame = [&seed]<typename P>(FrameT<P>& frame) {
+        using TChannel = typename P::ChannelType;
+        for (std::size_t row = 0; row < frame.height(); ++row)
+            for (std::size_t x = 0; x < frame.width(); ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                TChannel a = TChannel((seed >> 8) & P::MAX_VALUE);
+                if (row % 4 == 0 || (row % 4 == 1 && x < 40))
+                    a = P::MAX_VALUE;
+                else if (row % 4 == 2 && x >= 20)
+                    a = 0;
+                P p;
+                p.channels[3] = a;
+                for (std::size_t c = 0; c < 3; ++c) {
+                    seed = seed * 1664525u + 1013904223u;
+                    p.channels[c] = TChannel((std::uint64_t(seed >> 8) & P::MAX_VALUE) * a / P::MAX_VALUE);
+                }
+                frame(x, row) = p;
+            }
+    };
+    auto same_frame = []<typename P>(const FrameT<P>& a, const FrameT<P>& b) {
+        for (std::size_t row = 0; row < a.height(); ++row)
+            for (std::size_t x = 0; x < a.width(); ++x)
+                if (!(a(x, row) == b(x, row)))
+                    return false;
+        return true;
+    };
+
+    // the formulas of blend modes, in floating-point
+    auto expected = []<typename P>(const P& s, const P& d, const BlendMode mode) {
+        const double m = P::MAX_VALUE, sa = s.channels[3], da = d.channels[3];
+        P out;
+        for (std::size_t c = 0; c < 4; ++c) {
+            const double sc = s.channels[c], dc = d.channels[c];
+            double v;
+            switch (mode) {
+            case BLEND_OVER:     v = sc + std::floor(dc * (m - sa) / m + 0.5); break;
+            case BLEND_ADD:      v = sc + dc; break;
+            case BLEND_MULTIPLY: v = std::floor((sc * (dc + m - da) + dc * (m - sa)) / m + 0.5); break;
+            default:             v = sc + dc - std::floor(sc * dc / m + 0.5); break;
+            }
+            out.channels[c] = typename P::ChannelType(std::min(v, m));
+        }
+        return out;
+    };
+
+    const vcl::utils::NumaTopology topology = vcl::utils::NumaTopology::simulated(2);
+    FrameWorkers workers(topology, 2);
+
+    // SIMD and scalar kernels are exactly rounded and bit-exact, on workers as well
+    auto check_blend = [&]<typename P>() {
+        FrameT<P> src(67, 37), dst(67, 37), simd(67, 37), scalar(67, 37), threaded(67, 37);
+        premultiplied_frame(src);
+        premultiplied_frame(dst);
+        for (const BlendMode mode : { BLEND_OVER, BLEND_ADD, BLEND_MULTIPLY, BLEND_SCREEN }) {
+            dst.copy_to(simd);
+            dst.copy_to(scalar);
+            dst.copy_to(threaded);
+            blend(src, simd, mode);
+            blend_scalar(src, scalar, mode);
+            blend(src, threaded, mode, &workers);
+            assert(same_frame(simd, scalar) && same_frame(simd, threaded));
+            for (std::size_t row = 0; row < 37; ++row)
+                for (std::size_t x = 0; x < 67; ++x)
+                    assert(simd(x, row) == expected(src(x, row), dst(x, row), mode));
+        }
+
+        // opaque src over dst is src, transparent src leaves dst unchanged
+        FrameT<P> opaque(67, 37);
+        opaque.fill(P::rgb(P::MAX_VALUE / 3, 0, P::MAX_VALUE));
+        dst.copy_to(simd);
+        blend(opaque, simd);
+        assert(same_frame(simd, opaque));
+        FrameT<P> transparent(67, 37);
+        transparent.fill(P::rgba(0, 0, 0, 0));
+        for (const BlendMode mode : { BLEND_OVER, BLEND_ADD, BLEND_MULTIPLY, BLEND_SCREEN }) {
+            dst.copy_to(simd);
+            blend(transparent, simd, mode);
+            assert(same_frame(simd, dst));
+        }
+
+        // premultiplying opaque pixels keeps them, round trips are within the rounding of premultiplied colors
+        FrameT<P> straight(67, 37), premultiplied(67, 37), back(67, 37);
+        for (std::size_t row = 0; row < 37; ++row)
+            for (std::size_t x = 0; x < 67; ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                straight(x, row) = P::rgba(typename P::ChannelType(seed * 7), typename P::ChannelType(seed >> 5),
+                                           typename P::ChannelType(seed >> 13), typename P::ChannelType(row == 0 ? P::MAX_VALUE : seed >> 16));
+            }
+        premultiply(straight, premultiplied);
+        unpremultiply(premultiplied, back, &workers);
+        const double m = P::MAX_VALUE;
+        for (std::size_t row = 0; row < 37; ++row)
+            for (std::size_t x = 0; x < 67; ++x) {
+                const P p = straight(x, row), q = premultiplied(x, row), r = back(x, row);
+                const double a = p.a();
+                assert(q.a() == p.a() && r.a() == p.a());
+                for (std::size_t c = 0; c < 3; ++c) {
+                    assert(q.channels[c] == typename P::ChannelType(std::floor(p.channels[c] * a / m + 0.5)));
+                    if (a == 0)
+                        assert(r.channels[c] == 0);
+                    else
+                        assert(std::abs(double(r.channels[c]) - double(p.channels[c])) <= 0.5 * m / a + 0.5);
+                }
+                if (row == 0)
+                    assert(q == p && r == p);
+            }
+
+        // in place
+        premultiply(straight, straight);
+        assert(same_frame(straight, premultiplied));
+    };
+    check_blend.operator()<RGBA32>();
+    check_blend.operator()<BGRA32>();
+    check_blend.operator()<RGBA64>();
+
+    // overlays blended onto rectangles of frames, clipped to them
+    {
+        Frame_rgba32 overlay(20, 9), dst(67, 37), blended(67, 37);
+        premultiplied_frame(overlay);
+        premultiplied_frame(dst);
+        for (const Rect_i& rect : { Rect_i(10, 5, Dims_ui(20, 9)), Rect_i(-3, 30, Dims_ui(50, 50)), Rect_i(60, -4, Dims_ui(15, 8)),
+                                    Rect_i(5, 5, Dims_ui(7, 3)), Rect_i(70, 0, Dims_ui(8, 8)) }) {
+            dst.copy_to(blended);
+            blend(overlay, blended, rect, BLEND_SCREEN);
+            Frame_rgba32 scalar = dst.clone();
+            blend_scalar(overlay, scalar, rect, BLEND_SCREEN, &workers);
+            assert(same_frame(blended, scalar));
+            for (long row = 0; row < 37; ++row)
+                for (long x = 0; x < 67; ++x) {
+                    const long ox = x - rect.x, oy = row - rect.y;
+                    const bool inside = ox >= 0 && oy >= 0 && ox < std::min(20L, long(rect.width)) && oy < std::min(9L, long(rect.height));
+                    assert(blended(x, row) == (inside ? expected(overlay(ox, oy), dst(x, row), BLEND_SCREEN) : dst(x, row)));
+                }
+        }
+    }
+
+    try {
+        Frame_rgba32 a(4, 4), b(4, 5);
+        blend(a, b);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {}
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,176 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on the chroma resampling of YUV frames. */
+
+cout << "## frames.chroma_resampling / vcl::frames::resample_chroma() testing application..." << endl;
+
+{
+    using namespace vcl::frames;
+
+    static_assert(ChromaResamplable<YuvFrame_i420, YuvFrame_444> && ChromaResamplable<YuvFrame_nv12, YuvFrame_422>);
+    static_assert(!ChromaResamplable<YuvFrame_nv12, YuvFrame_p010>);
+
+    // pseudo-random samples, odd dimensions for tails and clamped borders
+    std::uint32_t seed = 123456789;
+    auto fill_random = [&seed]<typename F>(F& frame) {
+        for (std::size_t row = 0; row < frame.height(); ++row)
+            for (std::size_t x = 0; x < frame.width(); ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                frame.y()(x, row) = F::to_sample((seed >> 8) & F::MAX_VALUE);
+            }
+        for (std::size_t cy = 0; cy < frame.chroma_dims().height(); ++cy)
+            for (std::size_t cx = 0; cx < frame.chroma_dims().width(); ++cx) {
+                seed = seed * 1664525u + 1013904223u;
+                frame.cb_row(cy)[cx * F::CHROMA_STEP] = F::to_sample((seed >> 8) & F::MAX_VALUE);
+                frame.cr_row(cy)[cx * F::CHROMA_STEP] = F::to_sample((seed >> 20) & F::MAX_VALUE);
+            }
+    };
+    auto same_frame = []<typename F>(const F& a, const F& b) {
+        for (std::size_t row = 0; row < a.height(); ++row)
+            for (std::size_t x = 0; x < a.width(); ++x)
+                if (a.y()(x, row) != b.y()(x, row))
+                    return false;
+        for (std::size_t cy = 0; cy < a.chroma_dims().height(); ++cy)
+            for (std::size_t cx = 0; cx < a.chroma_dims().width(); ++cx)
+                if (a.cb_row(cy)[cx * F::CHROMA_STEP] != b.cb_row(cy)[cx * F::CHROMA_STEP] ||
+                    a.cr_row(cy)[cx * F::CHROMA_STEP] != b.cr_row(cy)[cx * F::CHROMA_STEP])
+                    return false;
+        return true;
+    };
+
+    const ChromaResampling resamplings[] = {
+        { CHROMA_NEAREST, SITING_COSITED, SITING_INTERSTITIAL },
+        { CHROMA_BILINEAR, SITING_COSITED, SITING_COSITED },
+        { CHROMA_BILINEAR, SITING_COSITED, SITING_INTERSTITIAL },
+        { CHROMA_BILINEAR, SITING_INTERSTITIAL, SITING_INTERSTITIAL }
+    };
+
+    // SIMD and scalar kernels are bit-exact, luma is copied
+    auto check_resampling = [&]<typename FSrc, typename FDst>(const std::size_t width, const std::size_t height) {
+        FSrc src(width, height);
+        fill_random(src);
+        for (const ChromaResampling& resampling : resamplings) {
+            FDst dst(width, height), reference(width, height);
+            resample_chroma(src, dst, resampling);
+            resample_chroma_scalar(src, reference, resampling);
+            assert(same_frame(dst, reference));
+            assert(dst.is_empty() || dst.y()(width - 1, height - 1) == src.y()(width - 1, height - 1));
+        }
+    };
+    check_resampling.operator()<YuvFrame_i420, YuvFrame_444>(101, 51);
+    check_resampling.operator()<YuvFrame_444, YuvFrame_i420>(101, 51);
+    check_resampling.operator()<YuvFrame_444, YuvFrame_nv12>(101, 51);
+    check_resampling.operator()<YuvFrame_nv12, YuvFrame_444>(101, 51);
+    check_resampling.operator()<YuvFrame_422, YuvFrame_i420>(101, 51);
+    check_resampling.operator()<YuvFrame_nv12, YuvFrame_422>(101, 51);
+    check_resampling.operator()<YuvFrame_422, YuvFrame_444>(101, 51);
+    check_resampling.operator()<YuvFrame_444, YuvFrame_422>(101, 51);
+    check_resampling.operator()<YuvFrame_nv12, YuvFrame_i420>(101, 51);
+    check_resampling.operator()<YuvFrame_i420, YuvFrame_444>(1100, 9);  // many tiles
+    check_resampling.operator()<YuvFrame_444, YuvFrame_nv12>(1100, 9);
+    check_resampling.operator()<YuvFrame_i420, YuvFrame_444>(0, 0);
+    {
+        using YuvFrame_p010_444 = YuvFrameT<std::uint16_t, 10, SUBSAMPLING_444, true>;
+        check_resampling.operator()<YuvFrame_p010, YuvFrame_p010_444>(37, 21);
+        check_resampling.operator()<YuvFrame_p010_444, YuvFrame_p010>(37, 21);
+    }
+
+    // uniform chroma is preserved by every filter
+    {
+        YuvFrame_i420 flat(101, 51);
+        flat.fill(64, 90, 200);
+        for (const ChromaResampling& resampling : resamplings) {
+            YuvFrame_444 up(101, 51);
+            resample_chroma(flat, up, resampling);
+            YuvFrame_nv12 down(101, 51);
+            resample_chroma(up, down, resampling);
+            for (std::size_t cx = 0; cx < 51; ++cx)
+                assert(up.cb()(2 * cx, 50) == 90 && up.cr()(2 * cx, 0) == 200 && down.cbcr()(cx, 25) == (CbCrT<std::uint8_t>{ 90, 200 }));
+        }
+    }
+
+    // nearest upsampling duplicates samples, nearest downsampling gets them back
+    {
+        YuvFrame_i420 src(101, 51);
+        fill_random(src);
+        YuvFrame_444 up(101, 51);
+        YuvFrame_i420 back(101, 51);
+        resample_chroma(src, up, resamplings[0]);
+        resample_chroma(up, back, resamplings[0]);
+        assert(same_frame(back, src));
+        assert(up.cb()(41, 17) == src.cb()(20, 8) && up.cr()(100, 50) == src.cr()(50, 25));
+    }
+
+    // bilinear weights, one row of a horizontal ramp
+    {
+        YuvFrame_444 ramp(32, 2);
+        for (std::size_t row = 0; row < 2; ++row)
+            for (std::size_t x = 0; x < 32; ++x) {
+                ramp.y()(x, row) = 16;
+                ramp.cb()(x, row) = std::uint8_t(4 * x);
+                ramp.cr()(x, row) = std::uint8_t(x == 9 ? 255 : 0);
+            }
+        YuvFrame_422 cosited(32, 2), interstitial(32, 2);
+        resample_chroma(ramp, cosited, { CHROMA_BILINEAR, SITING_COSITED, SITING_COSITED });
+        resample_chroma(ramp, interstitial, { CHROMA_BILINEAR, SITING_INTERSTITIAL, SITING_COSITED });
+        assert(cosited.cb()(5, 0) == 40 && cosited.cb()(0, 1) == 1);  // (4 + 2 * 0 + 4) / 4 at the left border
+        assert(cosited.cr()(4, 0) == 64 && cosited.cr()(5, 1) == 64);  // (1 * 255 + 2) / 4
+        assert(interstitial.cb()(5, 0) == 42 && interstitial.cr()(4, 0) == 128);  // (40 + 44 + 1) / 2, (0 + 255 + 1) / 2
+
+        YuvFrame_444 up(32, 2);
+        resample_chroma(interstitial, up, { CHROMA_BILINEAR, SITING_INTERSTITIAL, SITING_COSITED });
+        assert(up.cb()(10, 0) == 40 && up.cb()(11, 0) == 44);  // (34 + 3 * 42 + 2) / 4, (3 * 42 + 50 + 2) / 4
+    }
+
+    // same results on workers
+    {
+        const vcl::utils::NumaTopology topology = vcl::utils::NumaTopology::simulated(2);
+        FrameWorkers workers(topology, 2);
+        YuvFrame_nv12 src(101, 51);
+        fill_random(src);
+        YuvFrame_444 up(101, 51), threaded_up(101, 51);
+        resample_chroma(src, up);
+        resample_chroma(src, threaded_up, ChromaResampling(), &workers);
+        assert(same_frame(up, threaded_up));
+        YuvFrame_i420 down(101, 51), threaded_down(101, 51);
+        resample_chroma(up, down);
+        resample_chroma(up, threaded_down, ChromaResampling(), &workers);
+        assert(same_frame(down, threaded_down));
+    }
+
+    // dimensions must be the same
+    try {
+        YuvFrame_i420 src(100, 50);
+        YuvFrame_444 dst(100, 52);
+        resample_chroma(src, dst);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {}
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
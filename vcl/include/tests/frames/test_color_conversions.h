@@ -0,0 +1,164 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on RGB <-> YUV conversions, module frames.color_conversions. */
+
+cout << "## frames.color_conversions / RGB <-> YUV testing application..." << endl;
+
+{
+    using namespace vcl::frames;
+
+    // the classic values of BT.601, limited range
+    const YuvMatrix bt601 = yuv_matrix<8>(ColorSpec{ MATRIX_BT601, RANGE_LIMITED });
+    const RGB24 classic[3] = { RGB24::rgb(255, 255, 255), RGB24::rgb(0, 0, 0), RGB24::rgb(255, 0, 0) };
+    std::uint8_t y[3], u[3], v[3];
+    rgb_to_yuv_row_scalar(classic, y, u, v, 3, bt601);
+    assert(y[0] == 235 && u[0] == 128 && v[0] == 128);
+    assert(y[1] == 16 && u[1] == 128 && v[1] == 128);
+    assert(y[2] == 81 && u[2] == 90 && v[2] == 240);
+    static_assert(yuv_matrix<10>(ColorSpec{ MATRIX_BT709, RANGE_LIMITED }).luma_max == 940);
+    static_assert(yuv_matrix<10>(ColorSpec{ MATRIX_BT709, RANGE_LIMITED }).chroma_max == 960);
+    static_assert(yuv_matrix<8>(ColorSpec{ MATRIX_BT2020, RANGE_FULL }).luma_max == 255);
+
+    // pseudo-random RGB pixels, plus grays and saturated colors
+    std::vector<BGR24> pixels;
+    std::uint32_t seed = 12345;
+    for (int i = 0; i < 4096 + 5; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        pixels.push_back(BGR24::rgb(std::uint8_t(seed >> 24), std::uint8_t(seed >> 16), std::uint8_t(seed >> 8)));
+    }
+    for (int i = 0; i < 256; ++i)
+        pixels.push_back(BGR24::rgb(std::uint8_t(i), std::uint8_t(i), std::uint8_t(i)));
+    for (int c = 0; c < 8; ++c)
+        pixels.push_back(BGR24::rgb(c & 1 ? 255 : 0, c & 2 ? 255 : 0, c & 4 ? 255 : 0));
+    const std::size_t n = pixels.size();
+
+    for (const ColorMatrix matrix : { MATRIX_BT601, MATRIX_BT709, MATRIX_BT2020 }) {
+        for (const ColorRange range : { RANGE_LIMITED, RANGE_FULL }) {
+            const ColorSpec spec{ matrix, range };
+            const YuvMatrix m = yuv_matrix<8>(spec);
+            std::vector<std::uint8_t> ys(n), us(n), vs(n), yr(n), ur(n), vr(n);
+
+            // SIMD and scalar kernels are bit-exact
+            rgb_to_yuv_row(pixels.data(), ys.data(), us.data(), vs.data(), n, m);
+            rgb_to_yuv_row_scalar(pixels.data(), yr.data(), ur.data(), vr.data(), n, m);
+            assert(ys == yr && us == ur && vs == vr);
+
+            // within 1 of the floating point reference
+            const double kr = matrix == MATRIX_BT601 ? 0.299 : matrix == MATRIX_BT709 ? 0.2126 : 0.2627;
+            const double kb = matrix == MATRIX_BT601 ? 0.114 : matrix == MATRIX_BT709 ? 0.0722 : 0.0593;
+            const double sy = range == RANGE_LIMITED ? 219.0 / 255.0 : 1.0;
+            const double sc = range == RANGE_LIMITED ? 224.0 / 255.0 : 1.0;
+            const double oy = range == RANGE_LIMITED ? 16.0 : 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const double r = pixels[i].r(), g = pixels[i].g(), b = pixels[i].b();
+                const double luma = kr * r + (1.0 - kr - kb) * g + kb * b;
+                const double y_ref = std::clamp(oy + sy * luma, 0.0, 255.0);
+                const double u_ref = std::clamp(128.0 + sc * (b - luma) / (2.0 * (1.0 - kb)), 0.0, 255.0);
+                const double v_ref = std::clamp(128.0 + sc * (r - luma) / (2.0 * (1.0 - kr)), 0.0, 255.0);
+                assert(std::abs(ys[i] - y_ref) <= 1.0 && std::abs(us[i] - u_ref) <= 1.0 && std::abs(vs[i] - v_ref) <= 1.0);
+            }
+
+            // grays convert exactly, with neutral chroma
+            for (std::size_t i = 4096 + 5; i < 4096 + 5 + 256; ++i)
+                assert(us[i] == 128 && vs[i] == 128);
+
+            // back to RGB: SIMD and scalar kernels are bit-exact, round trips are close
+            std::vector<BGR24> back(n), back_ref(n);
+            yuv_to_rgb_row(ys.data(), us.data(), vs.data(), back.data(), n, m);
+            yuv_to_rgb_row_scalar(ys.data(), us.data(), vs.data(), back_ref.data(), n, m);
+            assert(back == back_ref);
+            for (std::size_t i = 0; i < n; ++i)
+                for (int c = 0; c < 3; ++c)
+                    assert(std::abs(int(back[i].channels[c]) - int(pixels[i].channels[c])) <= (range == RANGE_LIMITED ? 3 : 2));
+
+            // samples out of the limited range are clipped, also by SIMD kernels
+            std::vector<std::uint8_t> ones(n, 1), highs(n, 254);
+            yuv_to_rgb_row(ones.data(), highs.data(), ones.data(), back.data(), n, m);
+            yuv_to_rgb_row_scalar(ones.data(), highs.data(), ones.data(), back_ref.data(), n, m);
+            assert(back == back_ref);
+        }
+    }
+
+    // alpha gets opaque
+    {
+        const YuvMatrix m = yuv_matrix<8>(ColorSpec());
+        std::vector<std::uint8_t> ys(11, 100), us(11, 90), vs(11, 200);
+        std::vector<RGBA32> rgba(11, RGBA32::rgba(0, 0, 0, 0));
+        yuv_to_rgb_row(ys.data(), us.data(), vs.data(), rgba.data(), 11, m);
+        for (const RGBA32& p : rgba)
+            assert(p.a() == 255 && p == rgba[0]);
+    }
+
+    // frames, on the calling thread and on workers
+    {
+        const vcl::utils::NumaTopology topology = vcl::utils::NumaTopology::simulated(2);
+        FrameWorkers workers(topology, 2);
+
+        Frame_bgr24 rgb(133, 71);
+        for (std::size_t row = 0; row < rgb.height(); ++row)
+            for (std::size_t x = 0; x < rgb.width(); ++x)
+                rgb.row(row)[x] = pixels[(row * rgb.width() + x) % n];
+
+        const ColorSpec spec{ MATRIX_BT2020, RANGE_LIMITED };
+        Frame_b y1(133, 71), u1(133, 71), v1(133, 71), y2(133, 71), u2(133, 71), v2(133, 71);
+        rgb_to_yuv444(rgb, y1, u1, v1, spec);
+        rgb_to_yuv444(rgb, y2, u2, v2, spec, &workers);
+        assert(workers.tasks_count(0) + workers.tasks_count(1) == 4);
+
+        Frame_bgr24 back1(133, 71), back2(133, 71);
+        yuv444_to_rgb(y1, u1, v1, back1, spec);
+        yuv444_to_rgb(y2, u2, v2, back2, spec, &workers);
+        for (std::size_t row = 0; row < rgb.height(); ++row)
+            for (std::size_t x = 0; x < rgb.width(); ++x) {
+                assert(y1.row(row)[x] == y2.row(row)[x] && u1.row(row)[x] == u2.row(row)[x] && v1.row(row)[x] == v2.row(row)[x]);
+                assert(back1.row(row)[x] == back2.row(row)[x]);
+            }
+
+        Frame_b small(32, 71);
+        try {
+            rgb_to_yuv444(rgb, small, u1, v1);
+            assert(false);
+        }
+        catch (const std::invalid_argument&) {}
+    }
+
+    // 10 bits pixels
+    {
+        const YuvMatrix m = yuv_matrix<10>(ColorSpec{ MATRIX_BT709, RANGE_LIMITED });
+        const RGB30 rgb30[2] = { RGB30::rgb(1023, 1023, 1023), RGB30::rgb(0, 0, 0) };
+        std::uint16_t y10[2], u10[2], v10[2];
+        rgb_to_yuv_row(rgb30, y10, u10, v10, 2, m);
+        assert(y10[0] == 940 && u10[0] == 512 && v10[0] == 512);
+        assert(y10[1] == 64 && u10[1] == 512 && v10[1] == 512);
+        RGB30 back30[2];
+        yuv_to_rgb_row(y10, u10, v10, back30, 2, m);
+        assert(back30[0] == rgb30[0] && back30[1] == rgb30[1]);
+    }
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
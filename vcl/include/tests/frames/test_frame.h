@@ -0,0 +1,136 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on classes vcl::frames::FrameT and vcl::frames::FrameBuffersPool. */
+
+cout << "## frames.frame / vcl::frames::FrameT testing application..." << endl;
+
+{
+    using vcl::frames::FrameBuffersPool;
+    using vcl::frames::Frame_b;
+    using vcl::frames::Frame_us;
+
+    FrameBuffersPool pool;
+
+    // empty frames
+    Frame_b f0;
+    assert(f0.is_empty());
+    assert(f0.width() == 0 && f0.height() == 0);
+    assert(f0.use_count() == 0);
+    assert(Frame_b(0, 10, pool).is_empty());
+    assert(pool.allocations_count() == 0);
+
+    // aligned rows and padded stride
+    Frame_b f1(100, 50, pool);
+    assert(!f1.is_empty());
+    assert(!f1.is_view());
+    assert(f1.width() == 100 && f1.height() == 50);
+    assert(f1.dims().width() == 100 && f1.dims().height() == 50);
+    assert(f1.stride() == 128);
+    for (std::size_t y = 0; y < f1.height(); ++y)
+        assert(reinterpret_cast<std::uintptr_t>(f1.row(y)) % vcl::frames::FRAME_ROWS_ALIGNMENT == 0);
+    assert(Frame_us::stride_bytes(33) == 128);
+    assert(Frame_us(vcl::utils::Dims_us(1920, 1080), pool).stride() == 3840);
+
+    f1.fill(7);
+    assert(f1(99, 49) == 7);
+    f1.at(3, 4) = 9;
+    assert(f1(3, 4) == 9);
+    bool thrown = false;
+    try {
+        f1.at(100, 0) = 1;
+    }
+    catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // shared pixels
+    {
+        Frame_b f2 = f1;
+        assert(f1.use_count() == 2);
+        assert(f2.data() == f1.data());
+        f2(0, 0) = 42;
+        assert(f1(0, 0) == 42);
+    }
+    assert(f1.use_count() == 1);
+
+    // zero-copy views
+    vcl::graphitems::Rect_i rect(vcl::utils::Pos_i(10, 20), vcl::utils::Dims_ui(30, 5));
+    Frame_b v1 = f1.view(rect);
+    assert(v1.is_view());
+    assert(v1.width() == 30 && v1.height() == 5);
+    assert(v1.stride() == f1.stride());
+    assert(v1.data() == f1.data() + 20 * f1.stride() + 10);
+    assert(f1.use_count() == 2);
+    v1(0, 0) = 77;
+    assert(f1(10, 20) == 77);
+
+    rect.crop(5, 5, 1, 1);  // cropping then viewing costs no copy
+    Frame_b v2 = f1.view(rect);
+    assert(v2.width() == 20 && v2.height() == 3);
+    assert(&v2(0, 0) == &f1(15, 21));
+
+    Frame_b v3 = v1.view(vcl::graphitems::Rect_i(vcl::utils::Pos_i(25, 3), vcl::utils::Dims_ui(10, 10)));  // clipped
+    assert(v3.width() == 5 && v3.height() == 2);
+    assert(&v3(0, 0) == &f1(35, 23));
+    assert(f1.view(vcl::graphitems::Rect_i(vcl::utils::Pos_i(200, 0), vcl::utils::Dims_ui(10, 10))).is_empty());
+
+    // deep copies
+    Frame_b c1 = v1.clone(pool);
+    assert(!c1.is_view());
+    assert(c1.stride() == 64);
+    assert(c1(0, 0) == 77);
+    c1(0, 0) = 1;
+    assert(f1(10, 20) == 77);
+
+    // recycled buffers: no heap allocation in steady state
+    f0 = Frame_b();
+    v1 = v2 = v3 = c1 = f0;
+    f1 = f0;
+    const unsigned long long allocations = pool.allocations_count();
+    assert(pool.free_count() == allocations);
+    for (int i = 0; i < 100; ++i) {
+        Frame_b frame(100, 50, pool);
+        Frame_b roi = frame.view(rect);
+        roi.fill(std::uint8_t(i));
+    }
+    assert(pool.allocations_count() == allocations);
+    assert(pool.recycled_count() >= 100);
+
+    // capped free buffers
+    pool.max_free_bytes(0);
+    assert(pool.free_count() == 0);
+    assert(pool.free_bytes() == 0);
+    {
+        Frame_b frame(100, 50, pool);
+    }
+    assert(pool.free_count() == 0);
+    assert(pool.allocations_count() == allocations + 1);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,180 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on class vcl::frames::FrameBuffersPool. */
+
+cout << "## frames.frame_buffers / vcl::frames::FrameBuffersPool testing application..." << endl;
+
+{
+    using vcl::frames::FrameBuffersPool;
+    using vcl::frames::FrameBuffersPoolStats;
+    using vcl::frames::Frame_b;
+    using vcl::frames::Frame_us;
+
+    FrameBuffersPool pool;
+
+    // buffers are keyed by dimensions and pixel format
+    assert(Frame_b::buffer_key(128, 10).bytes_count() == Frame_us::buffer_key(64, 10).bytes_count());
+    assert(!(Frame_b::buffer_key(128, 10) == Frame_us::buffer_key(64, 10)));
+    assert(!(Frame_b::buffer_key(128, 10) == Frame_b::buffer_key(100, 10)));
+    {
+        Frame_b f(128, 10, pool);
+    }
+    {
+        Frame_us f(64, 10, pool);  // same size, other format
+        Frame_b g(100, 10, pool);  // same stride, other width
+    }
+    assert(pool.allocations_count() == 3);
+    assert(pool.recycled_count() == 0);
+    {
+        Frame_b f(128, 10, pool);
+        Frame_us g(64, 10, pool);
+    }
+    assert(pool.allocations_count() == 3);
+    assert(pool.stats().thread_cache_hits == 2);
+
+    // pre-warming
+    FrameBuffersPool warm_pool;
+    Frame_b::prewarm(640, 480, 4, warm_pool);
+    assert(warm_pool.allocations_count() == 4);
+    assert(warm_pool.free_count() == 4);
+    assert(warm_pool.free_bytes() == 4 * 640 * 480);
+    {
+        Frame_b frames[4] = { Frame_b(640, 480, warm_pool), Frame_b(640, 480, warm_pool),
+                              Frame_b(640, 480, warm_pool), Frame_b(640, 480, warm_pool) };
+    }
+    assert(warm_pool.allocations_count() == 4);
+    assert(warm_pool.stats().overflow_hits == 4);
+    assert(warm_pool.free_count() == 4);
+
+    // free buffers from other threads are recycled through the overflow list
+    {
+        std::vector<Frame_b> produced;
+        std::mutex produced_mutex;
+        std::thread producer([&] {
+            for (int i = 0; i < 16; ++i) {
+                Frame_b frame(640, 480, warm_pool);
+                frame.fill(std::uint8_t(i));
+                std::lock_guard<std::mutex> lock(produced_mutex);
+                produced.push_back(frame);
+            }
+        });
+        producer.join();
+        produced.clear();  // released by this thread
+        std::thread consumer([&] {
+            for (int i = 0; i < 16; ++i)
+                Frame_b frame(640, 480, warm_pool);
+        });
+        consumer.join();
+    }
+    FrameBuffersPoolStats stats = warm_pool.stats();
+    assert(stats.allocations_count == 4 + 16);  // the 4 buffers cached by this thread are not seen by the producer
+    assert(stats.free_count == 4 + 16);
+    assert(stats.allocated_bytes == 20 * 640 * 480);
+    assert(stats.peak_allocated_bytes == 20 * 640 * 480);
+    assert(stats.overflow_hits == 4 + 1);  // the consumer then recycles its buffer through its own cache
+    assert(stats.thread_cache_hits == 15);
+    assert(warm_pool.recycled_count() == stats.thread_cache_hits + stats.overflow_hits);
+    assert(warm_pool.report().find("heap allocations 20") != std::string::npos);
+
+    // memory cap
+    FrameBuffersPool capped_pool(FrameBuffersPool::DEFAULT_MAX_FREE_BYTES, 2 * 64 * 10);
+    {
+        Frame_b f(64, 10, capped_pool);
+        Frame_b g(64, 10, capped_pool);
+        bool thrown = false;
+        try {
+            Frame_b h(64, 10, capped_pool);
+        }
+        catch (const std::bad_alloc&) {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(capped_pool.allocated_bytes() == 2 * 64 * 10);
+    }
+    {
+        Frame_b f(128, 10, capped_pool);  // frees the free buffers with other keys first
+    }
+    stats = capped_pool.stats();
+    assert(stats.allocations_count == 3);
+    assert(stats.heap_frees_count == 2);
+    assert(stats.allocated_bytes <= stats.max_bytes);
+    assert(capped_pool.report().find("cap") != std::string::npos);
+
+    // pre-warming a capped pool
+    FrameBuffersPool capped_warm_pool(FrameBuffersPool::DEFAULT_MAX_FREE_BYTES, 3 * 64 * 10);
+    bool prewarm_thrown = false;
+    try {
+        Frame_b::prewarm(64, 10, 4, capped_warm_pool);
+    }
+    catch (const std::invalid_argument&) {
+        prewarm_thrown = true;
+    }
+    assert(prewarm_thrown);
+    assert(capped_warm_pool.allocations_count() == 0);
+    {
+        Frame_b f(32, 10, capped_warm_pool);
+    }
+    Frame_b::prewarm(64, 10, 3, capped_warm_pool);  // frees the free buffer with another key, keeps the pre-warmed ones
+    assert(capped_warm_pool.free_count() == 3);
+    assert(capped_warm_pool.free_bytes() == 3 * 64 * 10);
+    assert(capped_warm_pool.stats().heap_frees_count == 1);
+
+    // huge pages backings, falling back to default pages when none is available
+    FrameBuffersPool huge_pool;
+    assert(huge_pool.huge_pages() == vcl::frames::HUGE_PAGES_OFF);
+    {
+        Frame_b f(3840, 2160, huge_pool);
+        assert(f.memory_backing() == vcl::frames::BACKING_DEFAULT_PAGES);
+    }
+    huge_pool.huge_pages(vcl::frames::HUGE_PAGES_EXPLICIT);
+    huge_pool.trim(0);  // else the free default pages buffer would be recycled
+    {
+        Frame_b small(64, 64, huge_pool);
+        assert(small.memory_backing() == vcl::frames::BACKING_DEFAULT_PAGES);
+
+        Frame_b f(3840, 2160, huge_pool);
+        if (vcl::frames::transparent_huge_pages_available())
+            assert(f.memory_backing() != vcl::frames::BACKING_DEFAULT_PAGES);
+        if (f.memory_backing() != vcl::frames::BACKING_DEFAULT_PAGES)
+            assert(reinterpret_cast<std::uintptr_t>(f.data()) % vcl::frames::HUGE_PAGES_SIZE == 0);
+        f.fill(3);
+        assert(f(0, 0) == 3 && f(3839, 2159) == 3);
+    }
+    stats = huge_pool.stats();
+    assert(stats.backings_counts[vcl::frames::BACKING_DEFAULT_PAGES] >= 2);
+    assert(stats.backings_counts[vcl::frames::BACKING_DEFAULT_PAGES] + stats.backings_counts[vcl::frames::BACKING_TRANSPARENT_HUGE] +
+           stats.backings_counts[vcl::frames::BACKING_HUGETLB] == stats.allocations_count);
+    assert(huge_pool.report().find("transparent huge pages") != std::string::npos);
+
+    // trimming
+    warm_pool.trim(0);
+    assert(warm_pool.free_count() == 0);
+    assert(warm_pool.allocated_bytes() == 0);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
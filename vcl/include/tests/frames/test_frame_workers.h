@@ -0,0 +1,140 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on class vcl::frames::FrameWorkers and on NUMA bound frames. */
+
+cout << "## frames.frame_workers / vcl::frames::FrameWorkers testing application..." << endl;
+
+{
+    using vcl::frames::FrameBuffersPool;
+    using vcl::frames::FrameWorkers;
+    using vcl::frames::Frame_b;
+    using vcl::utils::NumaTopology;
+    using vcl::utils::NO_NUMA_NODE;
+
+    // frames bound to the nodes of a simulated topology
+    const NumaTopology topology = NumaTopology::simulated(2);
+    FrameBuffersPool pools[2];
+    pools[0].numa_node(0, topology);
+    pools[1].numa_node(1, topology);
+    assert(pools[1].numa_node() == 1);
+
+    Frame_b frames[2] = { Frame_b(64, 64, pools[0]), Frame_b(64, 64, pools[1]) };
+    assert(frames[0].numa_node() == 0);
+    assert(frames[1].numa_node() == 1);
+    assert(pools[1].stats().numa_bound_count == 1);
+    assert(pools[1].report().find("NUMA node 1") != std::string::npos);
+    assert(Frame_b().numa_node() == NO_NUMA_NODE);
+    FrameBuffersPool unbound_pool;
+    assert(Frame_b(64, 64, unbound_pool).numa_node() == NO_NUMA_NODE);
+
+    // tasks run on the node of their frame
+    FrameWorkers workers(topology, 2);
+    assert(workers.nodes_count() == 2);
+    assert(workers.threads_count() == 4);
+    assert(FrameWorkers::current_node() == NO_NUMA_NODE);
+
+    std::atomic<int> misplaced = 0;
+    for (int i = 0; i < 100; ++i) {
+        const Frame_b& frame = frames[i % 2];
+        workers.submit(frame, [&misplaced, &frame]() {
+            if (FrameWorkers::current_node() != frame.numa_node())
+                ++misplaced;
+        });
+    }
+    workers.wait();
+    assert(misplaced == 0);
+    assert(workers.tasks_count(0) == 50);
+    assert(workers.tasks_count(1) == 50);
+
+    // tasks on no node are shared out among nodes
+    for (int i = 0; i < 10; ++i)
+        workers.submit(NO_NUMA_NODE, []() {});
+    workers.wait();
+    assert(workers.tasks_count(0) == 55);
+    assert(workers.tasks_count(1) == 55);
+
+    // exceptions thrown by tasks
+    workers.submit(1, []() { throw std::runtime_error("task failed"); });
+    bool thrown = false;
+    try {
+        workers.wait();
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    workers.wait();
+
+    // rows bands only wait for their own tasks and only rethrow their own exceptions
+    std::atomic<bool> release_slow_task = false;
+    workers.submit(0, [&release_slow_task]() {
+        while (!release_slow_task.load())
+            std::this_thread::yield();
+        throw std::runtime_error("unrelated task failed");
+    });
+    std::atomic<std::size_t> rows_done = 0;
+    vcl::frames::for_rows_bands(64, NO_NUMA_NODE, &workers, [&rows_done](const std::size_t first_row, const std::size_t last_row) {
+        rows_done += last_row - first_row;
+    });
+    assert(rows_done == 64);
+    release_slow_task = true;
+
+    thrown = false;
+    try {
+        vcl::frames::for_rows_bands(64, NO_NUMA_NODE, &workers, [](const std::size_t first_row, const std::size_t) {
+            if (first_row == 0)
+                throw std::runtime_error("band failed");
+        });
+    }
+    catch (const std::runtime_error& e) {
+        thrown = std::string(e.what()) == "band failed";
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        workers.wait();
+    }
+    catch (const std::runtime_error& e) {
+        thrown = std::string(e.what()) == "unrelated task failed";
+    }
+    assert(thrown);
+
+    // rows bands run from workers do not deadlock them
+    rows_done = 0;
+    for (int i = 0; i < 8; ++i)
+        workers.submit(NO_NUMA_NODE, [&workers, &rows_done]() {
+            vcl::frames::for_rows_bands(64, NO_NUMA_NODE, &workers, [&rows_done](const std::size_t first_row, const std::size_t last_row) {
+                rows_done += last_row - first_row;
+            });
+        });
+    workers.wait();
+    assert(rows_done == 8 * 64);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,247 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on 1D, 3D and compile-time LUTs, module frames.luts. */
+
+cout << "## frames.luts / vcl::frames::Lut1D and Lut3D testing application..." << endl;
+
+{
+    using namespace vcl::frames;
+
+    static_assert(LutPixel<RGBA64> && LutPixel<BGR24> && !LutPixel<Gray8>);
+
+    // compile-time transfer LUTs, against the run-time functions of the standards
+    static_assert(transfer_lut<TRANSFER_SRGB_TO_LINEAR, 8>[0] == 0 && transfer_lut<TRANSFER_SRGB_TO_LINEAR, 8>[255] == 255);
+    static_assert(transfer_lut<TRANSFER_LINEAR_TO_PQ, 10>[1023] == 1023 && transfer_lut<TRANSFER_PQ_TO_LINEAR, 10>[0] == 0);
+    static_assert(std::is_same_v<decltype(transfer_lut<TRANSFER_LINEAR_TO_SRGB, 12>)::value_type, std::uint16_t>);
+    const auto& srgb_to_linear = transfer_lut<TRANSFER_SRGB_TO_LINEAR, 8>;
+    const auto& linear_to_srgb = transfer_lut<TRANSFER_LINEAR_TO_SRGB, 8>;
+    const auto& pq_to_linear_10 = transfer_lut<TRANSFER_PQ_TO_LINEAR, 10>;
+    const auto& pq_to_linear_12 = transfer_lut<TRANSFER_PQ_TO_LINEAR, 12>;
+    const auto& linear_to_pq_12 = transfer_lut<TRANSFER_LINEAR_TO_PQ, 12>;
+    for (unsigned i = 0; i < 256; ++i) {
+        const double x = i / 255.0;
+        const double linear = x <= 0.04045 ? x / 12.92 : std::pow((x + 0.055) / 1.055, 2.4);
+        const double srgb = x <= 0.0031308 ? 12.92 * x : 1.055 * std::pow(x, 1.0 / 2.4) - 0.055;
+        assert(srgb_to_linear[i] == std::uint8_t(linear * 255.0 + 0.5));
+        assert(linear_to_srgb[i] == std::uint8_t(srgb * 255.0 + 0.5));
+    }
+    auto pq_to_linear = [](const double x) {
+        const double e = std::pow(x, 4096.0 / (2523.0 * 128.0));
+        return std::pow(std::max(e - 3424.0 / 4096.0, 0.0) / (2413.0 / 128.0 - 2392.0 / 128.0 * e), 16384.0 / 2610.0);
+    };
+    for (unsigned i = 0; i < 1024; ++i)
+        assert(std::abs(transfer_function(TRANSFER_PQ_TO_LINEAR, i / 1023.0) - pq_to_linear(i / 1023.0)) < 1e-12);
+    assert(std::abs(transfer_function(TRANSFER_PQ_TO_LINEAR, 0.5081) - 0.01) < 1e-4);  // 100 cd/m2
+    for (unsigned i = 1; i < 4096; ++i)
+        assert(linear_to_pq_12[i] >= linear_to_pq_12[i - 1]);
+    for (unsigned i = 0; i < 4096; i += 7)
+        assert(std::abs(int(pq_to_linear_12[linear_to_pq_12[i]]) - int(i)) <= std::max(1, int(i) / 64));
+
+    // pseudo-random frames, odd widths for the scalar tails
+    std::uint32_t seed = 24680;
+    auto random_frame = [&seed]<typename P>(FrameT<P>& frame) {
+        for (std::size_t row = 0; row < frame.height(); ++row)
+            for (std::size_t x = 0; x < frame.width(); ++x)
+                for (std::size_t c = 0; c < P::CHANNELS_COUNT; ++c) {
+                    seed = seed * 1664525u + 1013904223u;
+                    frame(x, row).channels[c] = typename P::ChannelType((seed >> 8) & P::MAX_VALUE);
+                }
+    };
+    auto same_frame = []<typename P>(const FrameT<P>& a, const FrameT<P>& b) {
+        for (std::size_t row = 0; row < a.height(); ++row)
+            for (std::size_t x = 0; x < a.width(); ++x)
+                if (!(a(x, row) == b(x, row)))
+                    return false;
+        return true;
+    };
+    Frame_bgr24 bgr(67, 13), out(67, 13);
+    random_frame(bgr);
+
+    // transfer LUTs, alpha being kept
+    {
+        Frame_rgba32 rgba(67, 13);
+        random_frame(rgba);
+        Frame_rgba32 linear(67, 13);
+        apply_transfer<TRANSFER_SRGB_TO_LINEAR>(rgba, linear);
+        assert(linear(5, 7).g() == srgb_to_linear[rgba(5, 7).g()] && linear(5, 7).a() == rgba(5, 7).a());
+        FrameT<Gray10> gray(9, 3);
+        gray.fill(Gray10::gray(520));
+        apply_transfer<TRANSFER_PQ_TO_LINEAR>(gray, gray);
+        assert(gray(8, 2).value() == pq_to_linear_10[520]);
+    }
+
+    // 1D LUTs: identity, per-channel curves and domains
+    {
+        apply_lut(Lut1D(17), bgr, out);
+        assert(same_frame(out, bgr));
+
+        Lut1D curves(5);
+        for (std::size_t i = 0; i < 5; ++i)
+            curves.set(i, 1.0f - i / 4.0f, i / 4.0f, 0.5f);
+        apply_lut(curves, bgr, out);
+        for (std::size_t x = 0; x < 67; ++x)
+            assert(out(x, 12) == BGR24::rgb(255 - bgr(x, 12).r(), bgr(x, 12).g(), 128));
+
+        Lut1D half(2);
+        half.domain(LutDomain{ { 0.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f } });
+        apply_lut(half, bgr, out);
+        for (std::size_t x = 0; x < 67; ++x)
+            assert(std::abs(int(out(x, 3).b()) - std::min(255, 2 * int(bgr(x, 3).b()))) <= 1);
+
+        try {
+            apply_lut(Lut1D(), bgr, out);
+            assert(false);
+        }
+        catch (const std::invalid_argument&) {}
+        try {
+            half.domain(LutDomain{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 1.0f } });
+            assert(false);
+        }
+        catch (const std::invalid_argument&) {}
+    }
+
+    // 3D LUTs: identity and linear transforms are exact on 8 bits
+    for (const LutInterpolation interpolation : { LUT_TRILINEAR, LUT_TETRAHEDRAL }) {
+        apply_lut(Lut3D(17), bgr, out, interpolation);
+        assert(same_frame(out, bgr));
+
+        Lut3D swap(5);
+        for (std::size_t b = 0; b < 5; ++b)
+            for (std::size_t g = 0; g < 5; ++g)
+                for (std::size_t r = 0; r < 5; ++r)
+                    swap.set(r, g, b, g / 4.0f, b / 4.0f, r / 4.0f);
+        apply_lut(swap, bgr, out, interpolation);
+        for (std::size_t x = 0; x < 67; ++x)
+            assert(out(x, 6) == BGR24::rgb(bgr(x, 6).g(), bgr(x, 6).b(), bgr(x, 6).r()));
+    }
+
+    // 3D LUTs: pseudo-random nodes, colors on nodes get them
+    Lut3D random_lut(18);
+    for (std::size_t b = 0; b < 18; ++b)
+        for (std::size_t g = 0; g < 18; ++g)
+            for (std::size_t r = 0; r < 18; ++r) {
+                seed = seed * 1664525u + 1013904223u;
+                random_lut.set(r, g, b, (seed >> 24) / 255.0f, ((seed >> 16) & 255) / 255.0f, ((seed >> 8) & 255) / 255.0f);
+            }
+    for (const LutInterpolation interpolation : { LUT_TRILINEAR, LUT_TETRAHEDRAL }) {
+        Frame_bgr24 on_nodes(17, 1), mapped(17, 1);
+        for (std::size_t x = 0; x < 17; ++x)
+            on_nodes(x, 0) = BGR24::rgb(std::uint8_t(15 * x), std::uint8_t(255 - 15 * x), std::uint8_t(15 * (x / 2)));
+        apply_lut(random_lut, on_nodes, mapped, interpolation);
+        for (std::size_t x = 0; x < 17; ++x) {
+            const std::uint16_t* node = random_lut.node(x, 17 - x, x / 2);
+            assert(mapped(x, 0) == BGR24::rgb(std::uint8_t((node[0] * 255 + 8192) >> 14), std::uint8_t((node[1] * 255 + 8192) >> 14),
+                                              std::uint8_t((node[2] * 255 + 8192) >> 14)));
+        }
+    }
+
+    // 3D LUTs: SIMD and scalar kernels are bit-exact, on workers as well, alpha being kept
+    {
+        const vcl::utils::NumaTopology topology = vcl::utils::NumaTopology::simulated(2);
+        FrameWorkers workers(topology, 2);
+        auto check_lut3d = [&]<typename P>() {
+            FrameT<P> src(67, 37), simd(67, 37), scalar(67, 37), threaded(67, 37);
+            random_frame(src);
+            for (const LutInterpolation interpolation : { LUT_TRILINEAR, LUT_TETRAHEDRAL }) {
+                apply_lut(random_lut, src, simd, interpolation);
+                apply_lut_scalar(random_lut, src, scalar, interpolation);
+                apply_lut(random_lut, src, threaded, interpolation, &workers);
+                assert(same_frame(simd, scalar) && same_frame(simd, threaded));
+                assert(simd(66, 36).a() == src(66, 36).a());
+            }
+        };
+        check_lut3d.operator()<RGB24>();
+        check_lut3d.operator()<BGR24>();
+        check_lut3d.operator()<RGBA32>();
+        check_lut3d.operator()<BGRA32>();
+        check_lut3d.operator()<RGB30>();
+        check_lut3d.operator()<RGB48>();
+        check_lut3d.operator()<RGBA64>();
+
+        // in place
+        Frame_bgr24 in_place = bgr.clone();
+        apply_lut(random_lut, in_place, in_place);
+        apply_lut(random_lut, bgr, out);
+        assert(same_frame(in_place, out));
+    }
+
+    try {
+        Frame_bgr24 other(66, 13);
+        apply_lut(random_lut, bgr, other);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {}
+
+    // .cube files
+    {
+        std::istringstream text(
+            "# Created by hand\n"
+            "TITLE \"test LUT\"\n"
+            "LUT_1D_SIZE 2\n"
+            "LUT_3D_SIZE 2\n"
+            "LUT_3D_INPUT_RANGE 0.0 1.0\n"
+            "DOMAIN_MIN 0 0 0\r\n"
+            "DOMAIN_MAX 1 1 1\n"
+            "\n"
+            "0 0 0\n"
+            "1.0 1.0 1.0\n"
+            "0 0 0\n1 0 0\n0 1 0\n1 1 0\n0 0 1\n1 0 1\n0 1 1\n"
+            "\t1 1.5 -0.25   # clipped\n");
+        const CubeLut cube = parse_cube(text);
+        assert(cube.title == "test LUT" && cube.lut_1d.size() == 2 && cube.lut_3d.size() == 2);
+        assert(cube.lut_1d.node(1, 2) == 16384 && cube.lut_3d.node(1, 0, 0)[0] == 16384 && cube.lut_3d.node(1, 0, 0)[1] == 0);
+        assert(cube.lut_3d.node(0, 1, 1)[2] == 16384 && cube.lut_3d.node(1, 1, 1)[1] == 16384 && cube.lut_3d.node(1, 1, 1)[2] == 0);
+        apply_lut(cube.lut_1d, bgr, out);
+        assert(same_frame(out, bgr));
+
+        for (const char* bad : { "LUT_3D_SIZE 2\n0 0 0\n",                          // missing data
+                                 "LUT_1D_SIZE 2\n0 0 0\n1 1 1\n1 1 1\n",            // too many data lines
+                                 "LUT_1D_SIZE 2\n0 0 0\n1 x 1\n",                   // bad number
+                                 "LUT_1D_SIZE 2\n0 0 0\n1 1\n",                     // missing value
+                                 "0 0 0\n",                                         // data before size
+                                 "LUT_3D_SIZE 1\n0 0 0\n",                          // bad size
+                                 "LUT_1D_SIZE 2\n0 0 0\nTITLE \"late\"\n1 1 1\n",   // keyword after data
+                                 "LUT_1D_SIZE 2\nDOMAIN_MAX 0 1 1\n0 0 0\n1 1 1\n", // empty domain
+                                 "" }) {
+            std::istringstream bad_text(bad);
+            try {
+                parse_cube(bad_text);
+                assert(false);
+            }
+            catch (const std::invalid_argument&) {}
+        }
+
+        try {
+            load_cube("no/such/file.cube");
+            assert(false);
+        }
+        catch (const std::runtime_error&) {}
+    }
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
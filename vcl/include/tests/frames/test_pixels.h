@@ -0,0 +1,81 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on packed pixels types vcl::frames::PixelT. */
+
+cout << "## frames.pixels / vcl::frames::PixelT testing application..." << endl;
+
+{
+    using namespace vcl::frames;
+
+    // compile-time traits
+    static_assert(std::is_standard_layout_v<RGB24> && std::is_trivially_copyable_v<RGB24>);
+    static_assert(RGB24::CHANNELS_COUNT == 3 && RGB24::BITS_DEPTH == 8 && RGB24::LAYOUT == LAYOUT_RGB);
+    static_assert(BGRA32::CHANNELS_COUNT == 4 && BGRA32::HAS_ALPHA && BGRA32::RED_INDEX == 2 && BGRA32::ALPHA_INDEX == 3);
+    static_assert(BGR24::BLUE_INDEX == 0 && BGR24::ALPHA_INDEX == -1);
+    static_assert(Gray10::MAX_VALUE == 1023 && Gray12::MAX_VALUE == 4095 && Gray16::MAX_VALUE == 65535);
+    static_assert(RGB30::BITS_DEPTH == 10 && sizeof(RGB30::ChannelType) == 2);
+    static_assert(PixelTraits<RGBA64>::CHANNELS_COUNT == 4 && PixelTraits<RGBA64>::BITS_DEPTH == 16);
+    static_assert(PixelTraits<float>::IS_FLOATING && PixelTraits<std::uint16_t>::BITS_DEPTH == 16);
+    static_assert(PackedPixel<Gray8> && !PackedPixel<std::uint8_t>);
+    static_assert(std::is_same_v<RGB30::ClipVectType, vcl::vect::ClipVect3T<std::uint16_t, 0, 1023>>);
+
+    // constructors and accessors
+    constexpr RGB24 red = RGB24::rgb(255, 0, 0);
+    static_assert(red.r() == 255 && red.g() == 0 && red.a() == 255);
+    const BGRA32 bgra = BGRA32::rgba(10, 20, 30, 40);
+    assert(bgra.channels[0] == 30 && bgra.channels[2] == 10 && bgra.a() == 40);
+    assert(BGRA32::rgb(1, 2, 3).a() == 255);
+    assert(Gray10::gray(2000).value() == 1023);  // clipped
+    assert(Gray12::clipped(-5) == 0 && Gray12::clipped(5000) == 4095);
+    assert(RGB30::rgb(1000, 1023, 4000) == RGB30::rgb(1000, 1023, 1023));
+
+    // clipped vectors with the same bounds
+    const vcl::vect::ClipVect3T<std::uint16_t, 0, 1023> v = RGB30::rgb(1, 2, 3).to_clipvect();
+    assert(v[0] == 1 && v[1] == 2 && v[2] == 3);
+    assert(RGB30::from_clipvect(vcl::vect::ClipVect3T<std::uint16_t, 0, 1023>(2000, 5, 6)) == RGB30::rgb(1023, 5, 6));
+    assert(BGRA32::from_clipvect(bgra.to_clipvect()) == bgra);
+
+    // compile-time conversions
+    static_assert(pixel_cast<BGR24>(red) == BGR24::rgb(255, 0, 0));
+    static_assert(pixel_cast<RGB30>(RGB24::rgb(255, 128, 0)) == RGB30::rgb(1023, 514, 0));
+    static_assert(pixel_cast<RGB24>(RGB30::rgb(1023, 514, 3)) == RGB24::rgb(255, 128, 0));
+    static_assert(pixel_cast<Gray8>(RGB24::rgb(255, 255, 255)).value() == 255);
+    static_assert(pixel_cast<Gray16>(Gray8::gray(255)).value() == 65535);
+    static_assert(pixel_cast<RGBA32>(Gray8::gray(7)) == RGBA32::rgba(7, 7, 7, 255));
+    assert(pixel_cast<RGB24>(bgra) == RGB24::rgb(10, 20, 30));
+
+    // frames of packed pixels
+    Frame_rgb24 frame(100, 10);
+    assert(frame.stride() == 320);
+    frame.fill(red);
+    assert(frame(99, 9) == red);
+    assert(Frame_bgra32::stride_bytes(16) == 64);
+    assert(!(Frame_rgb24::buffer_key(64, 10) == Frame_bgr24::buffer_key(64, 10)));
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
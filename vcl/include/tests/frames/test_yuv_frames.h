@@ -0,0 +1,212 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on planar and semi-planar YUV frames vcl::frames::YuvFrameT, and on their conversions. */
+
+cout << "## frames.yuv_frames / vcl::frames::YuvFrameT testing application..." << endl;
+
+{
+    using namespace vcl::frames;
+    using vcl::graphitems::Rect_i;
+    using vcl::utils::Dims_ui;
+
+    // geometry, odd dimensions
+    static_assert(YuvFrame_i420::PLANES_COUNT == 3 && YuvFrame_nv12::PLANES_COUNT == 2);
+    static_assert(YuvFrame_p010::SAMPLES_SHIFT == 6 && YuvFrame_p010::to_sample(1023) == 0xffc0 && YuvFrame_p010::sample_value(0xffc0) == 1023);
+    static_assert(YuvFrame<YuvFrame_nv12> && YuvFrame<const YuvFrame_p010> && !YuvFrame<Frame_b>);
+    static_assert(SUBSAMPLING_420.chroma_width(101) == 51 && SUBSAMPLING_422.chroma_height(51) == 51);
+
+    YuvFrame_i420 i420(101, 51);
+    assert(i420.width() == 101 && i420.height() == 51);
+    assert(i420.chroma_dims() == Dims_ui(51, 26));
+    assert(i420.cb().width() == 51 && i420.cr().height() == 26);
+    YuvFrame_nv12 nv12(Dims_ui(101, 51));
+    assert(nv12.cbcr().width() == 51 && nv12.cbcr().height() == 26);
+    assert(YuvFrame_422(101, 51).chroma_dims() == Dims_ui(51, 51));
+    assert(YuvFrame_444(101, 51).chroma_dims() == Dims_ui(101, 51));
+    assert(YuvFrame_p010().is_empty());
+
+    // zero-copy views, widened to whole chroma samples
+    i420.fill(16, 128, 128);
+    const YuvFrame_i420 view = i420.view(Rect_i(5, 3, Dims_ui(10, 10)));
+    assert(view.is_view() && view.width() == 12 && view.height() == 12);
+    assert(view.y().row(0) == i420.y().row(2) + 4);
+    assert(view.cb().row(0) == i420.cb().row(1) + 2 && view.cr().row(5) == i420.cr().row(6) + 2);
+    assert(i420.y().use_count() == 2);
+    assert(i420.view(Rect_i(100, 50, Dims_ui(8, 8))).dims() == Dims_ui(1, 1));
+    assert(i420.view(Rect_i(200, 0, Dims_ui(8, 8))).is_empty());
+    const YuvFrame_nv12 nv12_view = nv12.view(Rect_i(5, 3, Dims_ui(10, 10)));
+    assert(nv12_view.cbcr().row(0) == nv12.cbcr().row(1) + 2);
+    assert(nv12.cr_row(3) == nv12.cb_row(3) + 1 && YuvFrame_nv12::CHROMA_STEP == 2 && i420.cr_row(3) == i420.cr().row(3));
+
+    YuvFrame_i420 copy = view.clone();
+    assert(!copy.is_view() && copy.y().row(0) != view.y().row(0));
+    copy.fill(1, 2, 3);
+    assert(view.y()(0, 0) == 16 && view.cr()(5, 5) == 128);
+    assert(copy.y()(11, 11) == 1 && copy.cb()(0, 0) == 2 && copy.cr()(5, 5) == 3);
+
+    // pseudo-random RGB frame, widths with SIMD blocks and tails
+    Frame_bgr24 rgb(101, 51);
+    std::uint32_t seed = 987654321;
+    for (std::size_t row = 0; row < rgb.height(); ++row)
+        for (std::size_t x = 0; x < rgb.width(); ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            rgb(x, row) = BGR24::rgb(std::uint8_t(seed >> 24), std::uint8_t(seed >> 16), std::uint8_t(seed >> 8));
+        }
+    const ColorSpec spec{ MATRIX_BT709, RANGE_LIMITED };
+    const YuvMatrix m = yuv_matrix<8>(spec);
+
+    auto same_plane = [](const auto& a, const auto& b) {
+        for (std::size_t row = 0; row < a.height(); ++row)
+            for (std::size_t x = 0; x < a.width(); ++x)
+                if (!(a(x, row) == b(x, row)))
+                    return false;
+        return true;
+    };
+    auto same_frame = [&]<typename F>(const F& a, const F& b) {
+        if constexpr (F::IS_SEMI_PLANAR)
+            return same_plane(a.y(), b.y()) && same_plane(a.cbcr(), b.cbcr());
+        else
+            return same_plane(a.y(), b.y()) && same_plane(a.cb(), b.cb()) && same_plane(a.cr(), b.cr());
+    };
+
+    // SIMD and scalar kernels are bit-exact, on every format
+    auto check_rgb_conversions = [&]<typename F>(F& yuv) {
+        constexpr unsigned Y_SHIFT = F::SUBSAMPLING.y_shift;
+        rgb_to_yuv(rgb, yuv, spec);
+        F reference(rgb.width(), rgb.height());
+        for (std::size_t cy = 0; cy < yuv.chroma_dims().height(); ++cy) {
+            const std::size_t row0 = cy << Y_SHIFT, row1 = std::min(row0 + Y_SHIFT, rgb.height() - 1);
+            rgb_to_yuv_frame_rows_scalar<F>(rgb.row(row0), rgb.row(row1), reference.y().row(row0), reference.y().row(row1),
+                                            reference.cb_row(cy), reference.cr_row(cy), rgb.width(), m);
+        }
+        assert(same_frame(yuv, reference));
+
+        Frame_bgr24 back(rgb.width(), rgb.height()), back_reference(rgb.width(), rgb.height());
+        yuv_to_rgb(yuv, back, spec);
+        for (std::size_t row = 0; row < rgb.height(); ++row) {
+            yuv_frame_row_to_rgb_scalar<F>(yuv.y().row(row), yuv.cb_row(row >> Y_SHIFT), yuv.cr_row(row >> Y_SHIFT), back_reference.row(row), rgb.width(), m);
+        }
+        assert(same_plane(back, back_reference));
+    };
+    YuvFrame_422 yuv422(101, 51);
+    YuvFrame_444 yuv444(101, 51);
+    check_rgb_conversions(i420);
+    check_rgb_conversions(nv12);
+    check_rgb_conversions(yuv422);
+    check_rgb_conversions(yuv444);
+
+    // planar and semi-planar formats get the same samples, 4:4:4 frames the ones of rgb_to_yuv444()
+    for (std::size_t cy = 0; cy < 26; ++cy)
+        for (std::size_t cx = 0; cx < 51; ++cx)
+            assert(nv12.cbcr()(cx, cy) == (CbCrT<std::uint8_t>{ i420.cb()(cx, cy), i420.cr()(cx, cy) }));
+    assert(same_plane(i420.y(), nv12.y()) && same_plane(i420.y(), yuv444.y()));
+    Frame_b y(101, 51), u(101, 51), v(101, 51);
+    rgb_to_yuv444(rgb, y, u, v, spec);
+    assert(same_plane(y, yuv444.y()) && same_plane(u, yuv444.cb()) && same_plane(v, yuv444.cr()));
+
+    // uniform blocks get the chroma of their color
+    Frame_bgr24 flat(40, 20);
+    flat.fill(BGR24::rgb(200, 30, 90));
+    YuvFrame_nv12 flat_nv12(40, 20);
+    rgb_to_yuv(flat, flat_nv12, spec);
+    Frame_b flat_y(40, 20), flat_u(40, 20), flat_v(40, 20);
+    rgb_to_yuv444(flat, flat_y, flat_u, flat_v, spec);
+    assert(flat_nv12.cbcr()(19, 9).cb == flat_u(0, 0) && flat_nv12.cbcr()(0, 0).cr == flat_v(0, 0));
+
+    // same results on workers
+    {
+        const vcl::utils::NumaTopology topology = vcl::utils::NumaTopology::simulated(2);
+        FrameWorkers workers(topology, 2);
+        YuvFrame_nv12 threaded(101, 51);
+        rgb_to_yuv(rgb, threaded, spec, &workers);
+        assert(same_frame(threaded, nv12));
+        Frame_bgr24 back(101, 51), threaded_back(101, 51);
+        yuv_to_rgb(nv12, back, spec);
+        yuv_to_rgb(threaded, threaded_back, spec, &workers);
+        assert(same_plane(back, threaded_back));
+
+        YuvFrame_i420 converted(101, 51);
+        convert_yuv(nv12, converted, &workers);
+        assert(same_frame(converted, i420));
+    }
+
+    // conversions between formats: interleaving, deinterleaving and bits depths
+    {
+        YuvFrame_nv12 to_nv12(101, 51);
+        convert_yuv(i420, to_nv12);
+        assert(same_frame(to_nv12, nv12));
+
+        YuvFrame_p010 p010(101, 51), p010_from_i420(101, 51);
+        convert_yuv(nv12, p010);
+        convert_yuv(i420, p010_from_i420);
+        assert(same_frame(p010, p010_from_i420));
+        for (std::size_t x = 0; x < 101; ++x)
+            assert(p010.y()(x, 50) == std::uint16_t(nv12.y()(x, 50) << 8));
+        assert(p010.cbcr()(50, 25).cr == std::uint16_t(nv12.cbcr()(50, 25).cr << 8));
+
+        YuvFrame_nv12 back_nv12(101, 51);
+        YuvFrame_i420 back_i420(101, 51);
+        convert_yuv(p010, back_nv12);
+        convert_yuv(p010, back_i420);
+        assert(same_frame(back_nv12, nv12) && same_frame(back_i420, i420));
+
+        // 10 bits values rounded to the nearest 8 bits ones, SIMD blocks and tails alike
+        for (std::size_t x = 0; x < 101; ++x)
+            p010.y()(x, 0) = YuvFrame_p010::to_sample(unsigned(x * 10 + 1) % 1024);
+        p010.y()(3, 0) = p010.y()(99, 0) = YuvFrame_p010::to_sample(1023);
+        convert_yuv(p010, back_nv12);
+        for (std::size_t x = 0; x < 101; ++x) {
+            const unsigned value = YuvFrame_p010::sample_value(p010.y()(x, 0));
+            assert(back_nv12.y()(x, 0) == std::min(255u, (value + 2) >> 2));
+        }
+        assert(back_nv12.y()(3, 0) == 255 && back_nv12.y()(99, 0) == 255);
+    }
+
+    // 10 bits RGB to P010, samples in the high bits
+    {
+        Frame_rgb30 rgb30(33, 17);
+        rgb30.fill(RGB30::rgb(1023, 1023, 1023));
+        YuvFrame_p010 p010(33, 17);
+        rgb_to_yuv(rgb30, p010, spec);
+        assert(p010.y()(32, 16) == std::uint16_t(940 << 6));
+        assert(p010.cbcr()(16, 8) == (CbCrT<std::uint16_t>{ std::uint16_t(512 << 6), std::uint16_t(512 << 6) }));
+        Frame_rgb30 back(33, 17);
+        yuv_to_rgb(p010, back, spec);
+        assert(back(0, 0) == RGB30::rgb(1023, 1023, 1023) && back(32, 16) == back(0, 0));
+    }
+
+    // dimensions must match
+    try {
+        YuvFrame_nv12 other(100, 51);
+        convert_yuv(i420, other);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {}
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -62,7 +62,7 @@ vcl::graphitems::Line_ui line_ul05(std::array<long long, 4>{ 1, 2, -3, 0x7fff'ff
 assert(line_ul05.start.x() == 1);
 assert(line_ul05.start.y() == 2);
 assert(line_ul05.end.x() == 0);
-assert(line_ul05.end.y() == 0xffff'ffff);
+assert(line_ul05.end.y() == std::min<unsigned long long>(0x7fff'ffff'ffff'ffff, std::numeric_limits<unsigned long>::max()));
 
 vcl::graphitems::Line_ll line_ll06(1, 2, vcl::utils::Pos_f(3.01f, 4.8));
 assert(line_ll06.start.x() == 1);
@@ -613,6 +613,24 @@ assert(ls.end.x() == 12);
 assert(ls.end.y() == 23);
 
 
+// drawing, with colors passed as references to their base class
+{
+    const vcl::utils::RGBColor red(255, 0, 0);
+    const vcl::utils::Color& color = red;
+    const cv::Scalar scalar = color;
+    assert(scalar[0] == 0 && scalar[1] == 0 && scalar[2] == 255);
+
+    cv::Mat frame(10, 10, CV_8UC3, cv::Scalar(0, 0, 0));
+    vcl::graphitems::Line horizontal(1, 5, 8, 5);
+    horizontal.draw(frame, color);
+    assert(frame.at<cv::Vec3b>(5, 4) == cv::Vec3b(0, 0, 255));
+    assert(frame.at<cv::Vec3b>(2, 4) == cv::Vec3b(0, 0, 0));
+
+    horizontal.draw(frame, vcl::utils::RGBColor(0, 255, 0));
+    assert(frame.at<cv::Vec3b>(5, 4) == cv::Vec3b(0, 255, 0));
+}
+
+
 
 
 
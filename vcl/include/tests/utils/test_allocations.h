@@ -0,0 +1,116 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on classes vcl::utils::AllocationTracker and vcl::utils::TrackingMemoryResource. */
+
+cout << "## utils.allocations / vcl::utils::AllocationTracker testing application..." << endl;
+
+{
+    using vcl::utils::AllocationSite;
+    using vcl::utils::AllocationTracker;
+    using vcl::utils::TrackingMemoryResource;
+
+    constexpr const char* SITE_A = "test_allocations site A";
+    constexpr const char* SITE_B = "test_allocations site B";
+
+    AllocationTracker::reset();
+
+    // explicit tracking memory resource, whatever VCL_ALLOC_TRACKING
+    TrackingMemoryResource resource;
+    {
+        AllocationSite site(SITE_A);
+        void* p = resource.allocate(100, 8);
+        {
+            AllocationSite nested(SITE_B);
+            void* q = resource.allocate(28, 4);
+            resource.deallocate(q, 28, 4);
+        }
+        void* r = resource.allocate(50);
+        resource.deallocate(r, 50);
+        resource.deallocate(p, 100, 8);
+    }
+    if constexpr (vcl::utils::ALLOC_TRACKING_ENABLED) {
+        assert(AllocationTracker::count(SITE_A) == 2);
+        assert(AllocationTracker::count(SITE_B) == 1);
+
+        bool found_a = false;
+        for (const vcl::utils::AllocationSiteStats& s : AllocationTracker::collect())
+            if (std::string_view(s.site) == SITE_A) {
+                found_a = true;
+                assert(s.bytes == 150);
+            }
+        assert(found_a);
+        assert(AllocationTracker::report().find(SITE_B) != std::string::npos);
+    }
+    else {
+        // sites cost nothing: allocations are accounted out of any vcl site
+        assert(AllocationTracker::count(SITE_A) == 0);
+        assert(AllocationTracker::count("(outside vcl)") == 3);
+    }
+    assert(AllocationTracker::count("never recorded site") == 0);
+
+    // pmr containers allocating from a tracking resource
+    {
+        vcl::utils::TimecodeArray25fps tcs(&resource);
+        assert(tcs.resource() == &resource);
+        const unsigned long long count_before = AllocationTracker::count("(outside vcl)") + AllocationTracker::vcl_count();
+        tcs.reserve(1000);
+        const unsigned long long count_reserved = AllocationTracker::count("(outside vcl)") + AllocationTracker::vcl_count();
+        assert(count_reserved == count_before + 1);
+
+        // zero-allocation frame loop once capacity is reserved
+        vcl::utils::Timecode25fps tc(0, 0, 0, 0);
+        for (int f = 0; f < 1000; ++f, ++tc)
+            tcs.push_back(tc);
+        assert(tcs.size() == 1000);
+        assert(AllocationTracker::count("(outside vcl)") + AllocationTracker::vcl_count() == count_reserved);
+
+        // copies allocate from the same resource
+        vcl::utils::TimecodeArray25fps copy(tcs);
+        assert(copy.resource() == &resource);
+        assert(AllocationTracker::count("(outside vcl)") + AllocationTracker::vcl_count() == count_reserved + 1);
+    }
+
+    // vcl call sites, when tracking is compiled in
+    if constexpr (vcl::utils::ALLOC_TRACKING_ENABLED) {
+        AllocationTracker::reset();
+        vcl::utils::TimecodeArray25fps tcs;
+        tcs.resize(100);
+        assert(AllocationTracker::count("vcl::utils::TimecodeArray::resize()") == 1);
+
+        const std::string tc_str = vcl::utils::Timecode25fps(1, 2, 3, 4);
+        assert(tc_str == "01:02:03:04");
+        assert(AllocationTracker::count("vcl::utils::Timecode::operator std::string()") == 0);
+    }
+    else
+        assert(vcl::utils::memory_resource() == std::pmr::get_default_resource());
+
+    AllocationTracker::reset();
+    assert(AllocationTracker::count(SITE_A) == 0);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,67 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on class vcl::utils::HwPerfMeter. */
+
+cout << "## utils.hw_perfmeters / vcl::utils::HwPerfMeter testing application..." << endl;
+
+{
+    vcl::utils::HwPerfMeter hw_perf;
+    cout << "   hardware counters available: " << std::boolalpha << hw_perf.is_available() << endl;
+
+    // a compute bound loop
+    hw_perf.start();
+    volatile unsigned long long acc = 0;
+    for (unsigned long long i = 0; i < 10'000'000; ++i)
+        acc = acc + i * i;
+    vcl::utils::HwCounters c0 = hw_perf.get_counters();
+    cout << "   compute: " << c0.report() << endl;
+
+    // a memory bound loop
+    std::vector<unsigned int> v(1 << 24);
+    hw_perf.start();
+    unsigned int idx = 0;
+    for (int i = 0; i < 1'000'000; ++i) {
+        idx = (idx * 1103515245u + 12345u) & ((1 << 24) - 1);
+        v[idx] += 1;
+    }
+    vcl::utils::HwCounters c1 = hw_perf.get_counters();
+    cout << "   memory:  " << c1.report() << endl;
+
+    assert(c0.elapsed_ns > 0 && c1.elapsed_ns > 0);
+    for (int i = 0; i < vcl::utils::HW_COUNTERS_COUNT; ++i) {
+        const auto id = vcl::utils::HwCounterId(i);
+        assert(hw_perf.is_available(id) == (c0.values[i] >= 0));
+        assert(hw_perf.is_available(id) == (c1.values[i] >= 0));
+    }
+    if (hw_perf.is_available(vcl::utils::HW_INSTRUCTIONS))
+        assert(c0.instructions() >= 10'000'000);
+    if (!hw_perf.is_available())
+        assert(c0.ipc() == 0.0 && c0.cycles() == -1);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,104 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on class vcl::utils::LatencyHistogram. */
+
+cout << "## utils.latency_histograms / vcl::utils::LatencyHistogram testing application..." << endl;
+
+{
+    using vcl::utils::LatencyHistogram;
+
+    // buckets consistency
+    for (unsigned long long v : { 0ull, 1ull, 127ull, 128ull, 129ull, 255ull, 256ull, 1000ull, 123456789ull, ~0ull >> 1, ~0ull }) {
+        const std::size_t i = LatencyHistogram::bucket_index(v);
+        assert(i < LatencyHistogram::BUCKETS_COUNT);
+        assert(LatencyHistogram::bucket_lowest(i) <= v && v <= LatencyHistogram::bucket_highest(i));
+        assert(LatencyHistogram::bucket_highest(i) - LatencyHistogram::bucket_lowest(i) <= v / 64);
+    }
+    for (std::size_t i = 1; i < LatencyHistogram::BUCKETS_COUNT; ++i)
+        assert(LatencyHistogram::bucket_lowest(i) == LatencyHistogram::bucket_highest(i - 1) + 1);
+    assert(LatencyHistogram::bucket_highest(LatencyHistogram::BUCKETS_COUNT - 1) == ~0ull);
+
+    LatencyHistogram h0;
+    assert(h0.count() == 0);
+    assert(h0.p99() == 0);
+    assert(h0.min() == 0 && h0.max() == 0);
+
+    // uniform distribution of values from 1 us up to 100 ms, recorded from two threads
+    LatencyHistogram h1, h2;
+    std::thread th1([&h1]() { for (unsigned long long v = 1; v <= 50'000; ++v) h1.record(v * 1000); });
+    std::thread th2([&h2]() { for (unsigned long long v = 50'001; v <= 100'000; ++v) h2.record(v * 1000); });
+    th1.join();
+    th2.join();
+    h1 += h2;
+
+    assert(h1.count() == 100'000);
+    assert(h1.min() == 1000);
+    assert(h1.max() == 100'000'000);
+    assert(h1.mean() == 50'000'500.0);
+
+    auto near = [](const unsigned long long value, const double expected) {
+        return vcl::utils::in_range_ii<double>(double(value), expected, expected * (1.0 + 1.0 / 64));
+    };
+    assert(near(h1.p50(), 50'000'000.0));
+    assert(near(h1.p90(), 90'000'000.0));
+    assert(near(h1.p99(), 99'000'000.0));
+    assert(near(h1.p999(), 99'900'000.0));
+    assert(h1.percentile(100.0) == 100'000'000);
+    assert(h1.percentile(0.0) == 1000);
+
+    h1.record(5'000'000'000ull, 1000);
+    assert(h1.count() == 101'000);
+    assert(h1.max() == 5'000'000'000ull);
+    assert(h1.p999() == 5'000'000'000ull);
+    cout << "   " << h1.report() << endl;
+
+    h1.reset();
+    assert(h1.count() == 0);
+
+    // nearest ranks, on values small enough to get their own buckets
+    for (unsigned long long v = 1; v <= 10; ++v)
+        h1.record(v);
+    assert(h1.percentile(10.0) == 1 && h1.percentile(11.0) == 2);
+    assert(h1.p90() == 9 && h1.percentile(91.0) == 10);
+    h1.reset();
+
+    // PerfMeter samples
+    vcl::utils::PerfMeter perf;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    h1.record(perf);
+    assert(h1.count() == 1 && h1.min() >= 2'000'000);
+
+    // recording overhead
+    constexpr unsigned long long N = 10'000'000;
+    perf.start();
+    for (unsigned long long v = 0; v < N; ++v)
+        h2.record(v * 7919 % 100'000'000);
+    cout << std::format("   histogram recording: {:.2f} ns\n", perf.get_elapsed_s() * 1e9 / N);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
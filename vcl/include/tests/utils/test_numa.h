@@ -0,0 +1,70 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on class vcl::utils::NumaTopology. */
+
+cout << "## utils.numa / vcl::utils::NumaTopology testing application..." << endl;
+
+{
+    using vcl::utils::NumaTopology;
+    using vcl::utils::NO_NUMA_NODE;
+
+    // topology of this machine
+    const NumaTopology& system = NumaTopology::system();
+    assert(&system == &NumaTopology::system());
+    assert(system.nodes_count() >= 1);
+    assert(!system.is_simulated());
+    for (int node = 0; node < system.nodes_count(); ++node) {
+        assert(!system.cpus(node).empty());
+        for (const int cpu : system.cpus(node))
+            assert(system.node_of_cpu(cpu) == node);
+    }
+    assert(system.node_of_cpu(-1) == NO_NUMA_NODE);
+    const int current = system.current_node();
+    assert(current == NO_NUMA_NODE || (current >= 0 && current < system.nodes_count()));
+
+    // simulated topology
+    const NumaTopology simulated = NumaTopology::simulated(2);
+    assert(simulated.nodes_count() == 2);
+    assert(simulated.is_simulated());
+    assert(!simulated.binds_memory());
+    assert(!simulated.cpus(0).empty() && !simulated.cpus(1).empty());
+    assert(NumaTopology::simulated(0).nodes_count() == 1);
+
+    std::vector<std::byte> memory(64);
+    assert(simulated.bind_memory(memory.data(), memory.size(), 1));  // nothing to bind
+    assert(!simulated.bind_memory(memory.data(), memory.size(), 2));
+    assert(!simulated.pin_current_thread(NO_NUMA_NODE));
+
+    std::thread pinned([&simulated]() {
+        if (simulated.pin_current_thread(1))
+            assert(simulated.current_node() != NO_NUMA_NODE);
+    });
+    pinned.join();
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -29,20 +29,62 @@ SOFTWARE.
 
 cout << "## utils.perfmeters / vcl::utils::PerfMeter testing application..." << endl;
 
+// sleeps may last much longer than requested on loaded machines, so only the lower bounds are tight
 vcl::utils::PerfMeter perf0;
 std::this_thread::sleep_for(std::chrono::milliseconds(150));
-assert( (vcl::utils::in_range_ii<double>(perf0.get_elapsed_ms(), 150.0, 167.0)) );
+assert( (vcl::utils::in_range_ii<double>(perf0.get_elapsed_ms(), 150.0, 150.0 + 250.0)) );
 cout << perf0.get_elapsed_ms() << std::endl;
 
 std::this_thread::sleep_for(std::chrono::milliseconds(150));
-assert((vcl::utils::in_range_ii<double>(perf0.get_elapsed_ms(), 300, 300 + 33)));
+assert((vcl::utils::in_range_ii<double>(perf0.get_elapsed_ms(), 300, 300 + 250.0)));
 cout << perf0.get_elapsed_ms() << std::endl;
 
 
 perf0.start();
 std::this_thread::sleep_for(std::chrono::milliseconds(127));
-assert((vcl::utils::in_range_ii<double>(perf0.get_elapsed_ms(), 127, 127 + 17.0)));
+assert((vcl::utils::in_range_ii<double>(perf0.get_elapsed_ms(), 127, 127 + 250.0)));
 cout << perf0.get_elapsed_ms() << std::endl;
 
 
+// TSC backend
+cout << "   invariant TSC: " << std::boolalpha << vcl::utils::TscClockBackend::has_invariant_tsc()
+     << ", ns per tick: " << vcl::utils::TscClockBackend::ns_per_tick() << endl;
+assert(vcl::utils::TscClockBackend::is_tsc() == vcl::utils::TscClockBackend::has_invariant_tsc());
+assert(!vcl::utils::SteadyClockBackend::is_tsc());
+
+vcl::utils::TscPerfMeter perf1;
+std::this_thread::sleep_for(std::chrono::milliseconds(150));
+assert((vcl::utils::in_range_ii<double>(perf1.get_elapsed_ms(), 150.0, 150.0 + 250.0)));
+assert((vcl::utils::in_range_ii<long long>(perf1.get_elapsed_ns(), 150'000'000, 150'000'000 + 250'000'000)));
+cout << perf1.get_elapsed_ms() << std::endl;
+
+perf1.start();
+std::this_thread::sleep_for(std::chrono::milliseconds(127));
+assert((vcl::utils::in_range_ii<double>(perf1.get_elapsed_ms(), 127, 127 + 250.0)));
+cout << perf1.get_elapsed_ms() << std::endl;
+
+{
+    // measures overhead,  steady clock vs. time-stamp counter
+    constexpr int N = 1'000'000;
+    long long sum_steady = 0, sum_tsc = 0;
+
+    perf0.start();
+    for (int i = 0; i < N; ++i) {
+        vcl::utils::PerfMeter p;
+        sum_steady += p.get_elapsed_ticks();
+    }
+    const double steady_ns = perf0.get_elapsed_s() * 1e9 / N;
+
+    perf0.start();
+    for (int i = 0; i < N; ++i) {
+        vcl::utils::TscPerfMeter p;
+        sum_tsc += p.get_elapsed_ticks();
+    }
+    const double tsc_ns = perf0.get_elapsed_s() * 1e9 / N;
+
+    assert(sum_steady >= 0 && sum_tsc >= 0);
+    cout << std::format("   measure overhead: steady clock {:.1f} ns, TSC {:.1f} ns\n", steady_ns, tsc_ns);
+}
+
+
 cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,137 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on classes vcl::utils::ProfileZone and vcl::utils::Profiler. */
+
+cout << "## utils.profilers / vcl::utils::Profiler testing application..." << endl;
+
+{
+    auto profiled_leaf = []() {
+        vcl::utils::ProfileZone zone("leaf");
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    };
+
+    auto profiled_frame = [&profiled_leaf]() {
+        vcl::utils::ProfileZone zone("test_frame");
+        {
+            vcl::utils::ProfileZone decode("decode");
+            profiled_leaf();
+        }
+        {
+            vcl::utils::ProfileZone convert("convert");
+            profiled_leaf();
+            profiled_leaf();
+        }
+    };
+
+    for (int i = 0; i < 10; ++i)
+        profiled_frame();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&profiled_frame]() {
+            for (int i = 0; i < 5; ++i)
+                profiled_frame();
+        });
+    for (auto& th : threads)
+        th.join();
+
+    const std::vector<vcl::utils::ProfileZoneStats> zones = vcl::utils::Profiler::collect();
+
+    if constexpr (vcl::utils::PROFILING_ENABLED) {
+        auto find_zone = [&zones](const std::string& path) {
+            return std::find_if(zones.begin(), zones.end(), [&path](const auto& z) { return z.path == path; });
+        };
+
+        const auto frame_it = find_zone("test_frame");
+        assert(frame_it != zones.end());
+        assert(frame_it->count == 30);
+        assert(frame_it->depth == 0);
+
+        const auto decode_it = find_zone("test_frame/decode/leaf");
+        assert(decode_it != zones.end());
+        assert(decode_it->count == 30);
+        assert(decode_it->depth == 2);
+        assert(decode_it > find_zone("test_frame/decode"));  // depth-first order
+
+        const auto convert_it = find_zone("test_frame/convert/leaf");
+        assert(convert_it != zones.end());
+        assert(convert_it->count == 60);
+        assert(convert_it->min_ns >= 50'000);
+        assert(convert_it->min_ns <= convert_it->max_ns);
+        assert(convert_it->total_ns >= 60 * convert_it->min_ns);
+        assert(frame_it->total_ns >= convert_it->total_ns + decode_it->total_ns);
+
+        cout << vcl::utils::Profiler::report();
+
+        // buffers of ended threads have been freed, their zones are still collected
+        const std::vector<vcl::utils::ProfileZoneStats> zones_again = vcl::utils::Profiler::collect();
+        const auto frame_again_it = std::find_if(zones_again.begin(), zones_again.end(), [](const auto& z) { return z.path == "test_frame"; });
+        assert(frame_again_it != zones_again.end());
+        assert(frame_again_it->count == 30);
+
+        // full buffers: zones nested in not recorded zones are not recorded either
+        static const std::vector<std::string> fill_names = [] {
+            std::vector<std::string> names;
+            for (int i = 0; i < 4095; ++i)
+                names.push_back(std::format("fill_{:d}", i));
+            return names;
+        }();
+        const unsigned long long dropped_before = vcl::utils::Profiler::dropped_count();
+        std::thread filler([]() {
+            for (const std::string& name : fill_names)
+                vcl::utils::ProfileZone zone(name.c_str());
+            {
+                vcl::utils::ProfileZone dropped("dropped_zone");
+                vcl::utils::ProfileZone nested(fill_names[0].c_str());
+            }
+            vcl::utils::ProfileZone zone(fill_names[0].c_str());
+        });
+        filler.join();
+
+        assert(vcl::utils::Profiler::dropped_count() == dropped_before + 2);
+        const std::vector<vcl::utils::ProfileZoneStats> full_zones = vcl::utils::Profiler::collect();
+        assert(std::none_of(full_zones.begin(), full_zones.end(), [](const auto& z) { return z.name == std::string("dropped_zone"); }));
+        const auto fill_it = std::find_if(full_zones.begin(), full_zones.end(), [](const auto& z) { return z.path == "fill_0"; });
+        assert(fill_it != full_zones.end());
+        assert(fill_it->count == 2);
+        assert(vcl::utils::Profiler::dropped_count() == dropped_before + 2);
+    }
+    else {
+        assert(zones.empty());
+        assert(vcl::utils::Profiler::dropped_count() == 0);
+    }
+
+    // profiling overhead
+    constexpr int N = 1'000'000;
+    vcl::utils::PerfMeter prof_perf;
+    for (int i = 0; i < N; ++i)
+        vcl::utils::ProfileZone zone("overhead");
+    cout << std::format("   profiling overhead: {:.2f} ns per zone\n", prof_perf.get_elapsed_s() * 1e9 / N);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
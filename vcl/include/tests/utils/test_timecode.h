@@ -62,4 +62,243 @@ assert(td25 < tb25);
 assert(tb25 > td25);
 assert(tb25 != td25);
 
+assert(tb25.hh() == 0);
+assert(tb25.mm() == 1);
+assert(tb25.ss() == 3);
+assert(tb25.ff() == 2);
+assert(tb25.frame_index() == 1577);
+
+// exact comparisons between frame rates: 00:00:01:00 @24fps == 00:00:01:00 @25fps
+assert(vcl::utils::Timecode24fps(0, 0, 1, 0) == vcl::utils::Timecode25fps(0, 0, 1, 0));
+assert(vcl::utils::Timecode24fps(0, 0, 0, 23) < vcl::utils::Timecode25fps(0, 0, 0, 24));
+assert(vcl::utils::Timecode25fps(0, 0, 0, 24) > vcl::utils::Timecode30fps(0, 0, 0, 28));
+assert(vcl::utils::Timecode25fps(0, 0, 0, 5) == vcl::utils::Timecode30fps(0, 0, 0, 6));
+
+// no more drift past 2^24 frames
+vcl::utils::Timecode30fps tbig(99, 59, 59, 28);
+assert(tbig.frame_index() == vcl::utils::Timecode30fps::FRAMES_COUNT - 2);
+assert(string(++tbig) == "99:59:59:29"s);
+assert((tbig + 1).is_error());
+assert(string(tbig - 30 * 3600) == "98:59:59:29"s);
+assert(string(vcl::utils::Timecode25fps(tbig)) == "99:59:59:24"s);
+
+// erroneous timecodes are all equal and greater than any valid one, at any frame rate
+assert((tbig + 1) > tbig);
+assert(tbig < (tbig + 1));
+assert((tbig + 1) == (vcl::utils::Timecode25fps(99, 59, 59, 24) + 1));
+assert((tbig + 1) > vcl::utils::Timecode24fps(0, 0, 0, 0));
+assert(vcl::utils::Timecode24fps(99, 59, 59, 23) < (tbig + 1));
+
+try {
+    vcl::utils::Timecode25fps terr(99, 60, 0, 0);
+    assert(false);
+}
+catch (std::invalid_argument&) {}
+
+try {
+    vcl::utils::Timecode25fps terr(360000);
+    assert(false);
+}
+catch (std::invalid_argument&) {}
+
+assert(string(vcl::utils::Timecode25fps("12:34:56:07")) == "12:34:56:07"s);
+
+
+// allocation-free formatting and parsing
+{
+    char tc_buffer[vcl::utils::Timecode25fps::TC_CHARS_SIZE];
+    assert(string(vcl::utils::Timecode25fps(1, 2, 3, 4).to_chars(tc_buffer)) == "01:02:03:04"s);
+    assert(string(tbig.to_chars(tc_buffer)) == "99:59:59:29"s);
+    assert(string((tbig + 1).to_chars(tc_buffer)) == "--:--:--:--"s);
+
+    vcl::utils::Timecode25fps tp;
+    assert(vcl::utils::Timecode25fps::parse("23:59:59:24"sv, tp));
+    assert(tp == vcl::utils::Timecode25fps(23, 59, 59, 24));
+    assert(!vcl::utils::Timecode25fps::parse("23:59:59:25"sv, tp) && tp.is_error());
+    assert(!vcl::utils::Timecode25fps::parse("23:60:59:00"sv, tp) && tp.is_error());
+    assert(!vcl::utils::Timecode25fps::parse("23:59;59:00"sv, tp) && tp.is_error());
+    assert(!vcl::utils::Timecode25fps::parse("2x:59:59:00"sv, tp) && tp.is_error());
+    assert(!vcl::utils::Timecode25fps::parse("1:2:3:4"sv, tp) && tp.is_error());
+    assert(!vcl::utils::Timecode25fps::parse(""sv, tp) && tp.is_error());
+
+    const std::array<std::string_view, 4> tc_column{ "00:00:00:01"sv, "10:00:00:00"sv, "10:00:00:99"sv, "99:59:59:24"sv };
+    std::array<vcl::utils::Timecode25fps, 4> tc_parsed;
+    assert(vcl::utils::Timecode25fps::parse(tc_column, tc_parsed) == 1);
+    assert(tc_parsed[0].frame_index() == 1);
+    assert(tc_parsed[1].frame_index() == 10 * vcl::utils::Timecode25fps::FRAMES_PER_HOUR);
+    assert(tc_parsed[2].is_error());
+    assert(tc_parsed[3].frame_index() == vcl::utils::Timecode25fps::FRAMES_COUNT - 1);
+}
+
+
+// rational frame rates and drop-frame counting
+{
+    using vcl::utils::Timecode29_97DF;
+    using vcl::utils::Timecode59_94DF;
+
+    assert(string(Timecode29_97DF()) == "00:00:00;00"s);
+    assert(string(Timecode29_97DF() + 1799) == "00:00:59;29"s);
+    assert(string(Timecode29_97DF() + 1800) == "00:01:00;02"s);
+    assert(string(Timecode29_97DF() + 17982) == "00:10:00;00"s);
+    assert(string(Timecode29_97DF() + 107892) == "01:00:00;00"s);
+    assert(Timecode29_97DF(1, 0, 0, 0).frame_index() == 107892);
+    assert(Timecode29_97DF("00:01:00;02").frame_index() == 1800);
+    assert(Timecode29_97DF("00:01:00:02").frame_index() == 1800);
+    assert(Timecode59_94DF(0, 1, 0, 4).frame_index() == 3600);
+    assert(Timecode59_94DF(1, 0, 0, 0).frame_index() == 2 * 107892);
+
+    try {
+        Timecode29_97DF terr(0, 1, 0, 1);  // dropped frame number
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+
+    Timecode29_97DF tdf;
+    assert(!Timecode29_97DF::parse("00:02:00;00"sv, tdf));
+    assert(Timecode29_97DF::parse("00:10:00;00"sv, tdf) && tdf.frame_index() == 17982);
+
+    // exact conversions between rates: 1 hour DF is 107892 * 1001 / 30000 = 3599.9964 seconds
+    assert(vcl::utils::Timecode25fps(Timecode29_97DF(1, 0, 0, 0)).frame_index() == 89999);
+    assert(vcl::utils::Timecode29_97fps(Timecode29_97DF(1, 0, 0, 0)).frame_index() == 107892);
+    assert(Timecode59_94DF(Timecode29_97DF(1, 0, 0, 0)) == Timecode29_97DF(1, 0, 0, 0));
+    assert(string(Timecode59_94DF(Timecode29_97DF(1, 0, 0, 0))) == "01:00:00;00"s);
+    assert(vcl::utils::Timecode30fps(1, 0, 0, 0) > Timecode29_97DF(1, 0, 0, 0));
+    assert(vcl::utils::Timecode30fps(0, 0, 0, 0) == Timecode29_97DF(0, 0, 0, 0));
+    assert(vcl::utils::Timecode29_97fps(0, 0, 0, 1) > vcl::utils::Timecode30fps(0, 0, 0, 1));
+
+    vcl::utils::Timecode23_976fps t23(1, 0, 0, 0);
+    assert(t23.frame_index() == 86400);
+    assert(t23.frame_s() == 3603.6);
+    assert(vcl::utils::Timecode24fps(t23) == vcl::utils::Timecode24fps(1, 0, 3, 14));
+    assert(vcl::utils::Timecode23_976fps(3603.6).frame_index() == 86400);
+    assert(vcl::utils::Timecode23_976fps(vcl::utils::Timecode24fps(1, 0, 3, 15)) == t23);
+
+    // full-range exhaustive drop-frame check
+    auto df_exhaustive_test = [](auto tc_type) {
+        using TC = decltype(tc_type);
+        constexpr unsigned long FPS = TC::FRAMES_PER_SECOND;
+        constexpr unsigned long DROPS = TC::DROPPED_FRAMES;
+
+        TC running;
+        unsigned long expected_index = 0;
+        for (unsigned int h = 0; h < 100; ++h)
+            for (unsigned int m = 0; m < 60; ++m)
+                for (unsigned int s = 0; s < 60; ++s)
+                    for (unsigned int f = (s == 0 && m % 10 != 0) ? DROPS : 0; f < FPS; ++f, ++expected_index, ++running) {
+                        assert(running.hh() == h && running.mm() == m && running.ss() == s && running.ff() == f);
+                        assert(running.frame_index() == expected_index);
+                        assert(TC(h, m, s, f) == running);
+                    }
+        assert(expected_index == TC::FRAMES_COUNT);
+        assert(running.is_error());
+    };
+    df_exhaustive_test(Timecode29_97DF());
+    df_exhaustive_test(Timecode59_94DF());
+}
+
+
+// multi-threaded stress test, timecodes being constructed, parsed and
+// formatted concurrently, with errors thrown from every thread
+{
+    constexpr unsigned int THREADS_COUNT = 8;
+    constexpr unsigned long LOOPS_COUNT = 20'000;
+    std::array<unsigned long, THREADS_COUNT> errors_counts{};
+    std::array<unsigned long, THREADS_COUNT> valid_counts{};
+    std::vector<std::thread> threads;
+
+    for (unsigned int t = 0; t < THREADS_COUNT; ++t)
+        threads.emplace_back([t, &errors_counts, &valid_counts]() {
+            char buffer[vcl::utils::Timecode29_97DF::TC_CHARS_SIZE];
+            for (unsigned long i = 0; i < LOOPS_COUNT; ++i) {
+                try {
+                    const vcl::utils::Timecode29_97DF tc(vcl::utils::Timecode25fps(i % 24, i % 61, i % 60, i % 25));
+                    const vcl::utils::Timecode29_97DF parsed(std::string(tc.to_chars(buffer)));
+                    valid_counts[t] += parsed == tc;
+                }
+                catch (std::invalid_argument&) {
+                    ++errors_counts[t];
+                }
+            }
+        });
+    for (auto& th : threads)
+        th.join();
+
+    for (unsigned int t = 0; t < THREADS_COUNT; ++t) {
+        assert(errors_counts[t] == LOOPS_COUNT / 61);  // i.e. minutes i % 61 == 60, with LOOPS_COUNT % 61 < 60
+        assert(valid_counts[t] + errors_counts[t] == LOOPS_COUNT);
+    }
+}
+
+
+// full-range exhaustive tests
+auto tc_exhaustive_test = [](auto tc_type) {
+    using TC = decltype(tc_type);
+    constexpr unsigned long FPS = TC::FRAMES_PER_SECOND;
+
+    TC running;
+    unsigned long expected_index = 0;
+    for (unsigned int h = 0; h < 100; ++h)
+        for (unsigned int m = 0; m < 60; ++m)
+            for (unsigned int s = 0; s < 60; ++s)
+                for (unsigned int f = 0; f < FPS; ++f, ++expected_index, ++running) {
+                    const TC tc(h, m, s, f);
+                    assert(tc.frame_index() == expected_index);
+                    assert(running == tc);
+                    assert(tc.hh() == h && tc.mm() == m && tc.ss() == s && tc.ff() == f);
+                    assert(vcl::utils::Timecode24fps(tc).frame_index() == (unsigned long)(expected_index * 24ull / FPS));
+                    assert(vcl::utils::Timecode30fps(tc).frame_index() == (unsigned long)(expected_index * 30ull / FPS));
+                    assert(vcl::utils::Timecode30fps(tc) <= tc);
+                    char buffer[TC::TC_CHARS_SIZE];
+                    TC parsed;
+                    assert(TC::parse(std::string_view(tc.to_chars(buffer), TC::TC_CHARS_SIZE - 1), parsed));
+                    assert(parsed == tc);
+                }
+    assert(expected_index == TC::FRAMES_COUNT);
+    assert(running.is_error());
+};
+tc_exhaustive_test(vcl::utils::Timecode24fps());
+tc_exhaustive_test(vcl::utils::Timecode25fps());
+tc_exhaustive_test(vcl::utils::Timecode30fps());
+
+
+// benchmarking of increments and comparisons
+{
+    constexpr unsigned long N = 5'000'000;
+    vcl::utils::Timecode25fps tc25;
+    vcl::utils::Timecode30fps tc30;
+    unsigned long lower_count = 0;
+
+    vcl::utils::PerfMeter tc_perf;
+    for (unsigned long i = 0; i < N; ++i)
+        ++tc25;
+    const double incr_ns = tc_perf.get_elapsed_s() * 1e9 / N;
+
+    tc_perf.start();
+    for (unsigned long i = 0; i < N; ++i, tc30 += 1)
+        lower_count += tc30 < tc25;
+    const double cmp_ns = tc_perf.get_elapsed_s() * 1e9 / N;
+
+    assert(lower_count == N);  // N frames @30fps are always less than N frames @25fps
+
+    char buffer[vcl::utils::Timecode25fps::TC_CHARS_SIZE];
+    unsigned long chars_sum = 0;
+    tc_perf.start();
+    for (unsigned long i = 0; i < N; ++i, --tc25)
+        chars_sum += tc25.to_chars(buffer)[10];
+    const double format_ns = tc_perf.get_elapsed_s() * 1e9 / N;
+
+    vcl::utils::Timecode25fps parsed;
+    unsigned long errors_count = 0;
+    tc_perf.start();
+    for (unsigned long i = 0; i < N; ++i) {
+        buffer[10] = char('0' + i % 10);
+        errors_count += !vcl::utils::Timecode25fps::parse(std::string_view(buffer, 11), parsed);
+    }
+    const double parse_ns = tc_perf.get_elapsed_s() * 1e9 / N;
+    assert(errors_count == 0 && chars_sum > 0);
+
+    cout << std::format("   Timecode increment: {:.2f} ns, cross-fps comparison: {:.2f} ns, formatting: {:.2f} ns, parsing: {:.2f} ns\n",
+                        incr_ns, cmp_ns, format_ns, parse_ns);
+}
+
 cout << "--- ALL TESTS PASSED ---" << endl << endl;
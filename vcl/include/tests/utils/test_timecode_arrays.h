@@ -0,0 +1,135 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on class vcl::utils::TimecodeArray. */
+
+cout << "## utils.timecode_arrays / vcl::utils::TimecodeArray testing application..." << endl;
+
+{
+    vcl::utils::TimecodeArray25fps tca;
+    assert(tca.empty());
+
+    tca.push_back(vcl::utils::Timecode25fps(1, 0, 0, 0));
+    tca.push_back(vcl::utils::Timecode25fps(0, 0, 1, 3));
+    tca.push_back(vcl::utils::Timecode25fps(99, 59, 59, 24) + 1);  // error
+    tca.push_back(vcl::utils::Timecode25fps(0, 30, 0, 0));
+    assert(tca.size() == 4);
+    assert(tca.index(1) == 28);
+    assert(tca[2].is_error());
+
+    std::array<vcl::utils::TimecodeComponents, 4> comps;
+    tca.to_components(comps);
+    assert(comps[0].hh == 1 && comps[0].mm == 0 && comps[0].ss == 0 && comps[0].ff == 0);
+    assert(comps[1].hh == 0 && comps[1].mm == 0 && comps[1].ss == 1 && comps[1].ff == 3);
+    assert(comps[2].hh == 0xff && comps[2].mm == 0xff && comps[2].ss == 0xff && comps[2].ff == 0xff);
+
+    std::array<std::array<char, 12>, 4> tc_chars;
+    tca.to_chars(tc_chars);
+    assert(string(tc_chars[0].data()) == "01:00:00:00"s);
+    assert(string(tc_chars[2].data()) == "--:--:--:--"s);
+    assert(string(tc_chars[3].data()) == "00:30:00:00"s);
+
+    tca.sort();
+    assert(tca.is_sorted());
+    assert(tca[0] == vcl::utils::Timecode25fps(0, 0, 1, 3));
+    assert(tca[3].is_error());
+    assert(tca.find(vcl::utils::Timecode25fps(0, 30, 0, 0)) == 1);
+    assert(tca.find(vcl::utils::Timecode25fps(0, 30, 0, 1)) == vcl::utils::TimecodeArray25fps::npos);
+    assert(tca.lower_bound(vcl::utils::Timecode25fps(0, 30, 0, 1)) == 2);
+    assert(tca.upper_bound(vcl::utils::Timecode25fps(0, 30, 0, 0)) == 2);
+
+    comps[0] = { 0, 0, 0, 25 };
+    comps[1] = { 10, 0, 0, 0 };
+    const std::size_t errors = tca.from_components(comps);
+    assert(errors == 2);
+    assert(tca[0].is_error());
+    assert(tca.index(1) == 10 * 3600 * 25);
+    assert(tca.index(2) == vcl::utils::TimecodeArray25fps::ERROR_INDEX);
+}
+
+
+// full-range bulk conversions vs. scalar Timecode ones
+auto tca_full_range_test = [](auto tca_type) {
+    using TCA = decltype(tca_type);
+    using TC = typename TCA::TimecodeType;
+
+    TCA tca(TC::FRAMES_COUNT);
+    for (unsigned long i = 0; i < TC::FRAMES_COUNT; ++i)
+        tca.index(i) = typename TCA::IndexT(i);
+
+    std::vector<vcl::utils::TimecodeComponents> comps(tca.size());
+    tca.to_components(comps);
+    for (unsigned long i = 0; i < TC::FRAMES_COUNT; i += 1 + i % 7) {
+        const TC tc = TC::from_frame_index(i);
+        assert(comps[i].hh == tc.hh() && comps[i].mm == tc.mm() && comps[i].ss == tc.ss() && comps[i].ff == tc.ff());
+    }
+
+    TCA back(tca.size());
+    const std::size_t errors = back.from_components(comps);
+    assert(errors == 0);
+    for (unsigned long i = 0; i < TC::FRAMES_COUNT; ++i)
+        assert(back.index(i) == i);
+};
+tca_full_range_test(vcl::utils::TimecodeArray25fps());
+tca_full_range_test(vcl::utils::TimecodeArray30fps());
+tca_full_range_test(vcl::utils::TimecodeArray29_97DF());
+tca_full_range_test(vcl::utils::TimecodeArray59_94DF());
+
+
+// benchmarking of bulk vs. scalar conversions
+{
+    constexpr std::size_t N = 1'000'000;
+    vcl::utils::TimecodeArray29_97DF tca(N);
+    for (std::size_t i = 0; i < N; ++i)
+        tca.index(i) = vcl::utils::TimecodeArray29_97DF::IndexT((i * 7919) % vcl::utils::Timecode29_97DF::FRAMES_COUNT);
+    std::vector<vcl::utils::TimecodeComponents> comps(N);
+
+    vcl::utils::PerfMeter tca_perf;
+    for (std::size_t i = 0; i < N; ++i) {
+        const vcl::utils::Timecode29_97DF tc = tca[i];
+        comps[i] = { tc.hh(), tc.mm(), tc.ss(), tc.ff() };
+    }
+    const double scalar_ns = tca_perf.get_elapsed_s() * 1e9 / N;
+
+    tca_perf.start();
+    tca.to_components(comps);
+    const double bulk_ns = tca_perf.get_elapsed_s() * 1e9 / N;
+
+    tca_perf.start();
+    const std::size_t errors = tca.from_components(comps);
+    const double back_ns = tca_perf.get_elapsed_s() * 1e9 / N;
+
+    tca_perf.start();
+    tca.sort();
+    const double sort_ns = tca_perf.get_elapsed_s() * 1e9 / N;
+    assert(errors == 0);
+
+    cout << std::format("   29.97DF index->components: scalar {:.2f} ns, bulk {:.2f} ns, components->index: bulk {:.2f} ns, sort: {:.2f} ns\n",
+                        scalar_ns, bulk_ns, back_ns, sort_ns);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,163 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on classes vcl::utils::TimecodeRange and vcl::utils::TimecodeRangeIndex. */
+
+cout << "## utils.timecode_ranges / vcl::utils::TimecodeRange testing application..." << endl;
+
+{
+    using vcl::utils::Timecode25fps;
+    using vcl::utils::TimecodeRange25fps;
+
+    TimecodeRange25fps r0;
+    assert(r0.empty());
+    assert(r0.duration() == 0);
+
+    TimecodeRange25fps r1(Timecode25fps(0, 0, 10, 0), Timecode25fps(0, 0, 20, 0));
+    assert(r1.duration() == 250);
+    assert(r1.contains(Timecode25fps(0, 0, 10, 0)));
+    assert(r1.contains(Timecode25fps(0, 0, 19, 24)));
+    assert(!r1.contains(Timecode25fps(0, 0, 20, 0)));
+    assert(string(r1.start()) == "00:00:10:00"s);
+    assert(string(r1.end()) == "00:00:20:00"s);
+
+    TimecodeRange25fps r2(Timecode25fps(0, 0, 19, 0), 50);
+    assert(r2.end_index() == 20 * 25 + 25);
+    assert(r1.overlaps(r2) && r2.overlaps(r1));
+    assert(r1.intersection(r2) == TimecodeRange25fps(Timecode25fps(0, 0, 19, 0), Timecode25fps(0, 0, 20, 0)));
+    assert(!r1.overlaps(TimecodeRange25fps(Timecode25fps(0, 0, 20, 0), 10)));
+    assert(r1.intersection(TimecodeRange25fps(Timecode25fps(0, 0, 20, 0), 10)).empty());
+    assert(r1.contains(TimecodeRange25fps(Timecode25fps(0, 0, 12, 0), 25)));
+
+    try {
+        TimecodeRange25fps rerr(Timecode25fps(0, 0, 20, 0), Timecode25fps(0, 0, 10, 0));
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+
+    // durations up to the very last frame of hour 99, never past it nor wrapping around
+    const Timecode25fps last(99, 59, 59, 24);
+    assert(TimecodeRange25fps(last, 1).end_index() == Timecode25fps::FRAMES_COUNT);
+    assert(TimecodeRange25fps(last, 1).end().is_error());
+    for (const unsigned long frames_count : { 2ul, std::numeric_limits<unsigned long>::max() }) {
+        try {
+            TimecodeRange25fps rerr(last, frames_count);
+            assert(false);
+        }
+        catch (std::invalid_argument& e) {
+            assert(std::string(e.what()).starts_with("TR002"));
+        }
+    }
+}
+
+
+// interval index vs. linear scans
+{
+    using vcl::utils::TimecodeRange25fps;
+
+    vcl::utils::TimecodeRangeIndex25fps empty_index;
+    std::vector<std::size_t> ids;
+    assert(empty_index.active_at(0ul, ids) == 0);
+
+    std::vector<TimecodeRange25fps> ranges;
+    unsigned long seed = 12345;
+    auto rnd = [&seed]() { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (unsigned long)(seed >> 33); };
+    for (std::size_t n : { 1, 2, 3, 7, 16, 17, 100, 1000, 4097 }) {
+        ranges.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            const unsigned long start = rnd() % 100'000;
+            ranges.push_back(TimecodeRange25fps::from_frame_indexes(start, start + rnd() % 2'000));
+        }
+        const vcl::utils::TimecodeRangeIndex25fps index(ranges);
+        assert(index.size() == n);
+
+        for (int q = 0; q < 200; ++q) {
+            const unsigned long start = rnd() % 102'000;
+            const TimecodeRange25fps query = TimecodeRange25fps::from_frame_indexes(start, start + rnd() % 500);
+
+            ids.clear();
+            index.overlapping(query, ids);
+            std::sort(ids.begin(), ids.end());
+
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i < n; ++i)
+                if (ranges[i].overlaps(query))
+                    expected.push_back(i);
+            assert(ids == expected);
+
+            ids.clear();
+            index.active_at(start, ids);
+            std::size_t active_count = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                active_count += ranges[i].contains(start);
+            assert(ids.size() == active_count);
+        }
+    }
+}
+
+
+// benchmarking with 1M intervals
+{
+    using vcl::utils::TimecodeRange25fps;
+    constexpr std::size_t N = 1'000'000;
+    constexpr std::size_t Q = 1'000;
+
+    std::vector<TimecodeRange25fps> ranges;
+    ranges.reserve(N);
+    unsigned long seed = 67890;
+    auto rnd = [&seed]() { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (unsigned long)(seed >> 33); };
+    for (std::size_t i = 0; i < N; ++i) {
+        const unsigned long start = rnd() % (vcl::utils::Timecode25fps::FRAMES_COUNT - 10'000);
+        ranges.push_back(TimecodeRange25fps::from_frame_indexes(start, start + 1 + rnd() % 5'000));
+    }
+
+    vcl::utils::PerfMeter tcr_perf;
+    const vcl::utils::TimecodeRangeIndex25fps index(ranges);
+    const double build_ms = tcr_perf.get_elapsed_ms();
+
+    std::vector<std::size_t> ids;
+    std::size_t found_count = 0;
+    tcr_perf.start();
+    for (std::size_t q = 0; q < Q; ++q) {
+        ids.clear();
+        found_count += (q < Q / 10) * index.active_at((unsigned long)(q * 8'999), ids);
+    }
+    const double query_us = tcr_perf.get_elapsed_s() * 1e6 / Q;
+
+    std::size_t scan_count = 0;
+    tcr_perf.start();
+    for (std::size_t q = 0; q < Q / 10; ++q)
+        for (const TimecodeRange25fps& r : ranges)
+            scan_count += r.contains((unsigned long)(q * 8'999));
+    const double scan_us = tcr_perf.get_elapsed_s() * 1e6 / (Q / 10);
+
+    assert(found_count == scan_count);
+    cout << std::format("   1M ranges: build {:.1f} ms, active-at query {:.2f} us, linear scan {:.2f} us\n",
+                        build_ms, query_us, scan_us);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
@@ -0,0 +1,121 @@
+#pragma once
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+/** \brief main for tests on classes vcl::utils::TraceSink and vcl::utils::TraceScope. */
+
+cout << "## utils.traces / vcl::utils::TraceSink testing application..." << endl;
+
+{
+    using vcl::utils::TraceSink;
+    using vcl::utils::TraceScope;
+
+    const char* TRACE_PATH = "vcl_test_trace.json";
+
+    // not running: events are ignored
+    assert(!TraceSink::is_running());
+    TraceSink::instant("ignored");
+
+    assert(TraceSink::start(TRACE_PATH, 5));
+    assert(TraceSink::is_running());
+    assert(!TraceSink::start(TRACE_PATH));
+
+    constexpr int THREADS_COUNT = 4;
+    constexpr int FRAMES_COUNT = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS_COUNT; ++t)
+        threads.emplace_back([t]() {
+            vcl::utils::Timecode25fps tc(0, 0, 0, 0);
+            for (int f = 0; f < FRAMES_COUNT; ++f, ++tc) {
+                TraceScope frame_scope("frame", tc, "pipeline");
+                {
+                    TraceScope decode_scope("decode");
+                }
+                TraceSink::counter("queue", f % 8);
+            }
+            if (t == 0)
+                TraceSink::instant("done", tc);
+        });
+    for (auto& th : threads)
+        th.join();
+
+    TraceSink::stop();
+    assert(!TraceSink::is_running());
+    assert(TraceSink::dropped_events() == 0);
+    assert(TraceSink::buffers_count() == 0);  // the buffers of ended threads are freed once flushed
+
+    std::ifstream in(TRACE_PATH);
+    const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    auto count_of = [&json](const std::string& pattern) {
+        std::size_t n = 0;
+        for (std::size_t pos = json.find(pattern); pos != std::string::npos; pos = json.find(pattern, pos + 1))
+            ++n;
+        return n;
+    };
+    assert(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    assert(json.ends_with("]}\n"));
+    assert(count_of("\"ph\":\"B\"") == 2 * THREADS_COUNT * FRAMES_COUNT);
+    assert(count_of("\"ph\":\"E\"") == 2 * THREADS_COUNT * FRAMES_COUNT);
+    assert(count_of("\"ph\":\"C\"") == THREADS_COUNT * FRAMES_COUNT);
+    assert(count_of("\"name\":\"done\"") == 1);
+    assert(count_of("\"timecode\":\"00:00:39:24\"") == THREADS_COUNT);
+    assert(count_of("\"timecode\":\"00:00:40:00\"") == 1);
+    assert(count_of("ignored") == 0);
+    assert(count_of("\"tid\":") == 5 * THREADS_COUNT * FRAMES_COUNT + 1);
+
+    // threads that keep being created and ended while running get their buffers freed
+    assert(TraceSink::start(TRACE_PATH, 1));
+    for (int t = 0; t < 16; ++t)
+        std::thread([]() { TraceSink::instant("short_lived"); }).join();
+    while (TraceSink::buffers_count() > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    TraceSink::stop();
+    std::ifstream short_lived_in(TRACE_PATH);
+    const std::string short_lived_json((std::istreambuf_iterator<char>(short_lived_in)), std::istreambuf_iterator<char>());
+    short_lived_in.close();
+    for (int tid = THREADS_COUNT + 1; tid <= THREADS_COUNT + 16; ++tid)
+        assert(short_lived_json.find(std::format("\"tid\":{},", tid)) != std::string::npos);
+
+    // full buffers: events are dropped, never blocking
+    assert(TraceSink::start(TRACE_PATH, 60'000));
+    vcl::utils::PerfMeter perf;
+    constexpr int N = 10'000;
+    for (int i = 0; i < N; ++i) {
+        TraceScope scope("overhead");
+    }
+    const double overhead_ns = perf.get_elapsed_s() * 1e9 / N;
+    for (int i = 0; i < 20'000; ++i)
+        TraceSink::counter("overflow", i);
+    TraceSink::stop();
+    assert(TraceSink::dropped_events() == 2 * N + 20'000 - (1 << 14));
+    cout << std::format("   trace scope overhead: {:.1f} ns\n", overhead_ns);
+
+    std::remove(TRACE_PATH);
+}
+
+cout << "--- ALL TESTS PASSED ---" << endl << endl;
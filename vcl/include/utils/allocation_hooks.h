@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+/** \brief Global operators new replacements for the tracking of allocations.
+*
+* To be included in exactly one translation unit of the application, e.g.
+* the one of main(), when VCL_ALLOC_TRACKING is defined. Every heap
+* allocation is then accounted to the current vcl::utils::AllocationSite,
+* or to "(outside vcl)", including those done by std containers returned
+* by vcl functions. Replacement functions must be attached to the global
+* module: they cannot be defined in module utils.allocations.
+*/
+#pragma once
+
+#if defined(VCL_ALLOC_TRACKING)
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#   include <malloc.h>
+#endif
+
+import utils.allocations;
+
+
+void* operator new(std::size_t size)
+{
+    vcl::utils::AllocationTracker::record(size);
+    if (void* p = std::malloc(size > 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    vcl::utils::AllocationTracker::record(size);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ::operator new(size, std::nothrow);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    vcl::utils::AllocationTracker::record(size);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_MSC_VER)
+    if (void* p = _aligned_malloc(size > 0 ? size : 1, align))
+        return p;
+#else
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align + (size == 0 ? align : 0)))
+        return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+#endif // VCL_ALLOC_TRACKING
@@ -0,0 +1,439 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define VCL_SSE2_AVAILABLE
+#   include <emmintrin.h>
+#endif
+
+export module frames.blending;
+
+import frames.frame;
+import frames.frame_workers;
+import frames.pixels;
+import graphitems.rect;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The blend modes of premultiplied-alpha pixels, src being blended onto dst.
+    * Formulas apply to the four channels, alpha included, M being the
+    * maximum value of channels and divisions by M being exactly rounded.
+    */
+    export enum BlendMode : unsigned char
+    {
+        BLEND_OVER = 0,     //!< Porter-Duff src over dst: s + d * (M - sa) / M.
+        BLEND_ADD,          //!< s + d, saturated.
+        BLEND_MULTIPLY,     //!< (s * (d + M - da) + d * (M - sa)) / M, i.e. s * d plus the parts of s and d out of the other one.
+        BLEND_SCREEN        //!< s + d - s * d / M.
+    };
+
+    /** \brief The concept of the pixels that get blended: 8 or 16 bits per channel, with alpha - RGBA32, BGRA32 and RGBA64. */
+    export template<typename P>
+    concept BlendPixel = PackedPixel<P> && P::HAS_ALPHA && P::ALPHA_INDEX == 3 &&
+                         (P::BITS_DEPTH == 8 || P::BITS_DEPTH == 16) && P::BITS_DEPTH == 8 * sizeof(typename P::ChannelType);
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Returns x / M rounded to the nearest, M being 2^Kbits - 1. Exact for x in [0, M * M]. */
+    template<const unsigned Kbits>
+    inline constexpr std::uint32_t _div_max(const std::uint32_t x) noexcept
+    {
+        const std::uint32_t y = x + (1u << (Kbits - 1));
+        return (y + (y >> Kbits)) >> Kbits;
+    }
+
+    /** \brief Returns premultiplied pixel s blended onto premultiplied pixel d. The reference of the SIMD kernels. */
+    template<const BlendMode Kmode, typename P>
+    inline P _blend_pixel(const P& s, const P& d) noexcept
+    {
+        using TChannel = typename P::ChannelType;
+        constexpr unsigned BITS = P::BITS_DEPTH;
+        constexpr std::uint32_t M = P::MAX_VALUE;
+
+        const std::uint32_t sa = s.channels[3], da = d.channels[3];
+        P out;
+        for (std::size_t c = 0; c < 4; ++c) {
+            const std::uint32_t sc = s.channels[c], dc = d.channels[c];
+            std::uint32_t v;
+            if constexpr (Kmode == BLEND_OVER)
+                v = sc + _div_max<BITS>(dc * (M - sa));
+            else if constexpr (Kmode == BLEND_ADD)
+                v = sc + dc;
+            else if constexpr (Kmode == BLEND_MULTIPLY)
+                v = _div_max<BITS>(sc * (dc + M - da) + dc * (M - sa));
+            else
+                v = sc + dc - _div_max<BITS>(sc * dc);
+            out.channels[c] = TChannel(std::min(v, M));
+        }
+        return out;
+    }
+
+
+#if defined(VCL_SSE2_AVAILABLE)
+    /** \brief Returns a * b / M per 16-bit lane, exactly rounded, M being 2^Kbits - 1. */
+    template<const unsigned Kbits>
+    inline __m128i _mul_div_sse2(const __m128i a, const __m128i b) noexcept
+    {
+        if constexpr (Kbits == 8) {
+            // products of 8-bits values fit 16-bits lanes
+            const __m128i y = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(y, _mm_srli_epi16(y, 8)), 8);
+        }
+        else {
+            const __m128i lo = _mm_mullo_epi16(a, b);
+            const __m128i hi = _mm_mulhi_epu16(a, b);
+            const __m128i half = _mm_set1_epi32(32768);
+            __m128i y0 = _mm_add_epi32(_mm_unpacklo_epi16(lo, hi), half);
+            __m128i y1 = _mm_add_epi32(_mm_unpackhi_epi16(lo, hi), half);
+            y0 = _mm_srli_epi32(_mm_add_epi32(y0, _mm_srli_epi32(y0, 16)), 16);
+            y1 = _mm_srli_epi32(_mm_add_epi32(y1, _mm_srli_epi32(y1, 16)), 16);
+            // unsigned packing with no SSE4.1 _mm_packus_epi32()
+            const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(y0, half), _mm_sub_epi32(y1, half));
+            return _mm_xor_si128(packed, _mm_set1_epi16(short(0x8000)));
+        }
+    }
+
+    /** \brief Returns (a * b + c * d) / M per 16-bit lane, exactly rounded, M being 2^Kbits - 1. */
+    template<const unsigned Kbits>
+    inline __m128i _mul2_div_sse2(const __m128i a, const __m128i b, const __m128i c, const __m128i d) noexcept
+    {
+        if constexpr (Kbits == 8) {
+            const __m128i y = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(a, b), _mm_mullo_epi16(c, d)), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(y, _mm_srli_epi16(y, 8)), 8);
+        }
+        else {
+            const __m128i ab_lo = _mm_mullo_epi16(a, b), ab_hi = _mm_mulhi_epu16(a, b);
+            const __m128i cd_lo = _mm_mullo_epi16(c, d), cd_hi = _mm_mulhi_epu16(c, d);
+            const __m128i half = _mm_set1_epi32(32768);
+            __m128i y0 = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(ab_lo, ab_hi), _mm_unpacklo_epi16(cd_lo, cd_hi)), half);
+            __m128i y1 = _mm_add_epi32(_mm_add_epi32(_mm_unpackhi_epi16(ab_lo, ab_hi), _mm_unpackhi_epi16(cd_lo, cd_hi)), half);
+            y0 = _mm_srli_epi32(_mm_add_epi32(y0, _mm_srli_epi32(y0, 16)), 16);
+            y1 = _mm_srli_epi32(_mm_add_epi32(y1, _mm_srli_epi32(y1, 16)), 16);
+            const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(y0, half), _mm_sub_epi32(y1, half));
+            return _mm_xor_si128(packed, _mm_set1_epi16(short(0x8000)));
+        }
+    }
+
+    /** \brief Returns the alphas of the two pixels of 16-bits lanes s broadcast to their four lanes. */
+    inline __m128i _alphas_sse2(const __m128i s) noexcept
+    {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    /** \brief Returns the two pixels of 16-bits lanes s blended onto the two ones of d. Bit-exact with _blend_pixel(). */
+    template<const BlendMode Kmode, const unsigned Kbits>
+    inline __m128i _blend_lanes_sse2(const __m128i s, const __m128i d) noexcept
+    {
+        const __m128i max_value = _mm_set1_epi16(short((1u << Kbits) - 1));
+        if constexpr (Kmode == BLEND_OVER)
+            return _mm_adds_epu16(s, _mul_div_sse2<Kbits>(d, _mm_sub_epi16(max_value, _alphas_sse2(s))));
+        else if constexpr (Kmode == BLEND_ADD)
+            return _mm_adds_epu16(s, d);
+        else if constexpr (Kmode == BLEND_MULTIPLY)
+            return _mul2_div_sse2<Kbits>(s, _mm_sub_epi16(_mm_add_epi16(d, max_value), _alphas_sse2(d)),
+                                         d, _mm_sub_epi16(max_value, _alphas_sse2(s)));
+        else  // s * d / M <= d, so that no lane wraps
+            return _mm_add_epi16(s, _mm_sub_epi16(d, _mul_div_sse2<Kbits>(s, d)));
+    }
+
+    /** \brief Returns the 16 bytes of pixels s blended onto the 16 bytes of pixels d. */
+    template<const BlendMode Kmode, typename P>
+    inline __m128i _blend_block_sse2(const __m128i s, const __m128i d) noexcept
+    {
+        if constexpr (P::BITS_DEPTH == 8) {
+            if constexpr (Kmode == BLEND_ADD)
+                return _mm_adds_epu8(s, d);
+            const __m128i zero = _mm_setzero_si128();
+            return _mm_packus_epi16(_blend_lanes_sse2<Kmode, 8>(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero)),
+                                    _blend_lanes_sse2<Kmode, 8>(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero)));
+        }
+        else
+            return _blend_lanes_sse2<Kmode, 16>(s, d);
+    }
+
+    /** \brief Returns true if the alphas of the 16 bytes of pixels s are all opaque. */
+    template<typename P>
+    inline bool _is_opaque_sse2(const __m128i s) noexcept
+    {
+        constexpr int ALPHAS_MASK = P::BITS_DEPTH == 8 ? 0x8888 : 0xc0c0;
+        return (_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8(-1))) & ALPHAS_MASK) == ALPHAS_MASK;
+    }
+#endif
+
+
+    //-----------------------------------------------------------------------
+    /** \brief Blends count pixels of src onto dst.
+    * Blocks of transparent src pixels leave dst unchanged whatever the
+    * mode. Over runs of opaque src pixels, src over dst is src: these runs
+    * are copied at once, so that blending opaque rows is a row copy.
+    */
+    template<const BlendMode Kmode, const bool Ksimd, typename P>
+    void _blend_row(const P* src, P* dst, const std::size_t count) noexcept
+    {
+        std::size_t x = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (Ksimd) {
+            constexpr std::size_t STEP = 16 / sizeof(P);
+            const __m128i zero = _mm_setzero_si128();
+            while (x + STEP <= count) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+                if constexpr (Kmode == BLEND_OVER) {
+                    if (_is_opaque_sse2<P>(s)) {
+                        std::size_t end = x + STEP;
+                        while (end + STEP <= count && _is_opaque_sse2<P>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + end))))
+                            end += STEP;
+                        std::memmove(dst + x, src + x, (end - x) * sizeof(P));
+                        x = end;
+                        continue;
+                    }
+                }
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(s, zero)) != 0xffff) {
+                    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _blend_block_sse2<Kmode, P>(s, d));
+                }
+                x += STEP;
+            }
+        }
+#endif
+        for (; x < count; ++x)
+            dst[x] = _blend_pixel<Kmode>(src[x], dst[x]);
+    }
+
+    /** \brief Blends the width x height pixels of src from (src_x, src_y) onto dst from (dst_x, dst_y). */
+    template<const bool Ksimd, typename P>
+    void _blend(const FrameT<P>& src, FrameT<P>& dst, const std::size_t src_x, const std::size_t src_y,
+                const std::size_t dst_x, const std::size_t dst_y, const std::size_t width, const std::size_t height,
+                const BlendMode mode, FrameWorkers* workers)
+    {
+        if (width == 0 || height == 0)
+            return;
+        for_rows_bands(height, dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row) {
+                const P* const s = src.row(src_y + row) + src_x;
+                P* const d = dst.row(dst_y + row) + dst_x;
+                switch (mode) {
+                case BLEND_OVER:     _blend_row<BLEND_OVER, Ksimd>(s, d, width);     break;
+                case BLEND_ADD:      _blend_row<BLEND_ADD, Ksimd>(s, d, width);      break;
+                case BLEND_MULTIPLY: _blend_row<BLEND_MULTIPLY, Ksimd>(s, d, width); break;
+                default:             _blend_row<BLEND_SCREEN, Ksimd>(s, d, width);   break;
+                }
+            }
+        });
+    }
+
+    /** \brief Blends src onto rect of dst, src top-left pixel going to rect top-left corner, clipped to rect, src and dst. */
+    template<const bool Ksimd, typename P, typename T>
+    void _blend_rect(const FrameT<P>& src, FrameT<P>& dst, const vcl::graphitems::RectT<T>& rect, const BlendMode mode,
+                     FrameWorkers* workers)
+    {
+        const long long x0 = (long long)rect.x;
+        const long long y0 = (long long)rect.y;
+        const long long left   = std::max(0LL, x0);
+        const long long top    = std::max(0LL, y0);
+        const long long right  = std::min({ (long long)dst.width(), x0 + (long long)rect.width, x0 + (long long)src.width() });
+        const long long bottom = std::min({ (long long)dst.height(), y0 + (long long)rect.height, y0 + (long long)src.height() });
+        if (left < right && top < bottom)
+            _blend<Ksimd>(src, dst, std::size_t(left - x0), std::size_t(top - y0), std::size_t(left), std::size_t(top),
+                          std::size_t(right - left), std::size_t(bottom - top), mode, workers);
+    }
+
+
+    //===================================================================
+    /** \brief Blends the premultiplied-alpha pixels of src onto the ones of dst, same sized.
+    * Results are exactly rounded, and are the same whatever the SIMD path
+    * and the count of workers threads. With BLEND_MULTIPLY, colors must
+    * not exceed their alpha, as premultiplied colors never do. src and dst
+    * may be the same frame. Rows are processed by workers if any, the
+    * calling thread waiting for them - so it must not be one of them.
+    * Throws std::invalid_argument if dimensions differ.
+    */
+    export template<BlendPixel P>
+    void blend(const FrameT<P>& src, FrameT<P>& dst, const BlendMode mode = BLEND_OVER, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for blending.");
+        _blend<true>(src, dst, 0, 0, 0, 0, src.width(), src.height(), mode, workers);
+    }
+
+    /** \brief Blends the premultiplied-alpha pixels of overlay src onto rect of dst.
+    * The top-left pixel of src goes to the top-left corner of rect, the
+    * blended region being clipped to rect, to src and to dst - so that
+    * nothing gets blended out of their overlap.
+    */
+    export template<BlendPixel P, typename T>
+        requires std::is_arithmetic_v<T>
+    inline void blend(const FrameT<P>& src, FrameT<P>& dst, const vcl::graphitems::RectT<T>& rect, const BlendMode mode = BLEND_OVER,
+                      FrameWorkers* workers = nullptr)
+    {
+        _blend_rect<true>(src, dst, rect, mode, workers);
+    }
+
+    /** \brief Blends src onto dst, with no SIMD. The reference of blend(), which gets the same results. */
+    export template<BlendPixel P>
+    void blend_scalar(const FrameT<P>& src, FrameT<P>& dst, const BlendMode mode = BLEND_OVER, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for blending.");
+        _blend<false>(src, dst, 0, 0, 0, 0, src.width(), src.height(), mode, workers);
+    }
+
+    /** \brief Blends src onto rect of dst, with no SIMD. The reference of blend(), which gets the same results. */
+    export template<BlendPixel P, typename T>
+        requires std::is_arithmetic_v<T>
+    inline void blend_scalar(const FrameT<P>& src, FrameT<P>& dst, const vcl::graphitems::RectT<T>& rect, const BlendMode mode = BLEND_OVER,
+                             FrameWorkers* workers = nullptr)
+    {
+        _blend_rect<false>(src, dst, rect, mode, workers);
+    }
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Premultiplies count pixels of src by their alpha into dst: c * a / M, exactly rounded. */
+    template<typename P>
+    void _premultiply_row(const P* src, P* dst, const std::size_t count) noexcept
+    {
+        using TChannel = typename P::ChannelType;
+        constexpr unsigned BITS = P::BITS_DEPTH;
+
+        std::size_t x = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        // alphas multiply colors, and M multiplies alphas so that they are kept
+        const __m128i colors_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+        const __m128i alphas_max = _mm_set_epi16(short(P::MAX_VALUE), 0, 0, 0, short(P::MAX_VALUE), 0, 0, 0);
+        auto premultiplied = [&](const __m128i v) {
+            return _mul_div_sse2<BITS>(v, _mm_or_si128(_mm_and_si128(_alphas_sse2(v), colors_mask), alphas_max));
+        };
+        for (; x + 16 / sizeof(P) <= count; x += 16 / sizeof(P)) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+            if constexpr (BITS == 8) {
+                const __m128i zero = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(premultiplied(_mm_unpacklo_epi8(v, zero)),
+                                                                                      premultiplied(_mm_unpackhi_epi8(v, zero))));
+            }
+            else
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), premultiplied(v));
+        }
+#endif
+        for (; x < count; ++x) {
+            const P p = src[x];
+            const std::uint32_t a = p.channels[3];
+            P q;
+            for (std::size_t c = 0; c < 3; ++c)
+                q.channels[c] = TChannel(_div_max<BITS>(p.channels[c] * a));
+            q.channels[3] = TChannel(a);
+            dst[x] = q;
+        }
+    }
+
+    /** \brief Returns the table of 8-bits unpremultiplied colors, indexed by alpha * 256 + color: c * 255 / a, rounded and saturated. */
+    consteval std::array<std::uint8_t, 256 * 256> _unpremultiply_table() noexcept
+    {
+        std::array<std::uint8_t, 256 * 256> table{};
+        for (std::uint32_t a = 1; a < 256; ++a)
+            for (std::uint32_t c = 0; c < 256; ++c)
+                table[a * 256 + c] = std::uint8_t(std::min<std::uint32_t>(255, (c * 255 + a / 2) / a));
+        return table;
+    }
+
+    /** \brief The 8-bits unpremultiplied colors per alpha, SSE2 having no gather for per-lane divisions. */
+    inline constexpr std::array<std::uint8_t, 256 * 256> _UNPREMULTIPLY_8 = _unpremultiply_table();
+
+    /** \brief Unpremultiplies count pixels of src by their alpha into dst: c * M / a, rounded and saturated, 0 if a is 0. */
+    template<typename P>
+    void _unpremultiply_row(const P* src, P* dst, const std::size_t count) noexcept
+    {
+        using TChannel = typename P::ChannelType;
+        constexpr std::uint64_t M = P::MAX_VALUE;
+
+        for (std::size_t x = 0; x < count; ++x) {
+            P p = src[x];
+            const std::uint32_t a = p.channels[3];
+            if (a != M) {
+                if constexpr (P::BITS_DEPTH == 8) {
+                    const std::uint8_t* const colors = _UNPREMULTIPLY_8.data() + a * 256;
+                    for (std::size_t c = 0; c < 3; ++c)
+                        p.channels[c] = colors[p.channels[c]];
+                }
+                else {
+                    for (std::size_t c = 0; c < 3; ++c)
+                        p.channels[c] = a == 0 ? TChannel(0) : TChannel(std::min<std::uint64_t>(M, (p.channels[c] * M + a / 2) / a));
+                }
+            }
+            dst[x] = p;
+        }
+    }
+
+    //===================================================================
+    /** \brief Premultiplies the colors of src by their alpha into dst, alpha being kept.
+    * src and dst may be the same frame. Rows are processed by workers if
+    * any, the calling thread waiting for them - so it must not be one of
+    * them. Throws std::invalid_argument if dimensions differ.
+    */
+    export template<BlendPixel P>
+    void premultiply(const FrameT<P>& src, FrameT<P>& dst, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for premultiplying.");
+        for_rows_bands(src.height(), dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                _premultiply_row(src.row(row), dst.row(row), src.width());
+        });
+    }
+
+    /** \brief Divides the premultiplied colors of src by their alpha into dst, alpha being kept.
+    * Colors of transparent pixels get 0. Opaque pixels are copied, 8-bits
+    * colors being looked up in a table per alpha. src and dst may be the
+    * same frame. Rows are processed by workers if any, the calling thread
+    * waiting for them - so it must not be one of them. Throws
+    * std::invalid_argument if dimensions differ.
+    */
+    export template<BlendPixel P>
+    void unpremultiply(const FrameT<P>& src, FrameT<P>& dst, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for unpremultiplying.");
+        for_rows_bands(src.height(), dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                _unpremultiply_row(src.row(row), dst.row(row), src.width());
+        });
+    }
+
+}
@@ -0,0 +1,351 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define VCL_SSE2_AVAILABLE
+#   include <emmintrin.h>
+#endif
+
+export module frames.chroma_resampling;
+
+import frames.frame;
+import frames.frame_workers;
+import frames.yuv_frames;
+import utils.allocations;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The filters of chroma resampling. */
+    export enum ChromaFilter : unsigned char
+    {
+        CHROMA_NEAREST = 0,  //!< the nearest chroma sample, no filtering.
+        CHROMA_BILINEAR      //!< the linear interpolation - or the triangle filter when downsampling - of the nearest chroma samples.
+    };
+
+    /** \brief The sitings of subsampled chroma samples relatively to luma ones. */
+    export enum ChromaSiting : unsigned char
+    {
+        SITING_COSITED = 0,  //!< chroma samples at the positions of even luma samples.
+        SITING_INTERSTITIAL  //!< chroma samples midway between even and odd luma samples.
+    };
+
+    /** \brief The options of chroma resampling.
+    * Defaults are the ones of H.264 and HEVC 4:2:0 video: chroma cosited
+    * horizontally, interstitial vertically.
+    */
+    export struct ChromaResampling
+    {
+        ChromaFilter filter{ CHROMA_BILINEAR };
+        ChromaSiting x_siting{ SITING_COSITED };
+        ChromaSiting y_siting{ SITING_INTERSTITIAL };
+    };
+
+    /** \brief The width of the tiles of chroma resampling, in output chroma samples. Intermediate lines of tiles stay in L1 caches. */
+    export inline constexpr std::size_t CHROMA_TILE_WIDTH = 512;
+
+    /** \brief The concept of pairs of YUV frames types whose chroma planes are resampled one into the other. */
+    export template<typename FSrc, typename FDst>
+    concept ChromaResamplable = YuvFrame<FSrc> && YuvFrame<FDst> &&
+                                std::is_same_v<typename FSrc::SampleType, typename FDst::SampleType> &&
+                                FSrc::BITS_DEPTH == FDst::BITS_DEPTH && FSrc::SAMPLES_SHIFT == FDst::SAMPLES_SHIFT &&
+                                FSrc::SUBSAMPLING.x_shift <= 1 && FSrc::SUBSAMPLING.y_shift <= 1 &&
+                                FDst::SUBSAMPLING.x_shift <= 1 && FDst::SUBSAMPLING.y_shift <= 1;
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief The taps of the resampling of chroma along one axis.
+    * Output sample j is the weighted sum of the input samples c-1, c and
+    * c+1, c being its center() and the weights being the ones of its
+    * phase(), then shifted right by shift.
+    */
+    struct _AxisTaps
+    {
+        int          ratio;          //!< 1 when downsampling by 2, -1 when upsampling by 2, 0 else.
+        std::uint8_t weights[2][3];  //!< the weights of the samples c-1, c and c+1, per phase.
+        unsigned     shift;          //!< the log2 of the sum of weights.
+
+        /** \brief Returns the index of the input sample at the center of output sample j. */
+        inline constexpr std::size_t center(const std::size_t j) const noexcept
+        {
+            return ratio > 0 ? 2 * j : ratio < 0 ? j >> 1 : j;
+        }
+
+        /** \brief Returns the phase of output sample j. */
+        inline constexpr unsigned phase(const std::size_t j) const noexcept
+        {
+            return ratio < 0 ? unsigned(j & 1) : 0;
+        }
+    };
+
+    /** \brief Returns the taps of the resampling of chroma subsampled by 2^src_shift into chroma subsampled by 2^dst_shift. */
+    inline constexpr _AxisTaps _axis_taps(const unsigned src_shift, const unsigned dst_shift, const ChromaFilter filter, const ChromaSiting siting) noexcept
+    {
+        if (src_shift == dst_shift)
+            return _AxisTaps{ 0, { { 0, 1, 0 }, { 0, 1, 0 } }, 0 };
+
+        const bool bilinear = filter == CHROMA_BILINEAR;
+        if (dst_shift > src_shift) {
+            // downsampling, outputs at 2j (cosited) or 2j + 1/2 (interstitial)
+            if (!bilinear)
+                return _AxisTaps{ 1, { { 0, 1, 0 }, { 0, 1, 0 } }, 0 };
+            return siting == SITING_COSITED ? _AxisTaps{ 1, { { 1, 2, 1 }, { 1, 2, 1 } }, 2 }
+                                            : _AxisTaps{ 1, { { 0, 1, 1 }, { 0, 1, 1 } }, 1 };
+        }
+        // upsampling, inputs at 2k (cosited) or 2k + 1/2 (interstitial)
+        if (!bilinear)
+            return _AxisTaps{ -1, { { 0, 1, 0 }, { 0, 1, 0 } }, 0 };
+        return siting == SITING_COSITED ? _AxisTaps{ -1, { { 0, 2, 0 }, { 0, 1, 1 } }, 1 }
+                                        : _AxisTaps{ -1, { { 1, 3, 0 }, { 0, 3, 1 } }, 2 };
+    }
+
+    /** \brief The type of the sums of weighted samples. */
+    template<typename TSample>
+    using _ChromaSum = std::conditional_t<sizeof(TSample) == 1, std::uint16_t, std::uint32_t>;
+
+    /** \brief Returns the horizontally filtered sum of output sample x, from count input samples Kstep samples apart. */
+    template<typename F, const std::size_t Kstep>
+    inline _ChromaSum<typename F::SampleType> _horizontal_sum(const typename F::SampleType* src, const std::size_t count,
+                                                             const std::size_t x, const _AxisTaps& taps) noexcept
+    {
+        const std::size_t c = taps.center(x);
+        const std::uint8_t* weights = taps.weights[taps.phase(x)];
+        _ChromaSum<typename F::SampleType> sum = weights[1] * F::sample_value(src[std::min(c, count - 1) * Kstep]);
+        if (weights[0] != 0)
+            sum += weights[0] * F::sample_value(src[(c > 0 ? std::min(c - 1, count - 1) : 0) * Kstep]);
+        if (weights[2] != 0)
+            sum += weights[2] * F::sample_value(src[std::min(c + 1, count - 1) * Kstep]);
+        return sum;
+    }
+
+    /** \brief Filters horizontally the output samples [x0, x1) of a chroma row, from count input samples Kstep samples apart. */
+    template<typename F, const std::size_t Kstep, const bool Ksimd>
+    void _horizontal_pass(const typename F::SampleType* src, const std::size_t count, _ChromaSum<typename F::SampleType>* line,
+                          const std::size_t x0, const std::size_t x1, const _AxisTaps& taps) noexcept
+    {
+        std::size_t x = x0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (Ksimd && sizeof(typename F::SampleType) == 1) {
+            // 8 words of input samples, reading no further than the Cr sample of the 8th pair
+            constexpr std::size_t MARGIN = Kstep == 2 ? 1 : 0;
+            auto load8 = [](const std::uint8_t* p) {
+                if constexpr (Kstep == 1)
+                    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+                else
+                    return _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi16(0x00ff));
+            };
+            const __m128i w[2][3] = { { _mm_set1_epi16(taps.weights[0][0]), _mm_set1_epi16(taps.weights[0][1]), _mm_set1_epi16(taps.weights[0][2]) },
+                                      { _mm_set1_epi16(taps.weights[1][0]), _mm_set1_epi16(taps.weights[1][1]), _mm_set1_epi16(taps.weights[1][2]) } };
+            auto weighted = [&w](const int phase, const __m128i prev, const __m128i center, const __m128i next) {
+                return _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(prev, w[phase][0]), _mm_mullo_epi16(center, w[phase][1])),
+                                     _mm_mullo_epi16(next, w[phase][2]));
+            };
+            const __m128i low_words = _mm_set1_epi32(0x0000ffff);
+            auto evens = [&low_words](const __m128i a, const __m128i b) {
+                return _mm_packs_epi32(_mm_and_si128(a, low_words), _mm_and_si128(b, low_words));
+            };
+            auto odds = [](const __m128i a, const __m128i b) {
+                return _mm_packs_epi32(_mm_srli_epi32(a, 16), _mm_srli_epi32(b, 16));
+            };
+
+            while (x < x1) {
+                __m128i* out = reinterpret_cast<__m128i*>(line + (x - x0));
+                if (taps.ratio == 0 && x + 8 <= x1 && x + 8 + MARGIN <= count) {
+                    _mm_storeu_si128(out, load8(src + x * Kstep));
+                    x += 8;
+                }
+                else if (taps.ratio > 0 && x >= 1 && x + 8 <= x1 && 2 * x + 16 + MARGIN <= count) {
+                    // inputs 2x - 1 .. 2x + 15
+                    const __m128i before_lo = load8(src + (2 * x - 1) * Kstep), before_hi = load8(src + (2 * x + 7) * Kstep);
+                    const __m128i from_lo = load8(src + 2 * x * Kstep), from_hi = load8(src + (2 * x + 8) * Kstep);
+                    _mm_storeu_si128(out, weighted(0, evens(before_lo, before_hi), evens(from_lo, from_hi), odds(from_lo, from_hi)));
+                    x += 8;
+                }
+                else if (taps.ratio < 0 && (x & 1) == 0 && x >= 2 && x + 16 <= x1 && x / 2 + 9 + MARGIN <= count) {
+                    // inputs x/2 - 1 .. x/2 + 8, outputs interleaved per phase
+                    const std::size_t k = x / 2;
+                    const __m128i prev = load8(src + (k - 1) * Kstep), center = load8(src + k * Kstep), next = load8(src + (k + 1) * Kstep);
+                    const __m128i even = weighted(0, prev, center, next), odd = weighted(1, prev, center, next);
+                    _mm_storeu_si128(out, _mm_unpacklo_epi16(even, odd));
+                    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(even, odd));
+                    x += 16;
+                }
+                else {
+                    line[x - x0] = _horizontal_sum<F, Kstep>(src, count, x, taps);
+                    ++x;
+                }
+            }
+        }
+#endif
+        for (; x < x1; ++x)
+            line[x - x0] = _horizontal_sum<F, Kstep>(src, count, x, taps);
+    }
+
+    /** \brief Filters vertically the three lines of Cb and Cr sums into count samples of a chroma row of F, starting at column x0. */
+    template<typename F, const bool Ksimd>
+    void _vertical_pass(const _ChromaSum<typename F::SampleType>* const cb_lines[3], const _ChromaSum<typename F::SampleType>* const cr_lines[3],
+                        const std::uint8_t weights[3], const unsigned shift, F& dst, const std::size_t cy, const std::size_t x0, const std::size_t count) noexcept
+    {
+        using Sum = _ChromaSum<typename F::SampleType>;
+        typename F::SampleType* cb = dst.cb_row(cy) + x0 * F::CHROMA_STEP;
+        typename F::SampleType* cr = dst.cr_row(cy) + x0 * F::CHROMA_STEP;
+        const Sum rounding = shift > 0 ? Sum(1u << (shift - 1)) : 0;
+
+        std::size_t x = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (Ksimd && sizeof(typename F::SampleType) == 1) {
+            const __m128i w[3] = { _mm_set1_epi16(weights[0]), _mm_set1_epi16(weights[1]), _mm_set1_epi16(weights[2]) };
+            const __m128i round = _mm_set1_epi16(short(rounding));
+            const __m128i count_shift = _mm_cvtsi32_si128(int(shift));
+            auto samples8 = [&](const Sum* const lines[3]) {
+                const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lines[0] + x)), w[0]),
+                                                                _mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lines[1] + x)), w[1])),
+                                                  _mm_add_epi16(_mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lines[2] + x)), w[2]), round));
+                const __m128i words = _mm_srl_epi16(sum, count_shift);
+                return _mm_packus_epi16(words, words);
+            };
+            for (; x + 8 <= count; x += 8) {
+                const __m128i cb_bytes = samples8(cb_lines), cr_bytes = samples8(cr_lines);
+                if constexpr (F::IS_SEMI_PLANAR)
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(cb + 2 * x), _mm_unpacklo_epi8(cb_bytes, cr_bytes));
+                else {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(cb + x), cb_bytes);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(cr + x), cr_bytes);
+                }
+            }
+        }
+#endif
+        for (; x < count; ++x) {
+            const Sum cb_sum = weights[0] * cb_lines[0][x] + weights[1] * cb_lines[1][x] + weights[2] * cb_lines[2][x] + rounding;
+            const Sum cr_sum = weights[0] * cr_lines[0][x] + weights[1] * cr_lines[1][x] + weights[2] * cr_lines[2][x] + rounding;
+            cb[x * F::CHROMA_STEP] = F::to_sample(unsigned(cb_sum >> shift));
+            cr[x * F::CHROMA_STEP] = F::to_sample(unsigned(cr_sum >> shift));
+        }
+    }
+
+    /** \brief Resamples the chroma of src into the chroma of dst, and copies luma. */
+    template<const bool Ksimd, typename FSrc, typename FDst>
+    void _resample_chroma(const FSrc& src, FDst& dst, const ChromaResampling& resampling, FrameWorkers* workers)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("YUV frames must get same dimensions for chroma resampling.");
+        if (src.is_empty())
+            return;
+
+        using Sum = _ChromaSum<typename FSrc::SampleType>;
+        const _AxisTaps h_taps = _axis_taps(FSrc::SUBSAMPLING.x_shift, FDst::SUBSAMPLING.x_shift, resampling.filter, resampling.x_siting);
+        const _AxisTaps v_taps = _axis_taps(FSrc::SUBSAMPLING.y_shift, FDst::SUBSAMPLING.y_shift, resampling.filter, resampling.y_siting);
+        const std::size_t src_width = FSrc::SUBSAMPLING.chroma_width(src.width());
+        const std::size_t src_height = FSrc::SUBSAMPLING.chroma_height(src.height());
+        const std::size_t dst_width = FDst::SUBSAMPLING.chroma_width(dst.width());
+        const std::size_t dst_height = FDst::SUBSAMPLING.chroma_height(dst.height());
+
+        for_rows_bands(dst_height, dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            // luma rows of the band
+            const std::size_t luma_last = std::min(last << FDst::SUBSAMPLING.y_shift, dst.height());
+            for (std::size_t row = first << FDst::SUBSAMPLING.y_shift; row < luma_last; ++row)
+                std::memmove(dst.y().row(row), src.y().row(row), dst.width() * sizeof(typename FDst::SampleType));
+
+            // tiles of columns, each input chroma row being filtered horizontally once per tile into a ring of 3 lines
+            std::vector<Sum> lines;
+            {
+                vcl::utils::AllocationSite site("vcl::frames::resample_chroma()");
+                lines.resize(6 * CHROMA_TILE_WIDTH);
+            }
+            for (std::size_t x0 = 0; x0 < dst_width; x0 += CHROMA_TILE_WIDTH) {
+                const std::size_t x1 = std::min(x0 + CHROMA_TILE_WIDTH, dst_width);
+                std::size_t cached_rows[3] = { src_height, src_height, src_height };  // none
+
+                for (std::size_t cy = first; cy < last; ++cy) {
+                    const std::size_t center = v_taps.center(cy);
+                    const std::uint8_t* weights = v_taps.weights[v_taps.phase(cy)];
+                    const Sum* cb_lines[3];
+                    const Sum* cr_lines[3];
+                    for (const int t : { 1, 0, 2 }) {
+                        if (weights[t] == 0) {
+                            cb_lines[t] = cb_lines[1];  // center weights are never 0
+                            cr_lines[t] = cr_lines[1];
+                            continue;
+                        }
+                        const std::size_t row = std::min(t == 0 ? (center > 0 ? center - 1 : 0) : center + std::size_t(t) - 1, src_height - 1);
+                        const std::size_t slot = row % 3;
+                        Sum* cb_line = lines.data() + 2 * slot * CHROMA_TILE_WIDTH;
+                        Sum* cr_line = cb_line + CHROMA_TILE_WIDTH;
+                        if (cached_rows[slot] != row) {
+                            _horizontal_pass<FSrc, FSrc::CHROMA_STEP, Ksimd>(src.cb_row(row), src_width, cb_line, x0, x1, h_taps);
+                            _horizontal_pass<FSrc, FSrc::CHROMA_STEP, Ksimd>(src.cr_row(row), src_width, cr_line, x0, x1, h_taps);
+                            cached_rows[slot] = row;
+                        }
+                        cb_lines[t] = cb_line;
+                        cr_lines[t] = cr_line;
+                    }
+                    _vertical_pass<FDst, Ksimd>(cb_lines, cr_lines, weights, h_taps.shift + v_taps.shift, dst, cy, x0, x1 - x0);
+                }
+            }
+        });
+    }
+
+
+    //===================================================================
+    /** \brief Resamples the chroma of src into the chroma subsampling of dst - 4:4:4, 4:2:2 or 4:2:0 - and copies luma.
+    * Filters are separable. Horizontal and vertical passes are fused: each
+    * tile of CHROMA_TILE_WIDTH output columns filters every input chroma
+    * row once horizontally, into a ring of lines the vertical pass reads
+    * from. Both passes get SSE2 kernels on 8-bits samples. Bands of rows
+    * are resampled by workers if any, the calling thread waiting for them
+    * - so it must not be one of them. Planar and semi-planar layouts may
+    * differ. Throws std::invalid_argument if dimensions differ.
+    */
+    export template<YuvFrame FSrc, YuvFrame FDst>
+        requires ChromaResamplable<FSrc, FDst>
+    inline void resample_chroma(const FSrc& src, FDst& dst, const ChromaResampling resampling = ChromaResampling(), FrameWorkers* workers = nullptr)
+    {
+        _resample_chroma<true>(src, dst, resampling, workers);
+    }
+
+    /** \brief Resamples the chroma of src into the chroma subsampling of dst, with no SIMD. The reference of resample_chroma(), which gets the same results. */
+    export template<YuvFrame FSrc, YuvFrame FDst>
+        requires ChromaResamplable<FSrc, FDst>
+    inline void resample_chroma_scalar(const FSrc& src, FDst& dst, const ChromaResampling resampling = ChromaResampling(), FrameWorkers* workers = nullptr)
+    {
+        _resample_chroma<false>(src, dst, resampling, workers);
+    }
+
+}
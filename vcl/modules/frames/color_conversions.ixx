@@ -0,0 +1,827 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define VCL_SSE2_AVAILABLE
+#   include <emmintrin.h>
+#endif
+
+export module frames.color_conversions;
+
+import frames.frame;
+import frames.frame_workers;
+import frames.pixels;
+import frames.yuv_frames;
+import vectors.clipvect2;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The RGB to YUV matrices. */
+    export enum ColorMatrix : unsigned char
+    {
+        MATRIX_BT601 = 0,  //!< ITU-R BT.601, standard definition.
+        MATRIX_BT709,      //!< ITU-R BT.709, high definition.
+        MATRIX_BT2020      //!< ITU-R BT.2020, ultra high definition, non-constant luminance.
+    };
+
+    /** \brief The ranges of YUV samples. */
+    export enum ColorRange : unsigned char
+    {
+        RANGE_LIMITED = 0,  //!< luma in [16, 235], chroma in [16, 240], scaled to the bits depth - the broadcast range.
+        RANGE_FULL          //!< luma and chroma over the whole bits depth.
+    };
+
+    /** \brief The specification of YUV color spaces. */
+    export struct ColorSpec
+    {
+        ColorMatrix matrix{ MATRIX_BT709 };
+        ColorRange  range{ RANGE_LIMITED };
+    };
+
+
+    //===================================================================
+    /** \brief The bounds of limited range luma samples of Kbits bits, as clipped vectors. */
+    export template<const unsigned Kbits>
+        requires (Kbits >= 8 && Kbits <= 12)
+    using LimitedLumaT = vcl::vect::ClipVect2T<std::uint16_t, std::uint16_t(16u << (Kbits - 8)), std::uint16_t(235u << (Kbits - 8))>;
+
+    /** \brief The bounds of limited range (Cb, Cr) chroma samples of Kbits bits, as clipped vectors. */
+    export template<const unsigned Kbits>
+        requires (Kbits >= 8 && Kbits <= 12)
+    using LimitedChromaT = vcl::vect::ClipVect2T<std::uint16_t, std::uint16_t(16u << (Kbits - 8)), std::uint16_t(240u << (Kbits - 8))>;
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief The bounds of clipped vectors types. */
+    template<typename TClipVect>
+    struct _ClipBounds;
+
+    template<typename T, const T Kmin, const T Kmax>
+    struct _ClipBounds<vcl::vect::ClipVect2T<T, Kmin, Kmax>>
+    {
+        static constexpr T MIN = Kmin;
+        static constexpr T MAX = Kmax;
+    };
+
+    /** \brief Rounds to the nearest integer, half away from zero. */
+    inline constexpr long _round(const double x) noexcept
+    {
+        return x >= 0.0 ? long(x + 0.5) : -long(-x + 0.5);
+    }
+
+
+    //===================================================================
+    /** \brief The fixed-point coefficients of RGB <-> YUV conversions.
+    *
+    * Coefficients are rounded from the floating point matrices of the
+    * ITU-R recommendations.  Rows of the forward matrix are adjusted on
+    * green, so that grays convert exactly: luma coefficients sum to the
+    * luma scale and chroma ones to 0. Every kernel - scalar or SIMD, on
+    * one or on many threads - computes with these same integers, so that
+    * all of them get bit-exact results.
+    */
+    export struct YuvMatrix
+    {
+        static constexpr int FORWARD_BITS = 14;  //!< the fractional bits of RGB to YUV coefficients.
+        static constexpr int INVERSE_BITS = 13;  //!< the fractional bits of YUV to RGB coefficients.
+
+        std::int16_t forward[3][3];       //!< the RGB to YUV matrix, rows Y, Cb, Cr and columns R, G, B.
+        std::int32_t forward_offsets[3];  //!< the offsets of Y, Cb and Cr, rounding included, in fixed-point.
+        std::int16_t luma_scale;          //!< the YUV to RGB scale of luma.
+        std::int16_t cr_to_r;             //!< the YUV to RGB Cr coefficient of red.
+        std::int16_t cb_to_g;             //!< the YUV to RGB Cb coefficient of green.
+        std::int16_t cr_to_g;             //!< the YUV to RGB Cr coefficient of green.
+        std::int16_t cb_to_b;             //!< the YUV to RGB Cb coefficient of blue.
+        std::int16_t luma_offset;         //!< the offset of luma, 16 scaled in limited range.
+        std::int16_t chroma_offset;       //!< the offset of chroma, half the range.
+        std::int16_t luma_min;            //!< the minimum luma value.
+        std::int16_t luma_max;            //!< the maximum luma value.
+        std::int16_t chroma_min;          //!< the minimum chroma value.
+        std::int16_t chroma_max;          //!< the maximum chroma value.
+        std::int16_t rgb_max;             //!< the maximum value of RGB channels.
+    };
+
+    /** \brief Returns the fixed-point coefficients of the conversions between RGB and YUV samples of Kbits bits. */
+    export template<const unsigned Kbits>
+        requires (Kbits >= 8 && Kbits <= 12)
+    inline constexpr YuvMatrix yuv_matrix(const ColorSpec spec) noexcept
+    {
+        const double kr = spec.matrix == MATRIX_BT601 ? 0.299 : spec.matrix == MATRIX_BT709 ? 0.2126 : 0.2627;
+        const double kb = spec.matrix == MATRIX_BT601 ? 0.114 : spec.matrix == MATRIX_BT709 ? 0.0722 : 0.0593;
+        const double kg = 1.0 - kr - kb;
+
+        const bool limited = spec.range == RANGE_LIMITED;
+        const double max_value = double((1u << Kbits) - 1);
+        const double luma_scale = limited ? double(219u << (Kbits - 8)) / max_value : 1.0;
+        const double chroma_scale = limited ? double(224u << (Kbits - 8)) / max_value : 1.0;
+
+        YuvMatrix m{};
+        m.luma_offset = limited ? std::int16_t(16u << (Kbits - 8)) : 0;
+        m.chroma_offset = std::int16_t(1u << (Kbits - 1));
+        m.rgb_max = std::int16_t(max_value);
+        if (limited) {
+            m.luma_min = _ClipBounds<LimitedLumaT<Kbits>>::MIN;
+            m.luma_max = _ClipBounds<LimitedLumaT<Kbits>>::MAX;
+            m.chroma_min = _ClipBounds<LimitedChromaT<Kbits>>::MIN;
+            m.chroma_max = _ClipBounds<LimitedChromaT<Kbits>>::MAX;
+        }
+        else {
+            m.luma_min = m.chroma_min = 0;
+            m.luma_max = m.chroma_max = m.rgb_max;
+        }
+
+        // forward matrix, rows adjusted on green
+        constexpr double FORWARD_ONE = double(1 << YuvMatrix::FORWARD_BITS);
+        const double rows[3][3] = {
+            { kr * luma_scale, kg * luma_scale, kb * luma_scale },
+            { -kr / (2.0 * (1.0 - kb)) * chroma_scale, -kg / (2.0 * (1.0 - kb)) * chroma_scale, 0.5 * chroma_scale },
+            { 0.5 * chroma_scale, -kg / (2.0 * (1.0 - kr)) * chroma_scale, -kb / (2.0 * (1.0 - kr)) * chroma_scale }
+        };
+        const long sums[3] = { _round(luma_scale * FORWARD_ONE), 0, 0 };
+        for (int i = 0; i < 3; ++i) {
+            m.forward[i][0] = std::int16_t(_round(rows[i][0] * FORWARD_ONE));
+            m.forward[i][2] = std::int16_t(_round(rows[i][2] * FORWARD_ONE));
+            m.forward[i][1] = std::int16_t(sums[i] - m.forward[i][0] - m.forward[i][2]);
+        }
+        const long rounding = 1L << (YuvMatrix::FORWARD_BITS - 1);
+        m.forward_offsets[0] = std::int32_t((long(m.luma_offset) << YuvMatrix::FORWARD_BITS) + rounding);
+        m.forward_offsets[1] = m.forward_offsets[2] = std::int32_t((long(m.chroma_offset) << YuvMatrix::FORWARD_BITS) + rounding);
+
+        // inverse matrix
+        constexpr double INVERSE_ONE = double(1 << YuvMatrix::INVERSE_BITS);
+        m.luma_scale = std::int16_t(_round(INVERSE_ONE / luma_scale));
+        m.cr_to_r = std::int16_t(_round(2.0 * (1.0 - kr) / chroma_scale * INVERSE_ONE));
+        m.cb_to_g = std::int16_t(_round(-2.0 * kb * (1.0 - kb) / kg / chroma_scale * INVERSE_ONE));
+        m.cr_to_g = std::int16_t(_round(-2.0 * kr * (1.0 - kr) / kg / chroma_scale * INVERSE_ONE));
+        m.cb_to_b = std::int16_t(_round(2.0 * (1.0 - kb) / chroma_scale * INVERSE_ONE));
+        return m;
+    }
+
+
+    //===================================================================
+    /** \brief The concept of packed RGB pixels types convertible to YUV: 3 or 4 channels of 8 to 12 bits. */
+    export template<typename P>
+    concept YuvConvertiblePixel = PackedPixel<P> && !P::IS_GRAY && P::BITS_DEPTH >= 8 && P::BITS_DEPTH <= 12;
+
+    /** \brief The concept of YUV frames types convertible from and to RGB: chroma subsampled by 2 at most, and not more vertically than horizontally. */
+    export template<typename F>
+    concept RgbConvertibleYuvFrame = YuvFrame<F> && F::BITS_DEPTH <= 12 && F::SUBSAMPLING.x_shift <= 1 && F::SUBSAMPLING.y_shift <= F::SUBSAMPLING.x_shift;
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Returns the offset of plane i, rounding included, for sums of 2^block_shift pixels. */
+    inline constexpr std::int32_t _forward_offset(const YuvMatrix& m, const int i, const int block_shift) noexcept
+    {
+        const int shift = YuvMatrix::FORWARD_BITS + block_shift;
+        return (std::int32_t(i == 0 ? m.luma_offset : m.chroma_offset) << shift) + (std::int32_t(1) << (shift - 1));
+    }
+
+    /** \brief Returns the sample of plane i for the sums (r, g, b) of 2^block_shift pixels. */
+    inline constexpr std::int32_t _forward_sample(const YuvMatrix& m, const int i, const std::int32_t r, const std::int32_t g, const std::int32_t b,
+                                                  const int block_shift) noexcept
+    {
+        const std::int32_t value = (m.forward[i][0] * r + m.forward[i][1] * g + m.forward[i][2] * b + _forward_offset(m, i, block_shift))
+                                   >> (YuvMatrix::FORWARD_BITS + block_shift);
+        return i == 0 ? std::clamp<std::int32_t>(value, m.luma_min, m.luma_max) : std::clamp<std::int32_t>(value, m.chroma_min, m.chroma_max);
+    }
+
+    /** \brief Returns the RGB pixel of the values (y, cb, cr), which are clipped to the YUV range first. */
+    template<typename P>
+    inline P _inverse_pixel(const std::int32_t y, const std::int32_t cb, const std::int32_t cr, const YuvMatrix& m) noexcept
+    {
+        constexpr std::int32_t ROUNDING = 1 << (YuvMatrix::INVERSE_BITS - 1);
+        const std::int32_t yy = std::clamp<std::int32_t>(y, m.luma_min, m.luma_max) - m.luma_offset;
+        const std::int32_t u = std::clamp<std::int32_t>(cb, m.chroma_min, m.chroma_max) - m.chroma_offset;
+        const std::int32_t v = std::clamp<std::int32_t>(cr, m.chroma_min, m.chroma_max) - m.chroma_offset;
+        const std::int32_t base = m.luma_scale * yy + ROUNDING;
+        return P::rgb(typename P::ChannelType(std::clamp<std::int32_t>((base + m.cr_to_r * v) >> YuvMatrix::INVERSE_BITS, 0, m.rgb_max)),
+                      typename P::ChannelType(std::clamp<std::int32_t>((base + m.cb_to_g * u + m.cr_to_g * v) >> YuvMatrix::INVERSE_BITS, 0, m.rgb_max)),
+                      typename P::ChannelType(std::clamp<std::int32_t>((base + m.cb_to_b * u) >> YuvMatrix::INVERSE_BITS, 0, m.rgb_max)));
+    }
+
+    /** \brief Returns the sample of FDst for the sample s of FSrc, rescaled to the bits depth of FDst. */
+    template<typename FSrc, typename FDst>
+    inline typename FDst::SampleType _convert_sample(const typename FSrc::SampleType s) noexcept
+    {
+        const unsigned value = FSrc::sample_value(s);
+        if constexpr (FDst::BITS_DEPTH >= FSrc::BITS_DEPTH)
+            return FDst::to_sample(value << (FDst::BITS_DEPTH - FSrc::BITS_DEPTH));
+        else
+            return FDst::to_sample(std::min(FDst::MAX_VALUE, (value + (1u << (FSrc::BITS_DEPTH - FDst::BITS_DEPTH - 1))) >> (FSrc::BITS_DEPTH - FDst::BITS_DEPTH)));
+    }
+
+
+    //===================================================================
+    /** \brief Converts a row of count RGB pixels into Y, Cb and Cr samples, with no SIMD. The reference kernel. */
+    export template<YuvConvertiblePixel P, typename TSample>
+    inline void rgb_to_yuv_row_scalar(const P* rgb, TSample* y, TSample* u, TSample* v, const std::size_t count, const YuvMatrix& m) noexcept
+    {
+        for (std::size_t x = 0; x < count; ++x) {
+            const std::int32_t r = rgb[x].r(), g = rgb[x].g(), b = rgb[x].b();
+            y[x] = TSample(_forward_sample(m, 0, r, g, b, 0));
+            u[x] = TSample(_forward_sample(m, 1, r, g, b, 0));
+            v[x] = TSample(_forward_sample(m, 2, r, g, b, 0));
+        }
+    }
+
+    /** \brief Converts a row of count Y, Cb and Cr samples into RGB pixels, with no SIMD. The reference kernel.
+    * Samples out of the YUV range are clipped first, e.g. super-black and
+    * super-white luma in limited range.
+    */
+    export template<YuvConvertiblePixel P, typename TSample>
+    inline void yuv_to_rgb_row_scalar(const TSample* y, const TSample* u, const TSample* v, P* rgb, const std::size_t count, const YuvMatrix& m) noexcept
+    {
+        for (std::size_t x = 0; x < count; ++x)
+            rgb[x] = _inverse_pixel<P>(y[x], u[x], v[x], m);
+    }
+
+    /** \brief Converts the 2^y_shift rows of RGB pixels of one chroma row of YUV frames F, with no SIMD. The reference kernel.
+    * rgb1 and y1 are the second rows of 4:2:0 frames - or the first ones
+    * again on the last row of frames with an odd height - and are ignored
+    * otherwise.  Chroma samples are the ones of the sums of the pixels of
+    * their blocks, the last column being repeated on odd widths.
+    */
+    export template<RgbConvertibleYuvFrame F, YuvConvertiblePixel P>
+    void rgb_to_yuv_frame_rows_scalar(const P* rgb0, const P* rgb1, typename F::SampleType* y0, typename F::SampleType* y1,
+                                      typename F::SampleType* cb, typename F::SampleType* cr, const std::size_t width, const YuvMatrix& m) noexcept
+    {
+        constexpr unsigned X_SHIFT = F::SUBSAMPLING.x_shift;
+        constexpr unsigned Y_SHIFT = F::SUBSAMPLING.y_shift;
+        const P* rows[2] = { rgb0, rgb1 };
+        typename F::SampleType* lumas[2] = { y0, y1 };
+
+        for (unsigned row = 0; row <= Y_SHIFT; ++row)
+            for (std::size_t x = 0; x < width; ++x)
+                lumas[row][x] = F::to_sample(_forward_sample(m, 0, rows[row][x].r(), rows[row][x].g(), rows[row][x].b(), 0));
+
+        for (std::size_t cx = 0; (cx << X_SHIFT) < width; ++cx) {
+            std::int32_t r = 0, g = 0, b = 0;
+            for (unsigned row = 0; row <= Y_SHIFT; ++row)
+                for (std::size_t dx = 0; dx < (std::size_t(1) << X_SHIFT); ++dx) {
+                    const P& p = rows[row][std::min((cx << X_SHIFT) + dx, width - 1)];
+                    r += p.r();
+                    g += p.g();
+                    b += p.b();
+                }
+            cb[cx * F::CHROMA_STEP] = F::to_sample(_forward_sample(m, 1, r, g, b, X_SHIFT + Y_SHIFT));
+            cr[cx * F::CHROMA_STEP] = F::to_sample(_forward_sample(m, 2, r, g, b, X_SHIFT + Y_SHIFT));
+        }
+    }
+
+    /** \brief Converts a row of YUV frames F into RGB pixels, with no SIMD. The reference kernel.
+    * cb and cr are the chroma samples of the row, shared by the pixels of
+    * their blocks.
+    */
+    export template<RgbConvertibleYuvFrame F, YuvConvertiblePixel P>
+    void yuv_frame_row_to_rgb_scalar(const typename F::SampleType* y, const typename F::SampleType* cb, const typename F::SampleType* cr,
+                                     P* rgb, const std::size_t width, const YuvMatrix& m) noexcept
+    {
+        for (std::size_t x = 0; x < width; ++x) {
+            const std::size_t c = (x >> F::SUBSAMPLING.x_shift) * F::CHROMA_STEP;
+            rgb[x] = _inverse_pixel<P>(F::sample_value(y[x]), F::sample_value(cb[c]), F::sample_value(cr[c]), m);
+        }
+    }
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+#if defined(VCL_SSE2_AVAILABLE)
+    /** \brief Returns the pair (lo, hi) of 16-bits coefficients in each 32-bits lane, as expected by _mm_madd_epi16(). */
+    inline __m128i _pairs(const std::int16_t lo, const std::int16_t hi) noexcept
+    {
+        return _mm_set1_epi32(std::int32_t(std::uint16_t(lo)) | std::int32_t(std::uint32_t(std::uint16_t(hi)) << 16));
+    }
+
+    /** \brief Returns the words of channel Kindex of 8 consecutive pixels. */
+    template<typename P, const int Kindex>
+    inline __m128i _gather8(const P* px) noexcept
+    {
+        // inserted words, no store-to-load forwarding stalls
+        return _mm_setr_epi16(px[0].channels[Kindex], px[1].channels[Kindex], px[2].channels[Kindex], px[3].channels[Kindex],
+                              px[4].channels[Kindex], px[5].channels[Kindex], px[6].channels[Kindex], px[7].channels[Kindex]);
+    }
+
+    /** \brief The SSE2 RGB to YUV conversion of 8 sums of 2^Kblock_shift pixels. */
+    template<const int Kblock_shift>
+    struct _ForwardSse2
+    {
+        static constexpr int SHIFT = YuvMatrix::FORWARD_BITS + Kblock_shift;
+
+        __m128i rg[3], b0[3], offsets[3], mins[3], maxs[3];
+
+        inline explicit _ForwardSse2(const YuvMatrix& m) noexcept
+        {
+            for (int i = 0; i < 3; ++i) {
+                rg[i] = _pairs(m.forward[i][0], m.forward[i][1]);
+                b0[i] = _pairs(m.forward[i][2], 0);
+                offsets[i] = _mm_set1_epi32(_forward_offset(m, i, Kblock_shift));
+                mins[i] = _mm_set1_epi16(i == 0 ? m.luma_min : m.chroma_min);
+                maxs[i] = _mm_set1_epi16(i == 0 ? m.luma_max : m.chroma_max);
+            }
+        }
+
+        /** \brief Returns the 8 words of the clamped samples of plane i. */
+        inline __m128i samples(const int i, const __m128i rv, const __m128i gv, const __m128i bv) const noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(rv, gv), rg[i]),
+                                                                          _mm_madd_epi16(_mm_unpacklo_epi16(bv, zero), b0[i])), offsets[i]), SHIFT);
+            const __m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(rv, gv), rg[i]),
+                                                                          _mm_madd_epi16(_mm_unpackhi_epi16(bv, zero), b0[i])), offsets[i]), SHIFT);
+            return _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(lo, hi), mins[i]), maxs[i]);
+        }
+    };
+
+    /** \brief The SSE2 YUV to RGB conversion of 8 pixels. */
+    struct _InverseSse2
+    {
+        __m128i luma_min, luma_max, chroma_min, chroma_max, luma_offset, chroma_offset, luma, to_r, to_g, to_b;
+
+        inline explicit _InverseSse2(const YuvMatrix& m) noexcept
+            : luma_min(_mm_set1_epi16(m.luma_min)), luma_max(_mm_set1_epi16(m.luma_max)),
+              chroma_min(_mm_set1_epi16(m.chroma_min)), chroma_max(_mm_set1_epi16(m.chroma_max)),
+              luma_offset(_mm_set1_epi16(m.luma_offset)), chroma_offset(_mm_set1_epi16(m.chroma_offset)),
+              luma(_pairs(m.luma_scale, std::int16_t(1 << (YuvMatrix::INVERSE_BITS - 1)))),
+              to_r(_pairs(0, m.cr_to_r)), to_g(_pairs(m.cb_to_g, m.cr_to_g)), to_b(_pairs(m.cb_to_b, 0))
+        {}
+
+        /** \brief Converts the 8 words (y, cb, cr) into 8 pixels P. */
+        template<typename P>
+        inline void store(const __m128i y, const __m128i cb, const __m128i cr, P* rgb) const noexcept
+        {
+            const __m128i yv = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(y, luma_min), luma_max), luma_offset);
+            const __m128i uv = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(cb, chroma_min), chroma_max), chroma_offset);
+            const __m128i vv = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(cr, chroma_min), chroma_max), chroma_offset);
+
+            const __m128i one = _mm_set1_epi16(1);
+            const __m128i base_lo = _mm_madd_epi16(_mm_unpacklo_epi16(yv, one), luma);
+            const __m128i base_hi = _mm_madd_epi16(_mm_unpackhi_epi16(yv, one), luma);
+            const __m128i cbcr_lo = _mm_unpacklo_epi16(uv, vv), cbcr_hi = _mm_unpackhi_epi16(uv, vv);
+
+            auto channel = [&](const __m128i coefficients) {
+                const __m128i lo = _mm_srai_epi32(_mm_add_epi32(base_lo, _mm_madd_epi16(cbcr_lo, coefficients)), YuvMatrix::INVERSE_BITS);
+                const __m128i hi = _mm_srai_epi32(_mm_add_epi32(base_hi, _mm_madd_epi16(cbcr_hi, coefficients)), YuvMatrix::INVERSE_BITS);
+                const __m128i words = _mm_packs_epi32(lo, hi);
+                return _mm_packus_epi16(words, words);
+            };
+            alignas(16) std::uint8_t r[16], g[16], b[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(r), channel(to_r));
+            _mm_store_si128(reinterpret_cast<__m128i*>(g), channel(to_g));
+            _mm_store_si128(reinterpret_cast<__m128i*>(b), channel(to_b));
+            for (int k = 0; k < 8; ++k) {
+                P& p = rgb[k];
+                p.channels[P::RED_INDEX] = r[k];
+                p.channels[P::GREEN_INDEX] = g[k];
+                p.channels[P::BLUE_INDEX] = b[k];
+                if constexpr (P::HAS_ALPHA)
+                    p.channels[P::ALPHA_INDEX] = P::MAX_VALUE;
+            }
+        }
+    };
+
+    /** \brief Converts blocks of 8 RGB pixels of 8 bits into Y, Cb and Cr samples. Returns the count of converted pixels. */
+    template<typename P>
+    std::size_t _rgb_to_yuv_row_sse2(const P* rgb, std::uint8_t* y, std::uint8_t* u, std::uint8_t* v, const std::size_t count, const YuvMatrix& m) noexcept
+    {
+        const _ForwardSse2<0> forward(m);
+        std::uint8_t* planes[3] = { y, u, v };
+        std::size_t x = 0;
+        for (; x + 8 <= count; x += 8) {
+            const __m128i rv = _gather8<P, P::RED_INDEX>(rgb + x);
+            const __m128i gv = _gather8<P, P::GREEN_INDEX>(rgb + x);
+            const __m128i bv = _gather8<P, P::BLUE_INDEX>(rgb + x);
+            for (int i = 0; i < 3; ++i) {
+                const __m128i samples = forward.samples(i, rv, gv, bv);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(planes[i] + x), _mm_packus_epi16(samples, samples));
+            }
+        }
+        return x;
+    }
+
+    /** \brief Converts blocks of 8 Y, Cb and Cr samples of 8 bits into RGB pixels. Returns the count of converted pixels. */
+    template<typename P>
+    std::size_t _yuv_to_rgb_row_sse2(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v, P* rgb, const std::size_t count, const YuvMatrix& m) noexcept
+    {
+        const _InverseSse2 inverse(m);
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t x = 0;
+        for (; x + 8 <= count; x += 8)
+            inverse.store(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero),
+                          _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x)), zero),
+                          _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x)), zero), rgb + x);
+        return x;
+    }
+
+    /** \brief Converts blocks of 16 x 2^y_shift RGB pixels of 8 bits into the samples of 8-bits frames F subsampled horizontally.
+    * Sums of pixels and interleaving are fused in the pass. Returns the
+    * count of converted pixels per row.
+    */
+    template<typename F, typename P>
+    std::size_t _rgb_to_yuv_frame_rows_sse2(const P* rgb0, const P* rgb1, std::uint8_t* y0, std::uint8_t* y1,
+                                            std::uint8_t* cb, std::uint8_t* cr, const std::size_t width, const YuvMatrix& m) noexcept
+    {
+        constexpr unsigned Y_SHIFT = F::SUBSAMPLING.y_shift;
+        const _ForwardSse2<0> luma(m);
+        const _ForwardSse2<1 + Y_SHIFT> chroma(m);
+        const __m128i ones = _mm_set1_epi16(1);
+        const P* rows[2] = { rgb0, rgb1 };
+        std::uint8_t* lumas[2] = { y0, y1 };
+
+        std::size_t x = 0;
+        for (; x + 16 <= width; x += 16) {
+            __m128i sums[3];
+            for (unsigned row = 0; row <= Y_SHIFT; ++row) {
+                const P* px = rows[row] + x;
+                const __m128i r[2] = { _gather8<P, P::RED_INDEX>(px), _gather8<P, P::RED_INDEX>(px + 8) };
+                const __m128i g[2] = { _gather8<P, P::GREEN_INDEX>(px), _gather8<P, P::GREEN_INDEX>(px + 8) };
+                const __m128i b[2] = { _gather8<P, P::BLUE_INDEX>(px), _gather8<P, P::BLUE_INDEX>(px + 8) };
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lumas[row] + x),
+                                 _mm_packus_epi16(luma.samples(0, r[0], g[0], b[0]), luma.samples(0, r[1], g[1], b[1])));
+
+                // sums of horizontal pairs, then of rows
+                const __m128i pairs[3] = { _mm_packs_epi32(_mm_madd_epi16(r[0], ones), _mm_madd_epi16(r[1], ones)),
+                                           _mm_packs_epi32(_mm_madd_epi16(g[0], ones), _mm_madd_epi16(g[1], ones)),
+                                           _mm_packs_epi32(_mm_madd_epi16(b[0], ones), _mm_madd_epi16(b[1], ones)) };
+                for (int c = 0; c < 3; ++c)
+                    sums[c] = row == 0 ? pairs[c] : _mm_add_epi16(sums[c], pairs[c]);
+            }
+
+            const __m128i cb_words = chroma.samples(1, sums[0], sums[1], sums[2]);
+            const __m128i cr_words = chroma.samples(2, sums[0], sums[1], sums[2]);
+            if constexpr (F::IS_SEMI_PLANAR)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cb + x), _mm_unpacklo_epi8(_mm_packus_epi16(cb_words, cb_words), _mm_packus_epi16(cr_words, cr_words)));
+            else {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(cb + x / 2), _mm_packus_epi16(cb_words, cb_words));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(cr + x / 2), _mm_packus_epi16(cr_words, cr_words));
+            }
+        }
+        return x;
+    }
+
+    /** \brief Converts blocks of 16 samples of a row of 8-bits frames F subsampled horizontally into RGB pixels of 8 bits.
+    * Chroma upsampling and deinterleaving are fused in the pass. Returns
+    * the count of converted pixels.
+    */
+    template<typename F, typename P>
+    std::size_t _yuv_frame_row_to_rgb_sse2(const std::uint8_t* y, const std::uint8_t* cb, const std::uint8_t* cr,
+                                           P* rgb, const std::size_t width, const YuvMatrix& m) noexcept
+    {
+        const _InverseSse2 inverse(m);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+
+        std::size_t x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const __m128i lumas = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+            __m128i cb_words, cr_words;
+            if constexpr (F::IS_SEMI_PLANAR) {
+                const __m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cb + x));
+                cb_words = _mm_and_si128(pairs, low_bytes);
+                cr_words = _mm_srli_epi16(pairs, 8);
+            }
+            else {
+                cb_words = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cb + x / 2)), zero);
+                cr_words = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cr + x / 2)), zero);
+            }
+            inverse.store(_mm_unpacklo_epi8(lumas, zero), _mm_unpacklo_epi16(cb_words, cb_words), _mm_unpacklo_epi16(cr_words, cr_words), rgb + x);
+            inverse.store(_mm_unpackhi_epi8(lumas, zero), _mm_unpackhi_epi16(cb_words, cb_words), _mm_unpackhi_epi16(cr_words, cr_words), rgb + x + 8);
+        }
+        return x;
+    }
+
+    /** \brief Returns 16 samples of FSrc as 16 bytes of 8-bits values. */
+    template<typename FSrc>
+    inline __m128i _load16(const typename FSrc::SampleType* samples) noexcept
+    {
+        if constexpr (sizeof(typename FSrc::SampleType) == 1)
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples));
+        else {
+            __m128i lo = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples)), FSrc::SAMPLES_SHIFT);
+            __m128i hi = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + 8)), FSrc::SAMPLES_SHIFT);
+            if constexpr (FSrc::BITS_DEPTH > 8) {
+                constexpr int SHIFT = FSrc::BITS_DEPTH - 8;
+                const __m128i rounding = _mm_set1_epi16(short(1 << (SHIFT - 1)));
+                lo = _mm_srli_epi16(_mm_adds_epu16(lo, rounding), SHIFT);
+                hi = _mm_srli_epi16(_mm_adds_epu16(hi, rounding), SHIFT);
+            }
+            return _mm_packus_epi16(lo, hi);
+        }
+    }
+
+    /** \brief Stores 16 bytes of 8-bits values as 16 samples of FDst. */
+    template<typename FDst>
+    inline void _store16(typename FDst::SampleType* samples, const __m128i bytes) noexcept
+    {
+        if constexpr (sizeof(typename FDst::SampleType) == 1)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(samples), bytes);
+        else {
+            constexpr int SHIFT = FDst::BITS_DEPTH - 8 + FDst::SAMPLES_SHIFT;
+            const __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(samples), _mm_slli_epi16(_mm_unpacklo_epi8(bytes, zero), SHIFT));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + 8), _mm_slli_epi16(_mm_unpackhi_epi8(bytes, zero), SHIFT));
+        }
+    }
+
+    /** \brief True if conversions from samples of FSrc to samples of FDst go through 8-bits values, so get SSE2 kernels. */
+    template<typename FSrc, typename FDst>
+    inline constexpr bool _SSE2_SAMPLES = sizeof(typename FSrc::SampleType) == 1 || sizeof(typename FDst::SampleType) == 1;
+#endif
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Converts count samples of FSrc into samples of FDst. */
+    template<typename FSrc, typename FDst>
+    void _convert_samples(const typename FSrc::SampleType* src, typename FDst::SampleType* dst, const std::size_t count) noexcept
+    {
+        if constexpr (std::is_same_v<typename FSrc::SampleType, typename FDst::SampleType> &&
+                      FSrc::BITS_DEPTH == FDst::BITS_DEPTH && FSrc::SAMPLES_SHIFT == FDst::SAMPLES_SHIFT)
+            std::memcpy(dst, src, count * sizeof(*src));
+        else {
+            std::size_t x = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+            if constexpr (_SSE2_SAMPLES<FSrc, FDst>)
+                for (; x + 16 <= count; x += 16)
+                    _store16<FDst>(dst + x, _load16<FSrc>(src + x));
+#endif
+            for (; x < count; ++x)
+                dst[x] = _convert_sample<FSrc, FDst>(src[x]);
+        }
+    }
+
+    /** \brief Interleaves count Cb and Cr samples of FSrc into pairs of samples of FDst. */
+    template<typename FSrc, typename FDst>
+    void _interleave_samples(const typename FSrc::SampleType* cb, const typename FSrc::SampleType* cr,
+                             typename FDst::SampleType* cbcr, const std::size_t count) noexcept
+    {
+        std::size_t x = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (_SSE2_SAMPLES<FSrc, FDst>)
+            for (; x + 16 <= count; x += 16) {
+                const __m128i cb_bytes = _load16<FSrc>(cb + x), cr_bytes = _load16<FSrc>(cr + x);
+                _store16<FDst>(cbcr + 2 * x, _mm_unpacklo_epi8(cb_bytes, cr_bytes));
+                _store16<FDst>(cbcr + 2 * x + 16, _mm_unpackhi_epi8(cb_bytes, cr_bytes));
+            }
+#endif
+        for (; x < count; ++x) {
+            cbcr[2 * x] = _convert_sample<FSrc, FDst>(cb[x]);
+            cbcr[2 * x + 1] = _convert_sample<FSrc, FDst>(cr[x]);
+        }
+    }
+
+    /** \brief Deinterleaves count pairs of Cb and Cr samples of FSrc into samples of FDst. */
+    template<typename FSrc, typename FDst>
+    void _deinterleave_samples(const typename FSrc::SampleType* cbcr, typename FDst::SampleType* cb,
+                               typename FDst::SampleType* cr, const std::size_t count) noexcept
+    {
+        std::size_t x = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (_SSE2_SAMPLES<FSrc, FDst>) {
+            const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+            for (; x + 16 <= count; x += 16) {
+                const __m128i lo = _load16<FSrc>(cbcr + 2 * x), hi = _load16<FSrc>(cbcr + 2 * x + 16);
+                _store16<FDst>(cb + x, _mm_packus_epi16(_mm_and_si128(lo, low_bytes), _mm_and_si128(hi, low_bytes)));
+                _store16<FDst>(cr + x, _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+            }
+        }
+#endif
+        for (; x < count; ++x) {
+            cb[x] = _convert_sample<FSrc, FDst>(cbcr[2 * x]);
+            cr[x] = _convert_sample<FSrc, FDst>(cbcr[2 * x + 1]);
+        }
+    }
+
+
+    //===================================================================
+    /** \brief Converts a row of count RGB pixels into Y, Cb and Cr samples, with SIMD on 8-bits formats when available. */
+    export template<YuvConvertiblePixel P, typename TSample>
+    inline void rgb_to_yuv_row(const P* rgb, TSample* y, TSample* u, TSample* v, const std::size_t count, const YuvMatrix& m) noexcept
+    {
+        std::size_t done = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (P::BITS_DEPTH == 8 && sizeof(TSample) == 1)
+            done = _rgb_to_yuv_row_sse2(rgb, y, u, v, count, m);
+#endif
+        rgb_to_yuv_row_scalar(rgb + done, y + done, u + done, v + done, count - done, m);
+    }
+
+    /** \brief Converts a row of count Y, Cb and Cr samples into RGB pixels, with SIMD on 8-bits formats when available. */
+    export template<YuvConvertiblePixel P, typename TSample>
+    inline void yuv_to_rgb_row(const TSample* y, const TSample* u, const TSample* v, P* rgb, const std::size_t count, const YuvMatrix& m) noexcept
+    {
+        std::size_t done = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (P::BITS_DEPTH == 8 && sizeof(TSample) == 1)
+            done = _yuv_to_rgb_row_sse2(y, u, v, rgb, count, m);
+#endif
+        yuv_to_rgb_row_scalar(y + done, u + done, v + done, rgb + done, count - done, m);
+    }
+
+    /** \brief Converts the 2^y_shift rows of RGB pixels of one chroma row of YUV frames F, with SIMD on 8-bits formats when available.
+    * \sa rgb_to_yuv_frame_rows_scalar(), which gets the same results.
+    */
+    export template<RgbConvertibleYuvFrame F, YuvConvertiblePixel P>
+    inline void rgb_to_yuv_frame_rows(const P* rgb0, const P* rgb1, typename F::SampleType* y0, typename F::SampleType* y1,
+                                      typename F::SampleType* cb, typename F::SampleType* cr, const std::size_t width, const YuvMatrix& m) noexcept
+    {
+        std::size_t done = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (P::BITS_DEPTH == 8 && sizeof(typename F::SampleType) == 1) {
+            if constexpr (F::SUBSAMPLING.x_shift == 1)
+                done = _rgb_to_yuv_frame_rows_sse2<F>(rgb0, rgb1, y0, y1, cb, cr, width, m);
+            else if constexpr (!F::IS_SEMI_PLANAR)
+                done = _rgb_to_yuv_row_sse2(rgb0, y0, cb, cr, width, m);
+        }
+#endif
+        const std::size_t chroma_done = (done >> F::SUBSAMPLING.x_shift) * F::CHROMA_STEP;
+        rgb_to_yuv_frame_rows_scalar<F>(rgb0 + done, rgb1 + done, y0 + done, y1 + done, cb + chroma_done, cr + chroma_done, width - done, m);
+    }
+
+    /** \brief Converts a row of YUV frames F into RGB pixels, with SIMD on 8-bits formats when available.
+    * \sa yuv_frame_row_to_rgb_scalar(), which gets the same results.
+    */
+    export template<RgbConvertibleYuvFrame F, YuvConvertiblePixel P>
+    inline void yuv_frame_row_to_rgb(const typename F::SampleType* y, const typename F::SampleType* cb, const typename F::SampleType* cr,
+                                     P* rgb, const std::size_t width, const YuvMatrix& m) noexcept
+    {
+        std::size_t done = 0;
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (P::BITS_DEPTH == 8 && sizeof(typename F::SampleType) == 1) {
+            if constexpr (F::SUBSAMPLING.x_shift == 1)
+                done = _yuv_frame_row_to_rgb_sse2<F>(y, cb, cr, rgb, width, m);
+            else if constexpr (!F::IS_SEMI_PLANAR)
+                done = _yuv_to_rgb_row_sse2(y, cb, cr, rgb, width, m);
+        }
+#endif
+        const std::size_t chroma_done = (done >> F::SUBSAMPLING.x_shift) * F::CHROMA_STEP;
+        yuv_frame_row_to_rgb_scalar<F>(y + done, cb + chroma_done, cr + chroma_done, rgb + done, width - done, m);
+    }
+
+
+    //===================================================================
+    /** \brief Converts an RGB frame into Y, Cb and Cr planes of the same dimensions (YUV 4:4:4).
+    * Samples get the bits depth of the RGB pixels. Rows are converted by
+    * workers if any, the calling thread waiting for them - so it must not
+    * be one of them. Throws std::invalid_argument if dimensions differ.
+    */
+    export template<YuvConvertiblePixel P, typename TSample>
+        requires std::is_unsigned_v<TSample> && (8 * sizeof(TSample) >= P::BITS_DEPTH)
+    void rgb_to_yuv444(const FrameT<P>& rgb, FrameT<TSample>& y, FrameT<TSample>& u, FrameT<TSample>& v,
+                       const ColorSpec spec = ColorSpec(), FrameWorkers* workers = nullptr)
+    {
+        if (y.width() != rgb.width() || y.height() != rgb.height() || u.width() != rgb.width() || u.height() != rgb.height() ||
+            v.width() != rgb.width() || v.height() != rgb.height())
+            throw std::invalid_argument("YUV planes must get the dimensions of the RGB frame.");
+
+        const YuvMatrix m = yuv_matrix<P::BITS_DEPTH>(spec);
+        for_rows_bands(rgb.height(), rgb.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                rgb_to_yuv_row(rgb.row(row), y.row(row), u.row(row), v.row(row), rgb.width(), m);
+        });
+    }
+
+    /** \brief Converts Y, Cb and Cr planes (YUV 4:4:4) into an RGB frame of the same dimensions.
+    * Samples get the bits depth of the RGB pixels. Rows are converted by
+    * workers if any, the calling thread waiting for them - so it must not
+    * be one of them. Throws std::invalid_argument if dimensions differ.
+    */
+    export template<YuvConvertiblePixel P, typename TSample>
+        requires std::is_unsigned_v<TSample> && (8 * sizeof(TSample) >= P::BITS_DEPTH)
+    void yuv444_to_rgb(const FrameT<TSample>& y, const FrameT<TSample>& u, const FrameT<TSample>& v, FrameT<P>& rgb,
+                       const ColorSpec spec = ColorSpec(), FrameWorkers* workers = nullptr)
+    {
+        if (y.width() != rgb.width() || y.height() != rgb.height() || u.width() != rgb.width() || u.height() != rgb.height() ||
+            v.width() != rgb.width() || v.height() != rgb.height())
+            throw std::invalid_argument("YUV planes must get the dimensions of the RGB frame.");
+
+        const YuvMatrix m = yuv_matrix<P::BITS_DEPTH>(spec);
+        for_rows_bands(rgb.height(), rgb.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                yuv_to_rgb_row(y.row(row), u.row(row), v.row(row), rgb.row(row), rgb.width(), m);
+        });
+    }
+
+    /** \brief Converts an RGB frame into a planar or semi-planar YUV frame of the same dimensions and bits depth.
+    * Chroma samples get the mean colors of their blocks of pixels, in the
+    * same pass as luma samples. Rows are converted by workers if any, the
+    * calling thread waiting for them - so it must not be one of them.
+    * Throws std::invalid_argument if dimensions differ.
+    */
+    export template<YuvConvertiblePixel P, RgbConvertibleYuvFrame F>
+        requires (P::BITS_DEPTH == F::BITS_DEPTH)
+    void rgb_to_yuv(const FrameT<P>& rgb, F& yuv, const ColorSpec spec = ColorSpec(), FrameWorkers* workers = nullptr)
+    {
+        if (yuv.width() != rgb.width() || yuv.height() != rgb.height())
+            throw std::invalid_argument("YUV frames must get the dimensions of the RGB frame.");
+        if (rgb.is_empty())
+            return;
+
+        constexpr unsigned Y_SHIFT = F::SUBSAMPLING.y_shift;
+        const YuvMatrix m = yuv_matrix<P::BITS_DEPTH>(spec);
+        for_rows_bands(F::SUBSAMPLING.chroma_height(rgb.height()), rgb.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t cy = first; cy < last; ++cy) {
+                const std::size_t row0 = cy << Y_SHIFT;
+                const std::size_t row1 = std::min(row0 + Y_SHIFT, rgb.height() - 1);
+                rgb_to_yuv_frame_rows<F>(rgb.row(row0), rgb.row(row1), yuv.y().row(row0), yuv.y().row(row1), yuv.cb_row(cy), yuv.cr_row(cy), rgb.width(), m);
+            }
+        });
+    }
+
+    /** \brief Converts a planar or semi-planar YUV frame into an RGB frame of the same dimensions and bits depth.
+    * Chroma samples are repeated over their blocks of pixels. Rows are
+    * converted by workers if any, the calling thread waiting for them - so
+    * it must not be one of them. Throws std::invalid_argument if
+    * dimensions differ.
+    */
+    export template<RgbConvertibleYuvFrame F, YuvConvertiblePixel P>
+        requires (P::BITS_DEPTH == F::BITS_DEPTH)
+    void yuv_to_rgb(const F& yuv, FrameT<P>& rgb, const ColorSpec spec = ColorSpec(), FrameWorkers* workers = nullptr)
+    {
+        if (yuv.width() != rgb.width() || yuv.height() != rgb.height())
+            throw std::invalid_argument("YUV frames must get the dimensions of the RGB frame.");
+
+        const YuvMatrix m = yuv_matrix<P::BITS_DEPTH>(spec);
+        for_rows_bands(rgb.height(), rgb.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row) {
+                const std::size_t cy = row >> F::SUBSAMPLING.y_shift;
+                yuv_frame_row_to_rgb<F>(yuv.y().row(row), yuv.cb_row(cy), yuv.cr_row(cy), rgb.row(row), rgb.width(), m);
+            }
+        });
+    }
+
+    /** \brief Converts a YUV frame into a YUV frame of another format with the same chroma subsampling and dimensions.
+    * Planes are interleaved or deinterleaved, and samples rescaled to the
+    * bits depth of dst - rounded to the nearest when narrowed - in one
+    * pass. Rows are converted by workers if any, the calling thread
+    * waiting for them - so it must not be one of them. Throws
+    * std::invalid_argument if dimensions differ.
+    */
+    export template<YuvFrame FSrc, YuvFrame FDst>
+        requires (FSrc::SUBSAMPLING == FDst::SUBSAMPLING)
+    void convert_yuv(const FSrc& src, FDst& dst, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("YUV frames must get same dimensions for conversion.");
+
+        constexpr std::size_t Y_MASK = (std::size_t(1) << FSrc::SUBSAMPLING.y_shift) - 1;
+        const std::size_t chroma_width = FSrc::SUBSAMPLING.chroma_width(src.width());
+        for_rows_bands(src.height(), dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row) {
+                _convert_samples<FSrc, FDst>(src.y().row(row), dst.y().row(row), src.width());
+                if ((row & Y_MASK) != 0)
+                    continue;
+
+                const std::size_t cy = row >> FSrc::SUBSAMPLING.y_shift;
+                if constexpr (FSrc::IS_SEMI_PLANAR && FDst::IS_SEMI_PLANAR)
+                    _convert_samples<FSrc, FDst>(src.cb_row(cy), dst.cb_row(cy), 2 * chroma_width);
+                else if constexpr (FDst::IS_SEMI_PLANAR)
+                    _interleave_samples<FSrc, FDst>(src.cb_row(cy), src.cr_row(cy), dst.cb_row(cy), chroma_width);
+                else if constexpr (FSrc::IS_SEMI_PLANAR)
+                    _deinterleave_samples<FSrc, FDst>(src.cb_row(cy), dst.cb_row(cy), dst.cr_row(cy), chroma_width);
+                else {
+                    _convert_samples<FSrc, FDst>(src.cb_row(cy), dst.cb_row(cy), chroma_width);
+                    _convert_samples<FSrc, FDst>(src.cr_row(cy), dst.cr_row(cy), chroma_width);
+                }
+            }
+        });
+    }
+
+}
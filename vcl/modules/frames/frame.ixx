@@ -0,0 +1,372 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+export module frames.frame;
+
+import frames.frame_buffers;
+import frames.frame_memory;
+import frames.pixels;
+import graphitems.rect;
+import utils.dims;
+import utils.numa;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //-----------------------------------------------------------------------
+    // Forward declaration and Specializations
+    /** \brief The generic class of frames of pixels. */
+    export template<typename PixelT>
+        requires std::is_trivially_copyable_v<PixelT> && std::is_standard_layout_v<PixelT>
+    class FrameT;
+
+    /** \brief The class of frames with unsigned char pixels (8 bits gray). */
+    export using Frame_b = FrameT<std::uint8_t>;
+
+    /** \brief The class of frames with unsigned short pixels (16 bits gray). */
+    export using Frame_us = FrameT<std::uint16_t>;
+
+    /** \brief The class of frames with float pixels. */
+    export using Frame_f = FrameT<float>;
+
+    /** \brief The class of frames with RGB24 pixels. */
+    export using Frame_rgb24 = FrameT<RGB24>;
+
+    /** \brief The class of frames with BGR24 pixels, as OpenCV CV_8UC3 images. */
+    export using Frame_bgr24 = FrameT<BGR24>;
+
+    /** \brief The class of frames with RGBA32 pixels. */
+    export using Frame_rgba32 = FrameT<RGBA32>;
+
+    /** \brief The class of frames with BGRA32 pixels, as OpenCV CV_8UC4 images. */
+    export using Frame_bgra32 = FrameT<BGRA32>;
+
+    /** \brief The class of frames with 10-bits RGB pixels, in 16-bits containers. */
+    export using Frame_rgb30 = FrameT<RGB30>;
+
+
+    //=======================================================================
+    /** \brief The generic class of frames of pixels.
+    *
+    * Frames are sized by DimsT. Their rows start on FRAME_ROWS_ALIGNMENT
+    * bytes boundaries, the stride between rows being padded accordingly.
+    * Storage is reference-counted: copying a frame shares its pixels, as
+    * cv::Mat does, while clone() copies them.  Buffers come from a
+    * FrameBuffersPool, so that streaming frames of steady sizes does no
+    * heap allocation once the pool is warm.
+    *
+    * view() returns a zero-copy sub-frame sharing the pixels of its
+    * frame.  Cropping a rectangle and viewing it costs no copy.
+    */
+    template<typename PixelT>
+        requires std::is_trivially_copyable_v<PixelT> && std::is_standard_layout_v<PixelT>
+    class FrameT
+    {
+    public:
+        using MyType    = vcl::frames::FrameT<PixelT>;  //!< wrapper to this class naming.
+        using PixelType = PixelT;                       //!< wrapper to the pixels type naming.
+
+
+        //---   Constructors   ----------------------------------------------
+        /** \brief Empty constructor, no pixels. */
+        inline FrameT() noexcept = default;
+
+        /** \brief Constructor (width, height), pixels being left uninitialized. */
+        inline FrameT(const std::size_t width, const std::size_t height, FrameBuffersPool& pool = FrameBuffersPool::default_pool())
+        {
+            if (width > 0 && height > 0) {
+                m_stride = stride_bytes(width);
+                m_buffer = pool.acquire(buffer_key(width, height));
+                m_data = m_buffer->data();
+                m_width = width;
+                m_height = height;
+            }
+        }
+
+        /** \brief Constructor (const vcl::utils::DimsT&), pixels being left uninitialized. */
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        inline explicit FrameT(const vcl::utils::DimsT<T>& dims, FrameBuffersPool& pool = FrameBuffersPool::default_pool())
+            : FrameT(std::size_t(dims.width()), std::size_t(dims.height()), pool)
+        {}
+
+        /** \brief Copy constructor, pixels being shared. */
+        inline FrameT(const MyType& other) noexcept
+            : m_buffer(other.m_buffer), m_data(other.m_data), m_width(other.m_width), m_height(other.m_height), m_stride(other.m_stride), m_is_view(other.m_is_view)
+        {
+            if (m_buffer != nullptr)
+                m_buffer->add_ref();
+        }
+
+        /** \brief Move constructor. */
+        inline FrameT(MyType&& other) noexcept
+            : m_buffer(std::exchange(other.m_buffer, nullptr)),
+              m_data(std::exchange(other.m_data, nullptr)),
+              m_width(std::exchange(other.m_width, 0)),
+              m_height(std::exchange(other.m_height, 0)),
+              m_stride(std::exchange(other.m_stride, 0)),
+              m_is_view(std::exchange(other.m_is_view, false))
+        {}
+
+
+        //---   Destructor   ------------------------------------------------
+        /** \brief Destructor, the pixels going back to their pool once no more referenced. */
+        inline ~FrameT() noexcept
+        {
+            if (m_buffer != nullptr)
+                m_buffer->release();
+        }
+
+
+        //---   Assignments   -----------------------------------------------
+        /** \brief Copy assignment, pixels being shared. */
+        inline MyType& operator= (const MyType& other) noexcept
+        {
+            MyType(other).swap(*this);
+            return *this;
+        }
+
+        /** \brief Move assignment. */
+        inline MyType& operator= (MyType&& other) noexcept
+        {
+            MyType(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        /** \brief Swaps the content of two frames. */
+        inline void swap(MyType& other) noexcept
+        {
+            std::swap(m_buffer, other.m_buffer);
+            std::swap(m_data, other.m_data);
+            std::swap(m_width, other.m_width);
+            std::swap(m_height, other.m_height);
+            std::swap(m_stride, other.m_stride);
+            std::swap(m_is_view, other.m_is_view);
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the width of this frame, in pixels. */
+        inline const std::size_t width() const noexcept
+        {
+            return m_width;
+        }
+
+        /** \brief Returns the height of this frame, in pixels. */
+        inline const std::size_t height() const noexcept
+        {
+            return m_height;
+        }
+
+        /** \brief Returns the dimensions of this frame. */
+        inline vcl::utils::Dims_ui dims() const noexcept
+        {
+            return vcl::utils::Dims_ui(m_width, m_height);
+        }
+
+        /** \brief Returns the count of bytes between the starts of two consecutive rows. */
+        inline const std::size_t stride() const noexcept
+        {
+            return m_stride;
+        }
+
+        /** \brief Returns true if this frame gets no pixel. */
+        inline const bool is_empty() const noexcept
+        {
+            return m_data == nullptr;
+        }
+
+        /** \brief Returns true if this frame is a sub-frame of a larger frame. */
+        inline const bool is_view() const noexcept
+        {
+            return m_is_view;
+        }
+
+        /** \brief Returns the count of frames and views sharing the pixels of this frame. */
+        inline const long use_count() const noexcept
+        {
+            return m_buffer != nullptr ? m_buffer->use_count() : 0;
+        }
+
+        /** \brief Returns the pages backing the pixels of this frame. */
+        inline const FrameMemoryBacking memory_backing() const noexcept
+        {
+            return m_buffer != nullptr ? m_buffer->backing() : BACKING_DEFAULT_PAGES;
+        }
+
+        /** \brief Returns the NUMA node the pixels of this frame are bound to, or NO_NUMA_NODE. */
+        inline const int numa_node() const noexcept
+        {
+            return m_buffer != nullptr ? m_buffer->numa_node() : vcl::utils::NO_NUMA_NODE;
+        }
+
+        /** \brief Returns the first byte of the first row. */
+        inline std::byte* data() const noexcept
+        {
+            return m_data;
+        }
+
+        /** \brief Returns the first pixel of row y. Not checked. */
+        inline PixelT* row(const std::size_t y) noexcept
+        {
+            return reinterpret_cast<PixelT*>(m_data + y * m_stride);
+        }
+
+        /** \brief Returns the first pixel of row y. Not checked. */
+        inline const PixelT* row(const std::size_t y) const noexcept
+        {
+            return reinterpret_cast<const PixelT*>(m_data + y * m_stride);
+        }
+
+        /** \brief Returns the pixel at (x, y). Not checked. */
+        inline PixelT& operator() (const std::size_t x, const std::size_t y) noexcept
+        {
+            return row(y)[x];
+        }
+
+        /** \brief Returns the pixel at (x, y). Not checked. */
+        inline const PixelT& operator() (const std::size_t x, const std::size_t y) const noexcept
+        {
+            return row(y)[x];
+        }
+
+        /** \brief Returns the pixel at (x, y). Throws std::out_of_range if out of this frame. */
+        inline PixelT& at(const std::size_t x, const std::size_t y)
+        {
+            if (x >= m_width || y >= m_height)
+                throw std::out_of_range("pixel position out of frame.");
+            return row(y)[x];
+        }
+
+        /** \brief Returns the pixel at (x, y). Throws std::out_of_range if out of this frame. */
+        inline const PixelT& at(const std::size_t x, const std::size_t y) const
+        {
+            if (x >= m_width || y >= m_height)
+                throw std::out_of_range("pixel position out of frame.");
+            return row(y)[x];
+        }
+
+
+        //---   Views   -----------------------------------------------------
+        /** \brief Returns the zero-copy sub-frame of this frame covered by rect.
+        * rect is clipped to this frame. The view is empty if rect does not
+        * overlap this frame. Rows of the view are aligned on
+        * FRAME_ROWS_ALIGNMENT bytes only if its left x is.
+        */
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        MyType view(const vcl::graphitems::RectT<T>& rect) const noexcept
+        {
+            const long long left   = std::max(0LL, (long long)rect.x);
+            const long long top    = std::max(0LL, (long long)rect.y);
+            const long long right  = std::min((long long)m_width, (long long)rect.x + (long long)rect.width);
+            const long long bottom = std::min((long long)m_height, (long long)rect.y + (long long)rect.height);
+
+            MyType sub;
+            if (m_data != nullptr && left < right && top < bottom) {
+                sub.m_buffer = m_buffer;
+                m_buffer->add_ref();
+                sub.m_data = m_data + std::size_t(top) * m_stride + std::size_t(left) * sizeof(PixelT);
+                sub.m_width = std::size_t(right - left);
+                sub.m_height = std::size_t(bottom - top);
+                sub.m_stride = m_stride;
+                sub.m_is_view = true;
+            }
+            return sub;
+        }
+
+
+        //---   Copies   ----------------------------------------------------
+        /** \brief Returns a copy of this frame with its own pixels, rows being aligned. */
+        MyType clone(FrameBuffersPool& pool = FrameBuffersPool::default_pool()) const
+        {
+            MyType copy(m_width, m_height, pool);
+            copy_to(copy);
+            return copy;
+        }
+
+        /** \brief Copies the pixels of this frame into other. Throws std::invalid_argument if dimensions differ. */
+        void copy_to(MyType& other) const
+        {
+            if (other.m_width != m_width || other.m_height != m_height)
+                throw std::invalid_argument("frames must get same dimensions for copy.");
+            const std::size_t row_bytes = m_width * sizeof(PixelT);
+            for (std::size_t y = 0; y < m_height; ++y)
+                std::memmove(other.m_data + y * other.m_stride, m_data + y * m_stride, row_bytes);
+        }
+
+        /** \brief Sets all pixels of this frame to value. */
+        void fill(const PixelT& value) noexcept
+        {
+            for (std::size_t y = 0; y < m_height; ++y)
+                std::fill_n(row(y), m_width, value);
+        }
+
+
+        //---   Strides   ---------------------------------------------------
+        /** \brief Returns the stride of frames rows width pixels wide, in bytes. */
+        static inline constexpr std::size_t stride_bytes(const std::size_t width) noexcept
+        {
+            return (width * sizeof(PixelT) + FRAME_ROWS_ALIGNMENT - 1) / FRAME_ROWS_ALIGNMENT * FRAME_ROWS_ALIGNMENT;
+        }
+
+        /** \brief Returns the key of the buffers of frames (width, height). */
+        static inline FrameBufferKey buffer_key(const std::size_t width, const std::size_t height) noexcept
+        {
+            return FrameBufferKey{ width, height, stride_bytes(width), pixel_format_tag<PixelT>() };
+        }
+
+
+        //---   Pools   -----------------------------------------------------
+        /** \brief Allocates count buffers of frames (width, height) in pool, touching their memory pages. */
+        static inline void prewarm(const std::size_t width, const std::size_t height, const std::size_t count,
+                                   FrameBuffersPool& pool = FrameBuffersPool::default_pool())
+        {
+            if (width > 0 && height > 0)
+                pool.prewarm(buffer_key(width, height), count);
+        }
+
+
+    private:
+        FrameBuffer* m_buffer{ nullptr };  //!< the shared buffer of pixels.
+        std::byte*   m_data{ nullptr };    //!< the first byte of the first row.
+        std::size_t  m_width{ 0 };         //!< the width of this frame, in pixels.
+        std::size_t  m_height{ 0 };        //!< the height of this frame, in pixels.
+        std::size_t  m_stride{ 0 };        //!< the count of bytes between two consecutive rows.
+        bool         m_is_view{ false };   //!< true if this frame is a sub-frame of a larger frame.
+    };
+
+}
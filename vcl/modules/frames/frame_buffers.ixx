@@ -0,0 +1,737 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+export module frames.frame_buffers;
+
+import frames.frame_memory;
+import utils.allocations;
+import utils.numa;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The alignment of frame buffers and of frame rows, in bytes. */
+    export constexpr std::size_t FRAME_ROWS_ALIGNMENT = 64;
+
+    /** \brief The size of memory pages touched when pre-warming buffers, in bytes. */
+    export constexpr std::size_t FRAME_PAGES_SIZE = 4096;
+
+
+    //===================================================================
+    /** \brief Returns a tag identifying the pixel format PixelT, to key frame buffers. */
+    export template<typename PixelT>
+    inline const void* pixel_format_tag() noexcept
+    {
+        static const char tag = 0;
+        return &tag;
+    }
+
+
+    //===================================================================
+    /** \brief The key of frame buffers: frames dimensions, stride and pixel format.
+    * Pools hand out again free buffers to frames of the same key only.
+    */
+    export struct FrameBufferKey
+    {
+        std::size_t width{ 0 };             //!< the width of frames, in pixels.
+        std::size_t height{ 0 };            //!< the height of frames, in pixels.
+        std::size_t stride{ 0 };            //!< the count of bytes between two consecutive rows.
+        const void* pixel_format{ nullptr };  //!< the tag of the pixel format of frames, see pixel_format_tag().
+
+        /** \brief Returns the size of buffers with this key, in bytes. */
+        inline const std::size_t bytes_count() const noexcept
+        {
+            return stride * height;
+        }
+
+        inline bool operator== (const FrameBufferKey&) const noexcept = default;
+    };
+
+
+    export class FrameBuffersPool;
+
+
+    //===================================================================
+    /** \brief The class of reference-counted frame buffers.
+    *
+    * Buffers are aligned on FRAME_ROWS_ALIGNMENT bytes.  They are shared
+    * by frames and by their views, and go back to their pool once their
+    * last reference is released. The reference count is embedded in the
+    * buffer, so that sharing buffers never allocates memory.
+    */
+    export class FrameBuffer
+    {
+    public:
+        FrameBuffer(const FrameBuffer&) = delete;
+        FrameBuffer& operator= (const FrameBuffer&) = delete;
+
+        /** \brief Returns the first byte of this buffer. */
+        inline std::byte* data() const noexcept
+        {
+            return m_memory.data;
+        }
+
+        /** \brief Returns the pages backing this buffer. */
+        inline const FrameMemoryBacking backing() const noexcept
+        {
+            return m_memory.backing;
+        }
+
+        /** \brief Returns the size of this buffer, in bytes. */
+        inline const std::size_t capacity() const noexcept
+        {
+            return m_key.bytes_count();
+        }
+
+        /** \brief Returns the NUMA node this buffer is bound to, or NO_NUMA_NODE. */
+        inline const int numa_node() const noexcept
+        {
+            return m_memory.numa_node;
+        }
+
+        /** \brief Returns the key of this buffer. */
+        inline const FrameBufferKey& key() const noexcept
+        {
+            return m_key;
+        }
+
+        /** \brief Returns the count of references to this buffer. */
+        inline const long use_count() const noexcept
+        {
+            return m_refs.load(std::memory_order_acquire);
+        }
+
+        /** \brief Adds one reference to this buffer. */
+        inline void add_ref() noexcept
+        {
+            m_refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /** \brief Releases one reference to this buffer, giving it back to its pool when no more referenced. */
+        inline void release() noexcept;
+
+
+    private:
+        friend class FrameBuffersPool;
+
+        inline FrameBuffer(const FrameMemory& memory, const FrameBufferKey& key, FrameBuffersPool* pool) noexcept
+            : m_memory(memory), m_key(key), m_pool(pool)
+        {}
+
+        std::atomic<long> m_refs{ 0 };  //!< the count of references to this buffer.
+        FrameMemory       m_memory;     //!< the aligned memory of this buffer.
+        FrameBufferKey    m_key;        //!< the key of this buffer.
+        FrameBuffersPool* m_pool;       //!< the pool this buffer goes back to.
+    };
+
+
+    //===================================================================
+    /** \brief The statistics of a pool of frame buffers. */
+    export struct FrameBuffersPoolStats
+    {
+        unsigned long long allocations_count;     //!< the count of buffers allocated from the heap.
+        unsigned long long heap_frees_count;      //!< the count of buffers given back to the heap.
+        unsigned long long thread_cache_hits;     //!< the count of buffers handed out again from per-thread caches.
+        unsigned long long overflow_hits;         //!< the count of buffers handed out again from the shared overflow list.
+        std::size_t        free_count;            //!< the count of free buffers.
+        std::size_t        free_bytes;            //!< the total size of free buffers, in bytes.
+        std::size_t        allocated_bytes;       //!< the total size of buffers allocated from the heap and not yet freed, in bytes.
+        std::size_t        peak_allocated_bytes;  //!< the peak of allocated_bytes.
+        std::size_t        max_bytes;             //!< the memory cap of the pool, in bytes.
+        std::size_t        max_free_bytes;        //!< the maximum total size of free buffers, in bytes.
+        std::array<unsigned long long, BACKINGS_COUNT> backings_counts;  //!< the count of buffers allocated per pages backing.
+        unsigned long long numa_bound_count;      //!< the count of buffers allocated bound to a NUMA node.
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief The per-thread cache of free buffers of one pool.
+    * Only accessed by its owning thread, so with no lock, but when its pool
+    * is destroyed or when its thread ends.
+    */
+    struct _ThreadCache
+    {
+        static constexpr std::size_t SLOTS_COUNT = 8;
+
+        std::atomic<FrameBuffersPool*> pool{ nullptr };
+        std::array<FrameBuffer*, SLOTS_COUNT> buffers{};
+        std::size_t count{ 0 };
+    };
+
+    /** \brief The registry of per-thread caches, protecting links between pools and caches. */
+    struct _CachesRegistry
+    {
+        std::mutex mutex;
+
+        static _CachesRegistry& instance()
+        {
+            static _CachesRegistry registry;
+            return registry;
+        }
+    };
+
+    /** \brief The per-thread caches of the calling thread, one per used pool. Flushed at thread end. */
+    struct _ThreadCaches
+    {
+        std::vector<std::unique_ptr<_ThreadCache>> caches;
+
+        inline ~_ThreadCaches() noexcept;
+    };
+
+    /** \brief Set once the caches of the calling thread are flushed, buffers released later on going to overflow lists. */
+    thread_local bool _thread_caches_ended = false;
+
+    inline _ThreadCaches* _thread_caches() noexcept
+    {
+        if (_thread_caches_ended)
+            return nullptr;
+        thread_local _ThreadCaches caches;
+        return &caches;
+    }
+
+
+    //===================================================================
+    /** \brief The class of recycling pools of frame buffers.
+    *
+    * Released buffers are kept for frames with the same key - same
+    * dimensions and pixel format. Each thread first recycles buffers
+    * from its own cache, with no lock,  then from a shared overflow list.
+    * Streaming frames of steady sizes does no heap allocation once the
+    * pool is warm, see prewarm().
+    *
+    * Free buffers in excess of max_free_bytes() go back to the heap. The
+    * total size of buffers allocated by the pool never exceeds max_bytes():
+    * std::bad_alloc is thrown instead, once the free buffers with other
+    * keys have been freed.
+    *
+    * Large buffers may be backed by huge pages,  which saves TLB misses
+    * when traversing 4K and 8K frames, see huge_pages().  Pools count the
+    * buffers allocated per pages backing, since huge pages fall back to
+    * default pages when the platform gets none.
+    *
+    * The memory of new buffers may be bound to a NUMA node, see
+    * numa_node(). One pool per node then feeds the workers of the node,
+    * see FrameWorkers.
+    *
+    * Pools must outlive the buffers they hand out and must not be
+    * destroyed while other threads use them.  The default pool is never
+    * destroyed for these reasons.
+    */
+    export class FrameBuffersPool
+    {
+    public:
+        static constexpr std::size_t DEFAULT_MAX_FREE_BYTES = std::size_t(512) << 20;             //!< 512 MB of free buffers at most, by default.
+        static constexpr std::size_t UNLIMITED_BYTES = std::numeric_limits<std::size_t>::max();  //!< no memory cap.
+
+        //---   Constructors / Destructor   -------------------------------
+        /** \brief Constructor. */
+        inline explicit FrameBuffersPool(const std::size_t max_free_bytes = DEFAULT_MAX_FREE_BYTES,
+                                         const std::size_t max_bytes = UNLIMITED_BYTES)
+            : m_max_free_bytes(max_free_bytes), m_max_bytes(max_bytes)
+        {
+            vcl::utils::AllocationSite site("vcl::frames::FrameBuffersPool::FrameBuffersPool()");
+            m_overflow.reserve(64);
+        }
+
+        /** \brief Destructor. Frees the free buffers, detaching the per-thread caches. */
+        inline ~FrameBuffersPool() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> registry_lock(_CachesRegistry::instance().mutex);
+                for (_ThreadCache* cache : m_caches) {
+                    for (std::size_t i = 0; i < cache->count; ++i)
+                        prvt_delete(cache->buffers[i]);
+                    cache->count = 0;
+                    cache->pool.store(nullptr, std::memory_order_release);
+                }
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (FrameBuffer* buffer : m_overflow)
+                prvt_delete(buffer);
+        }
+
+        FrameBuffersPool(const FrameBuffersPool&) = delete;
+        FrameBuffersPool& operator= (const FrameBuffersPool&) = delete;
+
+        /** \brief Returns the default pool of frame buffers. */
+        static FrameBuffersPool& default_pool()
+        {
+            static FrameBuffersPool* pool = new FrameBuffersPool();  // never deleted, see class comment
+            return *pool;
+        }
+
+
+        //---   Buffers   -------------------------------------------------
+        /** \brief Returns a buffer for key, referenced once.
+        * Recycles a free buffer with the same key if any,  from the cache
+        * of the calling thread first. Allocates a new one from the heap
+        * otherwise. Throws std::bad_alloc if max_bytes() would be exceeded.
+        */
+        FrameBuffer* acquire(const FrameBufferKey& key)
+        {
+            // per-thread cache, no lock
+            if (_ThreadCache* cache = prvt_thread_cache()) {
+                for (std::size_t i = 0; i < cache->count; ++i) {
+                    if (cache->buffers[i]->key() == key) {
+                        FrameBuffer* buffer = cache->buffers[i];
+                        cache->buffers[i] = cache->buffers[--cache->count];
+                        m_thread_cache_hits.fetch_add(1, std::memory_order_relaxed);
+                        return prvt_hand_out(buffer);
+                    }
+                }
+            }
+
+            // shared overflow list
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (std::size_t i = 0; i < m_overflow.size(); ++i) {
+                    if (m_overflow[i]->key() == key) {
+                        FrameBuffer* buffer = m_overflow[i];
+                        m_overflow[i] = m_overflow.back();
+                        m_overflow.pop_back();
+                        m_overflow_hits.fetch_add(1, std::memory_order_relaxed);
+                        return prvt_hand_out(buffer);
+                    }
+                }
+            }
+
+            // heap
+            FrameBuffer* buffer = prvt_allocate(key);
+            buffer->m_refs.store(1, std::memory_order_relaxed);
+            return buffer;
+        }
+
+        /** \brief Allocates count free buffers for key, touching their memory pages if asked.
+        * Pre-warming avoids page faults and heap allocations on the first
+        * frames of a stream. Throws std::invalid_argument if the count
+        * buffers alone would exceed max_bytes(),  and std::bad_alloc if
+        * max_bytes() would be exceeded once the free buffers with other
+        * keys have been freed. Buffers in excess of max_free_bytes() are
+        * not kept.
+        */
+        void prewarm(const FrameBufferKey& key, const std::size_t count, const bool touch_pages = true)
+        {
+            const std::size_t bytes_count = key.bytes_count();
+            if (bytes_count > 0 && count > max_bytes() / bytes_count)
+                throw std::invalid_argument(std::format("cannot prewarm {:d} frame buffers of {:d} bytes in a pool capped to {:d} bytes.",
+                                                        count, bytes_count, max_bytes()));
+
+            for (std::size_t n = 0; n < count; ++n) {
+                FrameBuffer* buffer = prvt_allocate(key);
+                if (touch_pages) {
+                    volatile std::byte* p = buffer->data();
+                    for (std::size_t offset = 0; offset < buffer->capacity(); offset += FRAME_PAGES_SIZE)
+                        p[offset] = std::byte(0);
+                }
+
+                const std::size_t bytes = buffer->capacity();
+                if (m_free_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes > max_free_bytes()) {
+                    m_free_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                    prvt_delete(buffer);
+                    return;
+                }
+                m_free_count.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                vcl::utils::AllocationSite site("vcl::frames::FrameBuffersPool::prewarm()");
+                m_overflow.push_back(buffer);
+            }
+        }
+
+        /** \brief Gives back to the heap the free buffers in excess of max_free_bytes.
+        * Trims the cache of the calling thread first,  then the overflow
+        * list. Caches of other threads are left untouched.
+        */
+        void trim(const std::size_t max_free_bytes) noexcept
+        {
+            if (_ThreadCache* cache = prvt_thread_cache(false)) {
+                while (cache->count > 0 && m_free_bytes.load(std::memory_order_relaxed) > max_free_bytes)
+                    prvt_free(cache->buffers[--cache->count]);
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (!m_overflow.empty() && m_free_bytes.load(std::memory_order_relaxed) > max_free_bytes) {
+                prvt_free(m_overflow.back());
+                m_overflow.pop_back();
+            }
+        }
+
+
+        //---   Statistics   ----------------------------------------------
+        /** \brief Returns the count of buffers allocated from the heap. */
+        inline const unsigned long long allocations_count() const noexcept
+        {
+            return m_allocations_count.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the count of buffers handed out again from caches and from the overflow list. */
+        inline const unsigned long long recycled_count() const noexcept
+        {
+            return m_thread_cache_hits.load(std::memory_order_relaxed) + m_overflow_hits.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the count of free buffers. */
+        inline const std::size_t free_count() const noexcept
+        {
+            return m_free_count.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the total size of free buffers, in bytes. */
+        inline const std::size_t free_bytes() const noexcept
+        {
+            return m_free_bytes.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the total size of buffers allocated from the heap and not yet freed, in bytes. */
+        inline const std::size_t allocated_bytes() const noexcept
+        {
+            return m_allocated_bytes.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the maximum total size of free buffers, in bytes. */
+        inline const std::size_t max_free_bytes() const noexcept
+        {
+            return m_max_free_bytes.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Sets the maximum total size of free buffers, in bytes, trimming free buffers in excess. */
+        inline void max_free_bytes(const std::size_t max_bytes) noexcept
+        {
+            m_max_free_bytes.store(max_bytes, std::memory_order_relaxed);
+            trim(max_bytes);
+        }
+
+        /** \brief Returns the memory cap of this pool, in bytes. */
+        inline const std::size_t max_bytes() const noexcept
+        {
+            return m_max_bytes.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Sets the memory cap of this pool, in bytes. Buffers already allocated are kept. */
+        inline void max_bytes(const std::size_t max_bytes) noexcept
+        {
+            m_max_bytes.store(max_bytes, std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the use of huge pages for new buffers. */
+        inline const HugePagesMode huge_pages() const noexcept
+        {
+            return m_huge_pages.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Sets the use of huge pages for new buffers. Free buffers are kept with their current pages. */
+        inline void huge_pages(const HugePagesMode mode) noexcept
+        {
+            m_huge_pages.store(mode, std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the NUMA node new buffers are bound to, or NO_NUMA_NODE. */
+        inline const int numa_node() const noexcept
+        {
+            return m_numa_node.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Binds the memory of new buffers to node of topology, or unbinds it with NO_NUMA_NODE.
+        * Free buffers are kept with their current binding,  so the node is
+        * better set before acquiring buffers. topology must outlive this pool.
+        */
+        inline void numa_node(const int node, const vcl::utils::NumaTopology& topology = vcl::utils::NumaTopology::system()) noexcept
+        {
+            m_numa_topology.store(&topology, std::memory_order_relaxed);
+            m_numa_node.store(node, std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the count of buffers allocated with the specified pages backing. */
+        inline const unsigned long long backing_count(const FrameMemoryBacking backing) const noexcept
+        {
+            return m_backings_counts[backing].load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns a snapshot of the statistics of this pool. */
+        FrameBuffersPoolStats stats() const noexcept
+        {
+            return FrameBuffersPoolStats{
+                m_allocations_count.load(std::memory_order_relaxed),
+                m_heap_frees_count.load(std::memory_order_relaxed),
+                m_thread_cache_hits.load(std::memory_order_relaxed),
+                m_overflow_hits.load(std::memory_order_relaxed),
+                m_free_count.load(std::memory_order_relaxed),
+                m_free_bytes.load(std::memory_order_relaxed),
+                m_allocated_bytes.load(std::memory_order_relaxed),
+                m_peak_allocated_bytes.load(std::memory_order_relaxed),
+                m_max_bytes.load(std::memory_order_relaxed),
+                m_max_free_bytes.load(std::memory_order_relaxed),
+                { backing_count(BACKING_DEFAULT_PAGES), backing_count(BACKING_TRANSPARENT_HUGE), backing_count(BACKING_HUGETLB) },
+                m_numa_bound_count.load(std::memory_order_relaxed)
+            };
+        }
+
+        /** \brief Returns a text report of the statistics of this pool. */
+        std::string report() const
+        {
+            const FrameBuffersPoolStats s = stats();
+            std::string txt = std::format("heap allocations {:d}, heap frees {:d}, thread cache hits {:d}, overflow hits {:d}\n",
+                                          s.allocations_count, s.heap_frees_count, s.thread_cache_hits, s.overflow_hits);
+            txt += std::format("allocated {:.1f} MB (peak {:.1f} MB), free {:d} buffers / {:.1f} MB",
+                               s.allocated_bytes / 1048576.0, s.peak_allocated_bytes / 1048576.0, s.free_count, s.free_bytes / 1048576.0);
+            if (s.max_bytes != UNLIMITED_BYTES)
+                txt += std::format(", cap {:.1f} MB", s.max_bytes / 1048576.0);
+            txt += '\n';
+            for (int b = 0; b < BACKINGS_COUNT; ++b)
+                txt += std::format("{}{} {:d}", b == 0 ? "" : ", ", backing_name(FrameMemoryBacking(b)), s.backings_counts[b]);
+            if (const int node = numa_node(); node != vcl::utils::NO_NUMA_NODE)
+                txt += std::format(", bound to NUMA node {:d}: {:d}", node, s.numa_bound_count);
+            return txt + '\n';
+        }
+
+
+    private:
+        friend class FrameBuffer;
+        friend struct _ThreadCaches;
+
+        /** \brief Returns the cache of the calling thread for this pool, creating it if asked. nullptr if none. */
+        _ThreadCache* prvt_thread_cache(const bool create = true) noexcept
+        {
+            _ThreadCaches* caches = _thread_caches();
+            if (caches == nullptr)
+                return nullptr;
+            _ThreadCache* detached = nullptr;
+            for (const std::unique_ptr<_ThreadCache>& cache : caches->caches) {
+                FrameBuffersPool* pool = cache->pool.load(std::memory_order_acquire);
+                if (pool == this)
+                    return cache.get();
+                if (pool == nullptr && detached == nullptr)
+                    detached = cache.get();
+            }
+            if (!create)
+                return nullptr;
+
+            try {
+                vcl::utils::AllocationSite site("vcl::frames::FrameBuffersPool::thread_cache()");
+                std::lock_guard<std::mutex> registry_lock(_CachesRegistry::instance().mutex);
+                m_caches.push_back(detached);
+                if (detached == nullptr) {
+                    caches->caches.push_back(std::make_unique<_ThreadCache>());
+                    m_caches.back() = detached = caches->caches.back().get();
+                }
+                detached->pool.store(this, std::memory_order_release);
+                return detached;
+            }
+            catch (...) {
+                if (!m_caches.empty() && m_caches.back() == nullptr)
+                    m_caches.pop_back();
+                return nullptr;  // no memory left for caches: the overflow list only is used
+            }
+        }
+
+        /** \brief Allocates a new buffer from the heap, freeing free buffers with other keys if max_bytes() would be exceeded. */
+        FrameBuffer* prvt_allocate(const FrameBufferKey& key)
+        {
+            const std::size_t bytes = key.bytes_count();
+            if (m_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes > max_bytes()) {
+                prvt_free_other_keys(key);
+                if (m_allocated_bytes.load(std::memory_order_relaxed) > max_bytes()) {
+                    m_allocated_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                    throw std::bad_alloc();
+                }
+            }
+
+            FrameBuffer* buffer = nullptr;
+            try {
+                vcl::utils::AllocationSite site("vcl::frames::FrameBuffersPool::acquire()");
+                const FrameMemory memory = allocate_frame_memory(bytes, FRAME_ROWS_ALIGNMENT, huge_pages(),
+                                                                 m_numa_topology.load(std::memory_order_relaxed), numa_node());
+                try {
+                    buffer = new FrameBuffer(memory, key, this);
+                }
+                catch (...) {
+                    free_frame_memory(memory);
+                    throw;
+                }
+            }
+            catch (...) {
+                m_allocated_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                throw;
+            }
+
+            m_allocations_count.fetch_add(1, std::memory_order_relaxed);
+            m_backings_counts[buffer->backing()].fetch_add(1, std::memory_order_relaxed);
+            if (buffer->numa_node() != vcl::utils::NO_NUMA_NODE)
+                m_numa_bound_count.fetch_add(1, std::memory_order_relaxed);
+            const std::size_t allocated = m_allocated_bytes.load(std::memory_order_relaxed);
+            std::size_t peak = m_peak_allocated_bytes.load(std::memory_order_relaxed);
+            while (allocated > peak && !m_peak_allocated_bytes.compare_exchange_weak(peak, allocated, std::memory_order_relaxed))
+                ;
+            return buffer;
+        }
+
+        /** \brief Hands out a free buffer, referenced once. */
+        inline FrameBuffer* prvt_hand_out(FrameBuffer* buffer) noexcept
+        {
+            m_free_count.fetch_sub(1, std::memory_order_relaxed);
+            m_free_bytes.fetch_sub(buffer->capacity(), std::memory_order_relaxed);
+            buffer->m_refs.store(1, std::memory_order_relaxed);
+            return buffer;
+        }
+
+        /** \brief Puts back a no more referenced buffer in the cache of the calling thread, else in the overflow list, else frees it. */
+        void prvt_recycle(FrameBuffer* buffer) noexcept
+        {
+            const std::size_t bytes = buffer->capacity();
+            if (m_free_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes > max_free_bytes()) {
+                m_free_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                prvt_release_to_heap(buffer);
+                return;
+            }
+            m_free_count.fetch_add(1, std::memory_order_relaxed);
+
+            if (_ThreadCache* cache = prvt_thread_cache()) {
+                if (cache->count < _ThreadCache::SLOTS_COUNT) {
+                    cache->buffers[cache->count++] = buffer;
+                    return;
+                }
+            }
+            prvt_push_overflow(buffer);
+        }
+
+        /** \brief Puts a free buffer in the overflow list, or frees it if no memory is left for the list. */
+        void prvt_push_overflow(FrameBuffer* buffer) noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            try {
+                vcl::utils::AllocationSite site("vcl::frames::FrameBuffersPool::recycle()");
+                m_overflow.push_back(buffer);
+            }
+            catch (...) {
+                prvt_free(buffer);
+            }
+        }
+
+        /** \brief Frees a free buffer. */
+        inline void prvt_free(FrameBuffer* buffer) noexcept
+        {
+            m_free_count.fetch_sub(1, std::memory_order_relaxed);
+            m_free_bytes.fetch_sub(buffer->capacity(), std::memory_order_relaxed);
+            prvt_release_to_heap(buffer);
+        }
+
+        /** \brief Gives back to the heap the free buffers with keys other than key.
+        * Frees from the cache of the calling thread and from the overflow
+        * list, so that the buffers just pre-warmed for key are kept.
+        */
+        void prvt_free_other_keys(const FrameBufferKey& key) noexcept
+        {
+            if (_ThreadCache* cache = prvt_thread_cache(false)) {
+                for (std::size_t i = cache->count; i-- > 0; ) {
+                    if (cache->buffers[i]->key() != key) {
+                        prvt_free(cache->buffers[i]);
+                        cache->buffers[i] = cache->buffers[--cache->count];
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::erase_if(m_overflow, [this, &key](FrameBuffer* buffer) {
+                if (buffer->key() == key)
+                    return false;
+                prvt_free(buffer);
+                return true;
+            });
+        }
+
+        /** \brief Gives back a buffer to the heap. */
+        inline void prvt_release_to_heap(FrameBuffer* buffer) noexcept
+        {
+            m_allocated_bytes.fetch_sub(buffer->capacity(), std::memory_order_relaxed);
+            m_heap_frees_count.fetch_add(1, std::memory_order_relaxed);
+            prvt_delete(buffer);
+        }
+
+        static inline void prvt_delete(FrameBuffer* buffer) noexcept
+        {
+            free_frame_memory(buffer->m_memory);
+            delete buffer;
+        }
+
+        mutable std::mutex              m_mutex;                      //!< protects the overflow list.
+        std::vector<FrameBuffer*>       m_overflow;                   //!< the free buffers shared by all threads.
+        std::vector<_ThreadCache*>      m_caches;                     //!< the per-thread caches of this pool, protected by the caches registry mutex.
+        std::atomic<std::size_t>        m_free_count{ 0 };            //!< the count of free buffers.
+        std::atomic<std::size_t>        m_free_bytes{ 0 };            //!< the total size of free buffers.
+        std::atomic<std::size_t>        m_allocated_bytes{ 0 };       //!< the total size of buffers allocated from the heap.
+        std::atomic<std::size_t>        m_peak_allocated_bytes{ 0 };  //!< the peak of m_allocated_bytes.
+        std::atomic<std::size_t>        m_max_free_bytes;             //!< the maximum total size of the free buffers.
+        std::atomic<std::size_t>        m_max_bytes;                  //!< the memory cap.
+        std::atomic<HugePagesMode>      m_huge_pages{ HUGE_PAGES_OFF };  //!< the use of huge pages for new buffers.
+        std::atomic<const vcl::utils::NumaTopology*> m_numa_topology{ nullptr };  //!< the NUMA topology of m_numa_node.
+        std::atomic<int>                m_numa_node{ vcl::utils::NO_NUMA_NODE };  //!< the NUMA node new buffers are bound to.
+        std::atomic<unsigned long long> m_allocations_count{ 0 };     //!< the count of buffers allocated from the heap.
+        std::atomic<unsigned long long> m_heap_frees_count{ 0 };      //!< the count of buffers given back to the heap.
+        std::atomic<unsigned long long> m_thread_cache_hits{ 0 };     //!< the count of buffers handed out again from per-thread caches.
+        std::atomic<unsigned long long> m_overflow_hits{ 0 };         //!< the count of buffers handed out again from the overflow list.
+        std::array<std::atomic<unsigned long long>, BACKINGS_COUNT> m_backings_counts{};  //!< the count of buffers allocated per pages backing.
+        std::atomic<unsigned long long> m_numa_bound_count{ 0 };      //!< the count of buffers allocated bound to a NUMA node.
+    };
+
+
+    //-----------------------------------------------------------------------
+    inline void FrameBuffer::release() noexcept
+    {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            m_pool->prvt_recycle(this);
+    }
+
+    //-----------------------------------------------------------------------
+    inline _ThreadCaches::~_ThreadCaches() noexcept
+    {
+        _thread_caches_ended = true;
+        std::lock_guard<std::mutex> registry_lock(_CachesRegistry::instance().mutex);
+        for (const std::unique_ptr<_ThreadCache>& cache : caches) {
+            FrameBuffersPool* pool = cache->pool.load(std::memory_order_acquire);
+            if (pool == nullptr)
+                continue;
+            for (std::size_t i = 0; i < cache->count; ++i)
+                pool->prvt_push_overflow(cache->buffers[i]);
+            cache->count = 0;
+            std::erase(pool->m_caches, cache.get());
+        }
+    }
+
+}
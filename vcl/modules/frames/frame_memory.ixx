@@ -0,0 +1,240 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#   define VCL_HUGE_PAGES_AVAILABLE
+#   include <sys/mman.h>
+#endif
+
+export module frames.frame_memory;
+
+import utils.numa;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The size of huge pages, in bytes. */
+    export constexpr std::size_t HUGE_PAGES_SIZE = std::size_t(2) << 20;
+
+    /** \brief The minimum size of memory blocks backed by huge pages, in bytes. Smaller blocks get default pages. */
+    export constexpr std::size_t HUGE_PAGES_MIN_BYTES = HUGE_PAGES_SIZE;
+
+
+    //===================================================================
+    /** \brief The pages backing frames memory. */
+    export enum FrameMemoryBacking : unsigned char
+    {
+        BACKING_DEFAULT_PAGES = 0,    //!< default pages, from the heap.
+        BACKING_TRANSPARENT_HUGE,     //!< transparent huge pages, advised on an anonymous mapping.
+        BACKING_HUGETLB,              //!< explicit huge pages, mapped from hugetlbfs.
+        BACKINGS_COUNT
+    };
+
+    /** \brief The use of huge pages for frames memory. */
+    export enum HugePagesMode : unsigned char
+    {
+        HUGE_PAGES_OFF = 0,           //!< default pages only.
+        HUGE_PAGES_TRANSPARENT,       //!< transparent huge pages, else default pages.
+        HUGE_PAGES_EXPLICIT           //!< explicit huge pages, else transparent huge pages, else default pages.
+    };
+
+    /** \brief Returns the name of a memory backing. */
+    export inline const char* backing_name(const FrameMemoryBacking backing) noexcept
+    {
+        switch (backing) {
+        case BACKING_TRANSPARENT_HUGE:
+            return "transparent huge pages";
+        case BACKING_HUGETLB:
+            return "hugetlb pages";
+        default:
+            return "default pages";
+        }
+    }
+
+
+    //===================================================================
+    /** \brief A block of frames memory, as allocated by allocate_frame_memory(). */
+    export struct FrameMemory
+    {
+        std::byte*         data{ nullptr };               //!< the first byte of the block.
+        std::size_t        mapped_bytes{ 0 };             //!< the size of the mapping, 0 if allocated from the heap.
+        std::size_t        alignment{ 0 };                //!< the alignment of the block, if allocated from the heap.
+        FrameMemoryBacking backing{ BACKING_DEFAULT_PAGES };  //!< the pages backing the block.
+        int                numa_node{ vcl::utils::NO_NUMA_NODE };  //!< the NUMA node the block is bound to, if any.
+    };
+
+
+    //===================================================================
+    /** \brief Returns true if transparent huge pages can be advised on this platform. */
+    export inline const bool transparent_huge_pages_available() noexcept
+    {
+#if defined(VCL_HUGE_PAGES_AVAILABLE)
+        static const bool available = []() {
+            try {
+                std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+                std::string modes;
+                std::getline(file, modes);
+                return modes.find("[always]") != std::string::npos || modes.find("[madvise]") != std::string::npos;
+            }
+            catch (...) {
+                return false;
+            }
+        }();
+        return available;
+#else
+        return false;
+#endif
+    }
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+#if defined(VCL_HUGE_PAGES_AVAILABLE)
+    /** \brief Returns bytes_count rounded up to a multiple of the huge pages size. */
+    inline constexpr std::size_t _huge_pages_bytes(const std::size_t bytes_count) noexcept
+    {
+        return (bytes_count + HUGE_PAGES_SIZE - 1) / HUGE_PAGES_SIZE * HUGE_PAGES_SIZE;
+    }
+
+    /** \brief The size of default pages, in bytes. */
+    constexpr std::size_t _DEFAULT_PAGES_SIZE = 4096;
+
+    /** \brief Maps default pages. nullptr if failed. */
+    inline std::byte* _map_default_pages(const std::size_t mapped_bytes) noexcept
+    {
+        void* p = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p != MAP_FAILED ? static_cast<std::byte*>(p) : nullptr;
+    }
+
+    /** \brief Maps explicit huge pages. nullptr if none are reserved. */
+    inline std::byte* _map_hugetlb(const std::size_t mapped_bytes) noexcept
+    {
+        void* p = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        return p != MAP_FAILED ? static_cast<std::byte*>(p) : nullptr;
+    }
+
+    /** \brief Maps default pages aligned on huge pages, advising transparent huge pages on them. nullptr if failed. */
+    inline std::byte* _map_transparent_huge(const std::size_t mapped_bytes) noexcept
+    {
+        // over-maps by one huge page, then unmaps the unaligned head and tail
+        const std::size_t over_bytes = mapped_bytes + HUGE_PAGES_SIZE;
+        void* p = mmap(nullptr, over_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return nullptr;
+
+        std::byte* begin = static_cast<std::byte*>(p);
+        std::byte* aligned = reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(begin) + HUGE_PAGES_SIZE - 1) & ~std::uintptr_t(HUGE_PAGES_SIZE - 1));
+        if (aligned > begin)
+            munmap(begin, std::size_t(aligned - begin));
+        if (std::byte* end = aligned + mapped_bytes; end < begin + over_bytes)
+            munmap(end, std::size_t(begin + over_bytes - end));
+
+        if (madvise(aligned, mapped_bytes, MADV_HUGEPAGE) != 0) {
+            munmap(aligned, mapped_bytes);
+            return nullptr;
+        }
+        return aligned;
+    }
+#endif
+
+
+    //===================================================================
+    /** \brief Allocates a block of bytes_count bytes aligned on alignment bytes, backed by huge pages if asked and if possible.
+    * Blocks smaller than HUGE_PAGES_MIN_BYTES, and blocks for which no huge
+    * page is available, fall back to default pages from the heap.  Huge
+    * pages blocks are aligned on HUGE_PAGES_SIZE.
+    *
+    * The block is bound to numa_node of topology if specified.  Bound
+    * blocks are mapped, not allocated from the heap, so that their pages
+    * are not shared with other allocations.  Blocks stay unbound if
+    * binding fails. Nothing gets bound with simulated or single-node
+    * topologies, the block being reported as bound nevertheless.
+    *
+    * Throws std::bad_alloc if no memory is left.
+    */
+    export inline FrameMemory allocate_frame_memory(const std::size_t bytes_count, const std::size_t alignment, const HugePagesMode mode,
+                                                    const vcl::utils::NumaTopology* topology = nullptr,
+                                                    const int numa_node = vcl::utils::NO_NUMA_NODE)
+    {
+        FrameMemory memory;
+        const bool bind = topology != nullptr && numa_node >= 0 && numa_node < topology->nodes_count();
+
+#if defined(VCL_HUGE_PAGES_AVAILABLE)
+        if (mode != HUGE_PAGES_OFF && bytes_count >= HUGE_PAGES_MIN_BYTES) {
+            memory.mapped_bytes = _huge_pages_bytes(bytes_count);
+            if (mode == HUGE_PAGES_EXPLICIT && (memory.data = _map_hugetlb(memory.mapped_bytes)) != nullptr)
+                memory.backing = BACKING_HUGETLB;
+            else if (transparent_huge_pages_available() && (memory.data = _map_transparent_huge(memory.mapped_bytes)) != nullptr)
+                memory.backing = BACKING_TRANSPARENT_HUGE;
+            else
+                memory.mapped_bytes = 0;
+        }
+
+        if (memory.data == nullptr && bind && topology->binds_memory() && alignment <= _DEFAULT_PAGES_SIZE) {
+            memory.mapped_bytes = (bytes_count + _DEFAULT_PAGES_SIZE - 1) / _DEFAULT_PAGES_SIZE * _DEFAULT_PAGES_SIZE;
+            if ((memory.data = _map_default_pages(memory.mapped_bytes)) == nullptr)
+                memory.mapped_bytes = 0;
+        }
+
+        if (memory.data != nullptr) {
+            if (bind && topology->bind_memory(memory.data, memory.mapped_bytes, numa_node))
+                memory.numa_node = numa_node;
+            return memory;
+        }
+#endif
+
+        memory.data = static_cast<std::byte*>(::operator new(bytes_count, std::align_val_t(alignment)));
+        memory.alignment = alignment;
+        if (bind && !topology->binds_memory())
+            memory.numa_node = numa_node;
+        return memory;
+    }
+
+    /** \brief Frees a block of memory allocated by allocate_frame_memory(). */
+    export inline void free_frame_memory(const FrameMemory& memory) noexcept
+    {
+        if (memory.data == nullptr)
+            return;
+#if defined(VCL_HUGE_PAGES_AVAILABLE)
+        if (memory.mapped_bytes > 0) {
+            munmap(memory.data, memory.mapped_bytes);
+            return;
+        }
+#endif
+        ::operator delete(memory.data, std::align_val_t(memory.alignment));
+    }
+
+}
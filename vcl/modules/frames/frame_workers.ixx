@@ -0,0 +1,340 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module frames.frame_workers;
+
+import frames.frame;
+import utils.allocations;
+import utils.numa;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief The NUMA node of the calling worker thread, NO_NUMA_NODE out of workers. */
+    thread_local int _worker_node = vcl::utils::NO_NUMA_NODE;
+
+
+    //===================================================================
+    /** \brief The class of NUMA-aware pools of worker threads.
+    *
+    * Workers are pinned on the CPUs of their NUMA node.  Tasks on frames
+    * are run by the workers of the node their pixels are bound to,  so
+    * that frames are processed where their memory lives. Tasks on frames
+    * bound to no node are shared out round-robin among nodes.
+    *
+    * Simulated topologies, see vcl::utils::NumaTopology::simulated(),
+    * get the same dispatching on single-node machines.
+    */
+    export class FrameWorkers
+    {
+    public:
+        using Task = std::function<void()>;  //!< the type of tasks run by workers.
+
+        //---   Constructors / Destructor   -------------------------------
+        /** \brief Constructor, threads_per_node workers per node of topology - as many as the CPUs of the node if 0.
+        * topology must outlive these workers.
+        */
+        explicit FrameWorkers(const vcl::utils::NumaTopology& topology = vcl::utils::NumaTopology::system(),
+                              const std::size_t threads_per_node = 1)
+            : m_topology(topology)
+        {
+            vcl::utils::AllocationSite site("vcl::frames::FrameWorkers::FrameWorkers()");
+            for (int node = 0; node < topology.nodes_count(); ++node)
+                m_nodes.push_back(std::make_unique<_NodeQueue>());
+            try {
+                for (int node = 0; node < topology.nodes_count(); ++node) {
+                    const std::size_t count = threads_per_node > 0 ? threads_per_node : topology.cpus(node).size();
+                    for (std::size_t t = 0; t < count; ++t)
+                        m_threads.emplace_back(&FrameWorkers::prvt_run, this, node);
+                }
+            }
+            catch (...) {
+                prvt_stop();
+                throw;
+            }
+        }
+
+        /** \brief Destructor, once the pending tasks are done. */
+        ~FrameWorkers() noexcept
+        {
+            prvt_stop();
+        }
+
+        FrameWorkers(const FrameWorkers&) = delete;
+        FrameWorkers& operator= (const FrameWorkers&) = delete;
+
+
+        //---   Tasks   ---------------------------------------------------
+        /** \brief Runs task on a worker of the NUMA node of frame. */
+        template<typename PixelT>
+        inline void submit(const FrameT<PixelT>& frame, Task task)
+        {
+            submit(frame.numa_node(), std::move(task));
+        }
+
+        /** \brief Runs task on a worker of node. Round-robin among nodes if node is NO_NUMA_NODE or out of the topology. */
+        void submit(int node, Task task)
+        {
+            if (node < 0 || node >= nodes_count())
+                node = int(m_next_node.fetch_add(1, std::memory_order_relaxed) % std::size_t(nodes_count()));
+
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+            _NodeQueue& queue = *m_nodes[node];
+            try {
+                vcl::utils::AllocationSite site("vcl::frames::FrameWorkers::submit()");
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            catch (...) {
+                prvt_task_done();
+                throw;
+            }
+            queue.condition.notify_one();
+        }
+
+        /** \brief Waits for all submitted tasks to be done. Rethrows the first exception thrown by tasks since last wait, if any. */
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_done_mutex);
+            m_done_condition.wait(lock, [this]() { return m_pending.load(std::memory_order_acquire) == 0; });
+            if (m_exception) {
+                std::exception_ptr exception = std::exchange(m_exception, nullptr);
+                std::rethrow_exception(exception);
+            }
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the count of NUMA nodes. */
+        inline const int nodes_count() const noexcept
+        {
+            return int(m_nodes.size());
+        }
+
+        /** \brief Returns the count of worker threads. */
+        inline const std::size_t threads_count() const noexcept
+        {
+            return m_threads.size();
+        }
+
+        /** \brief Returns the count of workers pinned on the CPUs of their node. */
+        inline const std::size_t pinned_count() const noexcept
+        {
+            return m_pinned_count.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the count of tasks run, or being run, by the workers of node. Not checked. */
+        inline const unsigned long long tasks_count(const int node) const noexcept
+        {
+            return m_nodes[node]->tasks_count.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the NUMA node of the calling worker thread, or NO_NUMA_NODE if not called from a worker. */
+        static inline const int current_node() noexcept
+        {
+            return _worker_node;
+        }
+
+
+    private:
+        /** \brief The queue of tasks of one node. */
+        struct _NodeQueue
+        {
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::deque<Task> tasks;
+            std::atomic<unsigned long long> tasks_count{ 0 };
+        };
+
+        const vcl::utils::NumaTopology& m_topology;          //!< the topology of nodes.
+        std::vector<std::unique_ptr<_NodeQueue>> m_nodes;     //!< the queues of tasks, one per node.
+        std::vector<std::thread> m_threads;                   //!< the worker threads.
+        std::atomic<std::size_t> m_next_node{ 0 };            //!< the next node of tasks with no node.
+        std::atomic<std::size_t> m_pinned_count{ 0 };         //!< the count of pinned workers.
+        std::atomic<std::size_t> m_pending{ 0 };              //!< the count of submitted tasks not yet done.
+        std::atomic<bool>        m_stopping{ false };         //!< true once workers are asked to stop.
+        std::mutex               m_done_mutex;                //!< protects m_exception and waits for tasks.
+        std::condition_variable  m_done_condition;            //!< notified when all pending tasks are done.
+        std::exception_ptr       m_exception;                 //!< the first exception thrown by tasks since last wait.
+
+        /** \brief The loop of the workers of node. */
+        void prvt_run(const int node) noexcept
+        {
+            _worker_node = node;
+            if (m_topology.pin_current_thread(node))
+                m_pinned_count.fetch_add(1, std::memory_order_relaxed);
+
+            _NodeQueue& queue = *m_nodes[node];
+            for (;;) {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(queue.mutex);
+                    queue.condition.wait(lock, [&]() { return !queue.tasks.empty() || m_stopping.load(std::memory_order_acquire); });
+                    if (queue.tasks.empty())
+                        return;  // stopping, once all tasks are done
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+
+                // counted before being run, so that callers of for_rows_bands() see it once their bands are done
+                queue.tasks_count.fetch_add(1, std::memory_order_relaxed);
+                try {
+                    task();
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(m_done_mutex);
+                    if (!m_exception)
+                        m_exception = std::current_exception();
+                }
+                prvt_task_done();
+            }
+        }
+
+        /** \brief Counts one task done, notifying waiters on the last one. */
+        inline void prvt_task_done() noexcept
+        {
+            if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(m_done_mutex);
+                m_done_condition.notify_all();
+            }
+        }
+
+        /** \brief Stops then joins the workers, once the pending tasks are done. */
+        void prvt_stop() noexcept
+        {
+            m_stopping.store(true, std::memory_order_release);
+            for (const std::unique_ptr<_NodeQueue>& queue : m_nodes) {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                queue->condition.notify_all();
+            }
+            for (std::thread& thread : m_threads)
+                if (thread.joinable())
+                    thread.join();
+        }
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief The latch of the bands of one call to for_rows_bands().
+    * Keeps the first exception thrown by the bands, so that unrelated
+    * tasks of the same workers are neither waited for nor rethrown.
+    */
+    class _BandsLatch
+    {
+    public:
+        inline explicit _BandsLatch(const std::size_t count) noexcept
+            : m_pending(count)
+        {}
+
+        /** \brief Counts count bands done, keeping exception if it is the first one. */
+        void count_down(const std::size_t count = 1, std::exception_ptr exception = nullptr) noexcept
+        {
+            // notifies while locked, since the waiter may destroy this latch as soon as it gets unlocked
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (exception && !m_exception)
+                m_exception = std::move(exception);
+            m_pending -= count;
+            if (m_pending == 0)
+                m_condition.notify_all();
+        }
+
+        /** \brief Waits for all bands to be done. Rethrows the first exception thrown by bands, if any. */
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_pending == 0; });
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+        }
+
+    private:
+        std::mutex              m_mutex;
+        std::condition_variable m_condition;
+        std::size_t             m_pending;
+        std::exception_ptr      m_exception;
+    };
+
+
+    //===================================================================
+    /** \brief Runs rows_fn(first_row, last_row) on bands of rows, on workers at numa_node if any, else on the calling thread.
+    * Only waits for its own bands. Called from a worker, runs all rows on
+    * the calling thread, since waiting there for other workers could
+    * deadlock the pool.
+    */
+    export template<typename Fn>
+    void for_rows_bands(const std::size_t height, const int numa_node, FrameWorkers* workers, Fn&& rows_fn)
+    {
+        constexpr std::size_t MIN_BAND_ROWS = 16;
+        const std::size_t bands = workers == nullptr || FrameWorkers::current_node() != vcl::utils::NO_NUMA_NODE
+                                      ? 1
+                                      : std::min(workers->threads_count(), std::max<std::size_t>(1, height / MIN_BAND_ROWS));
+        if (bands <= 1) {
+            rows_fn(std::size_t(0), height);
+            return;
+        }
+
+        _BandsLatch latch(bands);
+        for (std::size_t band = 0; band < bands; ++band) {
+            try {
+                workers->submit(numa_node, [&rows_fn, &latch, band, bands, height]() {
+                    try {
+                        rows_fn(height * band / bands, height * (band + 1) / bands);
+                        latch.count_down();
+                    }
+                    catch (...) {
+                        latch.count_down(1, std::current_exception());
+                    }
+                });
+            }
+            catch (...) {
+                // the already submitted bands reference rows_fn and latch
+                latch.count_down(bands - band, std::current_exception());
+                break;
+            }
+        }
+        latch.wait();
+    }
+
+}
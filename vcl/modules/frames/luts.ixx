@@ -0,0 +1,899 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define VCL_SSE2_AVAILABLE
+#   include <emmintrin.h>
+#endif
+
+export module frames.luts;
+
+import frames.frame;
+import frames.frame_workers;
+import frames.pixels;
+import utils.allocations;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The interpolations of 3D LUTs. */
+    export enum LutInterpolation : unsigned char
+    {
+        LUT_TRILINEAR = 0,  //!< the 8 nodes of the cell around colors.
+        LUT_TETRAHEDRAL     //!< the 4 nodes of the tetrahedron of the cell around colors - smoother on grays, and cheaper.
+    };
+
+    /** \brief The fractional bits of the fixed-point nodes of LUTs, 1.0 being 1 << LUT_NODE_BITS. */
+    export inline constexpr int LUT_NODE_BITS = 14;
+
+    /** \brief The maximum count of nodes per axis of 3D LUTs. */
+    export inline constexpr std::size_t LUT_3D_MAX_SIZE = 129;
+
+    /** \brief The maximum count of entries of 1D LUTs. */
+    export inline constexpr std::size_t LUT_1D_MAX_SIZE = 65536;
+
+    /** \brief The input domain of LUTs, per channel: [min, max] maps onto the first and the last nodes. */
+    export struct LutDomain
+    {
+        float min[3]{ 0.0f, 0.0f, 0.0f };
+        float max[3]{ 1.0f, 1.0f, 1.0f };
+    };
+
+    /** \brief The concept of packed pixels types LUTs apply to: colors, with or without alpha. */
+    export template<typename P>
+    concept LutPixel = PackedPixel<P> && !P::IS_GRAY;
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    inline constexpr std::int32_t _LUT_ONE = std::int32_t(1) << LUT_NODE_BITS;
+
+    /** \brief Returns the fixed-point node of value, clipped to [0, 1]. */
+    inline std::uint16_t _lut_node(const float value) noexcept
+    {
+        return std::uint16_t(std::clamp(value, 0.0f, 1.0f) * float(_LUT_ONE) + 0.5f);
+    }
+
+    /** \brief Throws std::invalid_argument if some axis of domain is empty. */
+    inline void _check_domain(const LutDomain& domain)
+    {
+        for (int c = 0; c < 3; ++c)
+            if (!(domain.max[c] > domain.min[c]))
+                throw std::invalid_argument("LUT domains must get max > min on each channel.");
+    }
+
+    /** \brief The mapping of the channel values of pixels on an axis of LUT nodes. */
+    struct _LutAxis
+    {
+        float    scale;       //!< the count of nodes per channel unit.
+        float    offset;      //!< the position of channel value 0.
+        float    last;        //!< the position of the last node.
+        unsigned last_index;  //!< the index of the last cell.
+
+        /** \brief Returns the position of value on this axis: the index of its cell in the high 16 bits, the fixed-point fraction in the low ones. */
+        inline std::uint32_t position(const unsigned value) const noexcept
+        {
+            const float p = std::clamp(float(value) * scale + offset, 0.0f, last);
+            const unsigned index = std::min(unsigned(p), last_index);
+            return (index << 16) | std::uint32_t((p - float(index)) * float(_LUT_ONE) + 0.5f);
+        }
+    };
+
+    /** \brief Returns the axis of size nodes spanning [domain_min, domain_max], for channels of max_value. */
+    inline _LutAxis _lut_axis(const std::size_t size, const float domain_min, const float domain_max, const unsigned max_value) noexcept
+    {
+        const float last = float(size - 1);
+        const float scale = last / (domain_max - domain_min);
+        return _LutAxis{ scale / float(max_value), -domain_min * scale, last, unsigned(size - 2) };
+    }
+
+    /** \brief The positions of the channel values of pixels P on the axes of a LUT.
+    * They are tabulated per channel value up to 12 bits channels, and
+    * computed on the fly for wider ones.
+    */
+    template<typename P>
+    class _LutPositions
+    {
+    public:
+        static constexpr bool TABULATED = P::BITS_DEPTH <= 12;
+        static constexpr std::size_t VALUES_COUNT = std::size_t(P::MAX_VALUE) + 1;
+
+        _LutPositions(const std::size_t size, const LutDomain& domain)
+        {
+            for (int c = 0; c < 3; ++c)
+                m_axes[c] = _lut_axis(size, domain.min[c], domain.max[c], P::MAX_VALUE);
+            if constexpr (TABULATED) {
+                {
+                    vcl::utils::AllocationSite site("vcl::frames::apply_lut()");
+                    m_table.resize(3 * VALUES_COUNT);
+                }
+                for (int c = 0; c < 3; ++c)
+                    for (unsigned value = 0; value < VALUES_COUNT; ++value)
+                        m_table[c * VALUES_COUNT + value] = m_axes[c].position(value);
+            }
+        }
+
+        /** \brief Returns the position of value on the axis of channel c, see _LutAxis::position(). */
+        inline std::uint32_t operator() (const int c, const unsigned value) const noexcept
+        {
+            if constexpr (TABULATED)
+                return m_table[c * VALUES_COUNT + value];
+            else
+                return m_axes[c].position(value);
+        }
+
+    private:
+        _LutAxis m_axes[3];
+        std::vector<std::uint32_t> m_table;
+    };
+
+    /** \brief Returns the channel value of max_value for the fixed-point value v, which is clipped to [0, 1]. */
+    inline constexpr std::uint32_t _lut_output(const std::int32_t v, const std::uint32_t max_value) noexcept
+    {
+        return (std::uint32_t(std::clamp(v, std::int32_t(0), _LUT_ONE)) * max_value + (1u << (LUT_NODE_BITS - 1))) >> LUT_NODE_BITS;
+    }
+
+
+    //===================================================================
+    /** \brief The class of 1D LUTs: one curve per color channel.
+    * Entries are fixed-point, clipped to [0, 1], and linearly interpolated
+    * on the domain of the LUT.
+    */
+    export class Lut1D
+    {
+    public:
+        //---   Constructors / Destructor   ---------------------------------
+        /** \brief Empty constructor. */
+        inline Lut1D() noexcept = default;
+
+        /** \brief Constructor, the identity curves of size entries. Throws std::invalid_argument if size is not in [2, LUT_1D_MAX_SIZE]. */
+        explicit Lut1D(const std::size_t size)
+            : m_size(size)
+        {
+            if (size < 2 || size > LUT_1D_MAX_SIZE)
+                throw std::invalid_argument("1D LUTs sizes must be in [2, 65536].");
+            vcl::utils::AllocationSite site("vcl::frames::Lut1D::Lut1D()");
+            m_nodes.resize(3 * size);
+            for (std::size_t i = 0; i < size; ++i) {
+                const std::uint16_t node = std::uint16_t((std::uint64_t(i) * _LUT_ONE + (size - 1) / 2) / (size - 1));
+                m_nodes[3 * i] = m_nodes[3 * i + 1] = m_nodes[3 * i + 2] = node;
+            }
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the count of entries of this LUT. */
+        inline const std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        /** \brief Returns true if this LUT gets no entry. */
+        inline const bool is_empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        /** \brief Returns the fixed-point entry index of channel - 0, 1 or 2 for red, green and blue. */
+        inline const std::uint16_t node(const std::size_t index, const int channel) const noexcept
+        {
+            return m_nodes[3 * index + channel];
+        }
+
+        /** \brief Returns the input domain of this LUT. */
+        inline const LutDomain& domain() const noexcept
+        {
+            return m_domain;
+        }
+
+
+        //---   Mutators   --------------------------------------------------
+        /** \brief Sets entry index, values being clipped to [0, 1]. */
+        inline void set(const std::size_t index, const float r, const float g, const float b) noexcept
+        {
+            m_nodes[3 * index] = _lut_node(r);
+            m_nodes[3 * index + 1] = _lut_node(g);
+            m_nodes[3 * index + 2] = _lut_node(b);
+        }
+
+        /** \brief Sets the input domain of this LUT. Throws std::invalid_argument if empty on some channel. */
+        inline void domain(const LutDomain& new_domain)
+        {
+            _check_domain(new_domain);
+            m_domain = new_domain;
+        }
+
+
+    private:
+        std::vector<std::uint16_t> m_nodes;  //!< the entries, channels interleaved.
+        std::size_t m_size{ 0 };
+        LutDomain m_domain;
+    };
+
+
+    //===================================================================
+    /** \brief The class of 3D LUTs: cubes of size^3 RGB nodes.
+    * Nodes are fixed-point, clipped to [0, 1], red indexes varying the
+    * fastest as in .cube files. Each node is stored on 4 16-bits words -
+    * r, g, b and padding - so that one load gets all of its channels and
+    * SIMD kernels interpolate channels side by side, with no gather.
+    */
+    export class Lut3D
+    {
+    public:
+        //---   Constructors / Destructor   ---------------------------------
+        /** \brief Empty constructor. */
+        inline Lut3D() noexcept = default;
+
+        /** \brief Constructor, the identity cube of size nodes per axis. Throws std::invalid_argument if size is not in [2, LUT_3D_MAX_SIZE]. */
+        explicit Lut3D(const std::size_t size)
+            : m_size(size)
+        {
+            if (size < 2 || size > LUT_3D_MAX_SIZE)
+                throw std::invalid_argument("3D LUTs sizes must be in [2, 129].");
+            vcl::utils::AllocationSite site("vcl::frames::Lut3D::Lut3D()");
+            m_nodes.resize(4 * size * size * size);
+            for (std::size_t b = 0; b < size; ++b)
+                for (std::size_t g = 0; g < size; ++g)
+                    for (std::size_t r = 0; r < size; ++r) {
+                        std::uint16_t* n = m_nodes.data() + 4 * ((b * size + g) * size + r);
+                        n[0] = std::uint16_t((r * _LUT_ONE + (size - 1) / 2) / (size - 1));
+                        n[1] = std::uint16_t((g * _LUT_ONE + (size - 1) / 2) / (size - 1));
+                        n[2] = std::uint16_t((b * _LUT_ONE + (size - 1) / 2) / (size - 1));
+                    }
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the count of nodes per axis of this LUT. */
+        inline const std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        /** \brief Returns true if this LUT gets no node. */
+        inline const bool is_empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        /** \brief Returns the fixed-point channels r, g and b of node (r_index, g_index, b_index). */
+        inline const std::uint16_t* node(const std::size_t r_index, const std::size_t g_index, const std::size_t b_index) const noexcept
+        {
+            return m_nodes.data() + 4 * ((b_index * m_size + g_index) * m_size + r_index);
+        }
+
+        /** \brief Returns the nodes of this LUT, 4 words each. */
+        inline const std::uint16_t* data() const noexcept
+        {
+            return m_nodes.data();
+        }
+
+        /** \brief Returns the input domain of this LUT. */
+        inline const LutDomain& domain() const noexcept
+        {
+            return m_domain;
+        }
+
+
+        //---   Mutators   --------------------------------------------------
+        /** \brief Sets node (r_index, g_index, b_index), values being clipped to [0, 1]. */
+        inline void set(const std::size_t r_index, const std::size_t g_index, const std::size_t b_index, const float r, const float g, const float b) noexcept
+        {
+            std::uint16_t* n = m_nodes.data() + 4 * ((b_index * m_size + g_index) * m_size + r_index);
+            n[0] = _lut_node(r);
+            n[1] = _lut_node(g);
+            n[2] = _lut_node(b);
+        }
+
+        /** \brief Sets the input domain of this LUT. Throws std::invalid_argument if empty on some channel. */
+        inline void domain(const LutDomain& new_domain)
+        {
+            _check_domain(new_domain);
+            m_domain = new_domain;
+        }
+
+
+    private:
+        std::vector<std::uint16_t> m_nodes;  //!< the nodes, 4 words each.
+        std::size_t m_size{ 0 };
+        LutDomain m_domain;
+    };
+
+
+    //===================================================================
+    /** \brief The fixed transfer functions of compile-time LUTs. */
+    export enum TransferFunction : unsigned char
+    {
+        TRANSFER_SRGB_TO_LINEAR = 0,  //!< the sRGB EOTF, IEC 61966-2-1.
+        TRANSFER_LINEAR_TO_SRGB,      //!< the inverse sRGB EOTF.
+        TRANSFER_PQ_TO_LINEAR,        //!< the PQ EOTF, SMPTE ST 2084, linear 1.0 being 10000 cd/m2.
+        TRANSFER_LINEAR_TO_PQ         //!< the inverse PQ EOTF.
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    inline constexpr double _LN2 = 0.69314718055994530942;
+
+    /** \brief Returns the natural logarithm of x > 0, at compile time. */
+    inline constexpr double _cx_log(double x) noexcept
+    {
+        int k = 0;
+        for (; x >= 65536.0; x /= 65536.0) k += 16;
+        for (; x < 1.0 / 65536.0; x *= 65536.0) k -= 16;
+        for (; x > 1.4142135623730951; x /= 2.0) ++k;
+        for (; x < 0.7071067811865476; x *= 2.0) --k;
+
+        // ln(x) = 2 atanh((x - 1) / (x + 1)), |t| < 0.18
+        const double t = (x - 1.0) / (x + 1.0), t2 = t * t;
+        double power = t, sum = 0.0;
+        for (int n = 1; n < 64 && (power > 1e-18 || power < -1e-18); n += 2) {
+            sum += power / n;
+            power *= t2;
+        }
+        return 2.0 * sum + k * _LN2;
+    }
+
+    /** \brief Returns e^x, at compile time. */
+    inline constexpr double _cx_exp(const double x) noexcept
+    {
+        if (x < -745.0)
+            return 0.0;
+        // x = k ln(2) + r, |r| <= ln(2) / 2
+        long k = long(x / _LN2 + (x >= 0.0 ? 0.5 : -0.5));
+        const double r = x - double(k) * _LN2;
+        double term = 1.0, sum = 1.0;
+        for (int n = 1; n < 32 && (term > 1e-18 || term < -1e-18); ++n) {
+            term *= r / n;
+            sum += term;
+        }
+        for (; k >= 16; k -= 16) sum *= 65536.0;
+        for (; k <= -16; k += 16) sum /= 65536.0;
+        for (; k > 0; --k) sum *= 2.0;
+        for (; k < 0; ++k) sum /= 2.0;
+        return sum;
+    }
+
+    /** \brief Returns x^y for x >= 0, at compile time. */
+    inline constexpr double _cx_pow(const double x, const double y) noexcept
+    {
+        return x <= 0.0 ? 0.0 : _cx_exp(y * _cx_log(x));
+    }
+
+
+    //-----------------------------------------------------------------------
+    /** \brief Returns the transfer function fn of x in [0, 1], at compile time as well as at run time. */
+    export inline constexpr double transfer_function(const TransferFunction fn, const double x) noexcept
+    {
+        // SMPTE ST 2084 constants
+        constexpr double M1 = 2610.0 / 16384.0, M2 = 2523.0 / 4096.0 * 128.0;
+        constexpr double C1 = 3424.0 / 4096.0, C2 = 2413.0 / 4096.0 * 32.0, C3 = 2392.0 / 4096.0 * 32.0;
+
+        switch (fn) {
+        case TRANSFER_SRGB_TO_LINEAR:
+            return x <= 0.04045 ? x / 12.92 : _cx_pow((x + 0.055) / 1.055, 2.4);
+        case TRANSFER_LINEAR_TO_SRGB:
+            return x <= 0.0031308 ? 12.92 * x : 1.055 * _cx_pow(x, 1.0 / 2.4) - 0.055;
+        case TRANSFER_PQ_TO_LINEAR: {
+            const double e = _cx_pow(x, 1.0 / M2);
+            return _cx_pow(std::max(e - C1, 0.0) / (C2 - C3 * e), 1.0 / M1);
+        }
+        default: {
+            const double y = _cx_pow(x, M1);
+            return _cx_pow((C1 + C2 * y) / (1.0 + C3 * y), M2);
+        }
+        }
+    }
+
+    /** \brief The type of the entries of the compile-time LUTs of Kbits bits. */
+    export template<const unsigned Kbits>
+    using TransferSampleT = std::conditional_t<(Kbits <= 8), std::uint8_t, std::uint16_t>;
+
+    // not to be used out of this module scope
+    template<const TransferFunction Kfn, const unsigned Kbits>
+    inline constexpr std::array<TransferSampleT<Kbits>, (1u << Kbits)> _transfer_table() noexcept
+    {
+        constexpr double MAX_VALUE = double((1u << Kbits) - 1);
+        std::array<TransferSampleT<Kbits>, (1u << Kbits)> table{};
+        for (std::size_t i = 0; i < table.size(); ++i)
+            table[i] = TransferSampleT<Kbits>(std::clamp(transfer_function(Kfn, double(i) / MAX_VALUE), 0.0, 1.0) * MAX_VALUE + 0.5);
+        return table;
+    }
+
+    /** \brief The LUT of transfer function Kfn on channels of Kbits bits, generated at compile time. */
+    export template<const TransferFunction Kfn, const unsigned Kbits>
+        requires (Kbits >= 8 && Kbits <= 12)
+    inline constexpr std::array<TransferSampleT<Kbits>, (1u << Kbits)> transfer_lut = _transfer_table<Kfn, Kbits>();
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Maps the color channels of count pixels through one table per channel, alpha being kept. */
+    template<typename P>
+    void _apply_tables_row(const P* src, P* dst, const std::size_t count, const typename P::ChannelType* const tables[3]) noexcept
+    {
+        for (std::size_t x = 0; x < count; ++x) {
+            P q = src[x];
+            if constexpr (P::IS_GRAY)
+                q.channels[0] = tables[0][q.channels[0]];
+            else {
+                q.channels[P::RED_INDEX] = tables[0][q.channels[P::RED_INDEX]];
+                q.channels[P::GREEN_INDEX] = tables[1][q.channels[P::GREEN_INDEX]];
+                q.channels[P::BLUE_INDEX] = tables[2][q.channels[P::BLUE_INDEX]];
+            }
+            dst[x] = q;
+        }
+    }
+
+    /** \brief The nodes of the cell of a color, with their fixed-point weights.
+    * Tetrahedral cells get 4 nodes and 4 weights summing to 1.0. Trilinear
+    * cells get 8 nodes, red indexes varying the fastest, and the weights
+    * of the previous and next nodes along r, g and b.
+    */
+    struct _LutCell
+    {
+        std::uint32_t offsets[8];  //!< the offsets of nodes, in words.
+        std::int16_t  weights[8];  //!< the weights of nodes, or of axes.
+    };
+
+    /** \brief The axes - 0, 1, 2 for r, g, b - by decreasing fractions, indexed by (fr >= fg) | (fg >= fb) << 1 | (fr >= fb) << 2. */
+    inline constexpr std::uint8_t _TETRAHEDRA[8][3] = { { 2, 1, 0 }, { 2, 0, 1 }, { 1, 2, 0 }, { 0, 1, 2 }, { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 0, 1, 2 } };
+
+    /** \brief Sets cell with the nodes around the color of positions (r, g, b) - see _LutAxis::position() - and their weights. */
+    template<const LutInterpolation Kinterpolation>
+    inline void _lut_cell(const std::uint32_t positions[3], const std::uint32_t size, _LutCell& cell) noexcept
+    {
+        const std::int32_t f[3] = { std::int32_t(positions[0] & 0xffff), std::int32_t(positions[1] & 0xffff), std::int32_t(positions[2] & 0xffff) };
+        const std::uint32_t steps[3] = { 4, 4 * size, 4 * size * size };
+        const std::uint32_t base = (positions[0] >> 16) * steps[0] + (positions[1] >> 16) * steps[1] + (positions[2] >> 16) * steps[2];
+
+        if constexpr (Kinterpolation == LUT_TETRAHEDRAL) {
+            // the tetrahedron from node 000 to node 111 along the axes of decreasing fractions, with no branch
+            const std::uint8_t* axes = _TETRAHEDRA[unsigned(f[0] >= f[1]) | (unsigned(f[1] >= f[2]) << 1) | (unsigned(f[0] >= f[2]) << 2)];
+            cell.offsets[0] = base;
+            cell.offsets[1] = base + steps[axes[0]];
+            cell.offsets[2] = cell.offsets[1] + steps[axes[1]];
+            cell.offsets[3] = base + steps[0] + steps[1] + steps[2];
+            cell.weights[0] = std::int16_t(_LUT_ONE - f[axes[0]]);
+            cell.weights[1] = std::int16_t(f[axes[0]] - f[axes[1]]);
+            cell.weights[2] = std::int16_t(f[axes[1]] - f[axes[2]]);
+            cell.weights[3] = std::int16_t(f[axes[2]]);
+        }
+        else {
+            for (int k = 0; k < 8; ++k)
+                cell.offsets[k] = base + (k & 1) * steps[0] + ((k >> 1) & 1) * steps[1] + (k >> 2) * steps[2];
+            for (int c = 0; c < 3; ++c) {
+                cell.weights[2 * c] = std::int16_t(_LUT_ONE - f[c]);
+                cell.weights[2 * c + 1] = std::int16_t(f[c]);
+            }
+        }
+    }
+
+    /** \brief Returns the pixel of the interpolated nodes of cell, alpha being the one of p. */
+    template<typename P, const std::size_t Kcount>
+    inline P _lut_pixel_scalar(const std::uint16_t* nodes, const _LutCell& cell, const P& p) noexcept
+    {
+        constexpr std::int32_t ROUNDING = 1 << (LUT_NODE_BITS - 1);
+        std::int32_t v[3];
+        for (int c = 0; c < 3; ++c) {
+            if constexpr (Kcount == 4) {
+                std::int32_t acc = ROUNDING;
+                for (std::size_t k = 0; k < 4; ++k)
+                    acc += cell.weights[k] * nodes[cell.offsets[k] + c];
+                v[c] = acc >> LUT_NODE_BITS;
+            }
+            else {
+                // along r, then g, then b
+                auto lerp = [&cell, ROUNDING](const int axis, const std::int32_t a, const std::int32_t b) {
+                    return (cell.weights[2 * axis] * a + cell.weights[2 * axis + 1] * b + ROUNDING) >> LUT_NODE_BITS;
+                };
+                std::int32_t along_r[4];
+                for (int k = 0; k < 4; ++k)
+                    along_r[k] = lerp(0, nodes[cell.offsets[2 * k] + c], nodes[cell.offsets[2 * k + 1] + c]);
+                v[c] = lerp(2, lerp(1, along_r[0], along_r[1]), lerp(1, along_r[2], along_r[3]));
+            }
+        }
+        using TChannel = typename P::ChannelType;
+        P q = p;
+        q.channels[P::RED_INDEX] = TChannel(_lut_output(v[0], P::MAX_VALUE));
+        q.channels[P::GREEN_INDEX] = TChannel(_lut_output(v[1], P::MAX_VALUE));
+        q.channels[P::BLUE_INDEX] = TChannel(_lut_output(v[2], P::MAX_VALUE));
+        return q;
+    }
+
+#if defined(VCL_SSE2_AVAILABLE)
+    /** \brief Returns the weighted sums of the 16-bits lanes pairs of a, with weights w0 and w1, rounded and fixed-point on 32-bits lanes. */
+    inline __m128i _lut_madd_sse2(const __m128i pairs, const std::int16_t w0, const std::int16_t w1) noexcept
+    {
+        const __m128i weights = _mm_set1_epi32(int(std::uint16_t(w0)) | (int(w1) * 65536));
+        return _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(pairs, weights), _mm_set1_epi32(1 << (LUT_NODE_BITS - 1))), LUT_NODE_BITS);
+    }
+
+    /** \brief Returns the 16-bits lanes of nodes a and b interleaved, channel by channel. */
+    inline __m128i _lut_node_pair_sse2(const std::uint16_t* a, const std::uint16_t* b) noexcept
+    {
+        return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b)));
+    }
+
+    /** \brief Returns the 16-bits lanes of the fixed-point 32-bits lanes of a and b interleaved. */
+    inline __m128i _lut_lerped_pair_sse2(const __m128i a, const __m128i b) noexcept
+    {
+        return _mm_unpacklo_epi16(_mm_packs_epi32(a, a), _mm_packs_epi32(b, b));
+    }
+
+    /** \brief Returns the interpolated channels r, g, b and 0 of cell, fixed-point on 32-bits lanes.
+    * Nodes are loaded whole and interleaved by pairs, so that one madd
+    * weights and sums the channels of two nodes.
+    */
+    template<const std::size_t Kcount>
+    inline __m128i _lut_acc_sse2(const std::uint16_t* nodes, const _LutCell& cell) noexcept
+    {
+        if constexpr (Kcount == 4) {
+            const __m128i acc = _mm_add_epi32(_mm_madd_epi16(_lut_node_pair_sse2(nodes + cell.offsets[0], nodes + cell.offsets[1]),
+                                                             _mm_set1_epi32(int(std::uint16_t(cell.weights[0])) | (int(cell.weights[1]) * 65536))),
+                                              _mm_madd_epi16(_lut_node_pair_sse2(nodes + cell.offsets[2], nodes + cell.offsets[3]),
+                                                             _mm_set1_epi32(int(std::uint16_t(cell.weights[2])) | (int(cell.weights[3]) * 65536))));
+            return _mm_srai_epi32(_mm_add_epi32(acc, _mm_set1_epi32(1 << (LUT_NODE_BITS - 1))), LUT_NODE_BITS);
+        }
+        else {
+            // along r, then g, then b
+            __m128i along_r[4];
+            for (int k = 0; k < 4; ++k)
+                along_r[k] = _lut_madd_sse2(_lut_node_pair_sse2(nodes + cell.offsets[2 * k], nodes + cell.offsets[2 * k + 1]), cell.weights[0], cell.weights[1]);
+            const __m128i along_g0 = _lut_madd_sse2(_lut_lerped_pair_sse2(along_r[0], along_r[1]), cell.weights[2], cell.weights[3]);
+            const __m128i along_g1 = _lut_madd_sse2(_lut_lerped_pair_sse2(along_r[2], along_r[3]), cell.weights[2], cell.weights[3]);
+            return _lut_madd_sse2(_lut_lerped_pair_sse2(along_g0, along_g1), cell.weights[4], cell.weights[5]);
+        }
+    }
+#endif
+
+    /** \brief Interpolates the colors of count pixels in a 3D LUT, alpha being kept. */
+    template<typename P, const LutInterpolation Kinterpolation, const bool Ksimd>
+    void _lut3d_row(const P* src, P* dst, const std::size_t count, const std::uint16_t* nodes, const std::uint32_t size, const _LutPositions<P>& positions) noexcept
+    {
+        constexpr std::size_t NODES_COUNT = Kinterpolation == LUT_TETRAHEDRAL ? 4 : 8;
+        using TChannel = typename P::ChannelType;
+        _LutCell cell;
+        auto locate = [&positions, size, &cell](const P& p) {
+            const std::uint32_t rgb[3] = { positions(0, p.r()), positions(1, p.g()), positions(2, p.b()) };
+            _lut_cell<Kinterpolation>(rgb, size, cell);
+        };
+        std::size_t x = 0;
+
+#if defined(VCL_SSE2_AVAILABLE)
+        if constexpr (Ksimd) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i one = _mm_set1_epi16(short(_LUT_ONE));
+            const __m128i max_value = _mm_set1_epi16(short(P::MAX_VALUE));
+            const __m128i rounding = _mm_set1_epi32(1 << (LUT_NODE_BITS - 1));
+            const __m128i bias32 = _mm_set1_epi32(32768), bias16 = _mm_set1_epi16(short(0x8000));
+            alignas(16) std::uint16_t out[8];
+
+            for (; x + 2 <= count; x += 2) {
+                const P p0 = src[x], p1 = src[x + 1];
+                locate(p0);
+                const __m128i acc0 = _lut_acc_sse2<NODES_COUNT>(nodes, cell);
+                locate(p1);
+                const __m128i acc1 = _lut_acc_sse2<NODES_COUNT>(nodes, cell);
+
+                // clipped to [0, 1] then scaled to MAX_VALUE: 16 x 16 -> 32 bits products
+                const __m128i v = _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(acc0, acc1), zero), one);
+                const __m128i lo = _mm_mullo_epi16(v, max_value), hi = _mm_mulhi_epu16(v, max_value);
+                const __m128i out0 = _mm_srli_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), rounding), LUT_NODE_BITS);
+                const __m128i out1 = _mm_srli_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), rounding), LUT_NODE_BITS);
+                _mm_store_si128(reinterpret_cast<__m128i*>(out),
+                                _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(out0, bias32), _mm_sub_epi32(out1, bias32)), bias16));
+
+                P q0 = p0, q1 = p1;
+                q0.channels[P::RED_INDEX] = TChannel(out[0]);
+                q0.channels[P::GREEN_INDEX] = TChannel(out[1]);
+                q0.channels[P::BLUE_INDEX] = TChannel(out[2]);
+                q1.channels[P::RED_INDEX] = TChannel(out[4]);
+                q1.channels[P::GREEN_INDEX] = TChannel(out[5]);
+                q1.channels[P::BLUE_INDEX] = TChannel(out[6]);
+                dst[x] = q0;
+                dst[x + 1] = q1;
+            }
+        }
+#endif
+        for (; x < count; ++x) {
+            const P p = src[x];
+            locate(p);
+            dst[x] = _lut_pixel_scalar<P, NODES_COUNT>(nodes, cell, p);
+        }
+    }
+
+    /** \brief Applies a 3D LUT to src into dst. */
+    template<const bool Ksimd, typename P>
+    void _apply_lut3d(const Lut3D& lut, const FrameT<P>& src, FrameT<P>& dst, const LutInterpolation interpolation, FrameWorkers* workers)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for LUTs.");
+        if (lut.is_empty())
+            throw std::invalid_argument("3D LUT is empty.");
+
+        const _LutPositions<P> positions(lut.size(), lut.domain());
+        const std::uint32_t size = std::uint32_t(lut.size());
+        for_rows_bands(src.height(), dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                if (interpolation == LUT_TETRAHEDRAL)
+                    _lut3d_row<P, LUT_TETRAHEDRAL, Ksimd>(src.row(row), dst.row(row), src.width(), lut.data(), size, positions);
+                else
+                    _lut3d_row<P, LUT_TRILINEAR, Ksimd>(src.row(row), dst.row(row), src.width(), lut.data(), size, positions);
+        });
+    }
+
+
+    //===================================================================
+    /** \brief Applies a 1D LUT to the color channels of src into dst, alpha being kept.
+    * The curves are first sampled once per channel value, so that pixels
+    * then get one table lookup per channel. src and dst may be the same
+    * frame. Rows are processed by workers if any, the calling thread
+    * waiting for them - so it must not be one of them. Throws
+    * std::invalid_argument if dimensions differ or if lut is empty.
+    */
+    export template<LutPixel P>
+    void apply_lut(const Lut1D& lut, const FrameT<P>& src, FrameT<P>& dst, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for LUTs.");
+        if (lut.is_empty())
+            throw std::invalid_argument("1D LUT is empty.");
+
+        using TChannel = typename P::ChannelType;
+        constexpr std::size_t VALUES_COUNT = std::size_t(P::MAX_VALUE) + 1;
+        std::vector<TChannel> tables;
+        {
+            vcl::utils::AllocationSite site("vcl::frames::apply_lut()");
+            tables.resize(3 * VALUES_COUNT);
+        }
+        for (int c = 0; c < 3; ++c) {
+            const _LutAxis axis = _lut_axis(lut.size(), lut.domain().min[c], lut.domain().max[c], P::MAX_VALUE);
+            for (unsigned value = 0; value < VALUES_COUNT; ++value) {
+                const std::uint32_t position = axis.position(value);
+                const std::uint32_t index = position >> 16;
+                const std::int32_t fraction = std::int32_t(position & 0xffff);
+                const std::int32_t v = (lut.node(index, c) * (_LUT_ONE - fraction) + lut.node(index + 1, c) * fraction + (1 << (LUT_NODE_BITS - 1))) >> LUT_NODE_BITS;
+                tables[c * VALUES_COUNT + value] = TChannel(_lut_output(v, P::MAX_VALUE));
+            }
+        }
+
+        const TChannel* const channels_tables[3] = { tables.data(), tables.data() + VALUES_COUNT, tables.data() + 2 * VALUES_COUNT };
+        for_rows_bands(src.height(), dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                _apply_tables_row(src.row(row), dst.row(row), src.width(), channels_tables);
+        });
+    }
+
+    /** \brief Applies a 3D LUT to the colors of src into dst, alpha being kept.
+    * Cells are located in scalar code, nodes being interpolated with SSE2
+    * two channels by two nodes at once. src and dst may be the same frame.
+    * Rows are processed by workers if any, the calling thread waiting for
+    * them - so it must not be one of them. Throws std::invalid_argument if
+    * dimensions differ or if lut is empty.
+    */
+    export template<LutPixel P>
+    inline void apply_lut(const Lut3D& lut, const FrameT<P>& src, FrameT<P>& dst, const LutInterpolation interpolation = LUT_TETRAHEDRAL,
+                          FrameWorkers* workers = nullptr)
+    {
+        _apply_lut3d<true>(lut, src, dst, interpolation, workers);
+    }
+
+    /** \brief Applies a 3D LUT to the colors of src into dst, with no SIMD. The reference of apply_lut(), which gets the same results. */
+    export template<LutPixel P>
+    inline void apply_lut_scalar(const Lut3D& lut, const FrameT<P>& src, FrameT<P>& dst, const LutInterpolation interpolation = LUT_TETRAHEDRAL,
+                                 FrameWorkers* workers = nullptr)
+    {
+        _apply_lut3d<false>(lut, src, dst, interpolation, workers);
+    }
+
+    /** \brief Applies the compile-time LUT of transfer function Kfn to the color channels of src into dst, alpha being kept.
+    * src and dst may be the same frame. Rows are processed by workers if
+    * any, the calling thread waiting for them - so it must not be one of
+    * them. Throws std::invalid_argument if dimensions differ.
+    */
+    export template<const TransferFunction Kfn, PackedPixel P>
+        requires (P::BITS_DEPTH >= 8 && P::BITS_DEPTH <= 12 && std::is_same_v<typename P::ChannelType, TransferSampleT<P::BITS_DEPTH>>)
+    void apply_transfer(const FrameT<P>& src, FrameT<P>& dst, FrameWorkers* workers = nullptr)
+    {
+        if (src.width() != dst.width() || src.height() != dst.height())
+            throw std::invalid_argument("frames must get same dimensions for LUTs.");
+
+        const auto& table = transfer_lut<Kfn, P::BITS_DEPTH>;
+        const typename P::ChannelType* const tables[3] = { table.data(), table.data(), table.data() };
+        for_rows_bands(src.height(), dst.numa_node(), workers, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t row = first; row < last; ++row)
+                _apply_tables_row(src.row(row), dst.row(row), src.width(), tables);
+        });
+    }
+
+
+    //===================================================================
+    /** \brief The LUTs of .cube files: a 1D LUT, a 3D LUT or both - the 1D one shaping the input of the 3D one. */
+    export struct CubeLut
+    {
+        std::string title;  //!< the title of the file, empty if none.
+        Lut1D lut_1d;       //!< the 1D LUT, empty if none.
+        Lut3D lut_3d;       //!< the 3D LUT, empty if none.
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Returns the count of floats parsed from text into values, at most max_count. */
+    inline std::size_t _parse_floats(std::string_view text, float* values, const std::size_t max_count) noexcept
+    {
+        std::size_t count = 0;
+        while (!text.empty()) {
+            const std::size_t start = text.find_first_not_of(" \t");
+            if (start == std::string_view::npos)
+                break;
+            text.remove_prefix(start);
+            if (count == max_count)
+                return max_count + 1;  // too many values
+            const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), values[count]);
+            if (result.ec != std::errc() || (result.ptr != text.data() + text.size() && *result.ptr != ' ' && *result.ptr != '\t'))
+                return 0;
+            text.remove_prefix(std::size_t(result.ptr - text.data()));
+            ++count;
+        }
+        return count;
+    }
+
+
+    //-----------------------------------------------------------------------
+    /** \brief Parses the Adobe / Resolve .cube LUT of stream in.
+    * Gets TITLE, LUT_1D_SIZE, LUT_3D_SIZE, DOMAIN_MIN, DOMAIN_MAX,
+    * LUT_1D_INPUT_RANGE and LUT_3D_INPUT_RANGE, other keywords being
+    * ignored, then the entries of the 1D LUT followed by the nodes of the
+    * 3D LUT. Values are clipped to [0, 1]. Throws std::invalid_argument
+    * with the number of the faulty line on syntax errors and on missing or
+    * extra data.
+    */
+    export CubeLut parse_cube(std::istream& in)
+    {
+        CubeLut cube;
+        std::size_t size_1d = 0, size_3d = 0, count = 0, total = 0, line_number = 0;
+        LutDomain domain, domain_1d, domain_3d;
+        bool has_range_1d = false, has_range_3d = false;
+        auto error = [&line_number](const std::string_view what) {
+            return std::invalid_argument(std::format(".cube line {:d}: {:s}.", line_number, what));
+        };
+
+        std::string line;
+        while (std::getline(in, line)) {
+            ++line_number;
+            std::string_view text(line);
+            text = text.substr(0, text.find('#'));
+            const std::size_t start = text.find_first_not_of(" \t\r");
+            if (start == std::string_view::npos)
+                continue;
+            text = text.substr(start, text.find_last_not_of(" \t\r") + 1 - start);
+
+            if ((text[0] >= 'A' && text[0] <= 'Z') || (text[0] >= 'a' && text[0] <= 'z')) {
+                // keywords
+                if (count > 0)
+                    throw error("keyword after data");
+                const std::size_t end = std::min(text.find_first_of(" \t"), text.size());
+                const std::string_view keyword = text.substr(0, end), args = text.substr(end);
+                float values[3];
+                if (keyword == "TITLE") {
+                    const std::size_t open = args.find('"'), close = args.rfind('"');
+                    if (open == std::string_view::npos || close == open)
+                        throw error("unquoted title");
+                    cube.title = args.substr(open + 1, close - open - 1);
+                }
+                else if (keyword == "LUT_1D_SIZE" || keyword == "LUT_3D_SIZE") {
+                    const bool is_1d = keyword == "LUT_1D_SIZE";
+                    if (_parse_floats(args, values, 1) != 1 || values[0] < 2.0f || values[0] > float(is_1d ? LUT_1D_MAX_SIZE : LUT_3D_MAX_SIZE) ||
+                        values[0] != float(std::size_t(values[0])))
+                        throw error("bad LUT size");
+                    (is_1d ? size_1d : size_3d) = std::size_t(values[0]);
+                }
+                else if (keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX") {
+                    if (_parse_floats(args, values, 3) != 3)
+                        throw error("bad domain");
+                    std::copy(values, values + 3, keyword == "DOMAIN_MIN" ? domain.min : domain.max);
+                }
+                else if (keyword == "LUT_1D_INPUT_RANGE" || keyword == "LUT_3D_INPUT_RANGE") {
+                    if (_parse_floats(args, values, 2) != 2)
+                        throw error("bad input range");
+                    LutDomain& range = keyword == "LUT_1D_INPUT_RANGE" ? domain_1d : domain_3d;
+                    std::fill(range.min, range.min + 3, values[0]);
+                    std::fill(range.max, range.max + 3, values[1]);
+                    (keyword == "LUT_1D_INPUT_RANGE" ? has_range_1d : has_range_3d) = true;
+                }
+                continue;
+            }
+
+            // data
+            if (count == 0) {
+                total = size_1d + size_3d * size_3d * size_3d;
+                if (total == 0)
+                    throw error("data before LUT size");
+                try {
+                    if (size_1d > 0) {
+                        cube.lut_1d = Lut1D(size_1d);
+                        cube.lut_1d.domain(has_range_1d ? domain_1d : domain);
+                    }
+                    if (size_3d > 0) {
+                        cube.lut_3d = Lut3D(size_3d);
+                        cube.lut_3d.domain(has_range_3d ? domain_3d : domain);
+                    }
+                }
+                catch (const std::invalid_argument&) {
+                    throw error("empty domain");
+                }
+            }
+            if (count == total)
+                throw error("too many data lines");
+            float rgb[3];
+            if (_parse_floats(text, rgb, 3) != 3)
+                throw error("bad data line");
+            if (count < size_1d)
+                cube.lut_1d.set(count, rgb[0], rgb[1], rgb[2]);
+            else {
+                const std::size_t k = count - size_1d;
+                cube.lut_3d.set(k % size_3d, (k / size_3d) % size_3d, k / (size_3d * size_3d), rgb[0], rgb[1], rgb[2]);
+            }
+            ++count;
+        }
+
+        if (count == 0 || count != total)
+            throw error(std::format("{:d} data lines, {:d} expected", count, total == 0 ? size_1d + size_3d * size_3d * size_3d : total));
+        return cube;
+    }
+
+    /** \brief Loads the .cube LUT file at path, see parse_cube(). Throws std::runtime_error if the file cannot be opened. */
+    export CubeLut load_cube(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            throw std::runtime_error(std::format("cannot open .cube file {:s}", path.string()));
+        return parse_cube(file);
+    }
+
+}
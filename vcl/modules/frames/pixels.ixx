@@ -0,0 +1,332 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+export module frames.pixels;
+
+import vectors.clipvect3;
+import vectors.clipvect4;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The layouts of channels in pixels. */
+    export enum PixelLayout : unsigned char
+    {
+        LAYOUT_GRAY = 0,  //!< one luminance channel.
+        LAYOUT_RGB,       //!< red, green, blue.
+        LAYOUT_BGR,       //!< blue, green, red, as OpenCV.
+        LAYOUT_RGBA,      //!< red, green, blue, alpha.
+        LAYOUT_BGRA       //!< blue, green, red, alpha.
+    };
+
+    /** \brief Returns the count of channels of a layout. */
+    export inline constexpr std::size_t layout_channels_count(const PixelLayout layout) noexcept
+    {
+        return layout == LAYOUT_GRAY ? 1 : (layout == LAYOUT_RGB || layout == LAYOUT_BGR) ? 3 : 4;
+    }
+
+
+    //-----------------------------------------------------------------------
+    // Forward declaration and Specializations
+    /** \brief The generic class of packed pixels, Kbits significant bits per channel. */
+    export template<typename TChannel, const PixelLayout Klayout, const unsigned Kbits = 8 * sizeof(TChannel)>
+        requires std::is_unsigned_v<TChannel> && (Kbits > 0) && (Kbits <= 8 * sizeof(TChannel))
+    struct PixelT;
+
+    /** \brief 8-bits gray pixels. */
+    export using Gray8 = PixelT<std::uint8_t, LAYOUT_GRAY>;
+
+    /** \brief 10-bits gray pixels, in 16-bits containers. */
+    export using Gray10 = PixelT<std::uint16_t, LAYOUT_GRAY, 10>;
+
+    /** \brief 12-bits gray pixels, in 16-bits containers. */
+    export using Gray12 = PixelT<std::uint16_t, LAYOUT_GRAY, 12>;
+
+    /** \brief 16-bits gray pixels. */
+    export using Gray16 = PixelT<std::uint16_t, LAYOUT_GRAY>;
+
+    /** \brief 8-bits per channel RGB pixels. */
+    export using RGB24 = PixelT<std::uint8_t, LAYOUT_RGB>;
+
+    /** \brief 8-bits per channel BGR pixels, as OpenCV CV_8UC3 images. */
+    export using BGR24 = PixelT<std::uint8_t, LAYOUT_BGR>;
+
+    /** \brief 8-bits per channel RGBA pixels. */
+    export using RGBA32 = PixelT<std::uint8_t, LAYOUT_RGBA>;
+
+    /** \brief 8-bits per channel BGRA pixels, as OpenCV CV_8UC4 images. */
+    export using BGRA32 = PixelT<std::uint8_t, LAYOUT_BGRA>;
+
+    /** \brief 10-bits per channel RGB pixels, in 16-bits containers. */
+    export using RGB30 = PixelT<std::uint16_t, LAYOUT_RGB, 10>;
+
+    /** \brief 12-bits per channel RGB pixels, in 16-bits containers. */
+    export using RGB36 = PixelT<std::uint16_t, LAYOUT_RGB, 12>;
+
+    /** \brief 16-bits per channel RGB pixels. */
+    export using RGB48 = PixelT<std::uint16_t, LAYOUT_RGB>;
+
+    /** \brief 16-bits per channel RGBA pixels. */
+    export using RGBA64 = PixelT<std::uint16_t, LAYOUT_RGBA>;
+
+
+    //===================================================================
+    /** \brief The generic class of packed pixels.
+    *
+    * Pixels are standard-layout and trivially copyable aggregates of their
+    * channels, in the order of their layout, so that frames of pixels can
+    * be shared with OpenCV and with SIMD kernels. Channels are valued in
+    * [0, MAX_VALUE], i.e. in the bounds of ClipVectType.  Traits are all
+    * compile-time constants, so that kernels get specialized per format
+    * with no runtime switch, see PixelTraits.
+    */
+    template<typename TChannel, const PixelLayout Klayout, const unsigned Kbits>
+        requires std::is_unsigned_v<TChannel> && (Kbits > 0) && (Kbits <= 8 * sizeof(TChannel))
+    struct PixelT
+    {
+        using MyType      = vcl::frames::PixelT<TChannel, Klayout, Kbits>;  //!< wrapper to this class naming.
+        using ChannelType = TChannel;                                      //!< wrapper to the channels type naming.
+
+        //---   Traits   --------------------------------------------------
+        static constexpr PixelLayout LAYOUT         = Klayout;                           //!< the layout of channels.
+        static constexpr std::size_t CHANNELS_COUNT = layout_channels_count(Klayout);    //!< the count of channels.
+        static constexpr unsigned    BITS_DEPTH     = Kbits;                             //!< the count of significant bits per channel.
+        static constexpr TChannel    MIN_VALUE      = TChannel(0);                       //!< the minimum value of channels.
+        static constexpr TChannel    MAX_VALUE      = TChannel((std::uint64_t(1) << Kbits) - 1);  //!< the maximum value of channels.
+        static constexpr bool        IS_GRAY        = Klayout == LAYOUT_GRAY;            //!< true for gray pixels.
+        static constexpr bool        HAS_ALPHA      = Klayout == LAYOUT_RGBA || Klayout == LAYOUT_BGRA;  //!< true if pixels get an alpha channel.
+
+        static constexpr int RED_INDEX   = IS_GRAY ? 0 : (Klayout == LAYOUT_RGB || Klayout == LAYOUT_RGBA) ? 0 : 2;  //!< the index of the red channel.
+        static constexpr int GREEN_INDEX = IS_GRAY ? 0 : 1;                                                             //!< the index of the green channel.
+        static constexpr int BLUE_INDEX  = IS_GRAY ? 0 : 2 - RED_INDEX;                                                 //!< the index of the blue channel.
+        static constexpr int ALPHA_INDEX = HAS_ALPHA ? 3 : -1;                                                          //!< the index of the alpha channel, -1 if none.
+
+        /** \brief The clipped vectors with the same channels and bounds, the channel itself for gray pixels. */
+        using ClipVectType = std::conditional_t<CHANNELS_COUNT == 1, TChannel,
+                                 std::conditional_t<CHANNELS_COUNT == 3, vcl::vect::ClipVect3T<TChannel, MIN_VALUE, MAX_VALUE>,
+                                                                          vcl::vect::ClipVect4T<TChannel, MIN_VALUE, MAX_VALUE>>>;
+
+
+        //---   Channels   ------------------------------------------------
+        TChannel channels[CHANNELS_COUNT];  //!< the channels, in the order of LAYOUT.
+
+
+        //---   Constructors   ------------------------------------------
+        /** \brief Returns the gray pixel of value, clipped. */
+        static inline constexpr MyType gray(const TChannel value) noexcept
+            requires IS_GRAY
+        {
+            return MyType{ { clipped(value) } };
+        }
+
+        /** \brief Returns the color pixel (r, g, b), clipped, opaque if with alpha. */
+        static inline constexpr MyType rgb(const TChannel r, const TChannel g, const TChannel b) noexcept
+            requires (!IS_GRAY)
+        {
+            MyType p{};
+            p.channels[RED_INDEX] = clipped(r);
+            p.channels[GREEN_INDEX] = clipped(g);
+            p.channels[BLUE_INDEX] = clipped(b);
+            if constexpr (HAS_ALPHA)
+                p.channels[ALPHA_INDEX] = MAX_VALUE;
+            return p;
+        }
+
+        /** \brief Returns the color pixel (r, g, b, a), clipped. */
+        static inline constexpr MyType rgba(const TChannel r, const TChannel g, const TChannel b, const TChannel a) noexcept
+            requires HAS_ALPHA
+        {
+            MyType p = rgb(r, g, b);
+            p.channels[ALPHA_INDEX] = clipped(a);
+            return p;
+        }
+
+        /** \brief Returns the pixel with the channels of a clipped vector, in the order of LAYOUT. */
+        static inline MyType from_clipvect(const ClipVectType& v) noexcept
+            requires (!IS_GRAY)
+        {
+            MyType p{};
+            for (std::size_t i = 0; i < CHANNELS_COUNT; ++i)
+                p.channels[i] = v[i];
+            return p;
+        }
+
+
+        //---   Accessors   ---------------------------------------------
+        /** \brief Returns the red channel, the luminance of gray pixels. */
+        inline constexpr TChannel r() const noexcept { return channels[RED_INDEX]; }
+
+        /** \brief Returns the green channel, the luminance of gray pixels. */
+        inline constexpr TChannel g() const noexcept { return channels[GREEN_INDEX]; }
+
+        /** \brief Returns the blue channel, the luminance of gray pixels. */
+        inline constexpr TChannel b() const noexcept { return channels[BLUE_INDEX]; }
+
+        /** \brief Returns the alpha channel, MAX_VALUE if none. */
+        inline constexpr TChannel a() const noexcept
+        {
+            if constexpr (HAS_ALPHA)
+                return channels[ALPHA_INDEX];
+            else
+                return MAX_VALUE;
+        }
+
+        /** \brief Returns the luminance of gray pixels. */
+        inline constexpr TChannel value() const noexcept
+            requires IS_GRAY
+        {
+            return channels[0];
+        }
+
+        /** \brief Returns the channels as a clipped vector, in the order of LAYOUT. */
+        inline ClipVectType to_clipvect() const noexcept
+            requires (!IS_GRAY)
+        {
+            if constexpr (CHANNELS_COUNT == 3)
+                return ClipVectType(channels[0], channels[1], channels[2]);
+            else
+                return ClipVectType(channels[0], channels[1], channels[2], channels[3]);
+        }
+
+
+        //---   Miscelaneous   ------------------------------------------
+        /** \brief Returns value clipped to the bounds of channels. */
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        static inline constexpr TChannel clipped(const T value) noexcept
+        {
+            if constexpr (std::is_signed_v<T>) {
+                if (value < T(0))
+                    return MIN_VALUE;
+            }
+            return (std::uint64_t)value > MAX_VALUE ? MAX_VALUE : TChannel(value);
+        }
+
+        inline constexpr bool operator== (const MyType&) const noexcept = default;
+    };
+
+
+    //===================================================================
+    /** \brief The compile-time traits of pixel types: packed pixels and plain arithmetic gray values. */
+    export template<typename P>
+    struct PixelTraits
+    {
+        static constexpr PixelLayout LAYOUT         = P::LAYOUT;
+        static constexpr std::size_t CHANNELS_COUNT = P::CHANNELS_COUNT;
+        static constexpr unsigned    BITS_DEPTH     = P::BITS_DEPTH;
+        static constexpr bool        HAS_ALPHA      = P::HAS_ALPHA;
+        static constexpr bool        IS_FLOATING    = false;
+        using ChannelType = typename P::ChannelType;
+    };
+
+    /** \brief The compile-time traits of plain arithmetic pixels, as gray values. */
+    template<typename P>
+        requires std::is_arithmetic_v<P>
+    struct PixelTraits<P>
+    {
+        static constexpr PixelLayout LAYOUT         = LAYOUT_GRAY;
+        static constexpr std::size_t CHANNELS_COUNT = 1;
+        static constexpr unsigned    BITS_DEPTH     = 8 * sizeof(P);
+        static constexpr bool        HAS_ALPHA      = false;
+        static constexpr bool        IS_FLOATING    = std::is_floating_point_v<P>;
+        using ChannelType = P;
+    };
+
+    /** \brief The concept of packed pixels types. */
+    export template<typename P>
+    concept PackedPixel = requires {
+        typename P::ChannelType;
+        { P::CHANNELS_COUNT } -> std::convertible_to<std::size_t>;
+        { P::BITS_DEPTH } -> std::convertible_to<unsigned>;
+        { P::LAYOUT } -> std::convertible_to<PixelLayout>;
+    } && std::is_standard_layout_v<P> && std::is_trivially_copyable_v<P>;
+
+
+    //===================================================================
+    /** \brief Returns channel value of FromBits bits scaled to ToBits bits, replicating high bits when widening. */
+    export template<const unsigned FromBits, const unsigned ToBits, typename TFrom>
+    inline constexpr std::uint32_t scale_channel(const TFrom value) noexcept
+    {
+        if constexpr (FromBits == ToBits)
+            return std::uint32_t(value);
+        else if constexpr (FromBits > ToBits)
+            return std::uint32_t(value) >> (FromBits - ToBits);
+        else if constexpr (2 * FromBits >= ToBits)
+            return (std::uint32_t(value) << (ToBits - FromBits)) | (std::uint32_t(value) >> (2 * FromBits - ToBits));
+        else
+            return std::uint32_t(value) << (ToBits - FromBits);
+    }
+
+    /** \brief Converts a packed pixel into another format, all choices being made at compile time.
+    * Channels get reordered and scaled to the destination depth.  Colors
+    * convert to gray with BT.601 luma weights, gray to colors replicates
+    * the luminance, missing alpha channels are opaque.
+    */
+    export template<PackedPixel PTo, PackedPixel PFrom>
+    inline constexpr PTo pixel_cast(const PFrom& p) noexcept
+    {
+        using ToChannel = typename PTo::ChannelType;
+        constexpr unsigned FROM_BITS = PFrom::BITS_DEPTH;
+        constexpr unsigned TO_BITS = PTo::BITS_DEPTH;
+
+        PTo q{};
+        if constexpr (PTo::IS_GRAY) {
+            if constexpr (PFrom::IS_GRAY) {
+                q.channels[0] = ToChannel(scale_channel<FROM_BITS, TO_BITS>(p.channels[0]));
+            }
+            else {
+                // BT.601 luma, 8 fractional bits fixed-point
+                const std::uint32_t y = (77 * std::uint32_t(p.r()) + 150 * std::uint32_t(p.g()) + 29 * std::uint32_t(p.b()) + 128) >> 8;
+                q.channels[0] = ToChannel(scale_channel<FROM_BITS, TO_BITS>(y));
+            }
+        }
+        else {
+            q.channels[PTo::RED_INDEX] = ToChannel(scale_channel<FROM_BITS, TO_BITS>(p.r()));
+            q.channels[PTo::GREEN_INDEX] = ToChannel(scale_channel<FROM_BITS, TO_BITS>(p.g()));
+            q.channels[PTo::BLUE_INDEX] = ToChannel(scale_channel<FROM_BITS, TO_BITS>(p.b()));
+            if constexpr (PTo::HAS_ALPHA)
+                q.channels[PTo::ALPHA_INDEX] = ToChannel(scale_channel<FROM_BITS, TO_BITS>(p.a()));
+        }
+        return q;
+    }
+
+
+    //-----------------------------------------------------------------------
+    static_assert(sizeof(Gray8) == 1 && sizeof(Gray16) == 2 && sizeof(Gray10) == 2);
+    static_assert(sizeof(RGB24) == 3 && sizeof(BGR24) == 3 && sizeof(RGBA32) == 4 && sizeof(BGRA32) == 4);
+    static_assert(sizeof(RGB30) == 6 && sizeof(RGB48) == 6 && sizeof(RGBA64) == 8);
+    static_assert(PackedPixel<RGB24> && PackedPixel<BGRA32> && PackedPixel<Gray12>);
+
+}
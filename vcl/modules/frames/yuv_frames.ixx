@@ -0,0 +1,403 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+export module frames.yuv_frames;
+
+import frames.frame;
+import frames.frame_buffers;
+import graphitems.rect;
+import utils.dims;
+
+
+//===========================================================================
+namespace vcl::frames {
+
+    //===================================================================
+    /** \brief The descriptor of chroma subsampling: chroma planes are 2^x_shift times narrower and 2^y_shift times shorter than luma. */
+    export struct ChromaSubsampling
+    {
+        unsigned char x_shift;  //!< the horizontal subsampling, as a power of 2.
+        unsigned char y_shift;  //!< the vertical subsampling, as a power of 2.
+
+        /** \brief Returns the width of chroma planes for luma planes width samples wide. */
+        inline constexpr std::size_t chroma_width(const std::size_t width) const noexcept
+        {
+            return (width + (std::size_t(1) << x_shift) - 1) >> x_shift;
+        }
+
+        /** \brief Returns the height of chroma planes for luma planes height samples high. */
+        inline constexpr std::size_t chroma_height(const std::size_t height) const noexcept
+        {
+            return (height + (std::size_t(1) << y_shift) - 1) >> y_shift;
+        }
+
+        inline constexpr bool operator== (const ChromaSubsampling&) const noexcept = default;
+    };
+
+    /** \brief No chroma subsampling, YUV 4:4:4. */
+    export inline constexpr ChromaSubsampling SUBSAMPLING_444{ 0, 0 };
+
+    /** \brief Chroma subsampled horizontally, YUV 4:2:2. */
+    export inline constexpr ChromaSubsampling SUBSAMPLING_422{ 1, 0 };
+
+    /** \brief Chroma subsampled horizontally and vertically, YUV 4:2:0. */
+    export inline constexpr ChromaSubsampling SUBSAMPLING_420{ 1, 1 };
+
+
+    //===================================================================
+    /** \brief The interleaved chroma samples of semi-planar YUV frames. */
+    export template<typename TSample>
+        requires std::is_unsigned_v<TSample>
+    struct CbCrT
+    {
+        TSample cb;
+        TSample cr;
+
+        inline constexpr bool operator== (const CbCrT&) const noexcept = default;
+    };
+
+
+    //-----------------------------------------------------------------------
+    // Forward declaration and Specializations
+    /** \brief The generic class of planar and semi-planar YUV frames. */
+    export template<typename TSample, const unsigned Kbits, const ChromaSubsampling Ksubsampling, const bool Ksemi_planar>
+        requires std::is_unsigned_v<TSample> && (Kbits >= 8) && (Kbits <= 8 * sizeof(TSample))
+    class YuvFrameT;
+
+    /** \brief The class of I420 frames: 8 bits, 4:2:0, planes Y, Cb and Cr. */
+    export using YuvFrame_i420 = YuvFrameT<std::uint8_t, 8, SUBSAMPLING_420, false>;
+
+    /** \brief The class of NV12 frames: 8 bits, 4:2:0, planes Y and interleaved CbCr. */
+    export using YuvFrame_nv12 = YuvFrameT<std::uint8_t, 8, SUBSAMPLING_420, true>;
+
+    /** \brief The class of P010 frames: 10 bits in the high bits of 16-bits samples, 4:2:0, planes Y and interleaved CbCr. */
+    export using YuvFrame_p010 = YuvFrameT<std::uint16_t, 10, SUBSAMPLING_420, true>;
+
+    /** \brief The class of YUV 4:2:2 frames: 8 bits, planes Y, Cb and Cr. */
+    export using YuvFrame_422 = YuvFrameT<std::uint8_t, 8, SUBSAMPLING_422, false>;
+
+    /** \brief The class of YUV 4:4:4 frames: 8 bits, planes Y, Cb and Cr. */
+    export using YuvFrame_444 = YuvFrameT<std::uint8_t, 8, SUBSAMPLING_444, false>;
+
+
+    //=======================================================================
+    /** \brief The generic class of planar and semi-planar YUV frames.
+    *
+    * Planes are frames of samples: luma Y, then either the two chroma
+    * planes Cb and Cr or, if semi-planar, one plane of interleaved CbCrT
+    * pairs. The geometry of chroma planes derives from the dimensions of
+    * the frame and from its chroma subsampling.  Planes share their
+    * pixels when returned or viewed, as frames do.
+    *
+    * Samples of semi-planar formats narrower than their containers are
+    * stored in the high bits, as in P010. Other ones are stored in the
+    * low bits.
+    */
+    template<typename TSample, const unsigned Kbits, const ChromaSubsampling Ksubsampling, const bool Ksemi_planar>
+        requires std::is_unsigned_v<TSample> && (Kbits >= 8) && (Kbits <= 8 * sizeof(TSample))
+    class YuvFrameT
+    {
+    public:
+        using MyType          = vcl::frames::YuvFrameT<TSample, Kbits, Ksubsampling, Ksemi_planar>;  //!< wrapper to this class naming.
+        using SampleType      = TSample;                                                               //!< wrapper to the samples type naming.
+        using PlaneType       = vcl::frames::FrameT<TSample>;                                          //!< the type of the luma plane, and of chroma planes if planar.
+        using ChromaPlaneType = std::conditional_t<Ksemi_planar, vcl::frames::FrameT<CbCrT<TSample>>, PlaneType>;  //!< the type of chroma planes.
+
+        static constexpr unsigned          BITS_DEPTH     = Kbits;                                       //!< the count of significant bits per sample.
+        static constexpr ChromaSubsampling SUBSAMPLING    = Ksubsampling;                                //!< the chroma subsampling.
+        static constexpr bool              IS_SEMI_PLANAR = Ksemi_planar;                                //!< true if chroma samples are interleaved.
+        static constexpr std::size_t       PLANES_COUNT   = Ksemi_planar ? 2 : 3;                        //!< the count of planes.
+        static constexpr unsigned          SAMPLES_SHIFT  = Ksemi_planar ? 8 * sizeof(TSample) - Kbits : 0;  //!< the left shift of sample values in their containers.
+        static constexpr unsigned          MAX_VALUE      = (1u << Kbits) - 1;                           //!< the maximum value of samples.
+        static constexpr std::size_t       CHROMA_STEP    = Ksemi_planar ? 2 : 1;                        //!< the count of samples between consecutive Cb (or Cr) samples of chroma rows.
+
+
+        //---   Constructors   ----------------------------------------------
+        /** \brief Empty constructor, no planes. */
+        inline YuvFrameT() noexcept = default;
+
+        /** \brief Constructor (width, height), samples being left uninitialized. */
+        inline YuvFrameT(const std::size_t width, const std::size_t height, FrameBuffersPool& pool = FrameBuffersPool::default_pool())
+            : m_y(width, height, pool)
+        {
+            if (!m_y.is_empty())
+                for (ChromaPlaneType& plane : m_chroma)
+                    plane = ChromaPlaneType(Ksubsampling.chroma_width(width), Ksubsampling.chroma_height(height), pool);
+        }
+
+        /** \brief Constructor (const vcl::utils::DimsT&), samples being left uninitialized. */
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        inline explicit YuvFrameT(const vcl::utils::DimsT<T>& dims, FrameBuffersPool& pool = FrameBuffersPool::default_pool())
+            : YuvFrameT(std::size_t(dims.width()), std::size_t(dims.height()), pool)
+        {}
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the width of this frame, in luma samples. */
+        inline const std::size_t width() const noexcept
+        {
+            return m_y.width();
+        }
+
+        /** \brief Returns the height of this frame, in luma samples. */
+        inline const std::size_t height() const noexcept
+        {
+            return m_y.height();
+        }
+
+        /** \brief Returns the dimensions of this frame. */
+        inline vcl::utils::Dims_ui dims() const noexcept
+        {
+            return m_y.dims();
+        }
+
+        /** \brief Returns the dimensions of the chroma planes of this frame. */
+        inline vcl::utils::Dims_ui chroma_dims() const noexcept
+        {
+            return vcl::utils::Dims_ui(Ksubsampling.chroma_width(width()), Ksubsampling.chroma_height(height()));
+        }
+
+        /** \brief Returns true if this frame gets no sample. */
+        inline const bool is_empty() const noexcept
+        {
+            return m_y.is_empty();
+        }
+
+        /** \brief Returns true if the planes of this frame are sub-frames of larger planes. */
+        inline const bool is_view() const noexcept
+        {
+            return m_y.is_view();
+        }
+
+        /** \brief Returns the NUMA node the samples of this frame are bound to, or NO_NUMA_NODE. */
+        inline const int numa_node() const noexcept
+        {
+            return m_y.numa_node();
+        }
+
+
+        //---   Planes   ----------------------------------------------------
+        /** \brief Returns the luma plane. */
+        inline const PlaneType& y() const noexcept
+        {
+            return m_y;
+        }
+
+        /** \brief Returns the luma plane. */
+        inline PlaneType& y() noexcept
+        {
+            return m_y;
+        }
+
+        /** \brief Returns the Cb plane of planar frames. */
+        inline const PlaneType& cb() const noexcept
+            requires (!Ksemi_planar)
+        {
+            return m_chroma[0];
+        }
+
+        /** \brief Returns the Cb plane of planar frames. */
+        inline PlaneType& cb() noexcept
+            requires (!Ksemi_planar)
+        {
+            return m_chroma[0];
+        }
+
+        /** \brief Returns the Cr plane of planar frames. */
+        inline const PlaneType& cr() const noexcept
+            requires (!Ksemi_planar)
+        {
+            return m_chroma[1];
+        }
+
+        /** \brief Returns the Cr plane of planar frames. */
+        inline PlaneType& cr() noexcept
+            requires (!Ksemi_planar)
+        {
+            return m_chroma[1];
+        }
+
+        /** \brief Returns the interleaved CbCr plane of semi-planar frames. */
+        inline const ChromaPlaneType& cbcr() const noexcept
+            requires Ksemi_planar
+        {
+            return m_chroma[0];
+        }
+
+        /** \brief Returns the interleaved CbCr plane of semi-planar frames. */
+        inline ChromaPlaneType& cbcr() noexcept
+            requires Ksemi_planar
+        {
+            return m_chroma[0];
+        }
+
+
+        /** \brief Returns the first Cb sample of chroma row cy, next ones being CHROMA_STEP samples away. Not checked. */
+        inline TSample* cb_row(const std::size_t cy) noexcept
+        {
+            return reinterpret_cast<TSample*>(m_chroma[0].row(cy));
+        }
+
+        /** \brief Returns the first Cb sample of chroma row cy, next ones being CHROMA_STEP samples away. Not checked. */
+        inline const TSample* cb_row(const std::size_t cy) const noexcept
+        {
+            return reinterpret_cast<const TSample*>(m_chroma[0].row(cy));
+        }
+
+        /** \brief Returns the first Cr sample of chroma row cy, next ones being CHROMA_STEP samples away. Not checked. */
+        inline TSample* cr_row(const std::size_t cy) noexcept
+        {
+            if constexpr (Ksemi_planar)
+                return reinterpret_cast<TSample*>(m_chroma[0].row(cy)) + 1;
+            else
+                return m_chroma[1].row(cy);
+        }
+
+        /** \brief Returns the first Cr sample of chroma row cy, next ones being CHROMA_STEP samples away. Not checked. */
+        inline const TSample* cr_row(const std::size_t cy) const noexcept
+        {
+            if constexpr (Ksemi_planar)
+                return reinterpret_cast<const TSample*>(m_chroma[0].row(cy)) + 1;
+            else
+                return m_chroma[1].row(cy);
+        }
+
+
+        //---   Samples   ---------------------------------------------------
+        /** \brief Returns the value of a stored sample. */
+        static inline constexpr unsigned sample_value(const TSample sample) noexcept
+        {
+            return unsigned(sample) >> SAMPLES_SHIFT;
+        }
+
+        /** \brief Returns the stored sample of value, which is not checked. */
+        static inline constexpr TSample to_sample(const unsigned value) noexcept
+        {
+            return TSample(value << SAMPLES_SHIFT);
+        }
+
+        /** \brief Sets all samples of this frame to the values (y, cb, cr). */
+        void fill(const unsigned y_value, const unsigned cb_value, const unsigned cr_value) noexcept
+        {
+            m_y.fill(to_sample(y_value));
+            if constexpr (Ksemi_planar)
+                m_chroma[0].fill(CbCrT<TSample>{ to_sample(cb_value), to_sample(cr_value) });
+            else {
+                m_chroma[0].fill(to_sample(cb_value));
+                m_chroma[1].fill(to_sample(cr_value));
+            }
+        }
+
+
+        //---   Views   -----------------------------------------------------
+        /** \brief Returns the zero-copy sub-frame of this frame covered by rect.
+        * rect is clipped to this frame, then widened to whole chroma
+        * samples: its left and top are rounded down and its right and
+        * bottom up to multiples of the subsampling. The view is empty if
+        * rect does not overlap this frame.
+        */
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        MyType view(const vcl::graphitems::RectT<T>& rect) const noexcept
+        {
+            constexpr long long X_STEP = 1LL << Ksubsampling.x_shift;
+            constexpr long long Y_STEP = 1LL << Ksubsampling.y_shift;
+            const long long left   = std::max(0LL, (long long)rect.x) / X_STEP * X_STEP;
+            const long long top    = std::max(0LL, (long long)rect.y) / Y_STEP * Y_STEP;
+            const long long right  = std::min((long long)width(), ((long long)rect.x + (long long)rect.width + X_STEP - 1) / X_STEP * X_STEP);
+            const long long bottom = std::min((long long)height(), ((long long)rect.y + (long long)rect.height + Y_STEP - 1) / Y_STEP * Y_STEP);
+
+            MyType sub;
+            if (!is_empty() && left < right && top < bottom) {
+                sub.m_y = m_y.view(vcl::graphitems::Rect_i(left, top, vcl::utils::Dims_ui(right - left, bottom - top)));
+                const vcl::graphitems::Rect_i chroma_rect(left >> Ksubsampling.x_shift, top >> Ksubsampling.y_shift,
+                                                          vcl::utils::Dims_ui(Ksubsampling.chroma_width(std::size_t(right - left)),
+                                                                              Ksubsampling.chroma_height(std::size_t(bottom - top))));
+                for (std::size_t i = 0; i < std::size(m_chroma); ++i)
+                    sub.m_chroma[i] = m_chroma[i].view(chroma_rect);
+            }
+            return sub;
+        }
+
+
+        //---   Copies   ----------------------------------------------------
+        /** \brief Returns a copy of this frame with its own samples. */
+        MyType clone(FrameBuffersPool& pool = FrameBuffersPool::default_pool()) const
+        {
+            MyType copy(width(), height(), pool);
+            copy_to(copy);
+            return copy;
+        }
+
+        /** \brief Copies the samples of this frame into other. Throws std::invalid_argument if dimensions differ. */
+        void copy_to(MyType& other) const
+        {
+            if (other.width() != width() || other.height() != height())
+                throw std::invalid_argument("YUV frames must get same dimensions for copy.");
+            m_y.copy_to(other.m_y);
+            for (std::size_t i = 0; i < std::size(m_chroma); ++i)
+                m_chroma[i].copy_to(other.m_chroma[i]);
+        }
+
+
+        //---   Pools   -----------------------------------------------------
+        /** \brief Allocates the buffers of count frames (width, height) in pool, touching their memory pages. */
+        static inline void prewarm(const std::size_t width, const std::size_t height, const std::size_t count,
+                                   FrameBuffersPool& pool = FrameBuffersPool::default_pool())
+        {
+            PlaneType::prewarm(width, height, count, pool);
+            ChromaPlaneType::prewarm(Ksubsampling.chroma_width(width), Ksubsampling.chroma_height(height), count * (PLANES_COUNT - 1), pool);
+        }
+
+
+    private:
+        PlaneType       m_y;                              //!< the luma plane.
+        ChromaPlaneType m_chroma[Ksemi_planar ? 1 : 2];   //!< the chroma planes, Cb and Cr or interleaved CbCr.
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    template<typename F>
+    struct _IsYuvFrame : std::false_type {};
+
+    template<typename TSample, const unsigned Kbits, const ChromaSubsampling Ksubsampling, const bool Ksemi_planar>
+    struct _IsYuvFrame<YuvFrameT<TSample, Kbits, Ksubsampling, Ksemi_planar>> : std::true_type {};
+
+    /** \brief The concept of YUV frames types, i.e. of the specializations of YuvFrameT. */
+    export template<typename F>
+    concept YuvFrame = _IsYuvFrame<std::remove_cv_t<F>>::value;
+
+}
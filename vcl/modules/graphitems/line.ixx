@@ -36,6 +36,7 @@ module;
 
 export module graphitems.line;
 
+import utils.allocations;
 import utils.base_funcs;
 import utils.colors;
 import utils.dims;
@@ -227,7 +228,7 @@ namespace vcl::graphitems {
 
 
         //---   Destructor   ------------------------------------------------
-        virtual inline ~LineT<TScalar>() noexcept
+        virtual inline ~LineT() noexcept
         {}
 
 
@@ -404,7 +405,7 @@ namespace vcl::graphitems {
         /** \brief casting operator to vcl::vect::ClipVect4T<T>.
         * Returns a 4-components vcl::vect::ClipVect4T (start.x, start.y, nd.x, end.y).
         */
-        template<typename T = TScalar, const size_t Kmin, const size_t Kmax>
+        template<typename T = TScalar, const T Kmin, const T Kmax>
             requires std::is_arithmetic_v<T>
         inline operator vcl::vect::ClipVect4T<T, Kmin, Kmax>() noexcept
         {
@@ -418,6 +419,7 @@ namespace vcl::graphitems {
             requires std::is_arithmetic_v<T>
         operator std::vector<T>() noexcept
         {
+            vcl::utils::AllocationSite site("vcl::graphitems::LineT::operator std::vector()");
             std::vector<T> v{ T(start.x()), T(start.y()), T(end.x()), T(end.y()) };
             return v;
         }
@@ -1136,7 +1138,7 @@ namespace vcl::graphitems {
         */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator+ (MyType line, const T& incr) noexcept
+        friend inline MyType operator+ (MyType line, const T& incr) noexcept
         {
             return line += incr;
         }
@@ -1147,7 +1149,7 @@ namespace vcl::graphitems {
         */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator+ (const T& incr, MyType line) noexcept
+        friend inline MyType operator+ (const T& incr, MyType line) noexcept
         {
             return line += incr;
         }
@@ -1158,7 +1160,7 @@ namespace vcl::graphitems {
         */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator- (MyType line, const T& incr) noexcept
+        friend inline MyType operator- (MyType line, const T& incr) noexcept
         {
             return line -= incr;
         }
@@ -1283,7 +1285,7 @@ namespace vcl::graphitems {
                          const int                border_thickness,
                          const cv::LineTypes      border_type)
         {
-            prvt_last_color = border_color;
+            prvt_last_color = cv::Scalar(border_color);
             prvt_last_thickness = border_thickness;
             prvt_last_type = border_type;
             draw(frame);
@@ -1304,7 +1306,7 @@ namespace vcl::graphitems {
                          const vcl::utils::Color& border_color,
                          const cv::LineTypes      border_type)
         {
-            prvt_last_color = border_color;
+            prvt_last_color = cv::Scalar(border_color);
             prvt_last_type = border_type;
             draw(frame);
         }
@@ -1314,7 +1316,7 @@ namespace vcl::graphitems {
                          const vcl::utils::Color& border_color,
                          const int                border_thickness)
         {
-            prvt_last_color = border_color;
+            prvt_last_color = cv::Scalar(border_color);
             prvt_last_thickness = border_thickness;
             draw(frame);
         }
@@ -1336,7 +1338,7 @@ namespace vcl::graphitems {
         /** \brief Draws this line in a specified frame (use previous border_thickness and _ttype again). */
         inline void draw(cv::Mat& frame, const vcl::utils::Color& border_color)
         {
-            prvt_last_color = border_color;
+            prvt_last_color = cv::Scalar(border_color);
             draw(frame);
         }
 
@@ -1361,9 +1363,27 @@ namespace vcl::graphitems {
 
 
     private:
-        vcl::utils::Color prvt_last_color{};
+        cv::Scalar        prvt_last_color{};
         int               prvt_last_thickness{ 1 };
         cv::LineTypes     prvt_last_type{ cv::LINE_8 };
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit line.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class LineT<char>;
+    extern template class LineT<unsigned char>;
+    extern template class LineT<short>;
+    extern template class LineT<unsigned short>;
+    extern template class LineT<long>;
+    extern template class LineT<unsigned long>;
+    extern template class LineT<long long>;
+    extern template class LineT<unsigned long long>;
+    extern template class LineT<float>;
+    extern template class LineT<double>;
+    extern template class LineT<long double>;
+#endif
+
 }
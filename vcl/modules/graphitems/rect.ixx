@@ -40,6 +40,7 @@ module;
 
 export module graphitems.rect;
 
+import utils.allocations;
 import utils.base_funcs;
 import utils.colors;
 import utils.dims;
@@ -211,7 +212,7 @@ namespace vcl::graphitems {
 
 
         //---   Destructor   ------------------------------------------------
-        virtual inline ~RectT<TScalar>()
+        virtual inline ~RectT()
         {}
 
 
@@ -581,11 +582,8 @@ namespace vcl::graphitems {
             requires std::is_arithmetic_v<T>
         operator std::vector<T>()
         {
-            std::vector<T> v;
-            v.push_back(T(this->x));
-            v.push_back(T(this->y));
-            v.push_back(T(this->width));
-            v.push_back(T(this->height));
+            vcl::utils::AllocationSite site("vcl::graphitems::RectT::operator std::vector()");
+            std::vector<T> v{ T(this->x), T(this->y), T(this->width), T(this->height) };  // one single allocation
             return v;
         }
 
@@ -2016,7 +2014,7 @@ namespace vcl::graphitems {
                          const int                border_thickness,
                          const cv::LineTypes      border_type)
         {
-            prvt_last_border_color = border_color;
+            prvt_last_border_color = cv::Scalar(border_color);
             prvt_last_border_thickness = border_thickness;
             prvt_last_border_type = border_type;
             draw(frame);
@@ -2037,7 +2035,7 @@ namespace vcl::graphitems {
                          const vcl::utils::Color& border_color,
                          const cv::LineTypes      border_type)
         {
-            prvt_last_border_color = border_color;
+            prvt_last_border_color = cv::Scalar(border_color);
             prvt_last_border_type = border_type;
             draw(frame);
         }
@@ -2047,7 +2045,7 @@ namespace vcl::graphitems {
                          const vcl::utils::Color& border_color,
                          const int                border_thickness)
         {
-            prvt_last_border_color = border_color;
+            prvt_last_border_color = cv::Scalar(border_color);
             prvt_last_border_thickness = border_thickness;
             draw(frame);
         }
@@ -2069,7 +2067,7 @@ namespace vcl::graphitems {
         /** \brief Draws this rectangle contours in a specified frame (use previous border_thickness and _ttype again). */
         inline void draw(cv::Mat& frame, const vcl::utils::Color& border_color)
         {
-            prvt_last_border_color = border_color;
+            prvt_last_border_color = cv::Scalar(border_color);
             draw(frame);
         }
 
@@ -2095,10 +2093,21 @@ namespace vcl::graphitems {
 
 
     private:
-        vcl::utils::Color prvt_last_border_color{ };
+        cv::Scalar        prvt_last_border_color{ };
         int               prvt_last_border_thickness{ 1 };
         cv::LineTypes     prvt_last_border_type{ cv::LINE_8 };
 
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit rect.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class RectT<short>;
+    extern template class RectT<long>;
+    extern template class RectT<float>;
+    extern template class RectT<double>;
+#endif
+
 }
@@ -0,0 +1,350 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module utils.allocations;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    /** \brief true if allocations tracking is compiled in, i.e. if VCL_ALLOC_TRACKING is defined at build time.
+    * When false, AllocationSite objects cost nothing and memory_resource()
+    * returns the default pmr memory resource.
+    */
+    export constexpr bool ALLOC_TRACKING_ENABLED =
+#ifdef VCL_ALLOC_TRACKING
+        true;
+#else
+        false;
+#endif
+
+
+    //===================================================================
+    /** \brief The allocation statistics of one call site.
+    */
+    export struct AllocationSiteStats
+    {
+        const char*        site;   //!< the static name of the call site.
+        unsigned long long count;  //!< the count of allocations done from this site.
+        unsigned long long bytes;  //!< the total count of bytes allocated from this site.
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief The name of the sites for allocations done out of any vcl call site. */
+    constexpr const char* _OUTSIDE_SITE = "(outside vcl)";
+
+    /** \brief One call site entry of the allocations table. */
+    struct _SiteSlot
+    {
+        std::atomic<const char*> site{ nullptr };
+        std::atomic<unsigned long long> count{ 0 };
+        std::atomic<unsigned long long> bytes{ 0 };
+    };
+
+    /** \brief The fixed-size table of call sites.
+    * Open addressing on the static names addresses. Recording never
+    * allocates memory,  so that it can be called from global operator
+    * new replacements.  Allocations from sites in excess of the table
+    * capacity are counted in overflow.
+    */
+    struct _AllocationsTable
+    {
+        static constexpr std::size_t SLOTS_COUNT = 512;  // must be a power of 2
+
+        std::array<_SiteSlot, SLOTS_COUNT> slots;
+        _SiteSlot overflow;
+
+        static _AllocationsTable& instance() noexcept
+        {
+            static _AllocationsTable table;
+            return table;
+        }
+
+        /** \brief Returns the slot of site, inserting it if needed, or the overflow slot if the table is full. */
+        _SiteSlot& slot(const char* site) noexcept
+        {
+            std::size_t i = prvt_hash(site);
+            for (std::size_t n = 0; n < SLOTS_COUNT; ++n, ++i) {
+                _SiteSlot& s = slots[i & (SLOTS_COUNT - 1)];
+                const char* current = s.site.load(std::memory_order_acquire);
+                if (current == site)
+                    return s;
+                if (current == nullptr) {
+                    if (s.site.compare_exchange_strong(current, site, std::memory_order_acq_rel) || current == site)
+                        return s;
+                }
+            }
+            return overflow;
+        }
+
+        static inline std::size_t prvt_hash(const char* site) noexcept
+        {
+            return std::size_t((reinterpret_cast<std::uintptr_t>(site) >> 3) * 0x9E3779B97F4A7C15ull >> 32);
+        }
+    };
+
+    /** \brief Returns the call site of the calling thread, nullptr if out of any vcl call site. */
+    inline const char*& _current_site() noexcept
+    {
+        thread_local const char* site = nullptr;
+        return site;
+    }
+
+    /** \brief Returns the count of nested tracked allocations of the calling thread.
+    * Used to not count twice allocations forwarded from a tracking
+    * memory resource to global operator new.
+    */
+    inline int& _tracking_depth() noexcept
+    {
+        thread_local int depth = 0;
+        return depth;
+    }
+
+
+    //===================================================================
+    /** \brief The class of scoped allocation call sites.
+    *
+    * Allocations done by the current thread while an AllocationSite is
+    * alive are accounted to its name.  Names must have static storage
+    * duration, e.g. string literals. Nested sites are accounted to the
+    * innermost one. When ALLOC_TRACKING_ENABLED is false, sites cost
+    * nothing.
+    */
+    export class AllocationSite
+    {
+    public:
+        /** \brief Constructor, enters the call site. */
+        inline explicit AllocationSite(const char* static_name) noexcept
+        {
+            if constexpr (ALLOC_TRACKING_ENABLED) {
+                m_previous = _current_site();
+                _current_site() = static_name;
+            }
+        }
+
+        /** \brief Destructor, leaves the call site. */
+        inline ~AllocationSite() noexcept
+        {
+            if constexpr (ALLOC_TRACKING_ENABLED)
+                _current_site() = m_previous;
+        }
+
+        AllocationSite(const AllocationSite&) = delete;
+        AllocationSite& operator= (const AllocationSite&) = delete;
+
+    private:
+        const char* m_previous = nullptr;  //!< the enclosing call site.
+    };
+
+
+    //===================================================================
+    /** \brief The tracker of allocations.
+    *
+    * Allocations are recorded by TrackingMemoryResource instances  and,
+    * when  header  "utils/allocation_hooks.h"  is  included in the
+    * application, by the global operators new. Recording is lock-free
+    * and never allocates.
+    */
+    export class AllocationTracker
+    {
+    public:
+        /** \brief Records one allocation of bytes, accounted to the current call site. */
+        static inline void record(const std::size_t bytes) noexcept
+        {
+            if (_tracking_depth() > 0)
+                return;
+            const char* site = _current_site();
+            _SiteSlot& s = _AllocationsTable::instance().slot(site != nullptr ? site : _OUTSIDE_SITE);
+            s.count.fetch_add(1, std::memory_order_relaxed);
+            s.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the count of allocations accounted to the named site, e.g. to check zero-allocation loops.
+        * Sites are compared by name, since the same literal may get different
+        * addresses in different translation units.
+        */
+        static const unsigned long long count(const std::string_view site_name) noexcept
+        {
+            unsigned long long total = 0;
+            for (const _SiteSlot& s : _AllocationsTable::instance().slots) {
+                const char* site = s.site.load(std::memory_order_acquire);
+                if (site != nullptr && std::string_view(site) == site_name)
+                    total += s.count.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        /** \brief Returns the count of allocations done from within vcl call sites. */
+        static const unsigned long long vcl_count() noexcept
+        {
+            unsigned long long total = 0;
+            for (const _SiteSlot& s : _AllocationsTable::instance().slots) {
+                const char* site = s.site.load(std::memory_order_acquire);
+                if (site != nullptr && site != _OUTSIDE_SITE)
+                    total += s.count.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        /** \brief Returns the statistics of all call sites, sorted by decreasing count of bytes.
+        * Sites with the same name - e.g. from different translation units - are merged.
+        */
+        static std::vector<AllocationSiteStats> collect()
+        {
+            std::vector<AllocationSiteStats> sites;
+            sites.reserve(_AllocationsTable::SLOTS_COUNT + 1);
+            _AllocationsTable& table = _AllocationsTable::instance();
+            for (const _SiteSlot& s : table.slots) {
+                const char* site = s.site.load(std::memory_order_acquire);
+                if (site != nullptr)
+                    sites.push_back({ site, s.count.load(std::memory_order_relaxed), s.bytes.load(std::memory_order_relaxed) });
+            }
+            if (table.overflow.count.load(std::memory_order_relaxed) > 0)
+                sites.push_back({ "(sites overflow)", table.overflow.count.load(std::memory_order_relaxed), table.overflow.bytes.load(std::memory_order_relaxed) });
+
+            std::sort(sites.begin(), sites.end(),
+                      [](const AllocationSiteStats& a, const AllocationSiteStats& b) { return std::string_view(a.site) < std::string_view(b.site); });
+            std::vector<AllocationSiteStats> merged;
+            for (const AllocationSiteStats& s : sites) {
+                if (!merged.empty() && std::string_view(merged.back().site) == std::string_view(s.site)) {
+                    merged.back().count += s.count;
+                    merged.back().bytes += s.bytes;
+                }
+                else if (s.count > 0)
+                    merged.push_back(s);
+            }
+
+            std::stable_sort(merged.begin(), merged.end(),
+                             [](const AllocationSiteStats& a, const AllocationSiteStats& b) { return a.bytes > b.bytes; });
+            return merged;
+        }
+
+        /** \brief Returns a text report of allocations, one call site per line. */
+        static std::string report()
+        {
+            std::string txt = std::format("{:<60s} {:>12s} {:>14s}\n", "allocation site", "count", "bytes");
+            for (const AllocationSiteStats& s : collect())
+                txt += std::format("{:<60s} {:>12d} {:>14d}\n", s.site, s.count, s.bytes);
+            return txt;
+        }
+
+        /** \brief Resets the statistics of all call sites. */
+        static void reset() noexcept
+        {
+            _AllocationsTable& table = _AllocationsTable::instance();
+            for (_SiteSlot& s : table.slots) {
+                s.count.store(0, std::memory_order_relaxed);
+                s.bytes.store(0, std::memory_order_relaxed);
+            }
+            table.overflow.count.store(0, std::memory_order_relaxed);
+            table.overflow.bytes.store(0, std::memory_order_relaxed);
+        }
+
+        /** \brief Prints the report on std::cerr at program exit. Registered once whatever the count of calls. */
+        static void report_at_exit()
+        {
+            static const bool registered = (std::atexit([] { std::cerr << "\n" << report(); }) == 0);
+            (void)registered;
+        }
+    };
+
+
+    //===================================================================
+    /** \brief The class of pmr memory resources that track allocations.
+    * Allocations are forwarded to an upstream resource and accounted
+    * to the current call site.
+    */
+    export class TrackingMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+        /** \brief Constructor. */
+        inline explicit TrackingMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+            : m_upstream(upstream)
+        {}
+
+        /** \brief Returns the upstream memory resource. */
+        inline std::pmr::memory_resource* upstream() const noexcept
+        {
+            return m_upstream;
+        }
+
+    protected:
+        void* do_allocate(const std::size_t bytes, const std::size_t alignment) override
+        {
+            AllocationTracker::record(bytes);
+            ++_tracking_depth();
+            struct _Leave { ~_Leave() { --_tracking_depth(); } } leave;
+            return m_upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, const std::size_t bytes, const std::size_t alignment) override
+        {
+            m_upstream->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        std::pmr::memory_resource* m_upstream;
+    };
+
+
+    //===================================================================
+    /** \brief Returns the memory resource used by default by vcl containers.
+    * A TrackingMemoryResource when ALLOC_TRACKING_ENABLED is true,  the
+    * default pmr memory resource otherwise.
+    */
+    export inline std::pmr::memory_resource* memory_resource() noexcept
+    {
+        if constexpr (ALLOC_TRACKING_ENABLED) {
+            static TrackingMemoryResource resource;
+            return &resource;
+        }
+        else
+            return std::pmr::get_default_resource();
+    }
+
+}
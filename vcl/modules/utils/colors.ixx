@@ -37,7 +37,7 @@ namespace vcl::utils {
     /** \brief class Color: the base class for all colors.
     * 
     * This class is abstract: operator '=(const Color<T>)' is set to
-    * be abstract.
+    * be abstract and the cast operator to cv::Scalar is pure virtual.
     */
     export class Color
     {
@@ -55,12 +55,15 @@ namespace vcl::utils {
 
         //--- Destructor ----------------------------------------------------
         /** \brief Destructor. */
-        inline ~Color() = default;
+        inline virtual ~Color() = default;
 
 
         //--- Assignment ----------------------------------------------------
         /** \brief Copy assignment. */
-        inline Color& operator=(Color& other) = default;
+        inline Color& operator=(const Color& other) = default;
+
+        /** \brief Move assignment. */
+        inline Color& operator=(Color&& other) = default;
 
         /** \brief Assignment by value.
         * This method MUST BE overridden in inheriting classes.
@@ -68,6 +71,64 @@ namespace vcl::utils {
         template<typename T>
             requires std::is_arithmetic_v<T>
         inline Color& operator=(const T& value) = delete;
+
+
+        //--- Conversion ----------------------------------------------------
+        /** \brief cast operator to cv::Scalar, as expected by OpenCV drawing functions.
+        * This method MUST BE overridden in inheriting classes.
+        */
+        virtual operator cv::Scalar() const noexcept = 0;
+    };
+
+
+    //===================================================================
+    /** \brief class RGBColor: 8-bits red, green and blue colors.
+    */
+    export class RGBColor : public Color
+    {
+    public:
+        //---   constructors   ------------------------------------------
+        /** \brief Empty constructor (black). */
+        inline RGBColor() noexcept = default;
+
+        /** \brief Valued constructor. */
+        inline RGBColor(const unsigned char red, const unsigned char green, const unsigned char blue) noexcept
+            : Color(), m_red(red), m_green(green), m_blue(blue)
+        {}
+
+
+        //--- Accessors -----------------------------------------------------
+        /** \brief Returns the red component of this color. */
+        inline const unsigned char red() const noexcept
+        {
+            return m_red;
+        }
+
+        /** \brief Returns the green component of this color. */
+        inline const unsigned char green() const noexcept
+        {
+            return m_green;
+        }
+
+        /** \brief Returns the blue component of this color. */
+        inline const unsigned char blue() const noexcept
+        {
+            return m_blue;
+        }
+
+
+        //--- Conversion ----------------------------------------------------
+        /** \brief cast operator to cv::Scalar, in the BGR order of OpenCV frames. */
+        inline virtual operator cv::Scalar() const noexcept override
+        {
+            return cv::Scalar(m_blue, m_green, m_red);
+        }
+
+
+    private:
+        unsigned char m_red{ 0 };
+        unsigned char m_green{ 0 };
+        unsigned char m_blue{ 0 };
     };
 
 }
\ No newline at end of file
@@ -164,14 +164,14 @@ namespace vcl::utils {
         {}
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~DimsT<TScalar>()
+        virtual inline ~DimsT()
         {}
 
         //---   Casting operator   --------------------------------------
         /** \brief cast operator to cv::Size_<_Tp> */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        inline operator cv::Size_<T>& ()
+        inline operator cv::Size_<T>() const
         {
             return cv::Size_<T>(T(this->width()), T(this->height()));
         }
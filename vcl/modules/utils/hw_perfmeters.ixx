@@ -0,0 +1,267 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <array>
+#include <cstdint>
+#include <format>
+#include <string>
+
+#if defined(__linux__)
+#   define VCL_PERF_EVENTS_AVAILABLE
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+export module utils.hw_perfmeters;
+
+import utils.perfmeters;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    /** \brief The identifiers of the hardware counters. */
+    export enum HwCounterId : unsigned char
+    {
+        HW_CYCLES = 0,
+        HW_INSTRUCTIONS,
+        HW_CACHE_MISSES,
+        HW_BRANCH_MISSES,
+        HW_COUNTERS_COUNT
+    };
+
+
+    //===================================================================
+    /** \brief The values of hardware counters over a measure.
+    * Counters that are not available are set to -1.
+    */
+    export struct HwCounters
+    {
+        long long elapsed_ns{ 0 };
+        std::array<long long, HW_COUNTERS_COUNT> values{ -1, -1, -1, -1 };
+
+        /** \brief Returns the count of CPU cycles, or -1 if not available. */
+        inline const long long cycles() const noexcept
+        {
+            return values[HW_CYCLES];
+        }
+
+        /** \brief Returns the count of retired instructions, or -1 if not available. */
+        inline const long long instructions() const noexcept
+        {
+            return values[HW_INSTRUCTIONS];
+        }
+
+        /** \brief Returns the count of last level cache misses, or -1 if not available. */
+        inline const long long cache_misses() const noexcept
+        {
+            return values[HW_CACHE_MISSES];
+        }
+
+        /** \brief Returns the count of mispredicted branches, or -1 if not available. */
+        inline const long long branch_misses() const noexcept
+        {
+            return values[HW_BRANCH_MISSES];
+        }
+
+        /** \brief Returns the count of instructions per cycle, or 0.0 if not available. */
+        inline const double ipc() const noexcept
+        {
+            return (cycles() > 0 && instructions() >= 0) ? double(instructions()) / double(cycles()) : 0.0;
+        }
+
+        /** \brief Returns a one line text report of these counters. */
+        std::string report() const
+        {
+            std::string txt = std::format("elapsed={:.3f}us", elapsed_ns * 1e-3);
+            constexpr std::array<const char*, HW_COUNTERS_COUNT> NAMES{ "cycles", "instructions", "cache-misses", "branch-misses" };
+            for (int i = 0; i < HW_COUNTERS_COUNT; ++i) {
+                if (values[i] >= 0)
+                    txt += std::format(" {}={}", NAMES[i], values[i]);
+                else
+                    txt += std::format(" {}=n/a", NAMES[i]);
+            }
+            if (cycles() > 0 && instructions() >= 0)
+                txt += std::format(" ipc={:.2f}", ipc());
+            return txt;
+        }
+    };
+
+
+    //===================================================================
+    /** \brief The class of hardware performance counters evaluators.
+    *
+    * Opens Linux perf_event counters (cycles, instructions, cache misses
+    * and branch misses) for the calling thread,  user space only.  The
+    * counters are grouped so that they are scheduled together on the PMU,
+    * and values are scaled when the kernel had to multiplex them.
+    * When perf events are not allowed - e.g. perf_event_paranoid setting,
+    * containers, virtual machines without PMU, non Linux platforms - the
+    * unavailable counters are reported as -1 while the elapsed time is
+    * still measured.
+    * Counters are attached to the calling thread: a meter must be started
+    * and read from the thread that created it.
+    */
+    export class HwPerfMeter
+    {
+    public:
+        /** \brief Empty constructor.
+        * Opens the counters and starts measuring.
+        */
+        HwPerfMeter() noexcept
+        {
+            m_fds.fill(-1);
+            m_group_index.fill(-1);
+            prvt_open();
+            start();
+        }
+
+        HwPerfMeter(const HwPerfMeter&) = delete;
+        HwPerfMeter& operator= (const HwPerfMeter&) = delete;
+
+        /** \brief Destructor, closes the counters.
+        */
+        ~HwPerfMeter() noexcept
+        {
+            prvt_close();
+        }
+
+        /** \brief Returns true if at least one hardware counter is available. */
+        inline const bool is_available() const noexcept
+        {
+            return m_leader_fd >= 0;
+        }
+
+        /** \brief Returns true if the specified hardware counter is available. */
+        inline const bool is_available(const HwCounterId id) const noexcept
+        {
+            return m_fds[id] >= 0;
+        }
+
+        /** \brief Resets the counters and internally sets the starting point. */
+        void start() noexcept
+        {
+#if defined(VCL_PERF_EVENTS_AVAILABLE)
+            if (m_leader_fd >= 0) {
+                ioctl(m_leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(m_leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+            m_perf_meter.start();
+        }
+
+        /** \brief Gets the counters values and elapsed time since last start, counters keep on running. */
+        const HwCounters get_counters() noexcept
+        {
+            HwCounters counters;
+            counters.elapsed_ns = m_perf_meter.get_elapsed_ns();
+
+#if defined(VCL_PERF_EVENTS_AVAILABLE)
+            if (m_leader_fd >= 0) {
+                // read format: nr, time_enabled, time_running, values[nr]
+                std::array<std::uint64_t, 3 + HW_COUNTERS_COUNT> buffer{};
+                if (read(m_leader_fd, buffer.data(), sizeof(buffer)) > 0) {
+                    const std::uint64_t nr = buffer[0];
+                    const std::uint64_t enabled = buffer[1];
+                    const std::uint64_t running = buffer[2];
+                    const double scale = (running > 0 && running < enabled) ? double(enabled) / double(running) : 1.0;
+                    for (int i = 0; i < HW_COUNTERS_COUNT; ++i) {
+                        const int g = m_group_index[i];
+                        if (g >= 0 && std::uint64_t(g) < nr)
+                            counters.values[i] = (long long)(double(buffer[3 + g]) * scale + 0.5);
+                    }
+                }
+            }
+#endif
+            return counters;
+        }
+
+        /** \brief gets measured duration in fractional milliseconds. */
+        inline const double get_elapsed_ms()
+        {
+            return m_perf_meter.get_elapsed_ms();
+        }
+
+
+    private:
+        std::array<int, HW_COUNTERS_COUNT> m_fds;          //!< the file descriptors of the counters, -1 if not available.
+        std::array<int, HW_COUNTERS_COUNT> m_group_index;  //!< the indexes of the counters values in the group read format.
+        int m_leader_fd{ -1 };                             //!< the file descriptor of the group leader.
+        vcl::utils::PerfMeter m_perf_meter;                //!< the elapsed time evaluator.
+
+        /** \brief Opens the available counters as one group attached to the calling thread. */
+        void prvt_open() noexcept
+        {
+#if defined(VCL_PERF_EVENTS_AVAILABLE)
+            constexpr std::array<std::uint64_t, HW_COUNTERS_COUNT> CONFIGS{
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES
+            };
+
+            int group_size = 0;
+            for (int i = 0; i < HW_COUNTERS_COUNT; ++i) {
+                perf_event_attr attr{};
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(perf_event_attr);
+                attr.config = CONFIGS[i];
+                attr.disabled = (m_leader_fd < 0) ? 1 : 0;  // the group is enabled through its leader
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                const int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, m_leader_fd, 0);
+                if (fd < 0)
+                    continue;  // not allowed or not supported: this counter is reported as unavailable
+
+                if (m_leader_fd < 0)
+                    m_leader_fd = fd;
+                m_fds[i] = fd;
+                m_group_index[i] = group_size++;
+            }
+#endif
+        }
+
+        /** \brief Closes the opened counters. */
+        void prvt_close() noexcept
+        {
+#if defined(VCL_PERF_EVENTS_AVAILABLE)
+            for (int& fd : m_fds) {
+                if (fd >= 0)
+                    close(fd);
+                fd = -1;
+            }
+#endif
+            m_leader_fd = -1;
+        }
+    };
+
+}
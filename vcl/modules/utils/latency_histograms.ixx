@@ -0,0 +1,273 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <string>
+
+export module utils.latency_histograms;
+
+import utils.perfmeters;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    // Forward declaration
+    /** \brief The generic class of latency histograms. */
+    export template<const unsigned int SUB_BITS = 7>
+    class LatencyHistogramT;
+
+    // Specializations
+    export using LatencyHistogram = LatencyHistogramT<7>;    //!< latency histograms with 1.6% max relative error on values.
+    export using LatencyHistogram_hp = LatencyHistogramT<9>; //!< high precision latency histograms, with 0.4% max relative error on values.
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The class of HDR-style latency histograms.
+    *
+    * Values - e.g. latencies in nanoseconds - are counted in log-linear
+    * buckets over the whole 64-bit range: every power of two range gets
+    * 2^(SUB_BITS-1) linear sub-buckets,  while values lower than 2^SUB_BITS
+    * are counted exactly. The relative error on reported values is then
+    * at most 1 / 2^(SUB_BITS-1).
+    *
+    * Memory is fixed at construction time,  recording a value is O(1) and
+    * never allocates.  Histograms are not thread-safe:  each thread should
+    * record into its own histogram,  histograms being merged afterwards.
+    */
+    template<const unsigned int SUB_BITS>
+    class LatencyHistogramT
+    {
+    public:
+        using MyType = LatencyHistogramT<SUB_BITS>;  //!< wrapper to this class naming.
+
+        static_assert(SUB_BITS >= 2 && SUB_BITS <= 16, "histograms sub-buckets bits count must be in range [2, 16]");
+
+        static constexpr std::size_t SUB_COUNT  = std::size_t(1) << SUB_BITS;               //!< count of exact buckets for lowest values.
+        static constexpr std::size_t HALF_COUNT = SUB_COUNT / 2;                            //!< count of sub-buckets per power of two range.
+        static constexpr std::size_t BUCKETS_COUNT = SUB_COUNT + (64 - SUB_BITS) * HALF_COUNT;  //!< total count of buckets.
+
+
+        //---   constructors   ----------------------------------------------
+        /** \brief Empty constructor.
+        */
+        inline LatencyHistogramT()
+        {
+            reset();
+        }
+
+
+        //---   Recording   -------------------------------------------------
+        /** \brief Records one value, in O(1). */
+        inline void record(const unsigned long long value) noexcept
+        {
+            ++m_counts[bucket_index(value)];
+            ++m_total_count;
+            m_total_sum += value;
+            m_min = std::min(m_min, value);
+            m_max = std::max(m_max, value);
+        }
+
+        /** \brief Records count times the same value, in O(1). */
+        inline void record(const unsigned long long value, const unsigned long long count) noexcept
+        {
+            if (count == 0)
+                return;
+            m_counts[bucket_index(value)] += count;
+            m_total_count += count;
+            m_total_sum += value * count;
+            m_min = std::min(m_min, value);
+            m_max = std::max(m_max, value);
+        }
+
+        /** \brief Records the elapsed time of a performance meter, in nanoseconds. */
+        template<typename ClockBackendT>
+        inline void record(vcl::utils::PerfMeterT<ClockBackendT>& perf_meter) noexcept
+        {
+            const long long elapsed_ns = perf_meter.get_elapsed_ns();
+            record(elapsed_ns > 0 ? (unsigned long long)elapsed_ns : 0ull);
+        }
+
+        /** \brief Merges other histogram into this one. */
+        MyType& merge(const MyType& other) noexcept
+        {
+            for (std::size_t i = 0; i < BUCKETS_COUNT; ++i)
+                m_counts[i] += other.m_counts[i];
+            m_total_count += other.m_total_count;
+            m_total_sum += other.m_total_sum;
+            m_min = std::min(m_min, other.m_min);
+            m_max = std::max(m_max, other.m_max);
+            return *this;
+        }
+
+        /** \brief operator += (merging) */
+        inline MyType& operator+= (const MyType& other) noexcept
+        {
+            return merge(other);
+        }
+
+        /** \brief Resets this histogram to no recorded value. */
+        void reset() noexcept
+        {
+            m_counts.fill(0);
+            m_total_count = 0;
+            m_total_sum = 0;
+            m_min = ~0ull;
+            m_max = 0;
+        }
+
+
+        //---   Statistics   ------------------------------------------------
+        /** \brief Returns the count of recorded values. */
+        inline const unsigned long long count() const noexcept
+        {
+            return m_total_count;
+        }
+
+        /** \brief Returns the min recorded value, or 0 if none. */
+        inline const unsigned long long min() const noexcept
+        {
+            return m_total_count == 0 ? 0 : m_min;
+        }
+
+        /** \brief Returns the max recorded value, or 0 if none. */
+        inline const unsigned long long max() const noexcept
+        {
+            return m_max;
+        }
+
+        /** \brief Returns the mean of recorded values, or 0.0 if none. */
+        inline const double mean() const noexcept
+        {
+            return m_total_count == 0 ? 0.0 : double(m_total_sum) / double(m_total_count);
+        }
+
+        /** \brief Returns the value at percentile (in range [0.0, 100.0]).
+        * The returned value is the highest value of the bucket that contains
+        * the nearest-rank percentile, i.e. the ceil(percentile% * count)-th
+        * value, clipped to the recorded min and max values, so that at least
+        * percentile% of the recorded values are not greater.
+        * Percentile 0.0 returns the min recorded value.
+        */
+        const unsigned long long percentile(const double pc) const noexcept
+        {
+            if (m_total_count == 0)
+                return 0;
+
+            const double p = std::clamp(pc, 0.0, 100.0);
+            if (p == 0.0)
+                return m_min;
+
+            unsigned long long rank = (unsigned long long)std::ceil(p * double(m_total_count) / 100.0);
+            rank = std::clamp(rank, 1ull, m_total_count);
+
+            unsigned long long cumul = 0;
+            for (std::size_t i = 0; i < BUCKETS_COUNT; ++i) {
+                cumul += m_counts[i];
+                if (cumul >= rank)
+                    return std::clamp(bucket_highest(i), min(), m_max);
+            }
+            return m_max;
+        }
+
+        /** \brief Returns the median value. */
+        inline const unsigned long long p50() const noexcept
+        {
+            return percentile(50.0);
+        }
+
+        /** \brief Returns the 90th percentile value. */
+        inline const unsigned long long p90() const noexcept
+        {
+            return percentile(90.0);
+        }
+
+        /** \brief Returns the 99th percentile value. */
+        inline const unsigned long long p99() const noexcept
+        {
+            return percentile(99.0);
+        }
+
+        /** \brief Returns the 99.9th percentile value. */
+        inline const unsigned long long p999() const noexcept
+        {
+            return percentile(99.9);
+        }
+
+        /** \brief Returns a one line text report of this histogram, values being nanoseconds reported in microseconds. */
+        std::string report() const
+        {
+            return std::format("count={} p50={:.3f}us p90={:.3f}us p99={:.3f}us p99.9={:.3f}us max={:.3f}us",
+                               count(), p50() * 1e-3, p90() * 1e-3, p99() * 1e-3, p999() * 1e-3, max() * 1e-3);
+        }
+
+
+        //---   Buckets   ---------------------------------------------------
+        /** \brief Returns the index of the bucket of value, in O(1). */
+        static inline const std::size_t bucket_index(const unsigned long long value) noexcept
+        {
+            if (value < SUB_COUNT)
+                return std::size_t(value);
+            const unsigned int shift = (unsigned int)std::bit_width(value) - SUB_BITS;  // i.e. value >> shift in [HALF_COUNT, SUB_COUNT)
+            return SUB_COUNT + (shift - 1) * HALF_COUNT + std::size_t(value >> shift) - HALF_COUNT;
+        }
+
+        /** \brief Returns the lowest value counted in bucket index. */
+        static inline const unsigned long long bucket_lowest(const std::size_t index) noexcept
+        {
+            if (index < SUB_COUNT)
+                return index;
+            const unsigned int shift = (unsigned int)((index - SUB_COUNT) / HALF_COUNT) + 1;
+            const unsigned long long top = (index - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+            return top << shift;
+        }
+
+        /** \brief Returns the highest value counted in bucket index. */
+        static inline const unsigned long long bucket_highest(const std::size_t index) noexcept
+        {
+            if (index < SUB_COUNT)
+                return index;
+            const unsigned int shift = (unsigned int)((index - SUB_COUNT) / HALF_COUNT) + 1;
+            return bucket_lowest(index) + ((1ull << shift) - 1);
+        }
+
+
+    private:
+        std::array<unsigned long long, BUCKETS_COUNT> m_counts;  //!< the counts of values per bucket.
+        unsigned long long m_total_count;                        //!< the count of recorded values.
+        unsigned long long m_total_sum;                          //!< the sum of recorded values.
+        unsigned long long m_min;                                //!< the min recorded value.
+        unsigned long long m_max;                                //!< the max recorded value.
+    };
+
+}
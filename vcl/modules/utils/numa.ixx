@@ -0,0 +1,273 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#   include <sched.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   include <linux/mempolicy.h>
+#   if defined(SYS_mbind)
+#       define VCL_NUMA_AVAILABLE
+#   endif
+#endif
+
+export module utils.numa;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    /** \brief The index of no NUMA node. */
+    export constexpr int NO_NUMA_NODE = -1;
+
+
+    //===================================================================
+    /** \brief The class of NUMA topologies: the nodes of the machine and their CPUs.
+    *
+    * system() is detected from /sys/devices/system/node on Linux.  It gets
+    * one node with all CPUs on machines with no NUMA and on other
+    * platforms.  simulated() splits the CPUs among virtual nodes,  so that
+    * NUMA placement can be tested on single-node machines: threads are
+    * pinned on the CPUs of their virtual node,  while memory is not bound.
+    *
+    * Nodes are indexed from 0 to nodes_count() - 1, whatever their system
+    * identifiers.
+    */
+    export class NumaTopology
+    {
+    public:
+        //---   Constructors   ----------------------------------------------
+        /** \brief Returns the NUMA topology of this machine. */
+        static const NumaTopology& system()
+        {
+            static const NumaTopology topology = prvt_detect();
+            return topology;
+        }
+
+        /** \brief Returns a simulated topology of nodes_count nodes, sharing out the CPUs of this process. */
+        static NumaTopology simulated(const int nodes_count)
+        {
+            const std::vector<int> cpus = prvt_process_cpus();
+            NumaTopology topology;
+            topology.m_simulated = true;
+            topology.m_nodes_cpus.resize(std::max(1, nodes_count));
+            const std::size_t n = topology.m_nodes_cpus.size();
+            for (std::size_t node = 0; node < n; ++node) {
+                topology.m_nodes_ids.push_back(int(node));
+                // contiguous CPUs per node, CPUs being shared when fewer than nodes
+                const std::size_t first = node * cpus.size() / n;
+                const std::size_t last = std::max(first + 1, (node + 1) * cpus.size() / n);
+                for (std::size_t c = first; c < last; ++c)
+                    topology.m_nodes_cpus[node].push_back(cpus[c % cpus.size()]);
+            }
+            return topology;
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the count of nodes. */
+        inline const int nodes_count() const noexcept
+        {
+            return int(m_nodes_cpus.size());
+        }
+
+        /** \brief Returns true if this topology is simulated. */
+        inline const bool is_simulated() const noexcept
+        {
+            return m_simulated;
+        }
+
+        /** \brief Returns true if memory gets bound to nodes, i.e. on real topologies with more than one node. */
+        inline const bool binds_memory() const noexcept
+        {
+#if defined(VCL_NUMA_AVAILABLE)
+            return !m_simulated && m_nodes_cpus.size() > 1;
+#else
+            return false;
+#endif
+        }
+
+        /** \brief Returns the CPUs of node. Not checked. */
+        inline const std::vector<int>& cpus(const int node) const noexcept
+        {
+            return m_nodes_cpus[node];
+        }
+
+        /** \brief Returns the node of cpu, or NO_NUMA_NODE if unknown. The first one when shared by simulated nodes. */
+        const int node_of_cpu(const int cpu) const noexcept
+        {
+            for (std::size_t node = 0; node < m_nodes_cpus.size(); ++node)
+                if (std::find(m_nodes_cpus[node].begin(), m_nodes_cpus[node].end(), cpu) != m_nodes_cpus[node].end())
+                    return int(node);
+            return NO_NUMA_NODE;
+        }
+
+
+        //---   Placement   -------------------------------------------------
+        /** \brief Binds the pages of [data, data + bytes_count) to node. data must be page aligned.
+        * Pages must not have been touched yet. Returns true if bound, or if
+        * there is nothing to bind: simulated or single-node topologies.
+        */
+        const bool bind_memory(void* data, const std::size_t bytes_count, const int node) const noexcept
+        {
+            if (node < 0 || node >= nodes_count())
+                return false;
+            if (!binds_memory())
+                return true;
+#if defined(VCL_NUMA_AVAILABLE)
+            constexpr std::size_t MASK_BITS = 8 * sizeof(unsigned long);
+            const int node_id = m_nodes_ids[node];
+            std::vector<unsigned long> mask(std::size_t(node_id) / MASK_BITS + 1, 0);
+            mask[std::size_t(node_id) / MASK_BITS] = 1UL << (std::size_t(node_id) % MASK_BITS);
+            return syscall(SYS_mbind, data, bytes_count, MPOL_BIND, mask.data(), mask.size() * MASK_BITS + 1, 0) == 0;
+#else
+            return false;
+#endif
+        }
+
+        /** \brief Pins the calling thread on the CPUs of node. Returns false if not possible on this platform. */
+        const bool pin_current_thread(const int node) const noexcept
+        {
+            if (node < 0 || node >= nodes_count())
+                return false;
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (const int cpu : m_nodes_cpus[node])
+                CPU_SET(cpu, &set);
+            return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+            return false;
+#endif
+        }
+
+        /** \brief Returns the node the calling thread is running on, or NO_NUMA_NODE if unknown. */
+        const int current_node() const noexcept
+        {
+#if defined(__linux__)
+            const int cpu = sched_getcpu();
+            return cpu >= 0 ? node_of_cpu(cpu) : NO_NUMA_NODE;
+#else
+            return nodes_count() == 1 ? 0 : NO_NUMA_NODE;
+#endif
+        }
+
+
+    private:
+        std::vector<std::vector<int>> m_nodes_cpus;  //!< the CPUs of each node.
+        std::vector<int> m_nodes_ids;                //!< the system identifiers of nodes.
+        bool m_simulated{ false };                   //!< true if simulated.
+
+        /** \brief Detects the topology of this machine. */
+        static NumaTopology prvt_detect()
+        {
+            NumaTopology topology;
+#if defined(__linux__)
+            try {
+                std::vector<std::pair<int, std::vector<int>>> nodes;
+                for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node")) {
+                    const std::string name = entry.path().filename().string();
+                    if (!name.starts_with("node") || name.size() == 4 || !std::all_of(name.begin() + 4, name.end(), [](const char c) { return c >= '0' && c <= '9'; }))
+                        continue;
+                    std::ifstream file(entry.path() / "cpulist");
+                    std::string cpulist;
+                    std::getline(file, cpulist);
+                    std::vector<int> cpus = prvt_parse_cpulist(cpulist);
+                    if (!cpus.empty())
+                        nodes.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+                }
+                std::sort(nodes.begin(), nodes.end());
+                for (auto& [id, cpus] : nodes) {
+                    topology.m_nodes_ids.push_back(id);
+                    topology.m_nodes_cpus.push_back(std::move(cpus));
+                }
+            }
+            catch (...) {
+                topology.m_nodes_ids.clear();
+                topology.m_nodes_cpus.clear();
+            }
+#endif
+            if (topology.m_nodes_cpus.empty()) {
+                topology.m_nodes_ids.push_back(0);
+                topology.m_nodes_cpus.push_back(prvt_process_cpus());
+            }
+            return topology;
+        }
+
+        /** \brief Returns the CPUs of a Linux cpulist, e.g. "0-3,8-11". */
+        static std::vector<int> prvt_parse_cpulist(const std::string& cpulist)
+        {
+            std::vector<int> cpus;
+            std::size_t pos = 0;
+            while (pos < cpulist.size()) {
+                std::size_t end = cpulist.find(',', pos);
+                if (end == std::string::npos)
+                    end = cpulist.size();
+                const std::string range = cpulist.substr(pos, end - pos);
+                if (const std::size_t dash = range.find('-'); dash != std::string::npos) {
+                    for (int cpu = std::stoi(range.substr(0, dash)); cpu <= std::stoi(range.substr(dash + 1)); ++cpu)
+                        cpus.push_back(cpu);
+                }
+                else if (!range.empty() && range.find_first_not_of(" \n") != std::string::npos) {
+                    cpus.push_back(std::stoi(range));
+                }
+                pos = end + 1;
+            }
+            return cpus;
+        }
+
+        /** \brief Returns the CPUs this process may run on. */
+        static std::vector<int> prvt_process_cpus()
+        {
+            std::vector<int> cpus;
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                    if (CPU_ISSET(cpu, &set))
+                        cpus.push_back(cpu);
+#endif
+            if (cpus.empty())
+                for (int cpu = 0; cpu < int(std::max(1u, std::thread::hardware_concurrency())); ++cpu)
+                    cpus.push_back(cpu);
+            return cpus;
+        }
+    };
+
+}
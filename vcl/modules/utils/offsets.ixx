@@ -159,7 +159,7 @@ namespace vcl::utils {
         {}
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~OffsetsT<TScalar>()
+        virtual inline ~OffsetsT()
         {}
 
         //---  Accessors/Mutators   -----------------------------------------
@@ -29,6 +29,17 @@ module;
 #include <format>
 #include <sstream>
 #include <string>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#   define VCL_TSC_AVAILABLE
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#       include <x86intrin.h>
+#   endif
+#endif
 
 export module utils.perfmeters;
 
@@ -37,26 +48,194 @@ export module utils.perfmeters;
 namespace vcl::utils {
 
     //===================================================================
-    /** the class of time performance evaluators.
+    // Forward declarations
+    export struct SteadyClockBackend;
+    export struct TscClockBackend;
+
+    /** \brief The generic class of time performance evaluators. */
+    export template<typename ClockBackendT = SteadyClockBackend>
+    class PerfMeterT;
+
+    // Specializations
+    export using PerfMeter = PerfMeterT<SteadyClockBackend>;    //!< time performance evaluators based on std::chrono::steady_clock.
+    export using TscPerfMeter = PerfMeterT<TscClockBackend>;    //!< low overhead time performance evaluators based on the CPU time-stamp counter.
+
+
+    //===================================================================
+    /** \brief The std::chrono::steady_clock backend of performance meters.
+    * Ticks are nanoseconds.
+    */
+    struct SteadyClockBackend
+    {
+        /** \brief Returns the current ticks count, to be used when starting a measure. */
+        static inline const long long start_ticks() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /** \brief Returns the current ticks count, to be used when stopping a measure. */
+        static inline const long long stop_ticks() noexcept
+        {
+            return start_ticks();
+        }
+
+        /** \brief Returns the duration of one tick in nanoseconds. */
+        static inline const double ns_per_tick() noexcept
+        {
+            return 1.0;
+        }
+
+        /** \brief Returns true if ticks are read from the CPU time-stamp counter. */
+        static inline const bool is_tsc() noexcept
+        {
+            return false;
+        }
+    };
+
+
+    //===================================================================
+    /** \brief The CPU time-stamp counter backend of performance meters.
+    *
+    * Ticks are read with rdtsc / rdtscp,  which costs a few tens of CPU
+    * cycles rather than the steady clock system call path.  The tick
+    * duration is calibrated once against std::chrono::steady_clock on
+    * first use. When the CPU does not provide an invariant time-stamp
+    * counter - or on non-x86 platforms - ticks gracefully fall back to
+    * steady clock nanoseconds.
     */
-    export class PerfMeter
+    struct TscClockBackend
+    {
+        /** \brief Returns the current ticks count, to be used when starting a measure.
+        * lfence prevents the counter read to be executed before preceding instructions.
+        */
+        static inline const long long start_ticks() noexcept
+        {
+#if defined(VCL_TSC_AVAILABLE)
+            if (prvt_calibration().invariant) {
+                _mm_lfence();
+                const long long ticks = (long long)__rdtsc();
+                _mm_lfence();
+                return ticks;
+            }
+#endif
+            return SteadyClockBackend::start_ticks();
+        }
+
+        /** \brief Returns the current ticks count, to be used when stopping a measure.
+        * rdtscp waits for all preceding instructions to be executed before reading the counter.
+        */
+        static inline const long long stop_ticks() noexcept
+        {
+#if defined(VCL_TSC_AVAILABLE)
+            if (prvt_calibration().invariant) {
+                unsigned int aux;
+                const long long ticks = (long long)__rdtscp(&aux);
+                _mm_lfence();
+                return ticks;
+            }
+#endif
+            return SteadyClockBackend::stop_ticks();
+        }
+
+        /** \brief Returns the calibrated duration of one tick in nanoseconds. */
+        static inline const double ns_per_tick() noexcept
+        {
+            return prvt_calibration().ns_per_tick;
+        }
+
+        /** \brief Returns true if ticks are read from the CPU time-stamp counter. */
+        static inline const bool is_tsc() noexcept
+        {
+            return prvt_calibration().invariant;
+        }
+
+        /** \brief Returns true if the CPU provides an invariant time-stamp counter. */
+        static const bool has_invariant_tsc() noexcept
+        {
+#if defined(VCL_TSC_AVAILABLE)
+            unsigned int regs[4]{ 0, 0, 0, 0 };
+#   if defined(_MSC_VER)
+            __cpuid((int*)regs, 0x80000000);
+            if (regs[0] < 0x80000007)
+                return false;
+            __cpuid((int*)regs, 0x80000007);
+#   else
+            if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+                return false;
+            __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#   endif
+            return (regs[3] & (1u << 8)) != 0;  // EDX bit 8: invariant TSC
+#else
+            return false;
+#endif
+        }
+
+    private:
+        /** \brief The calibration data of the time-stamp counter. */
+        struct _Calibration
+        {
+            bool invariant{ false };
+            double ns_per_tick{ 1.0 };
+
+            /** \brief Calibrates the time-stamp counter against the steady clock over a few milliseconds. */
+            _Calibration() noexcept
+            {
+#if defined(VCL_TSC_AVAILABLE)
+                if (!has_invariant_tsc())
+                    return;
+
+                const long long ns_0 = SteadyClockBackend::start_ticks();
+                const unsigned long long tsc_0 = __rdtsc();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                const long long ns_1 = SteadyClockBackend::stop_ticks();
+                const unsigned long long tsc_1 = __rdtsc();
+
+                if (tsc_1 > tsc_0 && ns_1 > ns_0) {
+                    ns_per_tick = double(ns_1 - ns_0) / double(tsc_1 - tsc_0);
+                    invariant = true;
+                }
+#endif
+            }
+        };
+
+        /** \brief Returns the calibration data, evaluated once on first call. */
+        static inline const _Calibration& prvt_calibration() noexcept
+        {
+            static const _Calibration calibration;
+            return calibration;
+        }
+    };
+
+
+    //===================================================================
+    /** \brief The class of time performance evaluators.
+    *
+    * The clock backend is selected at compile time:  SteadyClockBackend
+    * (default) or TscClockBackend for measures of very short durations,
+    * e.g. in hot loops.
+    */
+    template<typename ClockBackendT>
+    class PerfMeterT
     {
     public:
+        using MyType = PerfMeterT<ClockBackendT>;  //!< wrapper to this class naming.
+        using ClockBackend = ClockBackendT;        //!< wrapper to the clock backend naming.
+
         /** \brief Empty constructor.
         */
-        inline PerfMeter()
-            : prvt_start(std::chrono::steady_clock::now())
+        inline PerfMeterT()
+            : prvt_start(ClockBackendT::start_ticks())
         {}
 
         /** \brief Copy constructor.
         */
-        inline PerfMeter(const PerfMeter& other)
+        inline PerfMeterT(const MyType& other)
             : prvt_start(other.prvt_start)
         {}
 
         /** \brief Move constructor.
         */
-        inline PerfMeter(PerfMeter&& other)
+        inline PerfMeterT(MyType&& other)
             : prvt_start(other.prvt_start)
         {}
 
@@ -64,7 +243,7 @@ namespace vcl::utils {
         */
         inline void start()
         {
-            prvt_start = std::chrono::steady_clock::now();
+            prvt_start = ClockBackendT::start_ticks();
         }
 
         /** \brief gets measured duration in fractional milliseconds.
@@ -78,11 +257,39 @@ namespace vcl::utils {
         */
         inline const double get_elapsed_s()
         {
-            return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - prvt_start).count();
+            return double(get_elapsed_ticks()) * ClockBackendT::ns_per_tick() * 1e-9;
+        }
+
+        /** \brief gets measured duration in integer nanoseconds.
+        */
+        inline const long long get_elapsed_ns()
+        {
+            return (long long)(double(get_elapsed_ticks()) * ClockBackendT::ns_per_tick() + 0.5);
+        }
+
+        /** \brief gets measured duration in clock backend ticks.
+        */
+        inline const long long get_elapsed_ticks()
+        {
+            return ClockBackendT::stop_ticks() - prvt_start;
+        }
+
+        /** \brief returns the current time of the steady clock in integer nanoseconds.
+        */
+        static inline const long long now_ns() noexcept
+        {
+            return SteadyClockBackend::start_ticks();
+        }
+
+        /** \brief returns the current time of the clock backend in ticks.
+        */
+        static inline const long long now_ticks() noexcept
+        {
+            return ClockBackendT::start_ticks();
         }
 
     private:
-        std::chrono::steady_clock::time_point prvt_start;
+        long long prvt_start;
     };
 
 }
@@ -181,14 +181,14 @@ namespace vcl::utils {
         {}
 
         //---  Destructor   ---------------------------------------------
-        virtual inline ~PosT<TScalar>()
+        virtual inline ~PosT()
         {}
 
         //---   Casting operator   --------------------------------------
         /** \brief cast operator to cv::Point_<_Tp> */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        inline operator cv::Point_<T>& ()
+        inline operator cv::Point_<T>() const
         {
             return cv::Point_<T>(T(this->x()), T(this->y()));
         }
@@ -203,4 +203,22 @@ namespace vcl::utils {
 
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit pos.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class PosT<char>;
+    extern template class PosT<unsigned char>;
+    extern template class PosT<short>;
+    extern template class PosT<unsigned short>;
+    extern template class PosT<long>;
+    extern template class PosT<unsigned long>;
+    extern template class PosT<long long>;
+    extern template class PosT<unsigned long long>;
+    extern template class PosT<float>;
+    extern template class PosT<double>;
+    extern template class PosT<long double>;
+#endif
+
 }
\ No newline at end of file
@@ -0,0 +1,385 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+export module utils.profilers;
+
+import utils.allocations;
+import utils.perfmeters;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    /** \brief true if profiling is compiled in, i.e. if VCL_PROFILING is defined at build time.
+    * When false, ProfileZone objects cost nothing at all.
+    */
+    export constexpr bool PROFILING_ENABLED =
+#ifdef VCL_PROFILING
+        true;
+#else
+        false;
+#endif
+
+
+    //===================================================================
+    /** \brief The merged statistics of one zone of the profiling call tree.
+    */
+    export struct ProfileZoneStats
+    {
+        std::string        path;      //!< the '/' separated names of the zones from the root down to this zone.
+        const char*        name;      //!< the static name of this zone.
+        unsigned int       depth;     //!< the depth of this zone in the call tree, 0 for top-level zones.
+        unsigned long long count;     //!< the count of times this zone has been entered.
+        unsigned long long total_ns;  //!< the total time spent in this zone, in nanoseconds.
+        unsigned long long min_ns;    //!< the min time spent once in this zone, in nanoseconds.
+        unsigned long long max_ns;    //!< the max time spent once in this zone, in nanoseconds.
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief A node of the per-thread call tree.
+    * Tree links are only accessed by the owning thread.  name and parent
+    * are set before the node gets published and are never modified later.
+    * Statistics are atomics with a single writer, the owning thread, so
+    * that collectors may read them concurrently with no lock. Durations
+    * are kept in TscClockBackend ticks and converted to nanoseconds by
+    * collectors only.
+    */
+    struct _ZoneNode
+    {
+        const char*   name = nullptr;
+        std::uint32_t parent = 0;
+        std::uint32_t first_child = 0;
+        std::uint32_t next_sibling = 0;
+
+        std::atomic<unsigned long long> count{ 0 };
+        std::atomic<unsigned long long> total_ticks{ 0 };
+        std::atomic<unsigned long long> min_ticks{ ~0ull };
+        std::atomic<unsigned long long> max_ticks{ 0 };
+    };
+
+    /** \brief The fixed-size per-thread profiling buffer.
+    * Node 0 is the root of the call tree. Zones entered while the buffer
+    * is full are not recorded, nor are the zones nested in them, so that
+    * these never get recorded under a wrong parent.
+    */
+    struct _ThreadProfile
+    {
+        static constexpr std::uint32_t MAX_NODES = 4096;
+
+        std::array<_ZoneNode, MAX_NODES> nodes;
+        std::atomic<std::uint32_t> nodes_count{ 1 };  //!< published nodes count, the root included.
+        std::atomic<unsigned long long> dropped_count{ 0 };  //!< the count of not recorded zones, single writer.
+        std::atomic<bool> exited{ false };            //!< true once the owning thread has ended.
+        std::uint32_t current = 0;                    //!< the innermost active zone of the owning thread.
+        std::uint32_t dropped_depth = 0;              //!< the nesting depth of not recorded zones, 0 if none active.
+
+        /** \brief Enters zone name as a child of the current zone. Returns its node or 0 if not recorded. */
+        inline std::uint32_t enter(const char* name) noexcept
+        {
+            if (dropped_depth > 0)
+                return drop();
+
+            // looks for an already existing child with this name
+            std::uint32_t child = nodes[current].first_child;
+            while (child != 0 && nodes[child].name != name)
+                child = nodes[child].next_sibling;
+
+            if (child == 0) {
+                // creates a new child node
+                const std::uint32_t n = nodes_count.load(std::memory_order_relaxed);
+                if (n >= MAX_NODES)
+                    return drop();
+                nodes[n].name = name;
+                nodes[n].parent = current;
+                nodes[n].next_sibling = nodes[current].first_child;
+                nodes[current].first_child = n;
+                nodes_count.store(n + 1, std::memory_order_release);
+                child = n;
+            }
+            current = child;
+            return child;
+        }
+
+        /** \brief Leaves zone node, recording its duration in clock backend ticks. */
+        inline void leave(const std::uint32_t node, const unsigned long long duration_ticks) noexcept
+        {
+            _ZoneNode& z = nodes[node];
+            z.count.store(z.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            z.total_ticks.store(z.total_ticks.load(std::memory_order_relaxed) + duration_ticks, std::memory_order_relaxed);
+            if (duration_ticks < z.min_ticks.load(std::memory_order_relaxed))
+                z.min_ticks.store(duration_ticks, std::memory_order_relaxed);
+            if (duration_ticks > z.max_ticks.load(std::memory_order_relaxed))
+                z.max_ticks.store(duration_ticks, std::memory_order_relaxed);
+            current = z.parent;
+        }
+
+        /** \brief Leaves a not recorded zone. */
+        inline void leave_dropped() noexcept
+        {
+            --dropped_depth;
+        }
+
+    private:
+        /** \brief Enters a not recorded zone. Returns 0. */
+        inline std::uint32_t drop() noexcept
+        {
+            ++dropped_depth;
+            dropped_count.store(dropped_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return 0;
+        }
+    };
+
+    /** \brief The registry of all per-thread profiling buffers.
+    * Its mutex is locked once per thread at its first zone and by
+    * collectors, never while recording zones. Buffers outlive their
+    * threads up to the next collect, which merges their zones into the
+    * retired statistics and then frees them.
+    */
+    struct _ProfilesRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<_ThreadProfile>> profiles;
+        std::map<std::string, ProfileZoneStats> retired;  //!< the merged zones of the freed buffers.
+        unsigned long long retired_dropped_count = 0;     //!< the not recorded zones of the freed buffers.
+
+        static _ProfilesRegistry& instance()
+        {
+            static _ProfilesRegistry registry;
+            return registry;
+        }
+    };
+
+    /** \brief The per-thread owner of a profiling buffer, which marks it as exited at thread end. */
+    struct _ThreadProfileOwner
+    {
+        _ThreadProfile* profile;
+
+        inline _ThreadProfileOwner()
+        {
+            vcl::utils::AllocationSite site("vcl::utils::_thread_profile()");
+            _ProfilesRegistry& registry = _ProfilesRegistry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.profiles.push_back(std::make_unique<_ThreadProfile>());
+            profile = registry.profiles.back().get();
+        }
+
+        inline ~_ThreadProfileOwner()
+        {
+            _ProfilesRegistry& registry = _ProfilesRegistry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            profile->exited.store(true, std::memory_order_release);
+        }
+    };
+
+    /** \brief Returns the profiling buffer of the calling thread. */
+    inline _ThreadProfile& _thread_profile()
+    {
+        thread_local _ThreadProfileOwner owner;
+        return *owner.profile;
+    }
+
+
+    //===================================================================
+    /** \brief The class of scoped profiling zones.
+    *
+    * Zones are RAII objects:  the time spent between their construction
+    * and their destruction is recorded in the call tree of the current
+    * thread,  as a child of the innermost active zone.  Names must have
+    * static storage duration, e.g. string literals.
+    *
+    * Recording is lock-free and allocation-free.  Time is read from the
+    * CPU time-stamp counter when available, falling back to the  steady
+    * clock otherwise (see TscClockBackend). When profiling is not compiled
+    * in (see PROFILING_ENABLED), zones cost nothing.
+    *
+    * Usage:
+    *   void decode_frame() {
+    *       vcl::utils::ProfileZone zone("decode_frame");
+    *       ...
+    *   }
+    */
+    export class ProfileZone
+    {
+    public:
+        /** \brief Constructor, enters the zone. */
+        inline explicit ProfileZone(const char* static_name) noexcept
+        {
+            if constexpr (PROFILING_ENABLED) {
+                m_node = _thread_profile().enter(static_name);
+                m_start_ticks = vcl::utils::TscClockBackend::start_ticks();
+            }
+        }
+
+        /** \brief Destructor, leaves the zone. */
+        inline ~ProfileZone() noexcept
+        {
+            if constexpr (PROFILING_ENABLED) {
+                const long long stop_ticks = vcl::utils::TscClockBackend::stop_ticks();
+                if (m_node != 0)
+                    _thread_profile().leave(m_node, (unsigned long long)(stop_ticks - m_start_ticks));
+                else
+                    _thread_profile().leave_dropped();
+            }
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator= (const ProfileZone&) = delete;
+
+    private:
+        std::uint32_t m_node = 0;   //!< the node of this zone in the thread call tree.
+        long long m_start_ticks = 0;  //!< the time this zone has been entered at, in clock backend ticks.
+    };
+
+
+    //===================================================================
+    /** \brief The collector of profiling zones.
+    */
+    export class Profiler
+    {
+    public:
+        /** \brief Merges the call trees of all threads into per-zone statistics.
+        * Zones are merged by path. Results are sorted in depth-first order
+        * of paths. May be called while other threads are recording zones.
+        */
+        static std::vector<ProfileZoneStats> collect()
+        {
+            vcl::utils::AllocationSite site("vcl::utils::Profiler::collect()");
+            std::map<std::string, ProfileZoneStats> merged;
+
+            if constexpr (PROFILING_ENABLED) {
+                _ProfilesRegistry& registry = _ProfilesRegistry::instance();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+
+                // the buffers of ended threads are merged once and for all, then freed
+                std::erase_if(registry.profiles, [&registry](const std::unique_ptr<_ThreadProfile>& profile) {
+                    if (!profile->exited.load(std::memory_order_acquire))
+                        return false;
+                    merge(*profile, registry.retired);
+                    registry.retired_dropped_count += profile->dropped_count.load(std::memory_order_relaxed);
+                    return true;
+                });
+
+                merged = registry.retired;
+                for (const auto& profile : registry.profiles)
+                    merge(*profile, merged);
+            }
+
+            std::vector<ProfileZoneStats> zones;
+            zones.reserve(merged.size());
+            for (auto& [key, stats] : merged)
+                zones.push_back(std::move(stats));
+            return zones;
+        }
+
+        /** \brief Returns the count of zones that have not been recorded because of full per-thread buffers.
+        * Zones nested in not recorded zones are not recorded either and are counted also.
+        */
+        static unsigned long long dropped_count()
+        {
+            unsigned long long count = 0;
+            if constexpr (PROFILING_ENABLED) {
+                _ProfilesRegistry& registry = _ProfilesRegistry::instance();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                count = registry.retired_dropped_count;
+                for (const auto& profile : registry.profiles)
+                    count += profile->dropped_count.load(std::memory_order_relaxed);
+            }
+            return count;
+        }
+
+        /** \brief Returns a text report of the merged call tree, one zone per line.
+        */
+        static std::string report()
+        {
+            std::string txt = std::format("{:<40s} {:>10s} {:>12s} {:>10s} {:>10s} {:>10s}\n",
+                                          "zone", "count", "total ms", "mean us", "min us", "max us");
+            for (const ProfileZoneStats& z : collect())
+                txt += std::format("{:<40s} {:>10d} {:>12.3f} {:>10.3f} {:>10.3f} {:>10.3f}\n",
+                                   std::string(2 * z.depth, ' ') + z.name,
+                                   z.count,
+                                   z.total_ns * 1e-6,
+                                   z.total_ns * 1e-3 / z.count,
+                                   z.min_ns * 1e-3,
+                                   z.max_ns * 1e-3);
+            return txt;
+        }
+
+    private:
+        /** \brief Merges the call tree of one profiling buffer into merged, keyed by '\x01' separated paths.
+        * Durations get converted from clock backend ticks to nanoseconds.
+        */
+        static void merge(const _ThreadProfile& profile, std::map<std::string, ProfileZoneStats>& merged)
+        {
+            const double ns_per_tick = vcl::utils::TscClockBackend::ns_per_tick();
+            auto to_ns = [ns_per_tick](const unsigned long long ticks) {
+                return (unsigned long long)(double(ticks) * ns_per_tick + 0.5);
+            };
+
+            const std::uint32_t n = profile.nodes_count.load(std::memory_order_acquire);
+            std::vector<std::string> keys(n);
+            std::vector<unsigned int> depths(n, 0);
+
+            for (std::uint32_t i = 1; i < n; ++i) {
+                // parents are always created before their children.
+                // Keys get '\x01' separators so that children sort right after their parent.
+                const _ZoneNode& z = profile.nodes[i];
+                keys[i] = z.parent == 0 ? std::string(z.name) : keys[z.parent] + '\x01' + z.name;
+                depths[i] = z.parent == 0 ? 0 : depths[z.parent] + 1;
+
+                const unsigned long long count = z.count.load(std::memory_order_relaxed);
+                if (count == 0)
+                    continue;
+
+                auto [it, inserted] = merged.try_emplace(keys[i], ProfileZoneStats{ "", z.name, depths[i], 0, 0, ~0ull, 0 });
+                if (inserted) {
+                    it->second.path = keys[i];
+                    std::replace(it->second.path.begin(), it->second.path.end(), '\x01', '/');
+                }
+                ProfileZoneStats& stats = it->second;
+                stats.count += count;
+                stats.total_ns += to_ns(z.total_ticks.load(std::memory_order_relaxed));
+                stats.min_ns = std::min(stats.min_ns, to_ns(z.min_ticks.load(std::memory_order_relaxed)));
+                stats.max_ns = std::max(stats.max_ns, to_ns(z.max_ticks.load(std::memory_order_relaxed)));
+            }
+        }
+    };
+
+}
@@ -0,0 +1,435 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+export module utils.timecode_arrays;
+
+import utils.allocations;
+import utils.timecodes;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    // Forward declaration
+    /** \brief The generic class of packed arrays of timecodes. */
+    export template<const unsigned long FPS_NUM, const unsigned long FPS_DEN = 1, const bool DROP_FRAME = false>
+    class TimecodeArray;
+
+    // Specializations
+    export using TimecodeArray24fps = TimecodeArray<24>;  //!< arrays of 24 frames per second timecodes (cinema)
+    export using TimecodeArray25fps = TimecodeArray<25>;  //!< arrays of 25 frames per second timecodes (TV - DVB)
+    export using TimecodeArray30fps = TimecodeArray<30>;  //!< arrays of 30 frames per second timecodes
+    export using TimecodeArray50fps = TimecodeArray<50>;  //!< arrays of 50 frames per second timecodes (TV - DVB, HFR)
+    export using TimecodeArray60fps = TimecodeArray<60>;  //!< arrays of 60 frames per second timecodes
+
+    export using TimecodeArray23_976fps = TimecodeArray<24000, 1001>;        //!< arrays of 23.976 frames per second timecodes
+    export using TimecodeArray29_97DF   = TimecodeArray<30000, 1001, true>;  //!< arrays of 29.97 frames per second drop-frame timecodes
+    export using TimecodeArray59_94DF   = TimecodeArray<60000, 1001, true>;  //!< arrays of 59.94 frames per second drop-frame timecodes
+
+
+    //===================================================================
+    /** \brief The packed HH:MM:SS:FF components of a timecode.
+    * Components of erroneous timecodes are all set to 0xff.
+    */
+    export struct TimecodeComponents
+    {
+        unsigned char hh, mm, ss, ff;
+    };
+
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief Exact division by a constant, with multiply and shift only.
+    * Exact for every dividend x < 2^BITS. This is the division by
+    * invariant integers of Granlund-Montgomery:  with L = ceil(log2(D)),
+    * S = BITS + L and M = ceil(2^S / D),  floor(x * M / 2^S) == x / D.
+    * No division instruction remains in loops,  which lets them get
+    * vectorized by compilers.
+    */
+    template<const std::uint32_t D, const unsigned int BITS = 26>
+    struct _ConstDiv
+    {
+        static_assert(D > 0, "division by zero");
+
+        static constexpr unsigned int L = [] { unsigned int l = 0; while ((1ull << l) < D) ++l; return l; }();
+        static constexpr unsigned int S = BITS + L;
+        static constexpr std::uint64_t M = ((1ull << S) + D - 1) / D;
+
+        static_assert(S < 64 && M < (1ull << (64 - BITS)), "magic multiplier overflow");
+
+        static inline std::uint32_t div(const std::uint32_t x) noexcept
+        {
+            return std::uint32_t((std::uint64_t(x) * M) >> S);
+        }
+    };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The class of packed arrays of timecodes.
+    *
+    * Only frame indexes are stored, as 32-bit unsigned integers. Bulk
+    * conversions to and from HH:MM:SS:FF components are division-free
+    * branch-free loops that get vectorized by compilers. Sorting and
+    * binary searches operate directly on the packed frame indexes.
+    */
+    template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
+    class TimecodeArray
+    {
+    public:
+        using MyType       = TimecodeArray<FPS_NUM, FPS_DEN, DROP_FRAME>;  //!< wrapper to this class naming.
+        using TimecodeType = Timecode<FPS_NUM, FPS_DEN, DROP_FRAME>;       //!< wrapper to the related Timecode class naming.
+        using IndexT       = std::uint32_t;                                //!< the packed type of frame indexes.
+
+        static constexpr IndexT ERROR_INDEX = ~IndexT(0);                  //!< the packed frame index value of erroneous timecodes.
+        static constexpr std::size_t npos = std::size_t(-1);              //!< the value returned by unsuccessful searches.
+        static constexpr std::size_t TC_CHARS_SIZE = TimecodeType::TC_CHARS_SIZE;  //!< the size of formatted timecodes, terminating '\0' included.
+
+        static_assert(TimecodeType::FRAMES_COUNT < (1ul << 26), "frame indexes must fit the exact constant divisions");
+
+
+        //---   constructors   ----------------------------------------------
+        /** \brief Empty constructor.
+        * Memory is allocated from the vcl default memory resource.
+        */
+        inline TimecodeArray()
+            : m_indexes(vcl::utils::memory_resource())
+        {}
+
+        /** \brief Empty constructor, memory being allocated from resource.
+        */
+        inline explicit TimecodeArray(std::pmr::memory_resource* resource)
+            : m_indexes(resource)
+        {}
+
+        /** \brief Constructor with count of 00:00:00:00 timecodes.
+        */
+        inline explicit TimecodeArray(const std::size_t count, std::pmr::memory_resource* resource = vcl::utils::memory_resource())
+            : m_indexes(resource)
+        {
+            resize(count);
+        }
+
+        /** \brief Constructor (const std::span<const Timecode>).
+        */
+        inline explicit TimecodeArray(const std::span<const TimecodeType> tcs, std::pmr::memory_resource* resource = vcl::utils::memory_resource())
+            : m_indexes(resource)
+        {
+            reserve(tcs.size());
+            for (const TimecodeType& tc : tcs)
+                push_back(tc);
+        }
+
+        /** \brief Copy constructor, the copy allocating from the same memory resource.
+        */
+        inline TimecodeArray(const MyType& other)
+            : m_indexes(other.m_indexes.get_allocator())
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeArray::TimecodeArray(const TimecodeArray&)");
+            m_indexes = other.m_indexes;
+        }
+
+        /** \brief Move constructor.
+        */
+        inline TimecodeArray(MyType&& other) noexcept = default;
+
+        /** \brief Copy assignment.
+        */
+        inline MyType& operator= (const MyType& other)
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeArray::operator=(const TimecodeArray&)");
+            m_indexes = other.m_indexes;
+            return *this;
+        }
+
+        /** \brief Move assignment.
+        */
+        inline MyType& operator= (MyType&& other) = default;
+
+
+        //---   Memory   ----------------------------------------------------
+        /** \brief Returns the memory resource this array allocates from. */
+        inline std::pmr::memory_resource* resource() const noexcept
+        {
+            return m_indexes.get_allocator().resource();
+        }
+
+
+        //---   Accessors / Mutators   --------------------------------------
+        /** \brief Returns the count of timecodes in this array. */
+        inline const std::size_t size() const noexcept
+        {
+            return m_indexes.size();
+        }
+
+        /** \brief Returns true if this array contains no timecode. */
+        inline const bool empty() const noexcept
+        {
+            return m_indexes.empty();
+        }
+
+        /** \brief Reserves memory for count timecodes. */
+        inline void reserve(const std::size_t count)
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeArray::reserve()");
+            m_indexes.reserve(count);
+        }
+
+        /** \brief Resizes this array, new timecodes being set to 00:00:00:00. */
+        inline void resize(const std::size_t count)
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeArray::resize()");
+            m_indexes.resize(count, IndexT(0));
+        }
+
+        /** \brief Removes all timecodes from this array. */
+        inline void clear() noexcept
+        {
+            m_indexes.clear();
+        }
+
+        /** \brief Appends a timecode to this array. */
+        inline void push_back(const TimecodeType& tc)
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeArray::push_back()");
+            m_indexes.push_back(tc.is_error() ? ERROR_INDEX : IndexT(tc.frame_index()));
+        }
+
+        /** \brief Returns the timecode at position i. */
+        inline TimecodeType operator[] (const std::size_t i) const noexcept
+        {
+            return TimecodeType::from_frame_index(m_indexes[i] == ERROR_INDEX ? TimecodeType::ERROR_INDEX : m_indexes[i]);
+        }
+
+        /** \brief Returns a reference to the packed frame index at position i. */
+        inline IndexT& index(const std::size_t i) noexcept
+        {
+            return m_indexes[i];
+        }
+
+        /** \brief Returns the packed frame index at position i. */
+        inline const IndexT index(const std::size_t i) const noexcept
+        {
+            return m_indexes[i];
+        }
+
+        /** \brief Returns a view on the packed frame indexes. */
+        inline std::span<IndexT> indexes() noexcept
+        {
+            return std::span<IndexT>(m_indexes);
+        }
+
+        /** \brief Returns a view on the packed frame indexes. */
+        inline std::span<const IndexT> indexes() const noexcept
+        {
+            return std::span<const IndexT>(m_indexes);
+        }
+
+
+        //---   Bulk conversions   ------------------------------------------
+        /** \brief Converts all timecodes to their HH:MM:SS:FF components.
+        * Converts min(size(), comps.size()) timecodes.
+        */
+        void to_components(const std::span<TimecodeComponents> comps) const noexcept
+        {
+            prvt_to_components(m_indexes.data(), std::min(size(), comps.size()), comps.data());
+        }
+
+        /** \brief Sets all timecodes from their HH:MM:SS:FF components.
+        * Sets min(size(), comps.size()) timecodes. Invalid components get
+        * erroneous timecodes. Returns the count of errors.
+        */
+        const std::size_t from_components(const std::span<const TimecodeComponents> comps) noexcept
+        {
+            const std::size_t n = std::min(size(), comps.size());
+            const TimecodeComponents* in = comps.data();
+            IndexT* idx = m_indexes.data();
+            std::size_t errors_count = 0;
+
+            for (std::size_t i = 0; i < n; ++i) {
+                const IndexT hh = in[i].hh, mm = in[i].mm, ss = in[i].ss, ff = in[i].ff;
+
+                IndexT index = hh * FRAMES_PER_HOUR + mm * FRAMES_PER_MINUTE + ss * FRAMES_PER_SECOND + ff;
+                bool ok = (hh < 100) & (mm < 60) & (ss < 60) & (ff < FRAMES_PER_SECOND);
+                if constexpr (DROP_FRAME) {
+                    const IndexT minutes = 60 * hh + mm;
+                    index -= DROPPED_FRAMES * (minutes - _ConstDiv<10>::div(minutes));
+                    ok &= !((ss == 0) & (ff < DROPPED_FRAMES) & (minutes != 10 * _ConstDiv<10>::div(minutes)));
+                }
+
+                idx[i] = ok ? index : ERROR_INDEX;
+                errors_count += !ok;
+            }
+            return errors_count;
+        }
+
+        /** \brief Formats all timecodes into fixed-size char buffers.
+        * Formats min(size(), tc_chars.size()) timecodes, as "HH:MM:SS:FF"
+        * or "HH:MM:SS;FF" for drop-frame timecodes. Erroneous timecodes are
+        * formatted as "--:--:--:--". Never allocates memory.
+        */
+        void to_chars(const std::span<std::array<char, TC_CHARS_SIZE>> tc_chars) const noexcept
+        {
+            constexpr std::size_t BLOCK_SIZE = 256;
+            TimecodeComponents comps[BLOCK_SIZE];
+
+            const std::size_t n = std::min(size(), tc_chars.size());
+            for (std::size_t start = 0; start < n; start += BLOCK_SIZE) {
+                const std::size_t count = std::min(BLOCK_SIZE, n - start);
+                prvt_to_components(m_indexes.data() + start, count, comps);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    char* buffer = tc_chars[start + i].data();
+                    const TimecodeComponents& c = comps[i];
+                    if (c.hh == 0xff) {
+                        constexpr char ERR_TXT[TC_CHARS_SIZE] = "--:--:--:--";
+                        std::copy(ERR_TXT, ERR_TXT + TC_CHARS_SIZE, buffer);
+                    }
+                    else {
+                        prvt_put_2digits(buffer + 0, c.hh);
+                        prvt_put_2digits(buffer + 3, c.mm);
+                        prvt_put_2digits(buffer + 6, c.ss);
+                        prvt_put_2digits(buffer + 9, c.ff);
+                        buffer[2] = buffer[5] = ':';
+                        buffer[8] = DROP_FRAME ? ';' : ':';
+                        buffer[11] = '\0';
+                    }
+                }
+            }
+        }
+
+
+        //---   Sorting / Searching   ---------------------------------------
+        /** \brief Sorts this array in increasing time order. Erroneous timecodes are sorted last. */
+        inline void sort() noexcept
+        {
+            std::sort(m_indexes.begin(), m_indexes.end());
+        }
+
+        /** \brief Returns true if this array is sorted in increasing time order. */
+        inline const bool is_sorted() const noexcept
+        {
+            return std::is_sorted(m_indexes.begin(), m_indexes.end());
+        }
+
+        /** \brief Returns the position of the first timecode not less than tc in this sorted array.
+        * Returns size() if no such timecode exists.
+        */
+        inline const std::size_t lower_bound(const TimecodeType& tc) const noexcept
+        {
+            return std::size_t(std::lower_bound(m_indexes.begin(), m_indexes.end(), prvt_packed(tc)) - m_indexes.begin());
+        }
+
+        /** \brief Returns the position of the first timecode greater than tc in this sorted array.
+        * Returns size() if no such timecode exists.
+        */
+        inline const std::size_t upper_bound(const TimecodeType& tc) const noexcept
+        {
+            return std::size_t(std::upper_bound(m_indexes.begin(), m_indexes.end(), prvt_packed(tc)) - m_indexes.begin());
+        }
+
+        /** \brief Returns the position of a timecode equal to tc in this sorted array, or npos. */
+        inline const std::size_t find(const TimecodeType& tc) const noexcept
+        {
+            const std::size_t pos = lower_bound(tc);
+            return (pos < size() && m_indexes[pos] == prvt_packed(tc)) ? pos : npos;
+        }
+
+
+    private:
+        static constexpr IndexT FRAMES_PER_SECOND      = IndexT(TimecodeType::FRAMES_PER_SECOND);
+        static constexpr IndexT FRAMES_PER_MINUTE      = IndexT(TimecodeType::FRAMES_PER_MINUTE);
+        static constexpr IndexT FRAMES_PER_HOUR        = IndexT(TimecodeType::FRAMES_PER_HOUR);
+        static constexpr IndexT FRAMES_PER_10_MINUTES  = IndexT(TimecodeType::FRAMES_PER_10_MINUTES);
+        static constexpr IndexT FRAMES_PER_DROP_MINUTE = IndexT(TimecodeType::FRAMES_PER_DROP_MINUTE);
+        static constexpr IndexT DROPPED_FRAMES         = IndexT(TimecodeType::DROPPED_FRAMES);
+
+        std::pmr::vector<IndexT> m_indexes;  //!< the packed frame indexes of this array.
+
+
+        /** \brief Bulk conversion of n packed frame indexes to components.
+        * Division-free and branch-free loop body.
+        */
+        static void prvt_to_components(const IndexT* idx, const std::size_t n, TimecodeComponents* out) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i) {
+                const IndexT index = idx[i];
+                const IndexT number = prvt_tc_number(index);
+
+                const IndexT hh  = _ConstDiv<FRAMES_PER_HOUR>::div(number);
+                const IndexT rem = number - hh * FRAMES_PER_HOUR;
+                const IndexT mm  = _ConstDiv<FRAMES_PER_MINUTE>::div(rem);
+                const IndexT rms = rem - mm * FRAMES_PER_MINUTE;
+                const IndexT ss  = _ConstDiv<FRAMES_PER_SECOND>::div(rms);
+                const IndexT ff  = rms - ss * FRAMES_PER_SECOND;
+
+                const IndexT err_mask = IndexT(0) - IndexT(index == ERROR_INDEX);  // i.e. all bits set on error
+                out[i].hh = (unsigned char)(hh | err_mask);
+                out[i].mm = (unsigned char)(mm | err_mask);
+                out[i].ss = (unsigned char)(ss | err_mask);
+                out[i].ff = (unsigned char)(ff | err_mask);
+            }
+        }
+
+        /** \brief Returns the timecode number of a frame index, i.e. with dropped frame numbers added.
+        * Branch-free closed form of Timecode drop-frame counting.
+        */
+        static inline const IndexT prvt_tc_number(const IndexT index) noexcept
+        {
+            if constexpr (DROP_FRAME) {
+                const IndexT tens  = _ConstDiv<FRAMES_PER_10_MINUTES>::div(index);
+                const IndexT rem   = index - tens * FRAMES_PER_10_MINUTES;
+                const IndexT drops = _ConstDiv<FRAMES_PER_DROP_MINUTE>::div(std::max(rem, DROPPED_FRAMES) - DROPPED_FRAMES);
+                return index + DROPPED_FRAMES * (9 * tens + drops);
+            }
+            else
+                return index;
+        }
+
+        /** \brief Returns the packed frame index of a timecode. */
+        static inline const IndexT prvt_packed(const TimecodeType& tc) noexcept
+        {
+            return tc.is_error() ? ERROR_INDEX : IndexT(tc.frame_index());
+        }
+
+        /** \brief Writes the two decimal digits of value (< 100) into buffer. */
+        static inline void prvt_put_2digits(char* buffer, const unsigned int value) noexcept
+        {
+            buffer[0] = char('0' + value / 10);
+            buffer[1] = char('0' + value % 10);
+        }
+    };
+
+}
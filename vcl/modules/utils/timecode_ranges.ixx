@@ -0,0 +1,480 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+export module utils.timecode_ranges;
+
+import utils.allocations;
+import utils.timecodes;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //===================================================================
+    // Forward declarations
+    /** \brief The generic class of timecode ranges. */
+    export template<const unsigned long FPS_NUM, const unsigned long FPS_DEN = 1, const bool DROP_FRAME = false>
+    class TimecodeRange;
+
+    /** \brief The generic class of sorted indexes of timecode ranges. */
+    export template<const unsigned long FPS_NUM, const unsigned long FPS_DEN = 1, const bool DROP_FRAME = false>
+    class TimecodeRangeIndex;
+
+    // Specializations
+    export using TimecodeRange24fps = TimecodeRange<24>;  //!< ranges of 24 frames per second timecodes (cinema)
+    export using TimecodeRange25fps = TimecodeRange<25>;  //!< ranges of 25 frames per second timecodes (TV - DVB)
+    export using TimecodeRange30fps = TimecodeRange<30>;  //!< ranges of 30 frames per second timecodes
+    export using TimecodeRange50fps = TimecodeRange<50>;  //!< ranges of 50 frames per second timecodes (TV - DVB, HFR)
+    export using TimecodeRange60fps = TimecodeRange<60>;  //!< ranges of 60 frames per second timecodes
+
+    export using TimecodeRange23_976fps = TimecodeRange<24000, 1001>;        //!< ranges of 23.976 frames per second timecodes
+    export using TimecodeRange29_97DF   = TimecodeRange<30000, 1001, true>;  //!< ranges of 29.97 frames per second drop-frame timecodes
+    export using TimecodeRange59_94DF   = TimecodeRange<60000, 1001, true>;  //!< ranges of 59.94 frames per second drop-frame timecodes
+
+    export using TimecodeRangeIndex24fps = TimecodeRangeIndex<24>;  //!< indexes of 24 frames per second timecode ranges (cinema)
+    export using TimecodeRangeIndex25fps = TimecodeRangeIndex<25>;  //!< indexes of 25 frames per second timecode ranges (TV - DVB)
+    export using TimecodeRangeIndex30fps = TimecodeRangeIndex<30>;  //!< indexes of 30 frames per second timecode ranges
+    export using TimecodeRangeIndex50fps = TimecodeRangeIndex<50>;  //!< indexes of 50 frames per second timecode ranges (TV - DVB, HFR)
+    export using TimecodeRangeIndex60fps = TimecodeRangeIndex<60>;  //!< indexes of 60 frames per second timecode ranges
+
+    export using TimecodeRangeIndex23_976fps = TimecodeRangeIndex<24000, 1001>;        //!< indexes of 23.976 frames per second timecode ranges
+    export using TimecodeRangeIndex29_97DF   = TimecodeRangeIndex<30000, 1001, true>;  //!< indexes of 29.97 frames per second drop-frame timecode ranges
+    export using TimecodeRangeIndex59_94DF   = TimecodeRangeIndex<60000, 1001, true>;  //!< indexes of 59.94 frames per second drop-frame timecode ranges
+
+
+    // not to be used out of this module scope
+    enum _TRErrCode : unsigned char { TR001 = 0, TR002, _TR_ERR_COUNT };
+
+    constexpr std::array<const char*, _TR_ERR_COUNT> _TR_ERR_TXT{
+        "TR001: invalid timecode passed as TimecodeRange constructor argument",
+        "TR002: start of range passed after its end, or end past the last frame, as TimecodeRange constructor arguments",
+    };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The class of timecode ranges.
+    *
+    * Ranges are half-open intervals [start, end) of frame indexes, i.e.
+    * the end frame is not part of the range.  All operations on ranges
+    * are exact integer operations.
+    */
+    template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
+    class TimecodeRange
+    {
+    public:
+        using MyType       = TimecodeRange<FPS_NUM, FPS_DEN, DROP_FRAME>;  //!< wrapper to this class naming.
+        using TimecodeType = Timecode<FPS_NUM, FPS_DEN, DROP_FRAME>;       //!< wrapper to the related Timecode class naming.
+        using FrameIndex   = typename TimecodeType::FrameIndex;            //!< the internal type for frames index.
+
+
+        //---   constructors   ----------------------------------------------
+        /** \brief Empty constructor (empty range at 00:00:00:00).
+        */
+        inline TimecodeRange() noexcept
+            : m_start(0), m_end(0)
+        {}
+
+        /** \brief Constructor with start and end timecodes.
+        * The end timecode is excluded from the range.
+        */
+        inline TimecodeRange(const TimecodeType& start, const TimecodeType& end) noexcept(false)
+            : m_start(start.frame_index()), m_end(end.frame_index())
+        {
+            if (start.is_error() || end.is_error())
+                throw std::invalid_argument(_TR_ERR_TXT[TR001]);
+            if (m_start > m_end)
+                throw std::invalid_argument(_TR_ERR_TXT[TR002]);
+        }
+
+        /** \brief Constructor with start timecode and duration in frames.
+        * The range may end with the very last frame of hour 99, but not
+        * later.
+        */
+        inline TimecodeRange(const TimecodeType& start, const FrameIndex frames_count) noexcept(false)
+            : m_start(start.frame_index()), m_end(start.frame_index() + frames_count)
+        {
+            if (start.is_error())
+                throw std::invalid_argument(_TR_ERR_TXT[TR001]);
+            // checked on the duration, since the end index may wrap around
+            if (frames_count > TimecodeType::FRAMES_COUNT - m_start)
+                throw std::invalid_argument(_TR_ERR_TXT[TR002]);
+        }
+
+        /** \brief Returns a new range from start and end frame indexes.
+        * The end frame index is excluded from the range. Indexes are
+        * swapped if needed.
+        */
+        static inline MyType from_frame_indexes(const FrameIndex start, const FrameIndex end) noexcept
+        {
+            MyType r;
+            r.m_start = std::min(start, end);
+            r.m_end   = std::max(start, end);
+            return r;
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the first timecode of this range. */
+        inline TimecodeType start() const noexcept
+        {
+            return TimecodeType::from_frame_index(m_start);
+        }
+
+        /** \brief Returns the timecode that immediately follows this range.
+        * Notice: this is an erroneous timecode if the range ends with the
+        * very last frame of hour 99.
+        */
+        inline TimecodeType end() const noexcept
+        {
+            return TimecodeType::from_frame_index(m_end);
+        }
+
+        /** \brief Returns the frame index of the first frame of this range. */
+        inline const FrameIndex start_index() const noexcept
+        {
+            return m_start;
+        }
+
+        /** \brief Returns the frame index that immediately follows this range. */
+        inline const FrameIndex end_index() const noexcept
+        {
+            return m_end;
+        }
+
+        /** \brief Returns the count of frames in this range. */
+        inline const FrameIndex duration() const noexcept
+        {
+            return m_end - m_start;
+        }
+
+        /** \brief Returns true if this range contains no frame. */
+        inline const bool empty() const noexcept
+        {
+            return m_end == m_start;
+        }
+
+
+        //---   Containment / Intersection   --------------------------------
+        /** \brief Returns true if the frame at index is contained in this range. */
+        inline const bool contains(const FrameIndex index) const noexcept
+        {
+            return m_start <= index && index < m_end;
+        }
+
+        /** \brief Returns true if timecode tc is contained in this range. */
+        inline const bool contains(const TimecodeType& tc) const noexcept
+        {
+            return !tc.is_error() && contains(tc.frame_index());
+        }
+
+        /** \brief Returns true if other range is fully contained in this range. */
+        inline const bool contains(const MyType& other) const noexcept
+        {
+            return m_start <= other.m_start && other.m_end <= m_end;
+        }
+
+        /** \brief Returns true if this range and other share at least one frame. */
+        inline const bool overlaps(const MyType& other) const noexcept
+        {
+            return m_start < other.m_end && other.m_start < m_end;
+        }
+
+        /** \brief Returns the intersection of this range and other, which may be empty. */
+        inline MyType intersection(const MyType& other) const noexcept
+        {
+            const FrameIndex start = std::max(m_start, other.m_start);
+            const FrameIndex end   = std::min(m_end, other.m_end);
+            return from_frame_indexes(start, std::max(start, end));
+        }
+
+
+        //---   Comparisons   -----------------------------------------------
+        /** \brief operator == */
+        inline const bool operator== (const MyType& other) const noexcept
+        {
+            return m_start == other.m_start && m_end == other.m_end;
+        }
+
+        /** \brief operator != */
+        inline const bool operator!= (const MyType& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+
+    private:
+        FrameIndex m_start;  //!< the frame index of the first frame of this range.
+        FrameIndex m_end;    //!< the frame index immediately following this range.
+    };
+
+
+    //-----------------------------------------------------------------------
+    /** \brief The class of sorted indexes of timecode ranges.
+    *
+    * Answers "what is active at frame N" and "what overlaps [a, b)"  in
+    * O(log n + k) for k results. Ranges are sorted by start and stored
+    * in one contiguous array that embeds an implicit augmented binary
+    * tree: the node at position i has level l if the l lowest bits of i
+    * are set and bit l is cleared; each node keeps the max end of its
+    * subtree. Building is O(n log n).  Ranges are identified by their
+    * position in the sequence passed at build time.
+    */
+    template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
+    class TimecodeRangeIndex
+    {
+    public:
+        using MyType       = TimecodeRangeIndex<FPS_NUM, FPS_DEN, DROP_FRAME>;  //!< wrapper to this class naming.
+        using RangeType    = TimecodeRange<FPS_NUM, FPS_DEN, DROP_FRAME>;       //!< wrapper to the related TimecodeRange class naming.
+        using TimecodeType = typename RangeType::TimecodeType;                  //!< wrapper to the related Timecode class naming.
+        using FrameIndex   = typename RangeType::FrameIndex;                    //!< the internal type for frames index.
+
+
+        //---   constructors   ----------------------------------------------
+        /** \brief Empty constructor.
+        * Memory is allocated from the vcl default memory resource.
+        */
+        inline TimecodeRangeIndex()
+            : m_nodes(vcl::utils::memory_resource())
+        {}
+
+        /** \brief Empty constructor, memory being allocated from resource.
+        */
+        inline explicit TimecodeRangeIndex(std::pmr::memory_resource* resource)
+            : m_nodes(resource)
+        {}
+
+        /** \brief Constructor (const std::span<const RangeType>).
+        */
+        inline explicit TimecodeRangeIndex(const std::span<const RangeType> ranges, std::pmr::memory_resource* resource = vcl::utils::memory_resource())
+            : m_nodes(resource)
+        {
+            build(ranges);
+        }
+
+        /** \brief Copy constructor, the copy allocating from the same memory resource.
+        */
+        inline TimecodeRangeIndex(const MyType& other)
+            : m_nodes(other.m_nodes.get_allocator())
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeRangeIndex::TimecodeRangeIndex(const TimecodeRangeIndex&)");
+            m_nodes = other.m_nodes;
+        }
+
+        /** \brief Move constructor.
+        */
+        inline TimecodeRangeIndex(MyType&& other) noexcept = default;
+
+        /** \brief Copy assignment.
+        */
+        inline MyType& operator= (const MyType& other)
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeRangeIndex::operator=(const TimecodeRangeIndex&)");
+            m_nodes = other.m_nodes;
+            return *this;
+        }
+
+        /** \brief Move assignment.
+        */
+        inline MyType& operator= (MyType&& other) = default;
+
+
+        //---   Building   --------------------------------------------------
+        /** \brief Bulk (re)building of this index, in O(n log n).
+        * Ranges are identified by their position in ranges.
+        */
+        void build(const std::span<const RangeType> ranges)
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeRangeIndex::build()");
+            m_nodes.resize(ranges.size());
+            for (std::size_t i = 0; i < ranges.size(); ++i)
+                m_nodes[i] = _Node{ ranges[i].start_index(), ranges[i].end_index(), ranges[i].end_index(), i };
+
+            std::sort(m_nodes.begin(), m_nodes.end(),
+                      [](const _Node& a, const _Node& b) { return a.start < b.start; });
+            prvt_augment();
+        }
+
+        /** \brief Returns the count of indexed ranges. */
+        inline const std::size_t size() const noexcept
+        {
+            return m_nodes.size();
+        }
+
+        /** \brief Returns true if no range is indexed. */
+        inline const bool empty() const noexcept
+        {
+            return m_nodes.empty();
+        }
+
+
+        //---   Queries   ---------------------------------------------------
+        /** \brief Calls fn(id, range) for each indexed range that overlaps range.
+        */
+        template<typename Fn>
+        void for_each_overlap(const RangeType& range, Fn&& fn) const
+        {
+            prvt_query(range.start_index(), range.end_index(), fn);
+        }
+
+        /** \brief Appends to ids the identifiers of the indexed ranges that overlap range.
+        * Returns the count of appended identifiers.
+        */
+        std::size_t overlapping(const RangeType& range, std::vector<std::size_t>& ids) const
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TimecodeRangeIndex::overlapping()");
+            const std::size_t count = ids.size();
+            prvt_query(range.start_index(), range.end_index(),
+                       [&ids](const std::size_t id, const RangeType&) { ids.push_back(id); });
+            return ids.size() - count;
+        }
+
+        /** \brief Appends to ids the identifiers of the indexed ranges that contain the frame at index.
+        * Returns the count of appended identifiers.
+        */
+        std::size_t active_at(const FrameIndex index, std::vector<std::size_t>& ids) const
+        {
+            return overlapping(RangeType::from_frame_indexes(index, index + 1), ids);
+        }
+
+        /** \brief Appends to ids the identifiers of the indexed ranges that contain timecode tc.
+        * Returns the count of appended identifiers.
+        */
+        std::size_t active_at(const TimecodeType& tc, std::vector<std::size_t>& ids) const
+        {
+            return tc.is_error() ? 0 : active_at(tc.frame_index(), ids);
+        }
+
+
+    private:
+        /** \brief The nodes of the implicit tree. */
+        struct _Node
+        {
+            FrameIndex  start;    //!< the start of the indexed range.
+            FrameIndex  end;      //!< the end of the indexed range.
+            FrameIndex  max_end;  //!< the max end of the ranges in the subtree of this node.
+            std::size_t id;       //!< the identifier of the indexed range.
+        };
+
+        /** \brief A pending subtree visit in queries. */
+        struct _Visit
+        {
+            int         level;  //!< the level of the subtree root.
+            std::size_t pos;    //!< the position of the subtree root.
+            bool        right;  //!< true once the left subtree has been pushed.
+        };
+
+        static constexpr int SCAN_LEVEL = 3;  //!< subtrees at this level or below are linearly scanned.
+
+        std::pmr::vector<_Node> m_nodes;  //!< the sorted nodes of the implicit tree.
+        int m_max_level = -1;        //!< the level of the root of the implicit tree.
+
+
+        /** \brief Evaluates max_end in every node, in O(n).
+        * Positions past the end of the array are virtual nodes: their max
+        * end is the one of the last real subtree, tracked while climbing.
+        */
+        void prvt_augment() noexcept
+        {
+            const std::size_t n = m_nodes.size();
+            if (n == 0) {
+                m_max_level = -1;
+                return;
+            }
+
+            std::size_t last_i = 0;
+            FrameIndex last = 0;
+            for (std::size_t i = 0; i < n; i += 2) {
+                last_i = i;
+                last = m_nodes[i].max_end = m_nodes[i].end;
+            }
+
+            int k = 1;
+            for (; (std::size_t(1) << k) <= n; ++k) {
+                const std::size_t x = std::size_t(1) << (k - 1);
+                const std::size_t i0 = (x << 1) - 1;
+                const std::size_t step = x << 2;
+                for (std::size_t i = i0; i < n; i += step) {
+                    const FrameIndex el = m_nodes[i - x].max_end;
+                    const FrameIndex er = i + x < n ? m_nodes[i + x].max_end : last;
+                    m_nodes[i].max_end = std::max({ m_nodes[i].end, el, er });
+                }
+                last_i = ((last_i >> k) & 1) ? last_i - x : last_i + x;
+                if (last_i < n && m_nodes[last_i].max_end > last)
+                    last = m_nodes[last_i].max_end;
+            }
+            m_max_level = k - 1;
+        }
+
+        /** \brief Calls fn(id, range) for each node that overlaps [start, end).
+        */
+        template<typename Fn>
+        void prvt_query(const FrameIndex start, const FrameIndex end, Fn&& fn) const
+        {
+            if (m_max_level < 0 || start >= end)
+                return;
+
+            const std::size_t n = m_nodes.size();
+            _Visit stack[64];
+            int top = 0;
+            stack[top++] = _Visit{ m_max_level, (std::size_t(1) << m_max_level) - 1, false };
+
+            while (top > 0) {
+                const _Visit v = stack[--top];
+                if (v.level <= SCAN_LEVEL) {
+                    // small subtree: linear scan
+                    const std::size_t i0 = v.pos >> v.level << v.level;
+                    const std::size_t i1 = std::min(i0 + (std::size_t(1) << (v.level + 1)) - 1, n);
+                    for (std::size_t i = i0; i < i1 && m_nodes[i].start < end; ++i)
+                        if (start < m_nodes[i].end)
+                            fn(m_nodes[i].id, RangeType::from_frame_indexes(m_nodes[i].start, m_nodes[i].end));
+                }
+                else if (!v.right) {
+                    // first visit: the left subtree is pushed over this node
+                    const std::size_t left = v.pos - (std::size_t(1) << (v.level - 1));
+                    stack[top++] = _Visit{ v.level, v.pos, true };
+                    if (left >= n || m_nodes[left].max_end > start)
+                        stack[top++] = _Visit{ v.level - 1, left, false };
+                }
+                else if (v.pos < n && m_nodes[v.pos].start < end) {
+                    // second visit: this node, then its right subtree
+                    if (start < m_nodes[v.pos].end)
+                        fn(m_nodes[v.pos].id, RangeType::from_frame_indexes(m_nodes[v.pos].start, m_nodes[v.pos].end));
+                    stack[top++] = _Visit{ v.level - 1, v.pos + (std::size_t(1) << (v.level - 1)), false };
+                }
+            }
+        }
+    };
+
+}
@@ -25,15 +25,18 @@ SOFTWARE.
 //===========================================================================
 module;
 
-#include <format>
-#include <map>
-#include <sstream>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 export module utils.timecodes;
 
+import utils.allocations;
 import utils.ranges;
 
 
@@ -42,135 +45,300 @@ namespace vcl::utils {
 
     //===================================================================
     // Forward declaration
-    export template<const unsigned short FPS> class Timecode;
+    /** \brief The generic class of timecodes.
+    * Frame rates are rational values FPS_NUM / FPS_DEN frames per second.
+    * DROP_FRAME gets SMPTE drop-frame counting for 29.97 and 59.94 fps.
+    */
+    export template<const unsigned long FPS_NUM, const unsigned long FPS_DEN = 1, const bool DROP_FRAME = false>
+    class Timecode;
 
     // Specializations
     export using Timecode24fps = Timecode<24>; //!< 24 frames per second timecode (cinema)
     export using Timecode25fps = Timecode<25>; //!< 25 frames per second timecode (TV - DVB)
-    export using Timecode30fps = Timecode<30>; //!< ~30 frames per second timecode (TV - ATSC/ISDB)
+    export using Timecode30fps = Timecode<30>; //!< 30 frames per second timecode
+    export using Timecode50fps = Timecode<50>; //!< 50 frames per second timecode (TV - DVB, HFR)
+    export using Timecode60fps = Timecode<60>; //!< 60 frames per second timecode
+
+    export using Timecode23_976fps = Timecode<24000, 1001>; //!< 23.976 frames per second timecode (cinema on NTSC TV)
+    export using Timecode29_97fps  = Timecode<30000, 1001>; //!< 29.97 frames per second timecode, non drop-frame (TV - ATSC/ISDB)
+    export using Timecode59_94fps  = Timecode<60000, 1001>; //!< 59.94 frames per second timecode, non drop-frame (TV - ATSC/ISDB, HFR)
+
+    export using Timecode29_97DF = Timecode<30000, 1001, true>; //!< 29.97 frames per second timecode, SMPTE drop-frame (TV - ATSC/ISDB)
+    export using Timecode59_94DF = Timecode<60000, 1001, true>; //!< 59.94 frames per second timecode, SMPTE drop-frame (TV - ATSC/ISDB, HFR)
 
         
     // not to be used out of this module scope
-    std::map<std::string, std::string> _TC_ERR_TXT = {
-        {"TC001", "too big value for Timecode constructor argument"},
-        {"TC002", "invalid value for Timecode constructor arguments"},
-        {"TC003", "invalid timecode value passed as Timecode constructor argument"},
-        {"TC004", "invalid c_string content passed as Timecode constructor argument"},
+    // Notice: constant table indexed by error codes, i.e. lock-free and
+    // allocation-free lookups, and safe to use from concurrent threads.
+    enum _TCErrCode : unsigned char { TC001 = 0, TC002, TC003, TC004, _TC_ERR_COUNT };
+
+    constexpr std::array<const char*, _TC_ERR_COUNT> _TC_ERR_TXT{
+        "TC001: too big value for Timecode constructor argument",
+        "TC002: invalid value for Timecode constructor arguments",
+        "TC003: invalid timecode value passed as Timecode constructor argument",
+        "TC004: invalid c_string content passed as Timecode constructor argument",
     };
 
 
     //-----------------------------------------------------------------------
     /** \brief The class of timecodes.
+    *
+    * Notice: timecodes are internally stored as a single frame index. The
+    *   HH:MM:SS:FF components are evaluated on demand only. This way, all
+    *   comparisons and arithmetic operations - even between timecodes with
+    *   different frame rates - are exact integer operations.
+    *
+    * Notice: with rational frame rates, e.g. 30000/1001, the HH:MM:SS:FF
+    *   components count frames at the nominal integer rate, e.g. 30 fps.
+    *   With drop-frame counting,  frame numbers 0 and 1 (0 to 3 at 59.94
+    *   fps)  are skipped at the start of every minute but every tenth one.
+    *   Drop-frame timecodes get ';' as their frames separator.
     */
-    template<const unsigned short FPS>
+    template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
     class Timecode
     {
     public:
 
-        using MyType     = Timecode<FPS>;   //<! wrapper to this class naming.
-        using CompT      = unsigned char;   //!< the internal type of timecode components.
-        using FrameTime  = float        ;   //!< the internal type for fractional seconds time related to timecodes.
-        using FrameIndex = unsigned long;   //!< the internal type for frames index.
+        using MyType     = Timecode<FPS_NUM, FPS_DEN, DROP_FRAME>;  //<! wrapper to this class naming.
+        using CompT      = unsigned char;                           //!< the internal type of timecode components.
+        using FrameTime  = double       ;                           //!< the internal type for fractional seconds time related to timecodes.
+        using FrameIndex = unsigned long;                           //!< the internal type for frames index.
+
+        static constexpr unsigned long NOMINAL_FPS = (FPS_NUM + FPS_DEN - 1) / FPS_DEN;  //!< the integer frame rate of timecode components, e.g. 30 for 29.97 fps.
+        static constexpr FrameIndex DROPPED_FRAMES = DROP_FRAME ? NOMINAL_FPS / 15 : 0;  //!< count of dropped frame numbers per dropping minute.
+
+        static constexpr FrameIndex FRAMES_PER_SECOND = FrameIndex(NOMINAL_FPS);     //!< frames count per second of timecode components.
+        static constexpr FrameIndex FRAMES_PER_MINUTE = 60 * FRAMES_PER_SECOND;      //!< frames count per minute of timecode components.
+        static constexpr FrameIndex FRAMES_PER_HOUR   = 60 * FRAMES_PER_MINUTE;      //!< frames count per hour of timecode components.
+
+        static constexpr FrameIndex FRAMES_PER_DROP_MINUTE = FRAMES_PER_MINUTE - DROPPED_FRAMES;                 //!< actual frames count of dropping minutes.
+        static constexpr FrameIndex FRAMES_PER_10_MINUTES  = 10 * FRAMES_PER_MINUTE - 9 * DROPPED_FRAMES;        //!< actual frames count per 10 minutes.
 
-        CompT hh, mm, ss, ff;        //!< the four components of every timecode HH:MM:SS:FF.
-        bool b_error;                //!< error status of this timecode.
+        static constexpr FrameIndex FRAMES_COUNT = 600 * FRAMES_PER_10_MINUTES;  //!< count of valid frame indexes, i.e. from 00:00:00:00 up to the last frame of hour 99.
+        static constexpr FrameIndex ERROR_INDEX  = FrameIndex(-1);               //!< the frame index value of erroneous timecodes.
+
+        static_assert(FPS_NUM > 0 && FPS_DEN > 0, "Timecode frame rates must be strictly positive");
+        static_assert(NOMINAL_FPS <= 255, "Timecode nominal frame rates must be in range [1, 255]");
+        static_assert(!DROP_FRAME || (NOMINAL_FPS % 30 == 0 && FPS_NUM % FPS_DEN != 0),
+                      "drop-frame Timecode needs a fractional NTSC-like frame rate, e.g. 30000/1001 or 60000/1001");
 
 
         //---   constructors   ----------------------------------------------
         /** \brief Empty constructor.
         */
-        inline Timecode<FPS>()
-            : hh(0), mm(0), ss(0), ff(0), b_error(false)
+        inline Timecode() noexcept
+            : m_index(0)
         {}
 
-        /** \brief Constructor with a single value.
+        /** \brief Constructor with a single value (seconds).
         */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        inline Timecode<FPS>(const T value) noexcept(false)
-            : hh(0), mm(0), ss(0), ff(0), b_error(false)
+        inline Timecode(const T value) noexcept(false)
+            : m_index(0)
         {
-            prvt_set(Timecode::FrameTime(value));
-            if (b_error)
-                throw std::invalid_argument(_TC_ERR_TXT["TC001"]);
+            prvt_set_seconds(value);
+            if (is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC001]);
         }
 
         /** \brief Constructor with four filling values.
         */
-        inline Timecode<FPS>(const CompT hr, const CompT mn, const CompT sc, const CompT fr) noexcept(false)
-            : hh(hr), mm(mn), ss(sc), ff(fr), b_error(false)
+        inline Timecode(const CompT hr, const CompT mn, const CompT sc, const CompT fr) noexcept(false)
+            : m_index(0)
         {
-            if (b_error)
-                throw std::invalid_argument(_TC_ERR_TXT["TC002"]);
+            prvt_set(hr, mn, sc, fr);
+            if (is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC002]);
         }
 
         /** \brief Copy constructor.
         */
-        template<const unsigned short F>
-        inline Timecode<FPS>(const vcl::utils::Timecode<F>& other) noexcept(false)
-            : hh(0), mm(0), ss(0), ff(0), b_error(other.b_error)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline Timecode(const vcl::utils::Timecode<N, D, DF>& other) noexcept(false)
+            : m_index(0)
         {
-            if (b_error)
-                throw std::invalid_argument(_TC_ERR_TXT["TC003"]);
+            if (other.is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC003]);
             else
                 prvt_set(other);
         }
 
         /** \brief Move constructor.
         */
-        template<const unsigned short F>
-        inline Timecode<FPS>(vcl::utils::Timecode<F>&& other) noexcept(false)
-            : hh(0), mm(0), ss(0), ff(0), b_error(other.b_error)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline Timecode(vcl::utils::Timecode<N, D, DF>&& other) noexcept(false)
+            : m_index(0)
         {
-            if (b_error)
-                throw std::invalid_argument(_TC_ERR_TXT["TC003"]);
+            if (other.is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC003]);
             else
                 prvt_set(other);
         }
 
+        /** \brief Returns a new timecode set at the specified frame index.
+        * The returned timecode is in error state if index is too big.
+        */
+        static inline MyType from_frame_index(const FrameIndex index) noexcept
+        {
+            MyType tc;
+            if (index >= FRAMES_COUNT)
+                tc.prvt_set_error();
+            else
+                tc.m_index = index;
+            return tc;
+        }
+
         /** \brief Constructor from char*.
         */
-        inline Timecode<FPS>(const char* tc_chr) noexcept(false)
-            : hh(0), mm(0), ss(0), ff(0), b_error(false)
+        inline Timecode(const char* tc_chr) noexcept(false)
+            : m_index(0)
         {
-            prvt_set(std::string(tc_chr));
-            if (b_error)
-                throw std::invalid_argument(_TC_ERR_TXT["TC004"]);
+            prvt_set(std::string_view(tc_chr));
+            if (is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC004]);
         }
 
         /** \brief Constructor from string.
         */
-        inline Timecode<FPS>(const std::string& tc_str) noexcept(false)
-            : hh(0), mm(0), ss(0), ff(0), b_error(false)
+        inline Timecode(const std::string& tc_str) noexcept(false)
+            : m_index(0)
+        {
+            prvt_set(std::string_view(tc_str));
+            if (is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC003]);
+        }
+
+        /** \brief Constructor from string view.
+        */
+        inline Timecode(const std::string_view tc_str) noexcept(false)
+            : m_index(0)
         {
             prvt_set(tc_str);
-            if (b_error)
-                throw std::invalid_argument(_TC_ERR_TXT["TC003"]);
+            if (is_error())
+                throw std::invalid_argument(_TC_ERR_TXT[TC003]);
+        }
+
+
+        //---   Accessors   -------------------------------------------------
+        /** \brief Returns the hours component of this timecode. */
+        inline const CompT hh() const noexcept
+        {
+            return CompT(prvt_tc_number() / FRAMES_PER_HOUR);
+        }
+
+        /** \brief Returns the minutes component of this timecode. */
+        inline const CompT mm() const noexcept
+        {
+            return CompT(prvt_tc_number() / FRAMES_PER_MINUTE % 60);
+        }
+
+        /** \brief Returns the seconds component of this timecode. */
+        inline const CompT ss() const noexcept
+        {
+            return CompT(prvt_tc_number() / FRAMES_PER_SECOND % 60);
+        }
+
+        /** \brief Returns the frames component of this timecode. */
+        inline const CompT ff() const noexcept
+        {
+            return CompT(prvt_tc_number() % FRAMES_PER_SECOND);
+        }
+
+        /** \brief Returns true if this timecode is in error state. */
+        inline const bool is_error() const noexcept
+        {
+            return m_index == ERROR_INDEX;
+        }
+
+        /** \brief Returns true if this timecode gets drop-frame counting. */
+        static inline constexpr bool is_drop_frame() noexcept
+        {
+            return DROP_FRAME;
         }
 
 
         //---   Cast operations   -------------------------------------------
-        /** \brief long(): returns the frames count related to this timecode value.
         /** Returns the time (i.e. fractional seconds) related to this timecode.
         */
-        const Timecode::FrameTime frame_s() const
+        inline const Timecode::FrameTime frame_s() const noexcept
         {
-            constexpr Timecode::FrameTime eps = Timecode::FrameTime(1e-5f);
-            return Timecode::FrameTime(3600.0f * hh + 60.0f * mm + (float)ss + (float)ff / (float)FPS + kEPS);
+            return Timecode::FrameTime(m_index) * Timecode::FrameTime(FPS_DEN) / Timecode::FrameTime(FPS_NUM);
         }
 
         /** Returns the frame index related to this timecode.
         */
-        const Timecode::FrameIndex frame_index()  const
+        inline const Timecode::FrameIndex frame_index() const noexcept
         {
-            return (const Timecode::FrameIndex)(FPS * (3600 * hh + 60 * mm + ss) + ff);
+            return m_index;
         }
 
         /** \brief operator string&
+        * Notice: the 11 characters of the formatted timecode fit into the
+        * small string buffer of std::string, so no allocation happens here.
         */
-        inline operator std::string()
+        inline operator std::string() const
         {
-            return std::format("{:02d}:{:02d}:{:02d}:{:02d}", hh, mm, ss, ff);
+            vcl::utils::AllocationSite site("vcl::utils::Timecode::operator std::string()");
+            char buffer[TC_CHARS_SIZE];
+            return std::string(to_chars(buffer), TC_CHARS_SIZE - 1);
+        }
+
+
+        //---   Formatting / Parsing   --------------------------------------
+        static constexpr std::size_t TC_CHARS_SIZE = 12;  //!< the size of char buffers for formatted timecodes "HH:MM:SS:FF", terminating '\0' included.
+
+        /** \brief Formats this timecode into a fixed-size stack buffer.
+        * The buffer gets "HH:MM:SS:FF" followed by  a  terminating  '\0'.
+        * Drop-frame timecodes are formatted as "HH:MM:SS;FF". Erroneous
+        * timecodes are formatted as "--:--:--:--". Returns the passed
+        * buffer. Never allocates memory.
+        */
+        inline char* to_chars(char (&buffer)[TC_CHARS_SIZE]) const noexcept
+        {
+            if (is_error()) {
+                constexpr char ERR_TXT[TC_CHARS_SIZE] = "--:--:--:--";
+                for (std::size_t i = 0; i < TC_CHARS_SIZE; ++i)
+                    buffer[i] = ERR_TXT[i];
+            }
+            else {
+                const FrameIndex tc_number = prvt_tc_number();
+                prvt_put_2digits(buffer + 0, tc_number / FRAMES_PER_HOUR);
+                prvt_put_2digits(buffer + 3, tc_number / FRAMES_PER_MINUTE % 60);
+                prvt_put_2digits(buffer + 6, tc_number / FRAMES_PER_SECOND % 60);
+                prvt_put_2digits(buffer + 9, tc_number % FRAMES_PER_SECOND);
+                buffer[2] = buffer[5] = ':';
+                buffer[8] = DROP_FRAME ? ';' : ':';
+                buffer[11] = '\0';
+            }
+            return buffer;
+        }
+
+        /** \brief Parses a timecode "HH:MM:SS:FF" from a string view.
+        * Returns true on success. On failure, returns false and sets  tc
+        * in error state.  Never throws and never allocates. Only the fixed
+        * width format with two digits per component is accepted. Drop-frame
+        * timecodes accept either ':' or ';' as their frames separator.
+        */
+        static const bool parse(const std::string_view tc_str, MyType& tc) noexcept
+        {
+            tc.prvt_set(tc_str);
+            return !tc.is_error();
+        }
+
+        /** \brief Batch parsing of a whole column of timecodes.
+        * Parses min(tc_strs.size(), tcs.size()) timecodes. Erroneous ones
+        * are set in error state. Returns the count of parsing errors.
+        */
+        static const std::size_t parse(const std::span<const std::string_view> tc_strs, const std::span<MyType> tcs) noexcept
+        {
+            const std::size_t n = tc_strs.size() < tcs.size() ? tc_strs.size() : tcs.size();
+            std::size_t errors_count = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                tcs[i].prvt_set(tc_strs[i]);
+                errors_count += tcs[i].is_error();
+            }
+            return errors_count;
         }
 
 
@@ -187,8 +355,9 @@ namespace vcl::utils {
         */
         MyType operator++(int)
         {
+            MyType tmp(*this);
             *this += 1;
-            return *this - 1;
+            return tmp;
         }
 
 
@@ -205,18 +374,24 @@ namespace vcl::utils {
         */
         MyType operator--(int)
         {
+            MyType tmp(*this);
             *this -= 1;
-            return *this + 1;
+            return tmp;
         }
 
 
         //---   Operator +=   -------------------------------------------
         /* \brief operator += (const &)
+        * Notice: the added timecode is converted to this timecode frame
+        * rate, the converted value being truncated to its frame index.
         */
-        template<const unsigned short F>
-        MyType& operator +=(const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        MyType& operator +=(const vcl::utils::Timecode<N, D, DF>& rhs)
         {
-            prvt_set(this->frame_s() + rhs.frame_s());
+            if (rhs.is_error())
+                prvt_set_error();
+            else if (!is_error())
+                prvt_set_index((long long)m_index + prvt_convert<N, D>(rhs.frame_index()));
             return *this;
         }
 
@@ -226,7 +401,8 @@ namespace vcl::utils {
             requires std::is_arithmetic_v<T>
         MyType& operator += (const T offset)
         {
-            prvt_set(this->frame_index() + FrameIndex(offset));
+            if (!is_error())
+                prvt_set_index((long long)m_index + (long long)offset);
             return *this;
         }
 
@@ -234,8 +410,8 @@ namespace vcl::utils {
         //---   Operator +   --------------------------------------------
         /* \brief operator + (const &)
         */
-        template<const unsigned short F>
-        friend inline MyType operator+ (MyType lhs, const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        friend inline MyType operator+ (MyType lhs, const vcl::utils::Timecode<N, D, DF>& rhs)
         {
             return lhs += rhs;
         }
@@ -258,11 +434,19 @@ namespace vcl::utils {
 
         //---   Operator -=   -------------------------------------------
         /* \brief operator -= (const &)
+        * Notice: the difference is evaluated exactly and then truncated
+        * to this timecode frame rate. Negative differences are clipped
+        * to 00:00:00:00.
         */
-        template<const unsigned short F>
-        MyType& operator -= (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        MyType& operator -= (const vcl::utils::Timecode<N, D, DF>& rhs)
         {
-            prvt_set(this->frame_s() - rhs.frame_s());
+            if (rhs.is_error())
+                prvt_set_error();
+            else if (!is_error()) {
+                using Ratio = ConvRatio<N, D>;
+                prvt_set_index(((long long)m_index * Ratio::DIV - (long long)rhs.frame_index() * Ratio::MUL) / Ratio::DIV);
+            }
             return *this;
         }
 
@@ -272,7 +456,8 @@ namespace vcl::utils {
             requires std::is_arithmetic_v<T>
         MyType& operator -= (const T offset)
         {
-            prvt_set(this->frame_index() - FrameIndex(offset));
+            if (!is_error())
+                prvt_set_index((long long)m_index - (long long)offset);
             return *this;
         }
 
@@ -280,8 +465,8 @@ namespace vcl::utils {
         //---   Operator -   --------------------------------------------
         /* \brief operator - (const &)
         */
-        template<const unsigned short F>
-        friend inline MyType operator- (MyType lhs, const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        friend inline MyType operator- (MyType lhs, const vcl::utils::Timecode<N, D, DF>& rhs)
         {
             return lhs -= rhs;
         }
@@ -303,128 +488,231 @@ namespace vcl::utils {
 
 
         //---   Comparison Operators   ----------------------------------
+        // Notice: timecodes with different frame rates are compared on
+        // their exact time values, i.e. index1 / rate1 vs. index2 / rate2.
+        // Erroneous timecodes are all equal and greater than any valid one.
+
         /** operator < */
-        template<const unsigned short F>
-        inline bool operator < (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const bool operator < (const vcl::utils::Timecode<N, D, DF>& rhs) const noexcept
         {
-            return frame_s() < rhs.frame_s();
+            return prvt_cmp(rhs) < 0;
         }
 
         /** operator <= */
-        template<const unsigned short F>
-        inline bool operator <= (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const bool operator <= (const vcl::utils::Timecode<N, D, DF>& rhs) const noexcept
         {
-            return frame_s() < rhs.frame_s() || *this == rhs;
+            return prvt_cmp(rhs) <= 0;
         }
 
         /** operator > */
-        template<const unsigned short F>
-        inline bool operator > (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const bool operator > (const vcl::utils::Timecode<N, D, DF>& rhs) const noexcept
         {
-            return frame_s() > rhs.frame_s();
+            return prvt_cmp(rhs) > 0;
         }
 
         /** operator >= */
-        template<const unsigned short F>
-        inline bool operator >= (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const bool operator >= (const vcl::utils::Timecode<N, D, DF>& rhs) const noexcept
         {
-            return frame_s() > rhs.frame_s() || *this == rhs;
+            return prvt_cmp(rhs) >= 0;
         }
 
         /** operator == */
-        template<const unsigned short F>
-        inline bool operator == (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const bool operator == (const vcl::utils::Timecode<N, D, DF>& rhs) const noexcept
         {
-            constexpr FrameTime EPS = 1e-4f;
-            return vcl::utils::in_range_ii<FrameTime>(this->frame_s() - rhs.frame_s(), -EPS, EPS);
+            return prvt_cmp(rhs) == 0;
         }
 
         /** operator != */
-        template<const unsigned short F>
-        inline bool operator != (const vcl::utils::Timecode<F>& rhs)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const bool operator != (const vcl::utils::Timecode<N, D, DF>& rhs) const noexcept
         {
-            return !(*this == rhs);
+            return prvt_cmp(rhs) != 0;
         }
 
 
     private:
 
-        static inline Timecode::FrameTime kEPS = Timecode::FrameTime(1e-5);
+        static constexpr Timecode::FrameTime kEPS = Timecode::FrameTime(1e-5);
+
+        FrameIndex m_index;  //!< the frame index of this timecode, or ERROR_INDEX.
 
-        static std::string m_ERR_TXT[];
 
-        /** \brief Internally sets this timecode (const FrameIndex).
+        /** \brief Exact conversion ratio of frame indexes from rate N/D to this frame rate.
+        * A frame index i at rate N/D is displayed at time i * D / N,  i.e.
+        * at frame index i * D * FPS_NUM / (N * FPS_DEN) at this rate. The
+        * ratio is reduced at compile time to keep products small.
         */
-        inline void prvt_set(const Timecode::FrameIndex index)
+        template<const unsigned long N, const unsigned long D>
+        struct ConvRatio
         {
-            prvt_set(Timecode::FrameTime(index) / Timecode::FrameTime(FPS));
+            static constexpr unsigned long long MUL_ = (unsigned long long)D * FPS_NUM;
+            static constexpr unsigned long long DIV_ = (unsigned long long)N * FPS_DEN;
+            static constexpr unsigned long long GCD_ = std::gcd(MUL_, DIV_);
+
+            static constexpr long long MUL = (long long)(MUL_ / GCD_);  //!< the multiplier of converted indexes.
+            static constexpr long long DIV = (long long)(DIV_ / GCD_);  //!< the divisor of converted indexes.
+        };
+
+        /** \brief Converts a frame index at N/D frames per second into a frame index at this frame rate.
+        * Notice: the resulting index is truncated, i.e. it is the index
+        * of the frame that is displayed at the time of the converted one.
+        */
+        template<const unsigned long N, const unsigned long D>
+        static inline const long long prvt_convert(const FrameIndex other_index) noexcept
+        {
+            using Ratio = ConvRatio<N, D>;
+            if constexpr (Ratio::MUL == Ratio::DIV)
+                return (long long)other_index;
+            else
+                return (long long)other_index * Ratio::MUL / Ratio::DIV;
         }
 
-        /** \brief Internally sets this timecode (const FrameTime fractional seconds).
+        /** \brief Compares exactly the time values of this timecode and of another one.
+        * Returns a negative value, 0 or a positive value if this timecode
+        * is respectively less than, equal to or greater than other.
+        * Erroneous timecodes are handled first, since the conversion of
+        * ERROR_INDEX to long long is platform dependent.
         */
-        void prvt_set(const Timecode::FrameTime fract_sec)
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline const long long prvt_cmp(const Timecode<N, D, DF>& other) const noexcept
         {
-            if (fract_sec <= 0)
-                hh = mm = ss = ff = CompT(0);
-            else {
-                hh = CompT(fract_sec / 3600.0);
-                mm = CompT((unsigned long)(fract_sec / 60.0) % 60);
-                ss = CompT((unsigned long)(fract_sec) % 60);
-                ff = CompT(FPS * (fract_sec - (unsigned long)fract_sec + kEPS));
-                if (hh > 99)
-                    prvt_set_error();
-            }
+            if (is_error() || other.is_error())
+                return (long long)is_error() - (long long)other.is_error();
+
+            using Ratio = ConvRatio<N, D>;
+            if constexpr (Ratio::MUL == Ratio::DIV)
+                return (long long)m_index - (long long)other.frame_index();
+            else
+                return (long long)m_index * Ratio::DIV - (long long)other.frame_index() * Ratio::MUL;
         }
 
-        /** \brief Internally sets this timecode (const string&).
+        /** \brief Returns the timecode number of this timecode,  i.e. its frame
+        * index with the dropped frame numbers added when drop-frame counting.
+        * Closed form: 9 * DROPPED_FRAMES numbers per full 10 minutes period
+        * plus DROPPED_FRAMES numbers per started dropping minute.
         */
-        void prvt_set(const std::string& fract_sec) noexcept(false)
+        inline const FrameIndex prvt_tc_number() const noexcept
         {
-            std::stringstream sstr(fract_sec);
-            try {
-                sstr >> hh >> ':' >> mm >> ':' >> ss >> ':' >> ff;
-                prvt_check();
+            if constexpr (DROP_FRAME) {
+                const FrameIndex tens = m_index / FRAMES_PER_10_MINUTES;
+                const FrameIndex rem  = m_index % FRAMES_PER_10_MINUTES;
+                const FrameIndex drops = rem < DROPPED_FRAMES ? 0 : (rem - DROPPED_FRAMES) / FRAMES_PER_DROP_MINUTE;
+                return m_index + DROPPED_FRAMES * (9 * tens + drops);
             }
-            catch (...) {
+            else
+                return m_index;
+        }
+
+        /** \brief Internally sets this timecode (const frame index).
+        * Notice: negative indexes are clipped to 0 while too big indexes
+        * set this timecode in error state.
+        */
+        inline void prvt_set_index(const long long index) noexcept
+        {
+            if (index <= 0)
+                m_index = 0;
+            else if (index >= (long long)FRAMES_COUNT)
                 prvt_set_error();
-            }
+            else
+                m_index = FrameIndex(index);
         }
 
-        /** \brief Internally sets this timecode (const&).
+        /** \brief Internally sets this timecode (const fractional seconds).
         */
-        template<const unsigned short F>
-        void prvt_set(const Timecode<F>& other) noexcept(false)
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        void prvt_set_seconds(const T seconds) noexcept
         {
-            if (other.b_error)
-                throw std::invalid_argument("invalid timecode value passed as Timecode argument");
+            if (seconds <= 0)
+                m_index = 0;
+            else if constexpr (std::is_integral_v<T>)
+                prvt_set_index((unsigned long long)seconds >= 360000ull ? (long long)FRAMES_COUNT
+                                                                         : (long long)seconds * FPS_NUM / FPS_DEN);
             else {
-                prvt_set(other.frame_s());
+                const long double frames = (long double)seconds * FPS_NUM / FPS_DEN + kEPS;
+                prvt_set_index(frames >= (long double)FRAMES_COUNT ? (long long)FRAMES_COUNT
+                                                                   : (long long)frames);
             }
         }
 
-        /** \brief Internally checks for the correctness of this timecode .
+        /** \brief Internally sets this timecode (const components).
+        * Notice: dropped frame numbers are invalid timecodes.
         */
-        inline const bool prvt_check()
+        inline void prvt_set(const unsigned int hr, const unsigned int mn, const unsigned int sc, const unsigned int fr) noexcept
+        {
+            if (vcl::utils::in_range_io(hr, 0u, 100u) &&
+                    vcl::utils::in_range_io(mn, 0u, 60u) &&
+                    vcl::utils::in_range_io(sc, 0u, 60u) &&
+                    vcl::utils::in_range_io(fr, 0u, (unsigned int)FRAMES_PER_SECOND)) {
+                const FrameIndex tc_number = FrameIndex(hr * FRAMES_PER_HOUR + mn * FRAMES_PER_MINUTE + sc * FRAMES_PER_SECOND + fr);
+                if constexpr (DROP_FRAME) {
+                    if (sc == 0 && fr < DROPPED_FRAMES && mn % 10 != 0)
+                        prvt_set_error();
+                    else {
+                        const FrameIndex minutes = 60 * hr + mn;
+                        m_index = tc_number - DROPPED_FRAMES * (minutes - minutes / 10);
+                    }
+                }
+                else
+                    m_index = tc_number;
+            }
+            else
+                prvt_set_error();
+        }
+
+        /** \brief Internally sets this timecode (const string view).
+        * Branch-light parsing: all digits and separators are checked with
+        * no early exits and the validity gets evaluated once.
+        */
+        void prvt_set(const std::string_view tc_str) noexcept
         {
-            if (vcl::utils::in_range_ii<CompT, 0, 99>(hh) &&
-                    vcl::utils::in_range_io<CompT, 0, 60>(mm) &&
-                    vcl::utils::in_range_io<CompT, 0, 60>(ss) &&
-                    vcl::utils::in_range_io<CompT, 0, FPS>(ff))
-                prvt_clr_error();
+            if (tc_str.size() != TC_CHARS_SIZE - 1) {
+                prvt_set_error();
+                return;
+            }
+
+            const char* c = tc_str.data();
+            const unsigned int d0 = (unsigned int)(c[0] - '0'), d1 = (unsigned int)(c[1] - '0');
+            const unsigned int d3 = (unsigned int)(c[3] - '0'), d4 = (unsigned int)(c[4] - '0');
+            const unsigned int d6 = (unsigned int)(c[6] - '0'), d7 = (unsigned int)(c[7] - '0');
+            const unsigned int d9 = (unsigned int)(c[9] - '0'), d10 = (unsigned int)(c[10] - '0');
+
+            const bool ok = (d0 < 10) & (d1 < 10) & (d3 < 10) & (d4 < 10) &
+                            (d6 < 10) & (d7 < 10) & (d9 < 10) & (d10 < 10) &
+                            (c[2] == ':') & (c[5] == ':') & ((c[8] == ':') | (DROP_FRAME & (c[8] == ';')));
+            if (ok)
+                prvt_set(10 * d0 + d1, 10 * d3 + d4, 10 * d6 + d7, 10 * d9 + d10);
             else
                 prvt_set_error();
         }
 
-        /** \brief clears the internal error state  */
-        inline void prvt_clr_error()
+        /** \brief Internally sets this timecode (const&).
+        */
+        template<const unsigned long N, const unsigned long D, const bool DF>
+        inline void prvt_set(const Timecode<N, D, DF>& other) noexcept
+        {
+            if (other.is_error())
+                prvt_set_error();
+            else
+                prvt_set_index(prvt_convert<N, D>(other.frame_index()));
+        }
+
+        /** \brief Writes the two decimal digits of value (< 100) into buffer. */
+        static inline void prvt_put_2digits(char* buffer, const unsigned long value) noexcept
         {
-            b_error = false;
+            buffer[0] = char('0' + value / 10);
+            buffer[1] = char('0' + value % 10);
         }
 
         /** \brief sets the internal error state to true */
-        inline void prvt_set_error()
+        inline void prvt_set_error() noexcept
         {
-            b_error = true;
+            m_index = ERROR_INDEX;
         }
 
     };
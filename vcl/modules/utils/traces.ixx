@@ -0,0 +1,449 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+export module utils.traces;
+
+import utils.allocations;
+import utils.perfmeters;
+import utils.timecodes;
+
+
+//===========================================================================
+namespace vcl::utils {
+
+    //-----------------------------------------------------------------------
+    // not to be used out of this module scope
+    /** \brief One recorded trace event.
+    * Names and categories must have static storage duration. tc[0] is
+    * '\0' when the event is not tagged with a timecode.
+    */
+    struct _TraceEvent
+    {
+        const char* name;
+        const char* category;
+        long long   ts_ns;
+        long long   value;
+        char        phase;    //!< 'B'egin, 'E'nd, 'C'ounter or 'i'nstant, as in the Chrome trace-event format.
+        char        tc[12];
+    };
+
+    /** \brief The per-thread ring buffer of trace events.
+    * Single producer - the owning thread - and single consumer - the
+    * flushing thread. Events recorded while the buffer is full are
+    * dropped and counted, recording never blocks nor allocates.
+    */
+    struct _TraceRing
+    {
+        static constexpr std::uint32_t CAPACITY = 1u << 14;  // must be a power of 2
+
+        std::unique_ptr<_TraceEvent[]> events{ new _TraceEvent[CAPACITY] };
+        alignas(64) std::atomic<std::uint64_t> head{ 0 };    //!< next event to be written, modified by the producer only.
+        alignas(64) std::atomic<std::uint64_t> tail{ 0 };    //!< next event to be flushed, modified by the consumer only.
+        std::atomic<std::uint64_t> dropped{ 0 };
+        std::atomic<bool> exited{ false };                   //!< true once the owning thread has ended.
+        std::uint32_t tid = 0;
+
+        /** \brief Returns the next free event slot, or nullptr if the buffer is full, the event being then dropped. */
+        inline _TraceEvent* reserve() noexcept
+        {
+            const std::uint64_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            return &events[h & (CAPACITY - 1)];
+        }
+
+        /** \brief Publishes the last reserved event. */
+        inline void commit() noexcept
+        {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    };
+
+    /** \brief The registry of all per-thread trace buffers and the flushing thread state.
+    * Its mutex is locked once per thread at its first event and at its
+    * end, and by the flushing thread, never while recording events. The
+    * buffers of ended threads are freed once flushed.
+    */
+    struct _TracesRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<_TraceRing>> rings;
+        std::uint32_t last_tid = 0;                  //!< the tid of the last created buffer.
+        unsigned long long freed_dropped = 0;       //!< the dropped events of the freed buffers.
+
+        std::atomic<bool> running{ false };
+        long long origin_ns = 0;
+
+        std::mutex flush_mutex;
+        std::condition_variable flush_cv;
+        bool stop_requested = false;
+        std::thread flusher;
+        std::ofstream out;
+        bool first_event = true;
+
+        /** \brief Destructor, stops the sink if still running, so that the trace file gets closed. */
+        ~_TracesRegistry()
+        {
+            stop();
+        }
+
+        static _TracesRegistry& instance()
+        {
+            static _TracesRegistry registry;
+            return registry;
+        }
+
+        /** \brief Stops the flushing thread, flushes the remaining events and closes the trace file. */
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> flush_lock(flush_mutex);
+                if (!running.load(std::memory_order_relaxed))
+                    return;
+                running.store(false, std::memory_order_release);
+                stop_requested = true;
+            }
+            flush_cv.notify_all();
+            flusher.join();
+
+            std::lock_guard<std::mutex> flush_lock(flush_mutex);
+            flush();
+            out << "]}\n";
+            out.close();
+        }
+
+        /** \brief Writes all published events to the trace file. flush_mutex must be locked. */
+        void flush()
+        {
+            vcl::utils::AllocationSite site("vcl::utils::TraceSink::flush()");
+            std::vector<_TraceRing*> flushed_rings;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& ring : rings)
+                    flushed_rings.push_back(ring.get());
+            }
+
+            std::string txt;
+            std::vector<_TraceRing*> exited_rings;
+            for (_TraceRing* ring : flushed_rings) {
+                // loaded before head, so that all the events of an ended thread get flushed
+                if (ring->exited.load(std::memory_order_acquire))
+                    exited_rings.push_back(ring);
+                std::uint64_t t = ring->tail.load(std::memory_order_relaxed);
+                const std::uint64_t h = ring->head.load(std::memory_order_acquire);
+                for (; t != h; ++t) {
+                    const _TraceEvent& e = ring->events[t & (_TraceRing::CAPACITY - 1)];
+                    txt += first_event ? "\n" : ",\n";
+                    first_event = false;
+                    txt += std::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}",
+                                       e.name, e.category, e.phase, (e.ts_ns - origin_ns) * 1e-3, ring->tid);
+                    if (e.phase == 'C')
+                        txt += std::format(",\"args\":{{\"value\":{}}}}}", e.value);
+                    else if (e.tc[0] != '\0')
+                        txt += std::format(",\"args\":{{\"timecode\":\"{}\"}}}}", e.tc);
+                    else if (e.phase == 'i')
+                        txt += ",\"s\":\"t\"}";
+                    else
+                        txt += "}";
+                }
+                ring->tail.store(t, std::memory_order_release);
+            }
+            out << txt;
+            out.flush();
+
+            if (!exited_rings.empty())
+                free_rings(exited_rings);
+        }
+
+        /** \brief Frees the buffers of ended threads, keeping their count of dropped events. */
+        void free_rings(const std::vector<_TraceRing*>& exited_rings)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::erase_if(rings, [&](const std::unique_ptr<_TraceRing>& ring) {
+                if (std::find(exited_rings.begin(), exited_rings.end(), ring.get()) == exited_rings.end())
+                    return false;
+                freed_dropped += ring->dropped.load(std::memory_order_relaxed);
+                return true;
+            });
+        }
+    };
+
+    /** \brief The per-thread owner of a trace buffer, which marks it as exited at thread end. */
+    struct _ThreadRingOwner
+    {
+        _TraceRing* ring;
+
+        inline _ThreadRingOwner()
+        {
+            vcl::utils::AllocationSite site("vcl::utils::_thread_ring()");
+            _TracesRegistry& registry = _TracesRegistry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.rings.push_back(std::make_unique<_TraceRing>());
+            registry.rings.back()->tid = ++registry.last_tid;
+            ring = registry.rings.back().get();
+        }
+
+        inline ~_ThreadRingOwner()
+        {
+            _TracesRegistry& registry = _TracesRegistry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            ring->exited.store(true, std::memory_order_release);
+        }
+    };
+
+    /** \brief Returns the trace buffer of the calling thread. */
+    inline _TraceRing& _thread_ring()
+    {
+        thread_local _ThreadRingOwner owner;
+        return *owner.ring;
+    }
+
+
+    //===================================================================
+    /** \brief The sink of trace events, exported as Chrome trace-event JSON.
+    *
+    * Begin/end events,  instants and counters are recorded into per-thread
+    * ring buffers with no lock and no allocation,  timestamps being taken
+    * with PerfMeter.  A background thread periodically flushes them to a
+    * local file that can be loaded in chrome://tracing or ui.perfetto.dev.
+    * Events can be tagged with a Timecode,  shown in their "args".
+    * Events are ignored when the sink is not running.
+    *
+    * Usage:
+    *   vcl::utils::TraceSink::start("pipeline.json");
+    *   ...
+    *   {
+    *       vcl::utils::TraceScope scope("decode", tc);
+    *       ...
+    *   }
+    *   vcl::utils::TraceSink::stop();
+    */
+    export class TraceSink
+    {
+    public:
+        /** \brief Opens the trace file and starts the flushing thread.
+        * Returns false if the sink is already running or if the file
+        * cannot be created.
+        */
+        static const bool start(const std::string& file_path, const unsigned int flush_period_ms = 50)
+        {
+            _TracesRegistry& registry = _TracesRegistry::instance();
+            std::lock_guard<std::mutex> flush_lock(registry.flush_mutex);
+            if (registry.running.load(std::memory_order_relaxed))
+                return false;
+
+            registry.out.open(file_path, std::ios::out | std::ios::trunc);
+            if (!registry.out)
+                return false;
+            registry.out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            registry.first_event = true;
+
+            {
+                // forgets events recorded while stopped, and the buffers of the threads ended meanwhile
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                std::erase_if(registry.rings, [&registry](const std::unique_ptr<_TraceRing>& ring) {
+                    if (!ring->exited.load(std::memory_order_acquire))
+                        return false;
+                    registry.freed_dropped += ring->dropped.load(std::memory_order_relaxed);
+                    return true;
+                });
+                for (auto& ring : registry.rings)
+                    ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+            }
+
+            registry.origin_ns = vcl::utils::PerfMeter::now_ns();
+            registry.stop_requested = false;
+            registry.running.store(true, std::memory_order_release);
+            registry.flusher = std::thread(prvt_flush_loop, flush_period_ms);
+            return true;
+        }
+
+        /** \brief Stops the flushing thread, flushes the remaining events and closes the trace file. */
+        static inline void stop()
+        {
+            _TracesRegistry::instance().stop();
+        }
+
+        /** \brief Returns true if the sink is running. */
+        static inline const bool is_running() noexcept
+        {
+            return _TracesRegistry::instance().running.load(std::memory_order_relaxed);
+        }
+
+        /** \brief Returns the count of events dropped because of full buffers. */
+        static const unsigned long long dropped_events()
+        {
+            _TracesRegistry& registry = _TracesRegistry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            unsigned long long count = registry.freed_dropped;
+            for (const auto& ring : registry.rings)
+                count += ring->dropped.load(std::memory_order_relaxed);
+            return count;
+        }
+
+        /** \brief Returns the count of per-thread trace buffers, the ones of ended threads being freed once flushed. */
+        static const std::size_t buffers_count()
+        {
+            _TracesRegistry& registry = _TracesRegistry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            return registry.rings.size();
+        }
+
+        /** \brief Records the beginning of a duration event. */
+        static inline void begin(const char* static_name, const char* static_category = "vcl") noexcept
+        {
+            prvt_record('B', static_name, static_category, 0, prvt_no_tc);
+        }
+
+        /** \brief Records the beginning of a duration event tagged with a timecode. */
+        template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
+        static inline void begin(const char* static_name, const Timecode<FPS_NUM, FPS_DEN, DROP_FRAME>& tc, const char* static_category = "vcl") noexcept
+        {
+            prvt_record('B', static_name, static_category, 0, [&tc](char (&buffer)[12]) noexcept { tc.to_chars(buffer); });
+        }
+
+        /** \brief Records the end of the innermost duration event of the calling thread. */
+        static inline void end(const char* static_name, const char* static_category = "vcl") noexcept
+        {
+            prvt_record('E', static_name, static_category, 0, prvt_no_tc);
+        }
+
+        /** \brief Records an instant event. */
+        static inline void instant(const char* static_name, const char* static_category = "vcl") noexcept
+        {
+            prvt_record('i', static_name, static_category, 0, prvt_no_tc);
+        }
+
+        /** \brief Records an instant event tagged with a timecode. */
+        template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
+        static inline void instant(const char* static_name, const Timecode<FPS_NUM, FPS_DEN, DROP_FRAME>& tc, const char* static_category = "vcl") noexcept
+        {
+            prvt_record('i', static_name, static_category, 0, [&tc](char (&buffer)[12]) noexcept { tc.to_chars(buffer); });
+        }
+
+        /** \brief Records the value of a counter. */
+        static inline void counter(const char* static_name, const long long value, const char* static_category = "vcl") noexcept
+        {
+            prvt_record('C', static_name, static_category, value, prvt_no_tc);
+        }
+
+
+    private:
+        /** \brief Records one event into the calling thread buffer, set_tc() filling its timecode tag. */
+        template<typename SetTcT>
+        static inline void prvt_record(const char phase, const char* name, const char* category, const long long value, SetTcT&& set_tc) noexcept
+        {
+            if (!_TracesRegistry::instance().running.load(std::memory_order_relaxed))
+                return;
+
+            _TraceRing& ring = _thread_ring();
+            _TraceEvent* event = ring.reserve();
+            if (event == nullptr)
+                return;
+
+            event->ts_ns = vcl::utils::PerfMeter::now_ns();
+            event->name = name;
+            event->category = category;
+            event->value = value;
+            event->phase = phase;
+            set_tc(event->tc);
+            ring.commit();
+        }
+
+        /** \brief Sets an empty timecode tag. */
+        static inline void prvt_no_tc(char (&buffer)[12]) noexcept
+        {
+            buffer[0] = '\0';
+        }
+
+        /** \brief The loop of the flushing thread. */
+        static void prvt_flush_loop(const unsigned int flush_period_ms)
+        {
+            _TracesRegistry& registry = _TracesRegistry::instance();
+            std::unique_lock<std::mutex> flush_lock(registry.flush_mutex);
+            while (!registry.stop_requested) {
+                registry.flush_cv.wait_for(flush_lock, std::chrono::milliseconds(flush_period_ms));
+                registry.flush();
+            }
+        }
+    };
+
+
+    //===================================================================
+    /** \brief The class of scoped trace events.
+    * Records a begin event at construction time and the matching end
+    * event at destruction time. Names must have static storage duration.
+    */
+    export class TraceScope
+    {
+    public:
+        /** \brief Constructor, records the begin event. */
+        inline explicit TraceScope(const char* static_name, const char* static_category = "vcl") noexcept
+            : m_name(static_name), m_category(static_category)
+        {
+            TraceSink::begin(m_name, m_category);
+        }
+
+        /** \brief Constructor, records the begin event tagged with a timecode. */
+        template<const unsigned long FPS_NUM, const unsigned long FPS_DEN, const bool DROP_FRAME>
+        inline TraceScope(const char* static_name, const Timecode<FPS_NUM, FPS_DEN, DROP_FRAME>& tc, const char* static_category = "vcl") noexcept
+            : m_name(static_name), m_category(static_category)
+        {
+            TraceSink::begin(m_name, tc, m_category);
+        }
+
+        /** \brief Destructor, records the end event. */
+        inline ~TraceScope() noexcept
+        {
+            TraceSink::end(m_name, m_category);
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator= (const TraceScope&) = delete;
+
+    private:
+        const char* m_name;
+        const char* m_category;
+    };
+
+}
@@ -0,0 +1,48 @@
+/*
+MIT License
+
+Copyright (c) 2022 Philippe Schmouker, ph.schmouker (at) gmail.com
+
+Permission is hereby granted,  free of charge,  to any person obtaining a copy
+of this software and associated documentation files (the "Software"),  to deal
+in the Software without restriction,  including without limitation the  rights
+to use,  copy,  modify,  merge,  publish,  distribute, sublicense, and/or sell
+copies of the Software,  and  to  permit  persons  to  whom  the  Software  is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY  KIND,  EXPRESS  OR
+IMPLIED,  INCLUDING  BUT  NOT  LIMITED  TO  THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT  SHALL  THE
+AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE  FOR  ANY CLAIM,  DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  ARISING FROM,
+OUT  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//===========================================================================
+module vectors.clipvect2;
+
+
+//===========================================================================
+namespace vcl::vect {
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations declared in module vectors.clipvect2.
+    template class ClipVect2T<char, std::numeric_limits<char>::min(), std::numeric_limits<char>::max()>;
+    template class ClipVect2T<unsigned char, std::numeric_limits<unsigned char>::min(), std::numeric_limits<unsigned char>::max()>;
+    template class ClipVect2T<short, std::numeric_limits<short>::min(), std::numeric_limits<short>::max()>;
+    template class ClipVect2T<unsigned short, std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max()>;
+    template class ClipVect2T<long, std::numeric_limits<long>::min(), std::numeric_limits<long>::max()>;
+    template class ClipVect2T<unsigned long, std::numeric_limits<unsigned long>::min(), std::numeric_limits<unsigned long>::max()>;
+    template class ClipVect2T<long long, std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()>;
+    template class ClipVect2T<unsigned long long, std::numeric_limits<unsigned long long>::min(), std::numeric_limits<unsigned long long>::max()>;
+    template class ClipVect2T<float, std::numeric_limits<float>::min(), std::numeric_limits<float>::max()>;
+    template class ClipVect2T<double, std::numeric_limits<double>::min(), std::numeric_limits<double>::max()>;
+    template class ClipVect2T<long double, std::numeric_limits<long double>::min(), std::numeric_limits<long double>::max()>;
+    template class ClipVect2T<float, 0.0f, 1.0f>;
+    template class ClipVect2T<double, 0.0, 1.0>;
+
+}
@@ -60,7 +60,7 @@ namespace vcl::vect {
     export using ClipVect2 = ClipVect2s;
 
     /** \brief The class of 2D vectors with unsigned short components (16 bits). */
-    export using ClipVect2us = ClipVect2T<short, std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max()>;
+    export using ClipVect2us = ClipVect2T<unsigned short, std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max()>;
 
     /** \brief The class of 2D vectors with long int components (32 bits). */
     export using ClipVect2i = ClipVect2T<long, std::numeric_limits<long>::min(), std::numeric_limits<long>::max()>;
@@ -164,7 +164,7 @@ namespace vcl::vect {
         }
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~ClipVect2T<TScalar, Kmin, Kmax>()
+        virtual inline ~ClipVect2T()
         {}
 
         //---   Components accessors / mutators   --------------------------------------
@@ -290,9 +290,38 @@ namespace vcl::vect {
             requires std::is_arithmetic_v<T>
         inline const TScalar clipped(const T value) const
         {
-            const auto val = std::is_unsigned_v<T> ? (long long)value : value;
-            return val <= Kmin ? Kmin : (val >= Kmax ? Kmax : TScalar(val));
+            if constexpr (std::is_floating_point_v<T> || std::is_floating_point_v<TScalar>) {
+                const long double val = (long double)value;
+                return val <= (long double)Kmin ? Kmin : (val >= (long double)Kmax ? Kmax : TScalar(value));
+            }
+            else {
+                // compares as integers of same signedness as their types, e.g. unsigned long vs char on LP64 platforms
+                using ValueType = std::conditional_t<std::is_unsigned_v<T>, unsigned long long, long long>;
+                using ScalarType = std::conditional_t<std::is_unsigned_v<TScalar>, unsigned long long, long long>;
+                const ValueType val = ValueType(value);
+                return std::cmp_less_equal(val, ScalarType(Kmin)) ? Kmin : (std::cmp_greater_equal(val, ScalarType(Kmax)) ? Kmax : TScalar(value));
+            }
         }
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit clipvect2.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class ClipVect2T<char, std::numeric_limits<char>::min(), std::numeric_limits<char>::max()>;
+    extern template class ClipVect2T<unsigned char, std::numeric_limits<unsigned char>::min(), std::numeric_limits<unsigned char>::max()>;
+    extern template class ClipVect2T<short, std::numeric_limits<short>::min(), std::numeric_limits<short>::max()>;
+    extern template class ClipVect2T<unsigned short, std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max()>;
+    extern template class ClipVect2T<long, std::numeric_limits<long>::min(), std::numeric_limits<long>::max()>;
+    extern template class ClipVect2T<unsigned long, std::numeric_limits<unsigned long>::min(), std::numeric_limits<unsigned long>::max()>;
+    extern template class ClipVect2T<long long, std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()>;
+    extern template class ClipVect2T<unsigned long long, std::numeric_limits<unsigned long long>::min(), std::numeric_limits<unsigned long long>::max()>;
+    extern template class ClipVect2T<float, std::numeric_limits<float>::min(), std::numeric_limits<float>::max()>;
+    extern template class ClipVect2T<double, std::numeric_limits<double>::min(), std::numeric_limits<double>::max()>;
+    extern template class ClipVect2T<long double, std::numeric_limits<long double>::min(), std::numeric_limits<long double>::max()>;
+    extern template class ClipVect2T<float, 0.0f, 1.0f>;
+    extern template class ClipVect2T<double, 0.0, 1.0>;
+#endif
+
 }
@@ -58,7 +58,7 @@ namespace vcl::vect {
     export using ClipVect3 = ClipVect3s;
 
     /** \brief The class of 3D vectors with unsigned short components (16 bits). */
-    export using ClipVect3us = ClipVect3T<short, std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max()>;
+    export using ClipVect3us = ClipVect3T<unsigned short, std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max()>;
 
     /** \brief The class of 3D vectors with long int components (32 bits). */
     export using ClipVect3i = ClipVect3T<long, std::numeric_limits<long>::min(), std::numeric_limits<long>::max()>;
@@ -164,7 +164,7 @@ namespace vcl::vect {
         }
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~ClipVect3T<TScalar, Kmin, Kmax>()
+        virtual inline ~ClipVect3T()
         {}
 
         //---   Components accessors / mutators   --------------------------------------
@@ -234,8 +234,17 @@ namespace vcl::vect {
             requires std::is_arithmetic_v<T>
         inline const TScalar clipped(const T value) const
         {
-            const auto val = std::is_unsigned_v<T> ? (long long)value : value;
-            return val <= Kmin ? Kmin : (val >= Kmax ? Kmax : TScalar(val));
+            if constexpr (std::is_floating_point_v<T> || std::is_floating_point_v<TScalar>) {
+                const long double val = (long double)value;
+                return val <= (long double)Kmin ? Kmin : (val >= (long double)Kmax ? Kmax : TScalar(value));
+            }
+            else {
+                // compares as integers of same signedness as their types, e.g. unsigned long vs char on LP64 platforms
+                using ValueType = std::conditional_t<std::is_unsigned_v<T>, unsigned long long, long long>;
+                using ScalarType = std::conditional_t<std::is_unsigned_v<TScalar>, unsigned long long, long long>;
+                const ValueType val = ValueType(value);
+                return std::cmp_less_equal(val, ScalarType(Kmin)) ? Kmin : (std::cmp_greater_equal(val, ScalarType(Kmax)) ? Kmax : TScalar(value));
+            }
         }
     };
 
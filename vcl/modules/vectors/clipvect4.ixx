@@ -177,7 +177,7 @@ namespace vcl::vect {
         }
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~ClipVect4T<TScalar, Kmin, Kmax>()
+        virtual inline ~ClipVect4T()
         {}
 
         //---   Components accessors / mutators   --------------------------------------
@@ -267,8 +267,17 @@ namespace vcl::vect {
             requires std::is_arithmetic_v<T>
         inline const TScalar clipped(const T value) const
         {
-            const auto val = std::is_unsigned_v<T> ? (long long)value : value;
-            return val <= Kmin ? Kmin : (val >= Kmax ? Kmax : TScalar(val));
+            if constexpr (std::is_floating_point_v<T> || std::is_floating_point_v<TScalar>) {
+                const long double val = (long double)value;
+                return val <= (long double)Kmin ? Kmin : (val >= (long double)Kmax ? Kmax : TScalar(value));
+            }
+            else {
+                // compares as integers of same signedness as their types, e.g. unsigned long vs char on LP64 platforms
+                using ValueType = std::conditional_t<std::is_unsigned_v<T>, unsigned long long, long long>;
+                using ScalarType = std::conditional_t<std::is_unsigned_v<TScalar>, unsigned long long, long long>;
+                const ValueType val = ValueType(value);
+                return std::cmp_less_equal(val, ScalarType(Kmin)) ? Kmin : (std::cmp_greater_equal(val, ScalarType(Kmax)) ? Kmax : TScalar(value));
+            }
         }
     };
 
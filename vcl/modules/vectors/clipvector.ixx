@@ -111,7 +111,7 @@ namespace vcl::vect {
 
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~ClipVectorT<TScalar, Ksize, Kmin, Kmax>()
+        virtual inline ~ClipVectorT()
         {}
 
 
@@ -121,8 +121,17 @@ namespace vcl::vect {
             requires std::is_arithmetic_v<T>
         inline const TScalar clipped(const T value) const
         {
-            const auto val = std::is_unsigned_v<T> ? (long long)value : value;
-            return vcl::utils::max(Kmin, vcl::utils::min(TScalar(val), Kmax));
+            if constexpr (std::is_floating_point_v<T> || std::is_floating_point_v<TScalar>) {
+                const long double val = (long double)value;
+                return val <= (long double)Kmin ? Kmin : (val >= (long double)Kmax ? Kmax : TScalar(value));
+            }
+            else {
+                // compares as integers of same signedness as their types, e.g. unsigned long vs char on LP64 platforms
+                using ValueType = std::conditional_t<std::is_unsigned_v<T>, unsigned long long, long long>;
+                using ScalarType = std::conditional_t<std::is_unsigned_v<TScalar>, unsigned long long, long long>;
+                const ValueType val = ValueType(value);
+                return std::cmp_less_equal(val, ScalarType(Kmin)) ? Kmin : (std::cmp_greater_equal(val, ScalarType(Kmax)) ? Kmax : TScalar(value));
+            }
         }
     };
 
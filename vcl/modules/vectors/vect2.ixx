@@ -162,7 +162,7 @@ namespace vcl::vect {
         {}
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~Vect2T<TScalar>()
+        virtual inline ~Vect2T()
         {}
 
         //---   Components accessors / mutators   --------------------------------------
@@ -229,4 +229,22 @@ namespace vcl::vect {
 
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit vect2.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class Vect2T<char>;
+    extern template class Vect2T<unsigned char>;
+    extern template class Vect2T<short>;
+    extern template class Vect2T<unsigned short>;
+    extern template class Vect2T<long>;
+    extern template class Vect2T<unsigned long>;
+    extern template class Vect2T<long long>;
+    extern template class Vect2T<unsigned long long>;
+    extern template class Vect2T<float>;
+    extern template class Vect2T<double>;
+    extern template class Vect2T<long double>;
+#endif
+
 }
@@ -154,7 +154,7 @@ namespace vcl::vect {
         {}
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~Vect3T<TScalar>()
+        virtual inline ~Vect3T()
         {}
 
         //---   Components accessors / mutators   --------------------------------------
@@ -219,4 +219,22 @@ namespace vcl::vect {
         }
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit vect3.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class Vect3T<char>;
+    extern template class Vect3T<unsigned char>;
+    extern template class Vect3T<short>;
+    extern template class Vect3T<unsigned short>;
+    extern template class Vect3T<long>;
+    extern template class Vect3T<unsigned long>;
+    extern template class Vect3T<long long>;
+    extern template class Vect3T<unsigned long long>;
+    extern template class Vect3T<float>;
+    extern template class Vect3T<double>;
+    extern template class Vect3T<long double>;
+#endif
+
 }
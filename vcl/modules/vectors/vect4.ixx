@@ -168,7 +168,7 @@ namespace vcl::vect {
         }
 
         //---  Destructor   -------------------------------------------------
-        virtual inline ~Vect4T<TScalar>()
+        virtual inline ~Vect4T()
         {}
 
         //---   Components accessors / mutators   --------------------------------------
@@ -253,4 +253,22 @@ namespace vcl::vect {
         }
     };
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit vect4.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class Vect4T<char>;
+    extern template class Vect4T<unsigned char>;
+    extern template class Vect4T<short>;
+    extern template class Vect4T<unsigned short>;
+    extern template class Vect4T<long>;
+    extern template class Vect4T<unsigned long>;
+    extern template class Vect4T<long long>;
+    extern template class Vect4T<unsigned long long>;
+    extern template class Vect4T<float>;
+    extern template class Vect4T<double>;
+    extern template class Vect4T<long double>;
+#endif
+
 }
@@ -126,7 +126,7 @@ namespace vcl::vect {
 
 
         //---   Destructor   ------------------------------------------------
-        virtual inline ~VectorT<TScalar, Ksize>()
+        virtual inline ~VectorT()
         {}
 
 
@@ -142,9 +142,8 @@ namespace vcl::vect {
                 for_each([val](TScalar& c){ c = val; });
             }
             else {
-                // let's set the filling pattern
-                std::vector<TScalar> pattern;
-                _set_pattern(pattern, scalar_value, rest...);
+                // let's set the filling pattern - on the stack, no heap allocation
+                const std::array<TScalar, 1 + sizeof...(rest)> pattern{ clipped(scalar_value), clipped(rest)... };
                 // then, let's copy it as many times as needed
                 auto it = begin();
                 auto pit = pattern.begin();
@@ -654,7 +653,7 @@ namespace vcl::vect {
         /** \brief + operator (const std::pair, vcl::vect::Vect2) */
         template<typename T, typename U>
             requires std::is_arithmetic_v<T>&& std::is_arithmetic_v<U>
-        friend inline std::pair<T, U>& operator+ (std::pair<T, U> lhs, MyType rhs)
+        friend inline std::pair<T, U> operator+ (std::pair<T, U> lhs, MyType rhs)
         {
             return lhs += rhs;
         }
@@ -814,7 +813,7 @@ namespace vcl::vect {
         /** \brief - operator (const std::pair, vcl::vect::Vect2) */
         template<typename T, typename U>
             requires std::is_arithmetic_v<T>&& std::is_arithmetic_v<U>
-        friend inline std::pair<T, U>& operator- (std::pair<T, U> lhs, MyType rhs)
+        friend inline std::pair<T, U> operator- (std::pair<T, U> lhs, MyType rhs)
         {
             return lhs -= rhs;
         }
@@ -905,7 +904,7 @@ namespace vcl::vect {
         */
         template<typename T, size_t S>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator* (MyType lhs, const vcl::vect::VectorT<T, S>& rhs)
+        friend inline MyType operator* (MyType lhs, const vcl::vect::VectorT<T, S>& rhs)
         {
             return lhs *= rhs;
         }
@@ -913,7 +912,7 @@ namespace vcl::vect {
         /** \brief * operator (vcl::vect::VectorT, const TScalar) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator* (MyType lhs, const T value)
+        friend inline MyType operator* (MyType lhs, const T value)
         {
             return lhs *= value;
         }
@@ -921,7 +920,7 @@ namespace vcl::vect {
         /** \brief * operator (const TScalar, vcl::vect::VectorT) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator* (const T value, MyType rhs)
+        friend inline MyType operator* (const T value, MyType rhs)
         {
             return rhs *= value;
         }
@@ -929,7 +928,7 @@ namespace vcl::vect {
         /** \brief * operator (const std::array) */
         template<typename T, size_t S>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator* (MyType lhs, const std::array<T, S>& rhs)
+        friend inline MyType operator* (MyType lhs, const std::array<T, S>& rhs)
         {
             return lhs *= rhs;
         }
@@ -937,7 +936,7 @@ namespace vcl::vect {
         /** \brief * operator (const std::array, vcl::vect::VectorT) */
         template<typename T, size_t S>
             requires std::is_arithmetic_v<T>
-        friend inline std::array<T, S>& operator* (std::array<T, S> lhs, MyType rhs)
+        friend inline std::array<T, S> operator* (std::array<T, S> lhs, MyType rhs)
         {
             return lhs *= rhs;
         }
@@ -945,7 +944,7 @@ namespace vcl::vect {
         /** \brief * operator (const std::vector) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator* (MyType lhs, const std::vector<T> rhs)
+        friend inline MyType operator* (MyType lhs, const std::vector<T> rhs)
         {
             return lhs *= rhs;
         }
@@ -953,7 +952,7 @@ namespace vcl::vect {
         /** \brief * operator (const std::vector, vcl::vect::VectorT) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline std::vector<T>& operator* (std::vector<T> lhs, MyType rhs)
+        friend inline std::vector<T> operator* (std::vector<T> lhs, MyType rhs)
         {
             return lhs *= rhs;
         }
@@ -961,7 +960,7 @@ namespace vcl::vect {
         /** \brief * operator (const std::pair) */
         template<typename T, typename U>
             requires std::is_arithmetic_v<T>&& std::is_arithmetic_v<U>
-        friend inline MyType& operator* (MyType lhs, const std::pair<T, U>rhs)
+        friend inline MyType operator* (MyType lhs, const std::pair<T, U>rhs)
         {
             return lhs *= rhs;
         }
@@ -969,7 +968,7 @@ namespace vcl::vect {
         /** \brief * operator (const std::pair, vcl::vect::Vect2) */
         template<typename T, typename U>
             requires std::is_arithmetic_v<T>&& std::is_arithmetic_v<U>
-        friend inline std::pair<T, U>& operator* (std::pair<T, U> lhs, MyType rhs)
+        friend inline std::pair<T, U> operator* (std::pair<T, U> lhs, MyType rhs)
         {
             return lhs *= rhs;
         }
@@ -1054,7 +1053,7 @@ namespace vcl::vect {
         */
         template<typename T, size_t S>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator/ (MyType lhs, const vcl::vect::VectorT<T, S>& rhs)
+        friend inline MyType operator/ (MyType lhs, const vcl::vect::VectorT<T, S>& rhs)
         {
             return lhs /= rhs;
         }
@@ -1062,7 +1061,7 @@ namespace vcl::vect {
         /** \brief / operator (vcl::vect::VectorT, const TScalar) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator/ (MyType lhs, const T value)
+        friend inline MyType operator/ (MyType lhs, const T value)
         {
             return lhs /= value;
         }
@@ -1070,7 +1069,7 @@ namespace vcl::vect {
         /** \brief / operator (const T Scalar, vcl::vect::VectorT) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator/ (const T value, MyType& rhs)
+        friend inline MyType operator/ (const T value, MyType& rhs)
         {
             return MyType(value) /= rhs;
         }
@@ -1078,7 +1077,7 @@ namespace vcl::vect {
         /** \brief / operator (const std::array) */
         template<typename T, size_t S>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator/ (MyType lhs, const std::array<T, S>& rhs)
+        friend inline MyType operator/ (MyType lhs, const std::array<T, S>& rhs)
         {
             return lhs /= rhs;
         }
@@ -1086,7 +1085,7 @@ namespace vcl::vect {
         /** \brief / operator (const std::array, vcl::vect::VectorT) */
         template<typename T, size_t S>
             requires std::is_arithmetic_v<T>
-        friend inline std::array<T, S>& operator/ (std::array<T, S> lhs, MyType rhs)
+        friend inline std::array<T, S> operator/ (std::array<T, S> lhs, MyType rhs)
         {
             return lhs /= rhs;
         }
@@ -1094,7 +1093,7 @@ namespace vcl::vect {
         /** \brief / operator (const std::vector) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline MyType& operator/ (MyType lhs, const std::vector<T> rhs)
+        friend inline MyType operator/ (MyType lhs, const std::vector<T> rhs)
         {
             return lhs /= rhs;
         }
@@ -1102,7 +1101,7 @@ namespace vcl::vect {
         /** \brief / operator (const std::vector, vcl::vect::VectorT) */
         template<typename T>
             requires std::is_arithmetic_v<T>
-        friend inline std::vector<T>& operator/ (const std::vector<T> lhs, MyType rhs)
+        friend inline std::vector<T> operator/ (const std::vector<T> lhs, MyType rhs)
         {
             return lhs /= rhs;
         }
@@ -1110,7 +1109,7 @@ namespace vcl::vect {
         /** \brief / operator (vcl::vect::VectorT, const std::pair) */
         template<typename T, typename U>
             requires std::is_arithmetic_v<T>&& std::is_arithmetic_v<U>
-        friend inline MyType& operator/ (MyType lhs, const std::pair<T, U> rhs)
+        friend inline MyType operator/ (MyType lhs, const std::pair<T, U> rhs)
         {
             return lhs /= rhs;
         }
@@ -1118,7 +1117,7 @@ namespace vcl::vect {
         /** \brief / operator (const std::pair, vcl::vect::VectorT) */
         template<typename T, typename U>
             requires std::is_arithmetic_v<T>&& std::is_arithmetic_v<U>
-        friend inline MyType& operator/ (const std::pair<T, U> lhs, MyType& rhs)
+        friend inline MyType operator/ (const std::pair<T, U> lhs, MyType& rhs)
         {
             return lhs /= rhs;
         }
@@ -1393,7 +1392,7 @@ namespace vcl::vect {
         friend inline void mul(std::array<T, S>& lhs, const MyType& rhs)
         {
             auto rit = rhs.cbegin();
-            for (auto it = lhs.begin(); it != this->end() && rit != rhs.cend(); )
+            for (auto it = lhs.begin(); it != lhs.end() && rit != rhs.cend(); )
                 *it++ *= T(*rit++);
         }
 
@@ -1413,7 +1412,7 @@ namespace vcl::vect {
         friend inline void mul(std::vector<T>& lhs, const MyType& rhs)
         {
             auto rit = rhs.cbegin();
-            for (auto it = lhs.begin(); it != this->end() && rit != rhs.cend(); )
+            for (auto it = lhs.begin(); it != lhs.end() && rit != rhs.cend(); )
                 *it++ *= T(*rit++);
         }
 
@@ -1542,16 +1541,46 @@ namespace vcl::vect {
             }
         }
 
-        //---   _set_pattern()   --------------------------------------------
-        /** \brief Sets a pattern vector components with a parameters pack. */
-        template<typename T, typename... Ts>
-        void _set_pattern(std::vector<TScalar>& pattern, const T& first, Ts const... rest) {
-            pattern.push_back(clipped(first));
-            if constexpr (sizeof...(rest) > 0) {
-                _append(pattern, rest...);
-            }
-        }
-
     }; // end of class VectorT<typename TScalar, const size_t Ksize>
 
+
+    //-----------------------------------------------------------------------
+    // Explicit instantiations of the specializations, defined once in module
+    // implementation unit vector.cpp rather than in every importing unit.
+#if !defined(VCL_NO_EXPLICIT_INSTANTIATIONS)
+    extern template class VectorT<char, 2>;
+    extern template class VectorT<unsigned char, 2>;
+    extern template class VectorT<short, 2>;
+    extern template class VectorT<unsigned short, 2>;
+    extern template class VectorT<long, 2>;
+    extern template class VectorT<unsigned long, 2>;
+    extern template class VectorT<long long, 2>;
+    extern template class VectorT<unsigned long long, 2>;
+    extern template class VectorT<float, 2>;
+    extern template class VectorT<double, 2>;
+    extern template class VectorT<long double, 2>;
+    extern template class VectorT<char, 3>;
+    extern template class VectorT<unsigned char, 3>;
+    extern template class VectorT<short, 3>;
+    extern template class VectorT<unsigned short, 3>;
+    extern template class VectorT<long, 3>;
+    extern template class VectorT<unsigned long, 3>;
+    extern template class VectorT<long long, 3>;
+    extern template class VectorT<unsigned long long, 3>;
+    extern template class VectorT<float, 3>;
+    extern template class VectorT<double, 3>;
+    extern template class VectorT<long double, 3>;
+    extern template class VectorT<char, 4>;
+    extern template class VectorT<unsigned char, 4>;
+    extern template class VectorT<short, 4>;
+    extern template class VectorT<unsigned short, 4>;
+    extern template class VectorT<long, 4>;
+    extern template class VectorT<unsigned long, 4>;
+    extern template class VectorT<long long, 4>;
+    extern template class VectorT<unsigned long long, 4>;
+    extern template class VectorT<float, 4>;
+    extern template class VectorT<double, 4>;
+    extern template class VectorT<long double, 4>;
+#endif
+
 } // end of namespace vcl::vect
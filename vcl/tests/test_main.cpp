@@ -25,14 +25,31 @@ SOFTWARE.
 
 //===========================================================================
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include <opencv2/core.hpp>
+
 using namespace std;
 
 
@@ -47,10 +64,29 @@ import utils.pos;
 import utils.dims;
 import utils.offsets;
 import utils.ranges;
+import utils.colors;
 import utils.timecodes;
+import utils.timecode_arrays;
+import utils.timecode_ranges;
 import utils.perfmeters;
+import utils.profilers;
+import utils.latency_histograms;
+import utils.hw_perfmeters;
+import utils.traces;
+import utils.allocations;
+import utils.numa;
 import graphitems.rect;
 import graphitems.line;
+import frames.frame_memory;
+import frames.frame_buffers;
+import frames.pixels;
+import frames.frame;
+import frames.frame_workers;
+import frames.yuv_frames;
+import frames.color_conversions;
+import frames.chroma_resampling;
+import frames.luts;
+import frames.blending;
 
 //#include "tests/test_opencv.h"
 
@@ -70,11 +106,29 @@ int main()
 #include "tests/vectors/test_clipvect4.h"
 
 #include "tests/utils/test_pos.h"
+#include "tests/utils/test_timecode.h"
+#include "tests/utils/test_timecode_arrays.h"
+#include "tests/utils/test_timecode_ranges.h"
+#include "tests/utils/test_perfmeters.h"
+#include "tests/utils/test_profilers.h"
+#include "tests/utils/test_latency_histograms.h"
+#include "tests/utils/test_hw_perfmeters.h"
+#include "tests/utils/test_traces.h"
+#include "tests/utils/test_allocations.h"
+#include "tests/utils/test_numa.h"
+
+#include "tests/frames/test_frame.h"
+#include "tests/frames/test_frame_buffers.h"
+#include "tests/frames/test_frame_workers.h"
+#include "tests/frames/test_pixels.h"
+#include "tests/frames/test_color_conversions.h"
+#include "tests/frames/test_yuv_frames.h"
+#include "tests/frames/test_chroma_resampling.h"
+#include "tests/frames/test_luts.h"
+#include "tests/frames/test_blending.h"
 /**
 #include "tests/utils/test_dims.h"
 #include "tests/utils/test_offsets.h"
-#include "tests/utils/test_timecode.h"
-#include "tests/utils/test_perfmeters.h"
 
 #include "tests/graphitems/test_rect.h"
 **/